@@ -9,10 +9,13 @@
 #ifndef OPENMVG_FEATURES_BINARY_REGIONS_HPP
 #define OPENMVG_FEATURES_BINARY_REGIONS_HPP
 
+#include <cassert>
+#include <memory>
 #include <typeinfo>
 
 #include "openMVG/features/descriptor.hpp"
 #include "openMVG/features/regions.hpp"
+#include "openMVG/features/regions_binary_io.hpp"
 #include "openMVG/features/regions_scale_sort.hpp"
 #include "openMVG/matching/metric.hpp"
 
@@ -53,6 +56,7 @@ public:
     const std::string& sfileNameFeats,
     const std::string& sfileNameDescs) override
   {
+    ReleaseMapping();
     return loadFeatsFromFile(sfileNameFeats, vec_feats_)
           & loadDescsFromBinFile(sfileNameDescs, vec_descs_);
   }
@@ -62,6 +66,13 @@ public:
     const std::string& sfileNameFeats,
     const std::string& sfileNameDescs) const override
   {
+    if (mapped_descs_)
+    {
+      // Export a copy: a const object never releases its mapping
+      const DescsT descs(mapped_descs_, mapped_descs_ + vec_feats_.size());
+      return saveFeatsToFile(sfileNameFeats, vec_feats_)
+            & saveDescsToBinFile(sfileNameDescs, descs);
+    }
     return saveFeatsToFile(sfileNameFeats, vec_feats_)
           & saveDescsToBinFile(sfileNameDescs, vec_descs_);
   }
@@ -71,6 +82,27 @@ public:
     return loadFeatsFromFile(sfileNameFeats, vec_feats_);
   }
 
+  /// Read from a single binary file the regions and their descriptors.
+  bool LoadBinary(
+    const std::string& sfileNameRegions,
+    bool bMemoryMap = true) override
+  {
+    ReleaseMapping();
+    vec_descs_.clear();
+    if (!loadRegionsFromBinFile(sfileNameRegions, vec_feats_, mapped_file_, mapped_descs_))
+      return false;
+    if (!bMemoryMap)
+      DetachMapping();
+    return true;
+  }
+
+  /// Export in a single binary file the regions and their descriptors.
+  bool SaveBinary(const std::string& sfileNameRegions) const override
+  {
+    return saveRegionsToBinFile(
+      sfileNameRegions, vec_feats_, DescriptorsData(), vec_feats_.size());
+  }
+
   PointFeatures GetRegionsPositions() const override
   {
     return {vec_feats_.cbegin(), vec_feats_.cend()};
@@ -84,19 +116,45 @@ public:
   /// Return the number of defined regions
   size_t RegionCount() const override {return vec_feats_.size();}
 
+  /// Return the memory used by the regions (mapped descriptors are accounted)
+  size_t MemorySize() const override
+  {
+    const std::shared_ptr<const DescsT> descs_copy = std::atomic_load(&mapped_descs_copy_);
+    return vec_feats_.capacity() * sizeof(FeatureT)
+      + (mapped_descs_ ? vec_feats_.size() : vec_descs_.capacity()) * sizeof(DescriptorT)
+      + (descs_copy ? descs_copy->capacity() * sizeof(DescriptorT) : 0);
+  }
+
   /// Mutable and non-mutable FeatureT getters.
   inline FeatsT & Features() { return vec_feats_; }
   inline const FeatsT & Features() const { return vec_feats_; }
 
   /// Mutable and non-mutable DescriptorT getters.
-  inline DescsT & Descriptors() { return vec_descs_; }
-  inline const DescsT & Descriptors() const { return vec_descs_; }
+  /// The mutable getter first copies memory mapped descriptors in the container.
+  /// The non-mutable getter never releases the mapping: memory mapped
+  ///  descriptors are copied once in a separate container (use DescriptorsData()
+  ///  for a read only access without copy).
+  inline DescsT & Descriptors() { DetachMapping(); return vec_descs_; }
+  inline const DescsT & Descriptors() const
+  {
+    return mapped_descs_ ? MappedDescriptorsCopy() : vec_descs_;
+  }
 
-  const void * DescriptorRawData() const override { return &vec_descs_[0];}
+  /// Pointer to the first descriptor (mapped or owned)
+  const DescriptorT * DescriptorsData() const
+  {
+    return mapped_descs_ ? mapped_descs_ : vec_descs_.data();
+  }
+
+  const void * DescriptorRawData() const override { return DescriptorsData();}
+
+  /// Return true if the descriptors are read in place from a mapped file
+  bool IsMemoryMapped() const { return mapped_descs_ != nullptr; }
 
   template<class Archive>
   void serialize(Archive & ar)
   {
+    DetachMapping();
     ar(vec_feats_, vec_descs_);
   }
 
@@ -108,35 +166,74 @@ public:
   // Return the squared Hamming distance between two descriptors
   double SquaredDescriptorDistance(size_t i, const Regions * regions, size_t j) const override
   {
-    assert(i < vec_descs_.size());
+    assert(i < RegionCount());
     assert(regions);
     assert(j < regions->RegionCount());
 
     const Binary_Regions<FeatT, L> * regionsT = dynamic_cast<const Binary_Regions<FeatT, L> *>(regions);
     matching::Hamming<unsigned char> metric;
     const typename matching::Hamming<unsigned char>::ResultType descDist =
-      metric(vec_descs_[i].data(), regionsT->vec_descs_[j].data(), DescriptorT::static_size);
+      metric(DescriptorsData()[i].data(), regionsT->DescriptorsData()[j].data(), DescriptorT::static_size);
     return descDist * descDist;
   }
 
   /// Add the Inth region to another Region container
   void CopyRegion(size_t i, Regions * region_container) const override
   {
-    assert(i < vec_feats_.size() && i < vec_descs_.size());
-    static_cast<Binary_Regions<FeatT, L> *>(region_container)->vec_feats_.push_back(vec_feats_[i]);
-    static_cast<Binary_Regions<FeatT, L> *>(region_container)->vec_descs_.push_back(vec_descs_[i]);
+    assert(i < vec_feats_.size());
+    auto * regionsT = static_cast<Binary_Regions<FeatT, L> *>(region_container);
+    regionsT->DetachMapping();
+    regionsT->vec_feats_.push_back(vec_feats_[i]);
+    regionsT->vec_descs_.push_back(DescriptorsData()[i]);
   }
 
   bool SortAndSelectByRegionScale(int keep_count = -1) override
   {
+    DetachMapping();
     return features::SortAndSelectByRegionScale<FeatT, DescsT>(vec_feats_, vec_descs_, keep_count);
   }
 
 private:
+
+  /// Copy the mapped descriptors into the owned container and release the mapping
+  void DetachMapping()
+  {
+    if (!mapped_descs_)
+      return;
+    vec_descs_.assign(mapped_descs_, mapped_descs_ + vec_feats_.size());
+    ReleaseMapping();
+  }
+
+  void ReleaseMapping()
+  {
+    mapped_descs_ = nullptr;
+    mapped_file_.reset();
+    mapped_descs_copy_.reset();
+  }
+
+  /// Copy of the mapped descriptors, made on the first const Descriptors() call
+  ///  (concurrent calls are safe: a single copy is kept)
+  const DescsT & MappedDescriptorsCopy() const
+  {
+    std::shared_ptr<const DescsT> descs = std::atomic_load(&mapped_descs_copy_);
+    if (!descs)
+    {
+      const std::shared_ptr<const DescsT> copy =
+        std::make_shared<const DescsT>(mapped_descs_, mapped_descs_ + vec_feats_.size());
+      if (std::atomic_compare_exchange_strong(&mapped_descs_copy_, &descs, copy))
+        descs = copy;
+    }
+    return *descs;
+  }
+
   //--
   //-- internal data
   FeatsT vec_feats_; // region features
-  DescsT vec_descs_; // region descriptions
+  DescsT vec_descs_; // region descriptions (filled on demand if mapped)
+  // Memory mapped descriptors (used in place of vec_descs_ if not null)
+  std::shared_ptr<const system::MemoryMappedFile> mapped_file_;
+  const DescriptorT * mapped_descs_ = nullptr;
+  mutable std::shared_ptr<const DescsT> mapped_descs_copy_;
 };
 
 } // namespace features
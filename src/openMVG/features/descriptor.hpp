@@ -193,9 +193,10 @@ inline bool loadDescsFromBinFile(
   std::size_t cardDesc = 0;
   fileIn.read(reinterpret_cast<char*>(&cardDesc), sizeof(std::size_t));
   vec_desc.resize(cardDesc);
-  for (auto & it :vec_desc) {
-    fileIn.read(reinterpret_cast<char*>(it.data()),
-      VALUE::static_size*sizeof(typename VALUE::bin_type));
+  // Descriptors are stored contiguously: read them in a single call
+  if (cardDesc > 0) {
+    fileIn.read(reinterpret_cast<char*>(vec_desc[0].data()),
+      cardDesc*VALUE::static_size*sizeof(typename VALUE::bin_type));
   }
   const bool bOk = !fileIn.bad();
   fileIn.close();
@@ -8,12 +8,14 @@
 
 #include "openMVG/features/feature.hpp"
 #include "openMVG/features/descriptor.hpp"
+#include "openMVG/features/regions_factory.hpp"
 
 #include "testing/testing.h"
 
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <vector>
 
 using namespace openMVG;
@@ -129,6 +131,68 @@ TEST(descriptorIO, BINARY) {
   }
 }
 
+//Test single file binary export of regions (features + descriptors)
+TEST(regionsIO, BINARY) {
+  SIFT_Regions regions;
+  for (int i = 0; i < CARD; ++i)
+  {
+    regions.Features().emplace_back(i, i*2, i*3, i*4);
+    SIFT_Regions::DescriptorT desc;
+    for (int j = 0; j < 128; ++j)
+      desc[j] = static_cast<unsigned char>(i + j);
+    regions.Descriptors().emplace_back(desc);
+  }
+
+  EXPECT_TRUE(regions.SaveBinary("tempRegions.regions"));
+
+  for (const bool bMemoryMap : {true, false})
+  {
+    SIFT_Regions regions_read;
+    EXPECT_TRUE(regions_read.LoadBinary("tempRegions.regions", bMemoryMap));
+    EXPECT_EQ(bMemoryMap, regions_read.IsMemoryMapped());
+    EXPECT_EQ(CARD, regions_read.RegionCount());
+    // The mapped descriptor block is aligned in the file
+    if (bMemoryMap)
+      EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(regions_read.DescriptorRawData()) % 32);
+
+    const unsigned char * descs =
+      reinterpret_cast<const unsigned char*>(regions_read.DescriptorRawData());
+    for (int i = 0; i < CARD; ++i)
+    {
+      EXPECT_EQ(regions.Features()[i], regions_read.Features()[i]);
+      for (int j = 0; j < 128; ++j)
+        EXPECT_EQ(regions.Descriptors()[i][j], descs[i * 128 + j]);
+      EXPECT_EQ(0.0, regions.SquaredDescriptorDistance(i, &regions_read, i));
+    }
+
+    // A const access never releases the mapping (the raw pointer stays valid)
+    const SIFT_Regions & const_regions_read = regions_read;
+    EXPECT_TRUE(const_regions_read.Save("tempRegions.feat", "tempRegions.desc"));
+    EXPECT_EQ(bMemoryMap, regions_read.IsMemoryMapped());
+    EXPECT_EQ(descs, regions_read.DescriptorRawData());
+    EXPECT_EQ(CARD, const_regions_read.Descriptors().size());
+    for (int i = 0; i < CARD; ++i)
+      EXPECT_EQ(regions.Descriptors()[i], const_regions_read.Descriptors()[i]);
+    EXPECT_EQ(bMemoryMap, regions_read.IsMemoryMapped());
+  }
+
+  // A regions file cannot be read with another regions type
+  AKAZE_Float_Regions akaze_regions;
+  EXPECT_FALSE(akaze_regions.LoadBinary("tempRegions.regions"));
+  EXPECT_FALSE(regions.LoadBinary("x.regions"));
+
+  // A corrupted region count (the block sizes overflow) is detected
+  {
+    std::fstream file("tempRegions.regions", std::ios::in | std::ios::out | std::ios::binary);
+    Regions_File_Header header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    header.region_count = std::numeric_limits<uint64_t>::max() / 8 + 1;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+  EXPECT_FALSE(regions.LoadBinary("tempRegions.regions"));
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
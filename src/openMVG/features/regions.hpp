@@ -40,6 +40,20 @@ public:
   virtual bool LoadFeatures(
     const std::string& sfileNameFeats) = 0;
 
+  //--
+  // IO - single binary file (keypoints SoA + contiguous descriptors)
+  //--
+
+  /// Read regions from a binary regions file.
+  /// If bMemoryMap is true the descriptors are used in place from the mapped
+  ///  file (DescriptorRawData() points into the mapping), else they are copied.
+  virtual bool LoadBinary(
+    const std::string& sfileNameRegions,
+    bool bMemoryMap = true) = 0;
+
+  virtual bool SaveBinary(
+    const std::string& sfileNameRegions) const = 0;
+
   //--
   //- Basic description of a descriptor [Type, Length]
   //--
@@ -58,6 +72,9 @@ public:
   /// Return the number of defined regions
   virtual size_t RegionCount() const = 0;
 
+  /// Return the memory used by the regions and their descriptors (in bytes)
+  virtual size_t MemorySize() const = 0;
+
   /// Return a pointer to the first value of the descriptor array
   // Used to avoid complex template imbrication
   virtual const void * DescriptorRawData() const = 0;
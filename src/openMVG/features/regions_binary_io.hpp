@@ -0,0 +1,263 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_FEATURES_REGIONS_BINARY_IO_HPP
+#define OPENMVG_FEATURES_REGIONS_BINARY_IO_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "openMVG/features/feature.hpp"
+#include "openMVG/system/logger.hpp"
+#include "openMVG/system/memory_mapped_file.hpp"
+
+namespace openMVG {
+namespace features {
+
+/**
+ * Single file binary regions container (".regions").
+ *
+ * Layout (each block starts on a kRegionsFileAlignment byte boundary):
+ *  - Regions_File_Header
+ *  - keypoints as a structure of arrays: field_count arrays of region_count float
+ *  - descriptors as one contiguous block: region_count * descriptor_length bins
+ *
+ * The descriptor block can be memory mapped and used in place (zero copy).
+ */
+static const char kRegionsFileMagic[8] = {'O','M','V','G','R','G','N','\0'};
+static const uint32_t kRegionsFileVersion = 1;
+static const uint64_t kRegionsFileAlignment = 32;
+
+struct Regions_File_Header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t feature_field_count;  // Number of float used to store a keypoint
+  uint32_t descriptor_bin_size;  // sizeof of a descriptor element
+  uint32_t descriptor_length;    // Number of elements of a descriptor
+  uint64_t region_count;
+  uint64_t features_offset;      // Byte offset of the keypoint SoA block
+  uint64_t descriptors_offset;   // Byte offset of the descriptor block
+};
+
+/// Round an offset up to the regions file alignment
+inline uint64_t AlignRegionsFileOffset(uint64_t offset)
+{
+  return (offset + kRegionsFileAlignment - 1) & ~(kRegionsFileAlignment - 1);
+}
+
+/// Return true if a block of count elements of element_size bytes starting at
+///  offset is contained in a file of file_size bytes (without overflow on
+///  corrupted headers)
+inline bool FitsInRegionsFile
+(
+  uint64_t offset,
+  uint64_t count,
+  uint64_t element_size,
+  uint64_t file_size
+)
+{
+  return offset <= file_size
+    && (element_size == 0 || count <= (file_size - offset) / element_size);
+}
+
+/// Describe how a keypoint type is stored as a set of float fields
+template <typename FeatT>
+struct Feature_SoA_Traits;
+
+template <>
+struct Feature_SoA_Traits<PointFeature>
+{
+  static const uint32_t field_count = 2;
+  static void Pack(const PointFeature & feat, float * fields)
+  {
+    fields[0] = feat.x(); fields[1] = feat.y();
+  }
+  static PointFeature Unpack(const float * fields)
+  {
+    return {fields[0], fields[1]};
+  }
+};
+
+template <>
+struct Feature_SoA_Traits<SIOPointFeature>
+{
+  static const uint32_t field_count = 4;
+  static void Pack(const SIOPointFeature & feat, float * fields)
+  {
+    fields[0] = feat.x(); fields[1] = feat.y();
+    fields[2] = feat.scale(); fields[3] = feat.orientation();
+  }
+  static SIOPointFeature Unpack(const float * fields)
+  {
+    return {fields[0], fields[1], fields[2], fields[3]};
+  }
+};
+
+template <>
+struct Feature_SoA_Traits<AffinePointFeature>
+{
+  // l1, l2 and phi are derived from the ellipse parameters (a, b, c)
+  static const uint32_t field_count = 5;
+  static void Pack(const AffinePointFeature & feat, float * fields)
+  {
+    fields[0] = feat.x(); fields[1] = feat.y();
+    fields[2] = feat.a(); fields[3] = feat.b(); fields[4] = feat.c();
+  }
+  static AffinePointFeature Unpack(const float * fields)
+  {
+    return {fields[0], fields[1], fields[2], fields[3], fields[4]};
+  }
+};
+
+/// Write keypoints and descriptors to a single binary regions file
+template<typename FeaturesT, typename DescriptorT>
+bool saveRegionsToBinFile(
+  const std::string & sfileNameRegions,
+  const FeaturesT & vec_feats,
+  const DescriptorT * descs,
+  const std::size_t desc_count)
+{
+  using Traits = Feature_SoA_Traits<typename FeaturesT::value_type>;
+  const uint32_t field_count = Traits::field_count;
+  using BinT = typename DescriptorT::bin_type;
+
+  if (vec_feats.size() != desc_count)
+    return false;
+
+  std::ofstream file(sfileNameRegions.c_str(), std::ios::out | std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  const uint64_t region_count = vec_feats.size();
+  const uint64_t descriptor_size = DescriptorT::static_size * sizeof(BinT);
+
+  Regions_File_Header header;
+  std::memcpy(header.magic, kRegionsFileMagic, sizeof(header.magic));
+  header.version = kRegionsFileVersion;
+  header.feature_field_count = field_count;
+  header.descriptor_bin_size = sizeof(BinT);
+  header.descriptor_length = DescriptorT::static_size;
+  header.region_count = region_count;
+  header.features_offset = AlignRegionsFileOffset(sizeof(Regions_File_Header));
+  header.descriptors_offset = AlignRegionsFileOffset(
+    header.features_offset + field_count * region_count * sizeof(float));
+
+  const std::vector<char> padding(kRegionsFileAlignment, 0);
+  uint64_t position = 0;
+  const auto pad_to = [&](uint64_t offset)
+  {
+    file.write(padding.data(), offset - position);
+    position = offset;
+  };
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  position = sizeof(header);
+
+  // Keypoints: one contiguous array per field
+  pad_to(header.features_offset);
+  {
+    std::vector<float> soa(field_count * region_count);
+    std::array<float, Traits::field_count> fields;
+    for (uint64_t i = 0; i < region_count; ++i)
+    {
+      Traits::Pack(vec_feats[i], fields.data());
+      for (uint32_t k = 0; k < field_count; ++k)
+        soa[k * region_count + i] = fields[k];
+    }
+    file.write(reinterpret_cast<const char*>(soa.data()), soa.size() * sizeof(float));
+    position += soa.size() * sizeof(float);
+  }
+
+  // Descriptors: a single write of the contiguous block
+  pad_to(header.descriptors_offset);
+  if (region_count > 0)
+  {
+    static_assert(sizeof(DescriptorT) == DescriptorT::static_size * sizeof(BinT),
+      "Descriptors must be stored without padding");
+    file.write(reinterpret_cast<const char*>(descs), region_count * descriptor_size);
+  }
+
+  const bool bOk = file.good();
+  file.close();
+  return bOk;
+}
+
+/// Map a binary regions file and decode its keypoints.
+/// On success `mapping` owns the file mapping and `descs` points to the
+/// first descriptor stored in it (valid as long as `mapping` is alive).
+template<typename FeaturesT, typename DescriptorT>
+bool loadRegionsFromBinFile(
+  const std::string & sfileNameRegions,
+  FeaturesT & vec_feats,
+  std::shared_ptr<const system::MemoryMappedFile> & mapping,
+  const DescriptorT * & descs)
+{
+  using Traits = Feature_SoA_Traits<typename FeaturesT::value_type>;
+  const uint32_t field_count = Traits::field_count;
+  using BinT = typename DescriptorT::bin_type;
+
+  vec_feats.clear();
+  mapping.reset();
+  descs = nullptr;
+
+  auto file = std::make_shared<system::MemoryMappedFile>();
+  if (!file->open(sfileNameRegions) || file->size() < sizeof(Regions_File_Header))
+    return false;
+
+  Regions_File_Header header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (std::memcmp(header.magic, kRegionsFileMagic, sizeof(header.magic)) != 0
+      || header.version != kRegionsFileVersion)
+  {
+    OPENMVG_LOG_ERROR << "Invalid regions file: " << sfileNameRegions;
+    return false;
+  }
+  if (header.feature_field_count != field_count
+      || header.descriptor_bin_size != sizeof(BinT)
+      || header.descriptor_length != DescriptorT::static_size)
+  {
+    OPENMVG_LOG_ERROR << "Regions file type mismatch: " << sfileNameRegions;
+    return false;
+  }
+
+  const uint64_t region_count = header.region_count;
+  const uint64_t descriptor_size = DescriptorT::static_size * sizeof(BinT);
+  if (!FitsInRegionsFile(header.features_offset, region_count, field_count * sizeof(float), file->size())
+      || !FitsInRegionsFile(header.descriptors_offset, region_count, descriptor_size, file->size())
+      || header.features_offset % kRegionsFileAlignment != 0
+      || header.descriptors_offset % kRegionsFileAlignment != 0)
+  {
+    OPENMVG_LOG_ERROR << "Truncated regions file: " << sfileNameRegions;
+    return false;
+  }
+
+  const float * soa = reinterpret_cast<const float*>(file->data() + header.features_offset);
+  vec_feats.reserve(region_count);
+  std::array<float, Traits::field_count> fields;
+  for (uint64_t i = 0; i < region_count; ++i)
+  {
+    for (uint32_t k = 0; k < field_count; ++k)
+      fields[k] = soa[k * region_count + i];
+    vec_feats.emplace_back(Traits::Unpack(fields.data()));
+  }
+
+  descs = reinterpret_cast<const DescriptorT*>(file->data() + header.descriptors_offset);
+  mapping = std::move(file);
+  return true;
+}
+
+} // namespace features
+} // namespace openMVG
+
+#endif // OPENMVG_FEATURES_REGIONS_BINARY_IO_HPP
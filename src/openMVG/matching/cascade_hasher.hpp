@@ -61,7 +61,10 @@
 // Author: Chris Sweeney (cmsweeney@cs.ucsb.edu)
 
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <iostream>
 #include <random>
 #include <utility>
 #include <vector>
@@ -90,6 +93,11 @@ struct HashedDescriptions{
   using Bucket = std::vector<int>;
   // buckets[bucket_group][bucket_id] = bucket (container of description ids).
   std::vector<std::vector<Bucket>> buckets;
+
+  // The hash codes packed in a contiguous array of 64 bits words
+  // (code of description i: [i * nb_words_per_code, (i+1) * nb_words_per_code[).
+  std::vector<uint64_t> packed_hash_codes;
+  int nb_words_per_code = 0;
 };
 
 // This hasher will hash descriptors with a two-step hashing system:
@@ -229,25 +237,95 @@ public:
       }
     }
     // Build the Buckets
+    BuildBuckets(hashed_descriptions);
+    return hashed_descriptions;
+  }
+
+  // Fill the buckets of hashed descriptions from their bucket ids
+  //  and pack their hash codes
+  void BuildBuckets
+  (
+    HashedDescriptions & hashed_descriptions
+  ) const
+  {
+    const auto & hashed_desc = hashed_descriptions.hashed_desc;
+    const int nb_words = hashed_desc.empty() ? 0 :
+      (hashed_desc[0].hash_code.size() + 63) / 64;
+    hashed_descriptions.nb_words_per_code = nb_words;
+    hashed_descriptions.packed_hash_codes.assign(hashed_desc.size() * nb_words, 0);
+    for (int i = 0; i < hashed_desc.size(); ++i)
     {
-      hashed_descriptions.buckets.resize(nb_bucket_groups_);
-      for (int i = 0; i < nb_bucket_groups_; ++i)
-      {
-        hashed_descriptions.buckets[i].resize(nb_buckets_per_group_);
+      std::memcpy(&hashed_descriptions.packed_hash_codes[i * nb_words],
+        hashed_desc[i].hash_code.data(),
+        hashed_desc[i].hash_code.num_blocks() * sizeof(stl::dynamic_bitset::BlockType));
+    }
 
-        // Add the descriptor ID to the proper bucket group and id.
-        for (int j = 0; j < hashed_descriptions.hashed_desc.size(); ++j)
-        {
-          const uint16_t bucket_id = hashed_descriptions.hashed_desc[j].bucket_ids[i];
-          hashed_descriptions.buckets[i][bucket_id].push_back(j);
-        }
+    hashed_descriptions.buckets.clear();
+    hashed_descriptions.buckets.resize(nb_bucket_groups_);
+    for (int i = 0; i < nb_bucket_groups_; ++i)
+    {
+      hashed_descriptions.buckets[i].resize(nb_buckets_per_group_);
+
+      // Add the descriptor ID to the proper bucket group and id.
+      for (int j = 0; j < hashed_descriptions.hashed_desc.size(); ++j)
+      {
+        const uint16_t bucket_id = hashed_descriptions.hashed_desc[j].bucket_ids[i];
+        hashed_descriptions.buckets[i][bucket_id].push_back(j);
       }
     }
-    return hashed_descriptions;
+  }
+
+  int NbHashCode() const { return nb_hash_code_; }
+  int NbBucketGroups() const { return nb_bucket_groups_; }
+  int NbBitsPerBucket() const { return nb_bits_per_bucket_; }
+
+  // Binary export of the hashing configuration and projections
+  bool Save(std::ostream & stream) const
+  {
+    const int32_t header[3] = {nb_hash_code_, nb_bucket_groups_, nb_bits_per_bucket_};
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(primary_hash_projection_.data()),
+      primary_hash_projection_.size() * sizeof(float));
+    for (const auto & projection : secondary_hash_projection_)
+    {
+      stream.write(reinterpret_cast<const char*>(projection.data()),
+        projection.size() * sizeof(float));
+    }
+    return stream.good();
+  }
+
+  // Binary import of the hashing configuration and projections
+  bool Load(std::istream & stream)
+  {
+    int32_t header[3];
+    if (!stream.read(reinterpret_cast<char*>(header), sizeof(header))
+        || header[0] <= 0 || header[1] <= 0 || header[2] <= 0 || header[2] > 16)
+      return false;
+    nb_hash_code_ = header[0];
+    nb_bucket_groups_ = header[1];
+    nb_bits_per_bucket_ = header[2];
+    nb_buckets_per_group_ = 1 << nb_bits_per_bucket_;
+
+    primary_hash_projection_.resize(nb_hash_code_, nb_hash_code_);
+    stream.read(reinterpret_cast<char*>(primary_hash_projection_.data()),
+      primary_hash_projection_.size() * sizeof(float));
+    secondary_hash_projection_.resize(nb_bucket_groups_);
+    for (auto & projection : secondary_hash_projection_)
+    {
+      projection.resize(nb_bits_per_bucket_, nb_hash_code_);
+      stream.read(reinterpret_cast<char*>(projection.data()),
+        projection.size() * sizeof(float));
+    }
+    return static_cast<bool>(stream);
   }
 
   // Matches two collection of hashed descriptions with a fast matching scheme
   // based on the hash codes previously generated.
+  // For each query description:
+  // - the unique candidates sharing a bucket are collected,
+  // - their Hamming distances are computed in batch (SIMD kernels selected at runtime),
+  // - a counting sort on the Hamming distance selects the kNumTopCandidates best ones,
+  // - the L2 distance is computed on these candidates only.
   template <typename MatrixT, typename DistanceType>
   void Match_HashedDescriptions
   (
@@ -259,6 +337,135 @@ public:
     std::vector<DistanceType> * pvec_distances,
     const int NN = 2
   ) const
+  {
+    using Scalar = typename MatrixT::Scalar;
+    static const int kNumTopCandidates = 10;
+
+    const int nb_words = hashed_descriptions2.nb_words_per_code;
+    if (hashed_descriptions1.nb_words_per_code != nb_words)
+      return;
+
+    // Preallocated containers
+    std::vector<int> candidate_descriptors;
+    candidate_descriptors.reserve(hashed_descriptions2.hashed_desc.size());
+    std::vector<uint16_t> candidate_hamming_distances;
+    candidate_hamming_distances.reserve(hashed_descriptions2.hashed_desc.size());
+    std::vector<int> num_descriptors_with_hamming_distance(nb_words * 64 + 1);
+    std::vector<std::pair<DistanceType, int>> candidate_euclidean_distances;
+    candidate_euclidean_distances.reserve(kNumTopCandidates);
+
+    // A preallocated vector to determine if we have already used a particular
+    // feature for matching (i.e., prevents duplicates).
+    std::vector<bool> used_descriptor(hashed_descriptions2.hashed_desc.size(), false);
+
+    for (int i = 0; i < hashed_descriptions1.hashed_desc.size(); ++i)
+    {
+      candidate_descriptors.clear();
+      candidate_euclidean_distances.clear();
+
+      const auto& hashed_desc = hashed_descriptions1.hashed_desc[i];
+
+      // Accumulate the unique descriptors of each bucket group that are in
+      // the same bucket id as the query descriptor.
+      size_t nb_bucket_candidates = 0;
+      for (int j = 0; j < nb_bucket_groups_; ++j)
+      {
+        const uint16_t bucket_id = hashed_desc.bucket_ids[j];
+        const auto & bucket = hashed_descriptions2.buckets[j][bucket_id];
+        nb_bucket_candidates += bucket.size();
+        for (const auto& feature_id : bucket)
+        {
+          if (!used_descriptor[feature_id])
+          {
+            used_descriptor[feature_id] = true;
+            candidate_descriptors.emplace_back(feature_id);
+          }
+        }
+      }
+      for (const int candidate_id : candidate_descriptors)
+        used_descriptor[candidate_id] = false;
+
+      // Skip matching this descriptor if there are not at least NN candidates.
+      if (nb_bucket_candidates <= NN)
+      {
+        continue;
+      }
+
+      // Compute the hamming distance of all the candidates
+      const int nb_candidates = static_cast<int>(candidate_descriptors.size());
+      candidate_hamming_distances.resize(nb_candidates);
+      HammingDistances(
+        &hashed_descriptions1.packed_hash_codes[static_cast<size_t>(i) * nb_words],
+        hashed_descriptions2.packed_hash_codes.data(),
+        nb_words,
+        candidate_descriptors.data(),
+        nb_candidates,
+        candidate_hamming_distances.data());
+
+      // Counting sort: find the hamming distance threshold that selects
+      //  the kNumTopCandidates best candidates
+      std::fill(num_descriptors_with_hamming_distance.begin(),
+        num_descriptors_with_hamming_distance.end(), 0);
+      for (const uint16_t hamming_distance : candidate_hamming_distances)
+        ++num_descriptors_with_hamming_distance[hamming_distance];
+      const int last_distance = static_cast<int>(num_descriptors_with_hamming_distance.size()) - 1;
+      int max_distance = 0, nb_below_max_distance = 0;
+      while (max_distance < last_distance &&
+        nb_below_max_distance + num_descriptors_with_hamming_distance[max_distance] < kNumTopCandidates)
+      {
+        nb_below_max_distance += num_descriptors_with_hamming_distance[max_distance];
+        ++max_distance;
+      }
+      // Candidates at the threshold distance are kept in the candidate order
+      int nb_at_max_distance = kNumTopCandidates - nb_below_max_distance;
+
+      // Compute the euclidean distance of the selected candidates
+      for (int k = 0; k < nb_candidates; ++k)
+      {
+        const uint16_t hamming_distance = candidate_hamming_distances[k];
+        if (hamming_distance > max_distance ||
+            (hamming_distance == max_distance && nb_at_max_distance-- <= 0))
+          continue;
+        const int candidate_id = candidate_descriptors[k];
+        const DistanceType distance = L2<Scalar>()(
+          descriptions2.row(candidate_id).data(),
+          descriptions1.row(i).data(),
+          descriptions1.cols());
+        candidate_euclidean_distances.emplace_back(distance, candidate_id);
+      }
+
+      // Assert that each query is having at least NN retrieved neighbors
+      if (candidate_euclidean_distances.size() >= NN)
+      {
+        // Find the top NN candidates based on euclidean distance.
+        std::partial_sort(candidate_euclidean_distances.begin(),
+          candidate_euclidean_distances.begin() + NN,
+          candidate_euclidean_distances.end());
+        // save resulting neighbors
+        for (int l = 0; l < NN; ++l)
+        {
+          pvec_distances->emplace_back(candidate_euclidean_distances[l].first);
+          pvec_indices->emplace_back(IndMatch(i,candidate_euclidean_distances[l].second));
+        }
+      }
+      //else -> too few candidates... (save no one)
+    }
+  }
+
+  // Reference implementation of Match_HashedDescriptions:
+  // per candidate Hamming distance and histogram of the candidates.
+  // (kept to validate and benchmark the batched implementation)
+  template <typename MatrixT, typename DistanceType>
+  void Match_HashedDescriptions_Histogram
+  (
+    const HashedDescriptions& hashed_descriptions1,
+    const MatrixT & descriptions1,
+    const HashedDescriptions& hashed_descriptions2,
+    const MatrixT & descriptions2,
+    IndMatches * pvec_indices,
+    std::vector<DistanceType> * pvec_distances,
+    const int NN = 2
+  ) const
   {
     using MetricT = L2<typename MatrixT::Scalar>;
     MetricT metric;
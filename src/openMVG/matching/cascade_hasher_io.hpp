@@ -0,0 +1,231 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_MATCHING_CASCADE_HASHER_IO_HPP
+#define OPENMVG_MATCHING_CASCADE_HASHER_IO_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "openMVG/matching/cascade_hasher.hpp"
+
+namespace openMVG {
+namespace matching {
+
+//--
+// Binary persistence of the cascade hashing data:
+// - one file for the hasher (projections + zero mean descriptor),
+// - one sidecar file per image for its hashed descriptions (hash codes + bucket ids).
+// A sidecar file is valid only for the hasher and the regions it was computed from:
+//  the hasher is identified by a fingerprint of its content, the regions by a key
+//  provided by the caller (cheap to compute, e.g. from the regions files size & date).
+//--
+
+static const char kCascadeHasherMagic[8] = {'O','M','V','G','C','H','H','\0'};
+static const char kHashedDescriptionsMagic[8] = {'O','M','V','G','H','S','D','\0'};
+static const uint32_t kCascadeHashingFileVersion = 2;
+
+/// 64 bits FNV-1a hash of a memory block
+inline uint64_t FingerprintBytes
+(
+  const void * data,
+  const std::size_t size,
+  uint64_t hash = 14695981039346656037ULL
+)
+{
+  const unsigned char * bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/// Save a cascade hasher and its zero mean descriptor.
+/// Return the fingerprint of the saved configuration (0 on failure).
+inline uint64_t SaveCascadeHasher
+(
+  const std::string & filename,
+  const CascadeHasher & cascade_hasher,
+  const Eigen::VectorXf & zero_mean_descriptor
+)
+{
+  std::ostringstream content;
+  cascade_hasher.Save(content);
+  const int32_t dimension = zero_mean_descriptor.size();
+  content.write(reinterpret_cast<const char*>(&dimension), sizeof(dimension));
+  content.write(reinterpret_cast<const char*>(zero_mean_descriptor.data()),
+    dimension * sizeof(float));
+  const std::string bytes = content.str();
+  const uint64_t fingerprint = FingerprintBytes(bytes.data(), bytes.size());
+
+  std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+  if (!file.is_open())
+    return 0;
+  file.write(kCascadeHasherMagic, sizeof(kCascadeHasherMagic));
+  file.write(reinterpret_cast<const char*>(&kCascadeHashingFileVersion), sizeof(uint32_t));
+  file.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+  file.write(bytes.data(), bytes.size());
+  return file.good() ? fingerprint : 0;
+}
+
+/// Load a cascade hasher and its zero mean descriptor.
+/// Return the fingerprint of the loaded configuration (0 on failure).
+inline uint64_t LoadCascadeHasher
+(
+  const std::string & filename,
+  CascadeHasher & cascade_hasher,
+  Eigen::VectorXf & zero_mean_descriptor
+)
+{
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    return 0;
+  char magic[8];
+  uint32_t version = 0;
+  uint64_t fingerprint = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+  if (!file || std::memcmp(magic, kCascadeHasherMagic, sizeof(magic)) != 0
+      || version != kCascadeHashingFileVersion)
+    return 0;
+
+  if (!cascade_hasher.Load(file))
+    return 0;
+  int32_t dimension = 0;
+  file.read(reinterpret_cast<char*>(&dimension), sizeof(dimension));
+  if (!file || dimension != cascade_hasher.NbHashCode())
+    return 0;
+  zero_mean_descriptor.resize(dimension);
+  file.read(reinterpret_cast<char*>(zero_mean_descriptor.data()), dimension * sizeof(float));
+  return file ? fingerprint : 0;
+}
+
+/// Save hashed descriptions (the buckets are not saved, they are rebuilt at loading).
+inline bool SaveHashedDescriptions
+(
+  const std::string & filename,
+  const HashedDescriptions & hashed_descriptions,
+  const uint64_t hasher_fingerprint,
+  const uint64_t regions_key
+)
+{
+  std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  const auto & hashed_desc = hashed_descriptions.hashed_desc;
+  const uint64_t count = hashed_desc.size();
+  const uint32_t nb_bits = count ? hashed_desc[0].hash_code.size() : 0;
+  const uint32_t nb_bucket_groups = count ? hashed_desc[0].bucket_ids.size() : 0;
+
+  file.write(kHashedDescriptionsMagic, sizeof(kHashedDescriptionsMagic));
+  file.write(reinterpret_cast<const char*>(&kCascadeHashingFileVersion), sizeof(uint32_t));
+  file.write(reinterpret_cast<const char*>(&nb_bits), sizeof(nb_bits));
+  file.write(reinterpret_cast<const char*>(&nb_bucket_groups), sizeof(nb_bucket_groups));
+  file.write(reinterpret_cast<const char*>(&hasher_fingerprint), sizeof(hasher_fingerprint));
+  file.write(reinterpret_cast<const char*>(&regions_key), sizeof(regions_key));
+  file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  // Hash codes then bucket ids, each as a contiguous block
+  for (const auto & desc : hashed_desc)
+  {
+    file.write(reinterpret_cast<const char*>(desc.hash_code.data()),
+      desc.hash_code.num_blocks() * sizeof(stl::dynamic_bitset::BlockType));
+  }
+  for (const auto & desc : hashed_desc)
+  {
+    file.write(reinterpret_cast<const char*>(desc.bucket_ids.data()),
+      nb_bucket_groups * sizeof(uint16_t));
+  }
+  return file.good();
+}
+
+/// Load hashed descriptions if they have been computed with the given hasher
+///  from the regions identified by the given key.
+inline bool LoadHashedDescriptions
+(
+  const std::string & filename,
+  const CascadeHasher & cascade_hasher,
+  const uint64_t hasher_fingerprint,
+  const uint64_t regions_key,
+  HashedDescriptions & hashed_descriptions
+)
+{
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  char magic[8];
+  uint32_t version = 0, nb_bits = 0, nb_bucket_groups = 0;
+  uint64_t file_hasher_fingerprint = 0, file_regions_key = 0, count = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&nb_bits), sizeof(nb_bits));
+  file.read(reinterpret_cast<char*>(&nb_bucket_groups), sizeof(nb_bucket_groups));
+  file.read(reinterpret_cast<char*>(&file_hasher_fingerprint), sizeof(uint64_t));
+  file.read(reinterpret_cast<char*>(&file_regions_key), sizeof(uint64_t));
+  file.read(reinterpret_cast<char*>(&count), sizeof(count));
+  if (!file || std::memcmp(magic, kHashedDescriptionsMagic, sizeof(magic)) != 0
+      || version != kCascadeHashingFileVersion
+      || file_hasher_fingerprint != hasher_fingerprint
+      || file_regions_key != regions_key)
+    return false;
+  if (count > 0 && (nb_bits != static_cast<uint32_t>(cascade_hasher.NbHashCode())
+      || nb_bucket_groups != static_cast<uint32_t>(cascade_hasher.NbBucketGroups())))
+    return false;
+
+  // Check that the file contains the announced descriptions before allocating them
+  const std::streamoff header_end = file.tellg();
+  file.seekg(0, std::ios::end);
+  const std::streamoff file_end = file.tellg();
+  file.seekg(header_end);
+  if (!file || file_end < header_end)
+    return false;
+  const uint64_t bytes_per_desc =
+    stl::dynamic_bitset(nb_bits).num_blocks() * sizeof(stl::dynamic_bitset::BlockType)
+    + static_cast<uint64_t>(nb_bucket_groups) * sizeof(uint16_t);
+  if (count > 0 && (bytes_per_desc == 0
+      || count > static_cast<uint64_t>(file_end - header_end) / bytes_per_desc))
+    return false;
+
+  hashed_descriptions.hashed_desc.resize(count);
+  for (auto & desc : hashed_descriptions.hashed_desc)
+  {
+    desc.hash_code = stl::dynamic_bitset(nb_bits);
+    file.read(reinterpret_cast<char*>(desc.hash_code.data()),
+      desc.hash_code.num_blocks() * sizeof(stl::dynamic_bitset::BlockType));
+  }
+  const uint32_t bucket_count = 1u << cascade_hasher.NbBitsPerBucket();
+  for (auto & desc : hashed_descriptions.hashed_desc)
+  {
+    desc.bucket_ids.resize(nb_bucket_groups);
+    file.read(reinterpret_cast<char*>(desc.bucket_ids.data()),
+      nb_bucket_groups * sizeof(uint16_t));
+    for (const uint16_t bucket_id : desc.bucket_ids)
+    {
+      if (bucket_id >= bucket_count)
+        return false;
+    }
+  }
+  if (!file)
+    return false;
+
+  cascade_hasher.BuildBuckets(hashed_descriptions);
+  return true;
+}
+
+} // namespace matching
+} // namespace openMVG
+
+#endif // OPENMVG_MATCHING_CASCADE_HASHER_IO_HPP
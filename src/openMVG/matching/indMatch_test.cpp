@@ -12,6 +12,9 @@
 
 #include "testing/testing.h"
 
+#include <cstdio>
+#include <string>
+
 using namespace openMVG;
 using namespace matching;
 
@@ -53,6 +56,90 @@ TEST(IndMatch, IO)
   EXPECT_EQ(3, matches.at({1,2}).size());
 }
 
+TEST(IndMatch, IO_Writer)
+{
+  PairWiseMatches matches;
+  matches[{1,2}] = {{0,0},{1,1}, {2,2}};
+  matches[{0,1}] = {{0,0},{1,1}};
+  matches[{0,3}] = {};
+
+  for (const std::string filename : {"matches_stream.txt", "matches_stream.bin", "matches_stream.cbin"})
+  {
+    {
+      PairWiseMatches_Writer writer(filename);
+      EXPECT_TRUE(writer.good());
+      // Pairs are written in their insertion order
+      writer.insert({{1,2}, matches.at({1,2})});
+      writer.insert({{0,1}, matches.at({0,1})});
+      writer.insert({{0,3}, matches.at({0,3})});
+      EXPECT_EQ(3, writer.pairs().size());
+      EXPECT_TRUE(writer.close());
+    }
+    PairWiseMatches loaded_matches;
+    EXPECT_TRUE(Load(loaded_matches, filename));
+    EXPECT_EQ(3, loaded_matches.size());
+    for (const auto & pair_matches : matches)
+    {
+      EXPECT_EQ(1, loaded_matches.count(pair_matches.first));
+      EXPECT_TRUE(pair_matches.second == loaded_matches.at(pair_matches.first));
+    }
+  }
+
+  // Empty file
+  for (const std::string filename : {"matches_stream.bin", "matches_stream.cbin"})
+  {
+    {
+      PairWiseMatches_Writer writer(filename);
+    }
+    PairWiseMatches loaded_matches;
+    EXPECT_TRUE(Load(loaded_matches, filename));
+    EXPECT_EQ(0, loaded_matches.size());
+  }
+}
+
+TEST(IndMatch, IO_Columnar)
+{
+  PairWiseMatches matches;
+  matches[{0,1}] = {{0,0},{1,1}};
+  matches[{1,2}] = {{5,3},{1,400000},{2,2},{4000000000u,0}}; // unsorted & large indexes
+  matches[{2,3}] = {};
+  matches[{3,7}] = {{7,7}};
+
+  EXPECT_TRUE(Save(matches, "matches.cbin"));
+  PairWiseMatches loaded_matches;
+  EXPECT_TRUE(Load(loaded_matches, "matches.cbin"));
+  EXPECT_TRUE(matches == loaded_matches);
+
+  // Load only the pairs that use the given views
+  EXPECT_TRUE(Load(loaded_matches, "matches.cbin", {1,2,3}));
+  EXPECT_EQ(2, loaded_matches.size());
+  EXPECT_TRUE(matches.at({1,2}) == loaded_matches.at({1,2}));
+  EXPECT_TRUE(matches.at({2,3}) == loaded_matches.at({2,3}));
+
+  // Same selection from the other formats
+  EXPECT_TRUE(Save(matches, "matches.bin"));
+  PairWiseMatches loaded_bin_matches;
+  EXPECT_TRUE(Load(loaded_bin_matches, "matches.bin", {1,2,3}));
+  EXPECT_TRUE(loaded_matches == loaded_bin_matches);
+
+  // Random access to the pairs
+  PairWiseMatches_Reader reader("matches.cbin");
+  EXPECT_TRUE(reader.good());
+  EXPECT_EQ(4, reader.pairs().size());
+  IndMatches pair_matches;
+  EXPECT_TRUE(reader.read({3,7}, pair_matches));
+  EXPECT_TRUE(matches.at({3,7}) == pair_matches);
+  EXPECT_TRUE(reader.read({0,1}, pair_matches));
+  EXPECT_TRUE(matches.at({0,1}) == pair_matches);
+  EXPECT_FALSE(reader.read({0,7}, pair_matches));
+  EXPECT_TRUE(reader.good());
+
+  // Invalid file
+  EXPECT_TRUE(Save(matches, "matches.txt"));
+  EXPECT_TRUE(std::rename("matches.txt", "matches_invalid.cbin") == 0);
+  EXPECT_FALSE(Load(loaded_matches, "matches_invalid.cbin"));
+}
+
 TEST(IndMatch, DuplicateRemoval_NoRemoval)
 {
   std::vector<IndMatch> vec_indMatch = {
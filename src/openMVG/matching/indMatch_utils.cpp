@@ -14,7 +14,10 @@
 #include "openMVG/system/logger.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <iterator>
 #include <map>
 #include <vector>
@@ -28,6 +31,168 @@
 namespace openMVG {
 namespace matching {
 
+namespace {
+
+// Columnar binary match file (.cbin) layout, all the integers are little endian:
+// - header: magic (8 bytes), pair count (uint64), index offset (uint64),
+// - one chunk per pair: match count, the i_ column, then the j_ column.
+//    The columns store the zigzag encoded delta to the previous value,
+//    all the values are varint encoded,
+// - index: per pair: I (uint32), J (uint32), chunk offset (uint64), chunk size (uint64).
+const char kColumnarMagic[8] = {'O', 'M', 'V', 'G', 'M', 'C', 'B', '1'};
+const uint64_t kColumnarHeaderSize = 24;
+const uint64_t kColumnarIndexEntrySize = 24;
+
+struct Columnar_Chunk
+{
+  uint64_t offset, size;
+};
+
+void PutFixed(const uint64_t value, const int byte_count, std::vector<uint8_t> & buffer)
+{
+  for (int k = 0; k < byte_count; ++k)
+    buffer.push_back(static_cast<uint8_t>(value >> (8 * k)));
+}
+
+uint64_t GetFixed(const uint8_t * data, const int byte_count)
+{
+  uint64_t value = 0;
+  for (int k = 0; k < byte_count; ++k)
+    value |= static_cast<uint64_t>(data[k]) << (8 * k);
+  return value;
+}
+
+void PutVarint(uint64_t value, std::vector<uint8_t> & buffer)
+{
+  while (value >= 0x80)
+  {
+    buffer.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<uint8_t>(value));
+}
+
+bool GetVarint(const uint8_t *& data, const uint8_t * end, uint64_t & value)
+{
+  value = 0;
+  for (int shift = 0; shift < 64 && data != end; shift += 7)
+  {
+    const uint8_t byte = *data++;
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+uint64_t ZigZag(const int64_t value)
+{
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t UnZigZag(const uint64_t value)
+{
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void EncodeColumnarChunk(const IndMatches & pair_matches, std::vector<uint8_t> & buffer)
+{
+  buffer.clear();
+  PutVarint(pair_matches.size(), buffer);
+  int64_t previous = 0;
+  for (const IndMatch & match : pair_matches)
+  {
+    PutVarint(ZigZag(static_cast<int64_t>(match.i_) - previous), buffer);
+    previous = match.i_;
+  }
+  previous = 0;
+  for (const IndMatch & match : pair_matches)
+  {
+    PutVarint(ZigZag(static_cast<int64_t>(match.j_) - previous), buffer);
+    previous = match.j_;
+  }
+}
+
+bool DecodeColumnarChunk(const std::vector<uint8_t> & buffer, IndMatches & pair_matches)
+{
+  const uint8_t * data = buffer.data(), * end = data + buffer.size();
+  uint64_t count;
+  // Each match uses at least two bytes
+  if (!GetVarint(data, end, count) || count > buffer.size() / 2)
+    return false;
+  pair_matches.resize(count);
+  int64_t previous = 0;
+  uint64_t value;
+  for (IndMatch & match : pair_matches)
+  {
+    if (!GetVarint(data, end, value))
+      return false;
+    previous += UnZigZag(value);
+    match.i_ = static_cast<IndexT>(previous);
+  }
+  previous = 0;
+  for (IndMatch & match : pair_matches)
+  {
+    if (!GetVarint(data, end, value))
+      return false;
+    previous += UnZigZag(value);
+    match.j_ = static_cast<IndexT>(previous);
+  }
+  return data == end;
+}
+
+/// Read the header and the pair index of a .cbin file
+bool ReadColumnarIndex(std::ifstream & stream, std::map<Pair, Columnar_Chunk> & chunks)
+{
+  uint8_t header[kColumnarHeaderSize];
+  if (!stream.read(reinterpret_cast<char *>(header), kColumnarHeaderSize) ||
+      std::memcmp(header, kColumnarMagic, sizeof(kColumnarMagic)) != 0)
+    return false;
+  const uint64_t
+    pair_count = GetFixed(header + 8, 8),
+    index_offset = GetFixed(header + 16, 8);
+
+  stream.seekg(0, std::ios::end);
+  const uint64_t file_size = static_cast<uint64_t>(stream.tellg());
+  if (index_offset < kColumnarHeaderSize || index_offset > file_size ||
+      pair_count != (file_size - index_offset) / kColumnarIndexEntrySize ||
+      (file_size - index_offset) % kColumnarIndexEntrySize != 0)
+    return false;
+
+  std::vector<uint8_t> index(pair_count * kColumnarIndexEntrySize);
+  stream.seekg(index_offset);
+  if (!stream.read(reinterpret_cast<char *>(index.data()), index.size()))
+    return false;
+  for (uint64_t k = 0; k < pair_count; ++k)
+  {
+    const uint8_t * entry = index.data() + k * kColumnarIndexEntrySize;
+    const Pair pair(static_cast<IndexT>(GetFixed(entry, 4)), static_cast<IndexT>(GetFixed(entry + 4, 4)));
+    const Columnar_Chunk chunk = {GetFixed(entry + 8, 8), GetFixed(entry + 16, 8)};
+    if (chunk.offset < kColumnarHeaderSize || chunk.offset > index_offset ||
+        chunk.size > index_offset - chunk.offset)
+      return false;
+    chunks.emplace(pair, chunk);
+  }
+  return true;
+}
+
+/// Read and decode the chunk of a pair in a .cbin file
+bool ReadColumnarChunk
+(
+  std::ifstream & stream,
+  const Columnar_Chunk & chunk,
+  std::vector<uint8_t> & buffer,
+  IndMatches & pair_matches
+)
+{
+  buffer.resize(chunk.size);
+  stream.seekg(chunk.offset);
+  return stream.read(reinterpret_cast<char *>(buffer.data()), chunk.size) &&
+    DecodeColumnarChunk(buffer, pair_matches);
+}
+
+} // namespace
+
 bool Load
 (
   PairWiseMatches & matches,
@@ -69,6 +234,11 @@ bool Load
       stream.close();
     }
   }
+  else if (ext == "cbin")
+  {
+    PairWiseMatches_Reader reader(filename);
+    return reader.read(matches);
+  }
   else
   {
     OPENMVG_LOG_ERROR << "Unknown PairWiseMatches file extension: (" << ext << ").";
@@ -82,6 +252,18 @@ bool Load
   return static_cast<bool>(stream);
 }
 
+bool Load
+(
+  PairWiseMatches & matches,
+  const std::string & filename,
+  const std::set<IndexT> & view_ids
+)
+{
+  matches.clear();
+  PairWiseMatches_Reader reader(filename);
+  return reader.read(view_ids, matches);
+}
+
 bool Save
 (
   const PairWiseMatches & matches,
@@ -118,6 +300,13 @@ bool Save
       stream.close();
     }
   }
+  else if (ext == "cbin")
+  {
+    PairWiseMatches_Writer writer(filename);
+    for (const auto & cur_match : matches)
+      writer.insert({cur_match.first, cur_match.second});
+    return writer.close();
+  }
   else
   {
     OPENMVG_LOG_ERROR << "Unknown PairWiseMatches output file extension: " << filename;
@@ -129,5 +318,282 @@ bool Save
   }
   return static_cast<bool>(stream);
 }
+
+struct PairWiseMatches_Writer::Impl
+{
+  std::ofstream stream;
+  std::unique_ptr<cereal::PortableBinaryOutputArchive> archive; // .bin only
+  std::streampos size_tag_position; // .bin only: position of the pair count
+  cereal::size_type written_count = 0;
+  Pair_Set pairs;
+  // .cbin only
+  bool columnar = false;
+  uint64_t columnar_offset = 0; // position of the next chunk
+  std::vector<std::pair<Pair, Columnar_Chunk>> columnar_index;
+  std::vector<uint8_t> buffer;
+};
+
+PairWiseMatches_Writer::PairWiseMatches_Writer
+(
+  const std::string & filename
+): impl_(new Impl)
+{
+  const std::string ext = stlplus::extension_part(filename);
+  if (ext == "txt")
+  {
+    impl_->stream.open(filename);
+  }
+  else if (ext == "bin")
+  {
+    impl_->stream.open(filename.c_str(), std::ios::out | std::ios::binary);
+    if (impl_->stream)
+    {
+      // Same layout as a serialized map, the pair count is updated on close
+      impl_->archive.reset(new cereal::PortableBinaryOutputArchive(impl_->stream));
+      impl_->size_tag_position = impl_->stream.tellp();
+      (*impl_->archive)(cereal::make_size_tag(cereal::size_type(0)));
+    }
+  }
+  else if (ext == "cbin")
+  {
+    impl_->stream.open(filename.c_str(), std::ios::out | std::ios::binary);
+    if (impl_->stream)
+    {
+      // The pair count and the index offset are updated on close
+      impl_->columnar = true;
+      impl_->buffer.assign(kColumnarMagic, kColumnarMagic + sizeof(kColumnarMagic));
+      PutFixed(0, 8, impl_->buffer);
+      PutFixed(0, 8, impl_->buffer);
+      impl_->stream.write(reinterpret_cast<const char *>(impl_->buffer.data()), impl_->buffer.size());
+      impl_->columnar_offset = kColumnarHeaderSize;
+    }
+  }
+  else
+  {
+    OPENMVG_LOG_ERROR << "Unknown PairWiseMatches output file extension: " << filename;
+    impl_->stream.setstate(std::ios::failbit);
+  }
+
+  if (!impl_->stream)
+  {
+    OPENMVG_LOG_ERROR << "Cannot save the matche file: " << filename << ".";
+  }
+}
+
+PairWiseMatches_Writer::~PairWiseMatches_Writer()
+{
+  close();
+}
+
+void PairWiseMatches_Writer::insert
+(
+  std::pair<Pair, IndMatches> && pairWiseMatches
+)
+{
+  if (!impl_->stream.is_open() || !impl_->stream)
+    return;
+
+  const Pair & pair = pairWiseMatches.first;
+  const IndMatches & pair_matches = pairWiseMatches.second;
+  if (impl_->archive)
+  {
+    (*impl_->archive)(cereal::make_map_item(pair, pair_matches));
+  }
+  else if (impl_->columnar)
+  {
+    EncodeColumnarChunk(pair_matches, impl_->buffer);
+    impl_->stream.write(reinterpret_cast<const char *>(impl_->buffer.data()), impl_->buffer.size());
+    impl_->columnar_index.push_back({pair, {impl_->columnar_offset, impl_->buffer.size()}});
+    impl_->columnar_offset += impl_->buffer.size();
+  }
+  else
+  {
+    impl_->stream << pair.first << " " << pair.second << '\n' << pair_matches.size() << '\n';
+    copy(pair_matches.cbegin(), pair_matches.cend(),
+         std::ostream_iterator<IndMatch>(impl_->stream, "\n"));
+  }
+  ++impl_->written_count;
+  impl_->pairs.insert(pair);
+}
+
+bool PairWiseMatches_Writer::close()
+{
+  if (impl_->stream.is_open())
+  {
+    if (impl_->archive && impl_->stream)
+    {
+      impl_->stream.seekp(impl_->size_tag_position);
+      (*impl_->archive)(cereal::make_size_tag(impl_->written_count));
+      impl_->archive.reset();
+    }
+    if (impl_->columnar && impl_->stream)
+    {
+      // Append the pair index and update the header
+      std::vector<uint8_t> & buffer = impl_->buffer;
+      buffer.clear();
+      for (const auto & pair_chunk : impl_->columnar_index)
+      {
+        PutFixed(pair_chunk.first.first, 4, buffer);
+        PutFixed(pair_chunk.first.second, 4, buffer);
+        PutFixed(pair_chunk.second.offset, 8, buffer);
+        PutFixed(pair_chunk.second.size, 8, buffer);
+      }
+      impl_->stream.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+      buffer.clear();
+      PutFixed(impl_->columnar_index.size(), 8, buffer);
+      PutFixed(impl_->columnar_offset, 8, buffer);
+      impl_->stream.seekp(sizeof(kColumnarMagic));
+      impl_->stream.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+      impl_->columnar = false;
+    }
+    impl_->stream.close();
+    return static_cast<bool>(impl_->stream);
+  }
+  return good();
+}
+
+bool PairWiseMatches_Writer::good() const
+{
+  return static_cast<bool>(impl_->stream);
+}
+
+const Pair_Set & PairWiseMatches_Writer::pairs() const
+{
+  return impl_->pairs;
+}
+
+struct PairWiseMatches_Reader::Impl
+{
+  bool ok = false;
+  Pair_Set pairs;
+  // .cbin: the chunks are read on demand
+  std::ifstream stream;
+  std::map<Pair, Columnar_Chunk> chunks;
+  std::vector<uint8_t> buffer;
+  // Other formats: the matches are loaded on opening
+  PairWiseMatches matches;
+
+  bool read_if
+  (
+    const std::function<bool(const Pair &)> & predicate,
+    PairWiseMatches & read_matches
+  )
+  {
+    if (!ok)
+      return false;
+    if (!stream.is_open())
+    {
+      for (const auto & pair_matches : matches)
+        if (predicate(pair_matches.first))
+          read_matches.insert(pair_matches);
+      return true;
+    }
+    // Read the selected chunks in file order
+    std::vector<std::pair<Pair, Columnar_Chunk>> selected_chunks;
+    for (const auto & pair_chunk : chunks)
+      if (predicate(pair_chunk.first))
+        selected_chunks.push_back(pair_chunk);
+    std::sort(selected_chunks.begin(), selected_chunks.end(),
+      [](const std::pair<Pair, Columnar_Chunk> & a, const std::pair<Pair, Columnar_Chunk> & b)
+      {
+        return a.second.offset < b.second.offset;
+      });
+    for (const auto & pair_chunk : selected_chunks)
+    {
+      ok = ReadColumnarChunk(stream, pair_chunk.second, buffer, read_matches[pair_chunk.first]);
+      if (!ok)
+      {
+        OPENMVG_LOG_ERROR << "Cannot read the matches of the pair: "
+          << '(' << pair_chunk.first.first << ',' << pair_chunk.first.second << ')';
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+PairWiseMatches_Reader::PairWiseMatches_Reader
+(
+  const std::string & filename
+): impl_(new Impl)
+{
+  const std::string ext = stlplus::extension_part(filename);
+  if (ext == "cbin")
+  {
+    impl_->stream.open(filename.c_str(), std::ios::in | std::ios::binary);
+    impl_->ok = impl_->stream && ReadColumnarIndex(impl_->stream, impl_->chunks);
+    if (!impl_->ok)
+    {
+      OPENMVG_LOG_ERROR << "Cannot open the matche file: " << filename << ".";
+      impl_->chunks.clear();
+    }
+    for (const auto & pair_chunk : impl_->chunks)
+      impl_->pairs.insert(pair_chunk.first);
+  }
+  else
+  {
+    impl_->ok = Load(impl_->matches, filename);
+    for (const auto & pair_matches : impl_->matches)
+      impl_->pairs.insert(pair_matches.first);
+  }
+}
+
+PairWiseMatches_Reader::~PairWiseMatches_Reader() = default;
+
+bool PairWiseMatches_Reader::good() const
+{
+  return impl_->ok;
+}
+
+const Pair_Set & PairWiseMatches_Reader::pairs() const
+{
+  return impl_->pairs;
+}
+
+bool PairWiseMatches_Reader::read
+(
+  const Pair & pair,
+  IndMatches & pair_matches
+)
+{
+  if (!impl_->ok)
+    return false;
+  if (!impl_->stream.is_open())
+  {
+    const auto it = impl_->matches.find(pair);
+    if (it == impl_->matches.end())
+      return false;
+    pair_matches = it->second;
+    return true;
+  }
+  const auto it = impl_->chunks.find(pair);
+  if (it == impl_->chunks.end())
+    return false;
+  impl_->ok = ReadColumnarChunk(impl_->stream, it->second, impl_->buffer, pair_matches);
+  return impl_->ok;
+}
+
+bool PairWiseMatches_Reader::read
+(
+  const std::set<IndexT> & view_ids,
+  PairWiseMatches & matches
+)
+{
+  return impl_->read_if(
+    [&view_ids](const Pair & pair)
+    {
+      return view_ids.count(pair.first) && view_ids.count(pair.second);
+    },
+    matches);
+}
+
+bool PairWiseMatches_Reader::read
+(
+  PairWiseMatches & matches
+)
+{
+  return impl_->read_if([](const Pair &) { return true; }, matches);
+}
+
 }  // namespace matching
 }  // namespace openMVG
@@ -9,25 +9,102 @@
 #ifndef OPENMVG_MATCHING_IND_MATCH_UTILS_HPP
 #define OPENMVG_MATCHING_IND_MATCH_UTILS_HPP
 
+#include <cstddef>
+#include <memory>
+#include <set>
 #include <string>
+#include <utility>
 
 #include "openMVG/matching/indMatch.hpp"
+#include "openMVG/types.hpp"
 
 namespace openMVG {
 namespace matching {
 
+/// Supported match file formats (selected by the file extension):
+/// - .txt: text,
+/// - .bin: cereal portable binary,
+/// - .cbin: columnar binary. One chunk per pair, with the i_ and j_ columns
+///    stored as varint encoded deltas, and a pair index at the end of the file
+///    that allows to read only some pairs (see PairWiseMatches_Reader).
+
 bool Load
 (
   PairWiseMatches & matches,
   const std::string & filename
 );
 
+/// Load only the pairs that have their two views in view_ids
+/// (for .cbin files the other pairs are not read at all)
+bool Load
+(
+  PairWiseMatches & matches,
+  const std::string & filename,
+  const std::set<IndexT> & view_ids
+);
+
 bool Save
 (
   const PairWiseMatches & matches,
   const std::string & filename
 );
 
+/// Write the pairwise matches to a file (.txt, .bin or .cbin) as soon as they are
+///  inserted, so the whole PairWiseMatches does not need to be kept in memory.
+/// The written file can be read with Load().
+/// Not thread safe: the insert() calls must be serialized.
+class PairWiseMatches_Writer : public PairWiseMatchesContainer
+{
+public:
+  explicit PairWiseMatches_Writer(const std::string & filename);
+  ~PairWiseMatches_Writer() override;
+
+  void insert(std::pair<Pair, IndMatches> && pairWiseMatches) override;
+
+  /// Finalize the file (return false if a write failed)
+  bool close();
+
+  /// Return true if the file is open and all the writes succeeded
+  bool good() const;
+
+  /// The pairs written so far
+  const Pair_Set & pairs() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+/// Read the pairwise matches of a file pair by pair.
+/// For .cbin files only the pair index is loaded on opening, the matches are
+///  read on demand. The other formats are fully loaded on opening.
+/// Not thread safe.
+class PairWiseMatches_Reader
+{
+public:
+  explicit PairWiseMatches_Reader(const std::string & filename);
+  ~PairWiseMatches_Reader();
+
+  /// Return true if the file is open and all the reads succeeded
+  bool good() const;
+
+  /// The pairs stored in the file
+  const Pair_Set & pairs() const;
+
+  /// Read the matches of a pair (return false if the pair cannot be read)
+  bool read(const Pair & pair, IndMatches & pair_matches);
+
+  /// Read the pairs that have their two views in view_ids
+  bool read(const std::set<IndexT> & view_ids, PairWiseMatches & matches);
+
+  /// Read all the pairs
+  bool read(PairWiseMatches & matches);
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 }  // namespace matching
 }  // namespace openMVG
 
@@ -0,0 +1,390 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_MATCHING_MATCHER_BRUTE_FORCE_GEMM_HPP
+#define OPENMVG_MATCHING_MATCHER_BRUTE_FORCE_GEMM_HPP
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "openMVG/numeric/numeric.h"
+#include "openMVG/matching/matching_interface.hpp"
+#include "openMVG/matching/metric.hpp"
+
+namespace openMVG {
+namespace matching {
+
+/**
+ * Exhaustive squared L2 matcher computing the distances by blocks with a
+ *  matrix product: ||q - d||^2 = ||q||^2 + ||d||^2 - 2 q.d
+ * - query and database tiles are sized to stay in cache and the dot products
+ *   are computed by the Eigen GEMM (uint8 descriptors are converted to float
+ *   per tile, the products are exact for descriptors up to 258 dimensions),
+ * - the best candidates of each query are tracked while the tile is scanned,
+ * - the distances of the retained neighbors are recomputed exactly with Metric.
+ *
+ * If MutualCheck is true, the best database candidate of each query is also
+ *  searched in the same pass. A query whose nearest neighbor does not have
+ *  this query as nearest neighbor is reported with the maximal distance
+ *  (it is rejected by the distance ratio test).
+ */
+template < typename Scalar = float, typename Metric = L2<Scalar>, bool MutualCheck = false>
+class ArrayMatcherBruteForceGemm : public ArrayMatcher<Scalar, Metric>
+{
+  public:
+  using DistanceType = typename Metric::ResultType;
+
+  ArrayMatcherBruteForceGemm() = default;
+  virtual ~ArrayMatcherBruteForceGemm() = default;
+
+  /**
+   * Build the matching structure
+   *
+   * \param[in] dataset   Input data.
+   * \param[in] nbRows    The number of component.
+   * \param[in] dimension Length of the data contained in the dataset.
+   *
+   * \return True if success.
+   */
+  bool Build
+  (
+    const Scalar * dataset,
+    int nbRows,
+    int dimension
+  ) override
+  {
+    if (nbRows < 1)
+    {
+      memMapping.reset(nullptr);
+      return false;
+    }
+    memMapping.reset(new Eigen::Map<const BaseMat>(dataset, nbRows, dimension));
+    database_norms_ = memMapping->template cast<ComputeT>().rowwise().squaredNorm();
+    return true;
+  }
+
+  /**
+   * Search the nearest Neighbor of the scalar array query.
+   *
+   * \param[in]   query     The query array.
+   * \param[out]  indice    The indice of array in the dataset that.
+   *  have been computed as the nearest array.
+   * \param[out]  distance  The distance between the two arrays.
+   *
+   * \return True if success.
+   */
+  bool SearchNeighbour
+  (
+    const Scalar * query,
+    int * indice,
+    DistanceType * distance
+  ) override
+  {
+    IndMatches vec_index;
+    std::vector<DistanceType> dist;
+    if (!SearchNeighbours(query, 1, &vec_index, &dist, 1))
+      return false;
+    indice[0] = vec_index[0].j_;
+    distance[0] = dist[0];
+    return true;
+  }
+
+  /**
+   * Search the N nearest Neighbor of the scalar array query.
+   *
+   * \param[in]   query     The query array.
+   * \param[in]   nbQuery   The number of query rows.
+   * \param[out]  indices   The corresponding (query, neighbor) indices.
+   * \param[out]  distances The distances between the matched arrays.
+   * \param[in]  NN        The number of maximal neighbor that will be searched.
+   *
+   * \return True if success.
+   */
+  bool SearchNeighbours
+  (
+    const Scalar * query, int nbQuery,
+    IndMatches * pvec_indices,
+    std::vector<DistanceType> * pvec_distances,
+    size_t NN
+  ) override
+  {
+    if (!memMapping ||
+        NN > static_cast<size_t>(memMapping->rows()) ||
+        NN < 1 ||
+        nbQuery < 1)
+    {
+      return false;
+    }
+
+    const Eigen::Map<const BaseMat> queries(query, nbQuery, memMapping->cols());
+    std::vector<int> neighbors(nbQuery * NN);
+
+    // Split the queries in ranges processed in parallel
+    const int nb_thread = std::max(1, std::min(
+      static_cast<int>(std::thread::hardware_concurrency()),
+      (nbQuery + kQueryBlockSize - 1) / kQueryBlockSize));
+    std::vector<int> range;
+    SplitRange(0, nbQuery, nb_thread, range);
+
+    std::vector<Column_Best> column_bests(range.size() - 1);
+    std::vector<std::future<void>> fut;
+    for (size_t i = 1; i < range.size(); ++i)
+    {
+      fut.push_back(
+        std::async(
+          std::launch::async,
+          &ArrayMatcherBruteForceGemm::SearchNeighbours_func,
+          this,
+          std::cref(queries),
+          range[i-1],
+          range[i],
+          NN,
+          std::ref(neighbors),
+          MutualCheck ? &column_bests[i-1] : nullptr));
+    }
+    for (const auto & fut_it : fut)
+    {
+      fut_it.wait();
+    }
+
+    // Merge the best query of each database row found by each thread
+    std::vector<int> database_best_query;
+    if (MutualCheck)
+    {
+      Column_Best & best = column_bests[0];
+      for (size_t t = 1; t < column_bests.size(); ++t)
+      {
+        for (Eigen::Index j = 0; j < memMapping->rows(); ++j)
+        {
+          // Ranges are ordered: on equal distances the first query is kept
+          if (column_bests[t].distances[j] < best.distances[j])
+          {
+            best.distances[j] = column_bests[t].distances[j];
+            best.queries[j] = column_bests[t].queries[j];
+          }
+        }
+      }
+      database_best_query = std::move(best.queries);
+    }
+
+    // Exact distances of the retained neighbors
+    pvec_indices->resize(nbQuery * NN);
+    pvec_distances->resize(nbQuery * NN);
+    const Metric metric;
+    for (int i = 0; i < nbQuery; ++i)
+    {
+      const bool b_mutual = !MutualCheck
+        || database_best_query[neighbors[i * NN]] == i;
+      for (size_t k = 0; k < NN; ++k)
+      {
+        const int j = neighbors[i * NN + k];
+        (*pvec_indices)[i * NN + k] = IndMatch(i, j);
+        (*pvec_distances)[i * NN + k] = b_mutual
+          ? metric(query + i * memMapping->cols(),
+                   memMapping->data() + j * memMapping->cols(),
+                   memMapping->cols())
+          : std::numeric_limits<DistanceType>::max();
+      }
+      // Keep the neighbors sorted on their exact distance
+      for (size_t k = 1; k < NN; ++k)
+      {
+        for (size_t l = k; l > 0 &&
+          (*pvec_distances)[i * NN + l] < (*pvec_distances)[i * NN + l - 1]; --l)
+        {
+          std::swap((*pvec_distances)[i * NN + l], (*pvec_distances)[i * NN + l - 1]);
+          std::swap((*pvec_indices)[i * NN + l], (*pvec_indices)[i * NN + l - 1]);
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Search the N nearest Neighbor of several query arrays.
+   * With MutualCheck the arrays are searched one by one, since the mutual
+   *  nearest neighbors must be searched in each query array.
+   */
+  bool SearchNeighboursBatch
+  (
+    const std::vector<const Scalar *> & queries,
+    const std::vector<int> & nbQueries,
+    int dimension,
+    std::vector<IndMatches> * pvec_indices,
+    std::vector<std::vector<DistanceType>> * pvec_distances,
+    size_t NN
+  ) override
+  {
+    if (!MutualCheck)
+    {
+      return ArrayMatcher<Scalar, Metric>::SearchNeighboursBatch(
+        queries, nbQueries, dimension, pvec_indices, pvec_distances, NN);
+    }
+    if (queries.size() != nbQueries.size())
+      return false;
+    pvec_indices->resize(queries.size());
+    pvec_distances->resize(queries.size());
+    bool b_found = false;
+    for (size_t k = 0; k < queries.size(); ++k)
+    {
+      (*pvec_indices)[k].clear();
+      (*pvec_distances)[k].clear();
+      if (nbQueries[k] > 0)
+      {
+        b_found |= SearchNeighbours(queries[k], nbQueries[k],
+          &(*pvec_indices)[k], &(*pvec_distances)[k], NN);
+      }
+    }
+    return b_found;
+  }
+
+private:
+  // Descriptors are processed in float (double for double descriptors)
+  using ComputeT = typename std::conditional<
+    std::is_same<Scalar, double>::value, double, float>::type;
+  using BaseMat = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using ComputeMat = Eigen::Matrix<ComputeT, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using ComputeVec = Eigen::Matrix<ComputeT, Eigen::Dynamic, 1>;
+
+  // Tile size: a 128 x 1024 block of distances (512 KB in float)
+  enum { kQueryBlockSize = 128 };
+  enum { kDatabaseBlockSize = 1024 };
+
+  /// Best query (and its approximated distance) of each database row
+  struct Column_Best
+  {
+    std::vector<ComputeT> distances;
+    std::vector<int> queries;
+  };
+
+  /// Use a memory mapping in order to avoid memory re-allocation
+  std::unique_ptr<Eigen::Map<const BaseMat>> memMapping;
+  /// Squared norm of the database rows
+  ComputeVec database_norms_;
+
+  /**
+   * Search the N nearest Neighbor for the [query_start_index, query_stop_index[ range.
+   * \param[out] neighbors the database index of the NN neighbors of each query (updated for the range).
+   * \param[out] column_best the best query of each database row (if not null).
+   */
+  void SearchNeighbours_func
+  (
+    const Eigen::Map<const BaseMat> & queries,
+    int query_start_index,
+    int query_stop_index,
+    size_t NN,
+    std::vector<int> & neighbors,
+    Column_Best * column_best
+  ) const
+  {
+    const Eigen::Index nb_database = memMapping->rows();
+    if (column_best)
+    {
+      column_best->distances.assign(nb_database, std::numeric_limits<ComputeT>::max());
+      column_best->queries.assign(nb_database, -1);
+    }
+
+    ComputeMat query_block, database_block, dot_products;
+    ComputeVec query_norms;
+    std::vector<ComputeT> best_distances(kQueryBlockSize * NN);
+    for (int q0 = query_start_index; q0 < query_stop_index; q0 += kQueryBlockSize)
+    {
+      const int nb_query = std::min<int>(kQueryBlockSize, query_stop_index - q0);
+      query_block = queries.middleRows(q0, nb_query).template cast<ComputeT>();
+      query_norms = query_block.rowwise().squaredNorm();
+      std::fill(best_distances.begin(), best_distances.end(), std::numeric_limits<ComputeT>::max());
+      std::fill(neighbors.begin() + q0 * NN, neighbors.begin() + (q0 + nb_query) * NN, 0);
+
+      for (Eigen::Index d0 = 0; d0 < nb_database; d0 += kDatabaseBlockSize)
+      {
+        const Eigen::Index nb_db = std::min<Eigen::Index>(kDatabaseBlockSize, nb_database - d0);
+        database_block = memMapping->middleRows(d0, nb_db).template cast<ComputeT>();
+        dot_products.noalias() = query_block * database_block.transpose();
+
+        for (int i = 0; i < nb_query; ++i)
+        {
+          const ComputeT * dot = dot_products.data() + i * nb_db;
+          const ComputeT * norms = database_norms_.data() + d0;
+          const ComputeT query_norm = query_norms[i];
+          ComputeT * best = &best_distances[i * NN];
+          int * best_index = &neighbors[(q0 + i) * NN];
+          if (NN <= 2)
+          {
+            // Keep the two best candidates in registers
+            ComputeT best0 = best[0], best1 = NN == 2 ? best[1] : best[0];
+            int index0 = best_index[0], index1 = NN == 2 ? best_index[1] : best_index[0];
+            for (Eigen::Index j = 0; j < nb_db; ++j)
+            {
+              const ComputeT distance = norms[j] - 2 * dot[j];
+              if (distance < best1)
+              {
+                if (distance < best0)
+                {
+                  best1 = best0; index1 = index0;
+                  best0 = distance; index0 = static_cast<int>(d0 + j);
+                }
+                else
+                {
+                  best1 = distance; index1 = static_cast<int>(d0 + j);
+                }
+              }
+            }
+            best[0] = best0; best_index[0] = index0;
+            if (NN == 2)
+            {
+              best[1] = best1; best_index[1] = index1;
+            }
+          }
+          else
+          {
+            // Sorted insertion in the NN best candidates
+            for (Eigen::Index j = 0; j < nb_db; ++j)
+            {
+              const ComputeT distance = norms[j] - 2 * dot[j];
+              if (distance < best[NN - 1])
+              {
+                size_t k = NN - 1;
+                for (; k > 0 && distance < best[k - 1]; --k)
+                {
+                  best[k] = best[k - 1];
+                  best_index[k] = best_index[k - 1];
+                }
+                best[k] = distance;
+                best_index[k] = static_cast<int>(d0 + j);
+              }
+            }
+          }
+
+          if (column_best)
+          {
+            ComputeT * column_distances = column_best->distances.data() + d0;
+            int * column_queries = column_best->queries.data() + d0;
+            for (Eigen::Index j = 0; j < nb_db; ++j)
+            {
+              const ComputeT distance = query_norm + norms[j] - 2 * dot[j];
+              if (distance < column_distances[j])
+              {
+                column_distances[j] = distance;
+                column_queries[j] = q0 + i;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+}  // namespace matching
+}  // namespace openMVG
+
+#endif  // OPENMVG_MATCHING_MATCHER_BRUTE_FORCE_GEMM_HPP
@@ -9,13 +9,19 @@
 #ifndef OPENMVG_MATCHING_MATCHER_HNSW_HPP
 #define OPENMVG_MATCHING_MATCHER_HNSW_HPP
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <memory>
 #ifdef OPENMVG_USE_OPENMP
 #include <omp.h>
 #endif
+#include <stdexcept>
+#include <string>
 #include <typeindex>
 #include <vector>
 
+#include "openMVG/matching/matcher_type.hpp"
 #include "openMVG/matching/matching_interface.hpp"
 #include "openMVG/matching/metric.hpp"
 #include "openMVG/matching/metric_hnsw.hpp"
@@ -40,11 +46,14 @@ class HNSWMatcher: public ArrayMatcher<Scalar, Metric>
 public:
   using DistanceType = typename Metric::ResultType;
 
-  HNSWMatcher() = default;
+  explicit HNSWMatcher(const HNSWParams & params = HNSWParams()): params_(params) {}
   virtual ~HNSWMatcher()= default;
 
   /**
    * Build the matching structure
+   * If an index filename is set in the parameters, the graph saved by a
+   *  previous run is reused if it indexes the same data, else the built
+   *  graph is saved to this file.
    *
    * \param[in] dataset   Input data.
    * \param[in] nbRows    The number of component.
@@ -61,6 +70,7 @@ public:
   {
     HNSW_metric_.reset();
     HNSW_matcher_.reset();
+    b_loaded_ = false;
 
     if (nbRows < 1)
     {
@@ -98,7 +108,13 @@ public:
       return false;
     }
 
-    HNSW_matcher_.reset(new HierarchicalNSW<DistanceType>(HNSW_metric_.get(), nbRows, 16, 100));
+    if (!params_.index_filename.empty() && Load(params_.index_filename, dataset, nbRows))
+    {
+      b_loaded_ = true;
+      return true;
+    }
+
+    HNSW_matcher_.reset(new HierarchicalNSW<DistanceType>(HNSW_metric_.get(), nbRows, params_.M, params_.ef_construction));
 
     // add a first point...
     HNSW_matcher_->addPoint(static_cast<const void *>(dataset), static_cast<size_t>(0));
@@ -110,6 +126,10 @@ public:
         HNSW_matcher_->addPoint(static_cast<const void *>(dataset + dimension * vector_id), static_cast<size_t>(vector_id));
     }
 
+    if (!params_.index_filename.empty() && !Save(params_.index_filename))
+    {
+      OPENMVG_LOG_WARNING << "HNSW matcher: cannot save the index to " << params_.index_filename;
+    }
     return true;
   };
 
@@ -132,7 +152,7 @@ public:
   {
     if (!HNSW_matcher_)
       return false;
-    HNSW_matcher_->setEf(16); //here we stay conservative but it could probably be lowered in this case (first NN)
+    HNSW_matcher_->setEf(params_.ef_search); //here we stay conservative but it could probably be lowered in this case (first NN)
     const auto result = HNSW_matcher_->searchKnn(query, 1).top();
     *indice = result.second;
     *distance =  result.first;
@@ -163,12 +183,12 @@ public:
     // EfSearch parameter could not be < NN.
     // -
     // For vectors with dimensionality of approx. 64-128 and for 2 NNs,
-    // EfSearch = 16 produces good results in conjunction with other parameters fixed in this file (EfConstruct = 16, M = 100).
+    // EfSearch = 16 produces good results in conjunction with the default construction parameters (M = 16, EfConstruct = 100).
     // But nothing has been evaluated on our side for lower / higher dimensionality and for a higher number of NNs.
     // So for now and for NN > 2, EfSearch is fixed to 2 * NNs without a good a priori knowledge.
     // A good value for EfSearch could really depends on the two other parameters (EfConstruct / M).
     if (NN <= 2) {
-      HNSW_matcher_->setEf(16);
+      HNSW_matcher_->setEf(params_.ef_search);
     } else {
       HNSW_matcher_->setEf(std::max(NN*2, static_cast<size_t>(nbQuery)));
     }
@@ -193,7 +213,59 @@ public:
     return true;
   };
 
+  /// Save the graph (with a copy of the indexed data) to a file
+  bool Save(const std::string & filename) const
+  {
+    if (!HNSW_matcher_)
+      return false;
+    HNSW_matcher_->saveIndex(filename);
+    return std::ifstream(filename, std::ios::binary).good();
+  }
+
+  /// Return true if the graph has been loaded from the index file by Build
+  bool loaded() const { return b_loaded_; }
+
 private:
+  /// Load a graph if it has been built with the current parameters from the given data
+  bool Load
+  (
+    const std::string & filename,
+    const Scalar * dataset,
+    int nbRows
+  )
+  {
+    if (!std::ifstream(filename, std::ios::binary).good())
+      return false;
+    std::unique_ptr<HierarchicalNSW<DistanceType>> index;
+    try
+    {
+      index.reset(new HierarchicalNSW<DistanceType>(HNSW_metric_.get(), filename));
+    }
+    catch (const std::exception &)
+    {
+      return false;
+    }
+    const size_t data_size = HNSW_metric_->get_data_size();
+    if (index->cur_element_count != static_cast<size_t>(nbRows)
+        || index->size_data_per_element_ != index->size_links_level0_ + data_size + sizeof(labeltype)
+        || index->M_ != static_cast<size_t>(params_.M)
+        || index->ef_construction_ != static_cast<size_t>(std::max(params_.ef_construction, params_.M)))
+      return false;
+    // Check that the indexed data are the current descriptors
+    for (size_t i = 0; i < index->cur_element_count; ++i)
+    {
+      const labeltype label = index->getExternalLabel(static_cast<tableint>(i));
+      if (label >= static_cast<labeltype>(nbRows)
+          || std::memcmp(index->getDataByInternalId(static_cast<tableint>(i)),
+                         dataset + dimension_ * label, data_size) != 0)
+        return false;
+    }
+    HNSW_matcher_ = std::move(index);
+    return true;
+  }
+
+  HNSWParams params_;
+  bool b_loaded_ = false;
   int dimension_;
   std::unique_ptr<SpaceInterface<DistanceType>> HNSW_metric_;
   std::unique_ptr<HierarchicalNSW<DistanceType>> HNSW_matcher_;
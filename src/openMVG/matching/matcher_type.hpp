@@ -9,6 +9,8 @@
 #ifndef OPENMVG_MATCHING_MATCHER_TYPE_HPP
 #define OPENMVG_MATCHING_MATCHER_TYPE_HPP
 
+#include <string>
+
 namespace openMVG{
 namespace matching{
 
@@ -20,7 +22,18 @@ enum EMatcherType : unsigned char
   HNSW_L2,
   HNSW_L1,
   BRUTE_FORCE_HAMMING,
-  HNSW_HAMMING
+  HNSW_HAMMING,
+  BRUTE_FORCE_L2_GEMM,        // Blocked matrix product brute force
+  BRUTE_FORCE_L2_GEMM_MUTUAL  // idem + mutual nearest neighbor check
+};
+
+/// Parameters of the HNSW matchers (HNSW_L2, HNSW_L1, HNSW_HAMMING)
+struct HNSWParams
+{
+  int M = 16;                 // Number of links per node
+  int ef_construction = 100;  // Size of the candidate list at construction
+  int ef_search = 16;         // Size of the candidate list at search (for 1 or 2 nearest neighbors)
+  std::string index_filename; // If not empty, the graph is loaded from (or saved to) this file
 };
 
 } // namespace matching
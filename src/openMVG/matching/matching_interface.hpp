@@ -9,6 +9,8 @@
 #ifndef OPENMVG_MATCHING_MATCHING_INTERFACE_HPP
 #define OPENMVG_MATCHING_MATCHING_INTERFACE_HPP
 
+#include <algorithm>
+#include <numeric>
 #include <vector>
 
 #include "openMVG/matching/indMatch.hpp"
@@ -68,6 +70,68 @@ class ArrayMatcher
                                   IndMatches * indices,
                                   std::vector<DistanceType> * distances,
                                   size_t NN)=0;
+
+  /**
+   * Search the N nearest Neighbor of several query arrays (i.e. the
+   *  descriptors of several images) with a single search over the index.
+   * The query arrays are concatenated and searched at once, then the results
+   *  are split back per array (query indices are local to each array).
+   *
+   * \param[in]   queries    The query arrays.
+   * \param[in]   nbQueries  The number of rows of each query array.
+   * \param[in]   dimension  Length of a query row.
+   * \param[out]  indices    The (query, neighbor) indices of each query array.
+   * \param[out]  distances  The distances of each query array.
+   * \param[in]   NN         The number of maximal neighbor that will be searched.
+   *
+   * \return True if success.
+   */
+  virtual bool SearchNeighboursBatch( const std::vector<const Scalar *> & queries,
+                                      const std::vector<int> & nbQueries,
+                                      int dimension,
+                                      std::vector<IndMatches> * indices,
+                                      std::vector<std::vector<DistanceType>> * distances,
+                                      size_t NN)
+  {
+    if (queries.size() != nbQueries.size())
+      return false;
+
+    const std::size_t nbQuery = std::accumulate(nbQueries.cbegin(), nbQueries.cend(), std::size_t(0));
+    if (nbQuery < 1)
+      return false;
+
+    // Concatenate the query arrays
+    std::vector<Scalar> all_queries(nbQuery * dimension);
+    std::vector<std::size_t> offsets(1, 0);
+    for (std::size_t k = 0; k < queries.size(); ++k)
+    {
+      std::copy(queries[k], queries[k] + nbQueries[k] * dimension,
+                all_queries.begin() + offsets.back() * dimension);
+      offsets.push_back(offsets.back() + nbQueries[k]);
+    }
+
+    IndMatches all_indices;
+    std::vector<DistanceType> all_distances;
+    if (!SearchNeighbours(all_queries.data(), static_cast<int>(nbQuery),
+                          &all_indices, &all_distances, NN)
+        || all_indices.size() != nbQuery * NN
+        || all_distances.size() != nbQuery * NN)
+      return false;
+
+    // Split the results per query array
+    indices->resize(queries.size());
+    distances->resize(queries.size());
+    for (std::size_t k = 0; k < queries.size(); ++k)
+    {
+      (*indices)[k].assign(all_indices.cbegin() + offsets[k] * NN,
+                           all_indices.cbegin() + offsets[k + 1] * NN);
+      for (auto & match : (*indices)[k])
+        match.i_ -= offsets[k];
+      (*distances)[k].assign(all_distances.cbegin() + offsets[k] * NN,
+                             all_distances.cbegin() + offsets[k + 1] * NN);
+    }
+    return true;
+  }
 };
 
 }  // namespace matching
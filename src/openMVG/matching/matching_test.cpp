@@ -9,7 +9,9 @@
 
 
 #include "openMVG/matching/matcher_brute_force.hpp"
+#include "openMVG/matching/matcher_brute_force_gemm.hpp"
 #include "openMVG/matching/matcher_cascade_hashing.hpp"
+#include "openMVG/matching/cascade_hasher_io.hpp"
 #include "openMVG/matching/matcher_kdtree_flann.hpp"
 #include "openMVG/matching/matcher_hnsw.hpp"
 
@@ -18,7 +20,12 @@
 
 #include "testing/testing.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <random>
 using namespace std;
 
 using namespace openMVG;
@@ -151,8 +158,171 @@ TEST(Matching, ArrayMatcher_Hnsw_Simple__NN)
   EXPECT_EQ(IndMatch(0,4), vec_nIndice[4]);
 }
 
+TEST(Matching, ArrayMatcher_Hnsw_Save_Load)
+{
+  using MatT = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  MatT database = MatT::Random(200, 32);
+  const MatT queries = MatT::Random(20, 32);
+
+  HNSWParams params;
+  params.index_filename = "hnsw_index.hnsw_l2";
+  std::remove(params.index_filename.c_str());
+
+  // First build: the graph is computed and saved
+  HNSWMatcher<float> matcher(params);
+  EXPECT_TRUE(matcher.Build(database.data(), database.rows(), database.cols()));
+  EXPECT_FALSE(matcher.loaded());
+  EXPECT_TRUE(std::ifstream(params.index_filename).good());
+
+  // Second build on the same data: the graph is loaded
+  HNSWMatcher<float> matcher_loaded(params);
+  EXPECT_TRUE(matcher_loaded.Build(database.data(), database.rows(), database.cols()));
+  EXPECT_TRUE(matcher_loaded.loaded());
+
+  IndMatches indices, indices_loaded;
+  std::vector<float> distances, distances_loaded;
+  EXPECT_TRUE(matcher.SearchNeighbours(queries.data(), queries.rows(), &indices, &distances, 2));
+  EXPECT_TRUE(matcher_loaded.SearchNeighbours(queries.data(), queries.rows(),
+    &indices_loaded, &distances_loaded, 2));
+  EXPECT_TRUE(indices == indices_loaded);
+  EXPECT_TRUE(distances == distances_loaded);
+
+  // Other data: the saved graph is rejected and rebuilt
+  database(10, 3) += 1.f;
+  HNSWMatcher<float> matcher_other(params);
+  EXPECT_TRUE(matcher_other.Build(database.data(), database.rows(), database.cols()));
+  EXPECT_FALSE(matcher_other.loaded());
+  std::remove(params.index_filename.c_str());
+}
+
+// Check that the blocked GEMM matcher retrieves the brute force neighbors
+//  (several database and query tiles are used)
+template <typename Scalar>
+bool CheckBruteForceGemm(const size_t NN)
+{
+  using MatT = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  const int dimension = 128, nb_database = 2500, nb_query = 300;
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  MatT database(nb_database, dimension), queries(nb_query, dimension);
+  for (int i = 0; i < database.size(); ++i)
+    database.data()[i] = distribution(gen);
+  for (int i = 0; i < queries.size(); ++i)
+    queries.data()[i] = distribution(gen);
+
+  ArrayMatcherBruteForce<Scalar> reference_matcher;
+  ArrayMatcherBruteForceGemm<Scalar> matcher;
+  IndMatches reference_indices, indices;
+  std::vector<typename L2<Scalar>::ResultType> reference_distances, distances;
+  if (!reference_matcher.Build(database.data(), nb_database, dimension)
+      || !matcher.Build(database.data(), nb_database, dimension)
+      || !reference_matcher.SearchNeighbours(queries.data(), nb_query,
+            &reference_indices, &reference_distances, NN)
+      || !matcher.SearchNeighbours(queries.data(), nb_query, &indices, &distances, NN))
+    return false;
+
+  // Same distances, and the indices must match their distance
+  //  (equidistant neighbors can be retrieved in a different order)
+  if (reference_distances != distances)
+    return false;
+  const L2<Scalar> metric;
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    if (reference_indices[i].i_ != indices[i].i_ ||
+        distances[i] != metric(queries.row(indices[i].i_).data(),
+          database.row(indices[i].j_).data(), dimension))
+      return false;
+  }
+  return true;
+}
+
+TEST(Matching, ArrayMatcherBruteForceGemm_uint8)
+{
+  EXPECT_TRUE(CheckBruteForceGemm<uint8_t>(1));
+  EXPECT_TRUE(CheckBruteForceGemm<uint8_t>(2));
+  EXPECT_TRUE(CheckBruteForceGemm<uint8_t>(5));
+}
+
+TEST(Matching, ArrayMatcherBruteForceGemm_float)
+{
+  EXPECT_TRUE(CheckBruteForceGemm<float>(2));
+  EXPECT_TRUE(CheckBruteForceGemm<float>(5));
+}
+
+TEST(Matching, ArrayMatcherBruteForceGemm_Mutual)
+{
+  const float array[] = {0, 1, 2, 5, 6};
+  ArrayMatcherBruteForceGemm<float, L2<float>, true> matcher;
+  EXPECT_TRUE( matcher.Build(array, 5, 1) );
+
+  // 1.9 and 2.2 have 2 as nearest neighbor, 2 has 1.9 as nearest neighbor
+  // 5.9 and 6 are mutual nearest neighbors
+  const float query[] = {1.9f, 2.2f, 5.9f};
+  IndMatches vec_nIndice;
+  vector<float> vec_fDistance;
+  EXPECT_TRUE( matcher.SearchNeighbours(query, 3, &vec_nIndice, &vec_fDistance, 2) );
+  EXPECT_EQ( 6, vec_nIndice.size());
+  EXPECT_EQ(IndMatch(0,2), vec_nIndice[0]);
+  EXPECT_NEAR( Square(0.1f), vec_fDistance[0], 1e-6);
+  EXPECT_EQ( std::numeric_limits<float>::max(), vec_fDistance[2]);
+  EXPECT_EQ( std::numeric_limits<float>::max(), vec_fDistance[3]);
+  EXPECT_EQ(IndMatch(2,4), vec_nIndice[4]);
+  EXPECT_NEAR( Square(0.1f), vec_fDistance[4], 1e-6);
+}
+
 //-- Test LIMIT case (empty arrays)
 
+// Check that a batched search returns the results of the per array searches
+template <typename MatcherT>
+bool CheckSearchNeighboursBatch(MatcherT & matcher)
+{
+  using MatT = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  const int dimension = 32;
+  const MatT database = MatT::Random(500, dimension);
+  const std::vector<MatT> queries =
+    {MatT::Random(40, dimension), MatT(0, dimension), MatT::Random(7, dimension)};
+
+  if (!matcher.Build(database.data(), database.rows(), dimension))
+    return false;
+
+  std::vector<const float *> query_ptrs;
+  std::vector<int> query_counts;
+  for (const MatT & query : queries)
+  {
+    query_ptrs.push_back(query.data());
+    query_counts.push_back(query.rows());
+  }
+  std::vector<IndMatches> batch_indices;
+  std::vector<std::vector<float>> batch_distances;
+  if (!matcher.SearchNeighboursBatch(query_ptrs, query_counts, dimension,
+                                     &batch_indices, &batch_distances, 2)
+      || batch_indices.size() != queries.size()
+      || batch_distances.size() != queries.size())
+    return false;
+
+  for (size_t k = 0; k < queries.size(); ++k)
+  {
+    IndMatches indices;
+    std::vector<float> distances;
+    if (queries[k].rows() > 0 &&
+        !matcher.SearchNeighbours(queries[k].data(), queries[k].rows(), &indices, &distances, 2))
+      return false;
+    if (indices != batch_indices[k] || distances != batch_distances[k])
+      return false;
+  }
+  return true;
+}
+
+TEST(Matching, ArrayMatcher_SearchNeighboursBatch)
+{
+  ArrayMatcherBruteForce<float> brute_force_matcher;
+  EXPECT_TRUE(CheckSearchNeighboursBatch(brute_force_matcher));
+  ArrayMatcherBruteForceGemm<float, L2<float>, true> gemm_mutual_matcher;
+  EXPECT_TRUE(CheckSearchNeighboursBatch(gemm_mutual_matcher));
+  HNSWMatcher<float> hnsw_matcher;
+  EXPECT_TRUE(CheckSearchNeighboursBatch(hnsw_matcher));
+}
+
 TEST(Matching, ArrayMatcherBruteForce_Simple_EmptyArrays)
 {
   ArrayMatcherBruteForce<float> matcher;
@@ -163,6 +333,16 @@ TEST(Matching, ArrayMatcherBruteForce_Simple_EmptyArrays)
   EXPECT_FALSE( matcher.SearchNeighbour(nullptr, &nIndice, &fDistance) );
 }
 
+TEST(Matching, ArrayMatcherBruteForceGemm_Simple_EmptyArrays)
+{
+  ArrayMatcherBruteForceGemm<float> matcher;
+  EXPECT_FALSE( matcher.Build(nullptr, 0, 4) );
+
+  int nIndice = -1;
+  float fDistance = -1.0f;
+  EXPECT_FALSE( matcher.SearchNeighbour(nullptr, &nIndice, &fDistance) );
+}
+
 TEST(Matching, ArrayMatcher_Kdtree_Flann_Simple_EmptyArrays)
 {
   ArrayMatcher_Kdtree_Flann<float> matcher;
@@ -183,6 +363,87 @@ TEST(Matching, Cascade_Hashing_Simple_EmptyArrays)
   EXPECT_FALSE( matcher.SearchNeighbour(nullptr, &nIndice, &fDistance) );
 }
 
+TEST(Matching, Cascade_Hashing_Save_Load)
+{
+  // Random descriptions
+  Eigen::MatrixXf descriptions = Eigen::MatrixXf::Random(50, 128);
+
+  CascadeHasher cascade_hasher;
+  cascade_hasher.Init(128);
+  const Eigen::VectorXf zero_mean = CascadeHasher::GetZeroMeanDescriptor(descriptions);
+  const HashedDescriptions hashed =
+    cascade_hasher.CreateHashedDescriptions(descriptions, zero_mean);
+
+  const uint64_t hasher_fingerprint =
+    SaveCascadeHasher("cascade_hasher.bin", cascade_hasher, zero_mean);
+  EXPECT_TRUE(hasher_fingerprint != 0);
+  EXPECT_TRUE(SaveHashedDescriptions("hashed.chash", hashed, hasher_fingerprint, 42));
+
+  CascadeHasher cascade_hasher_loaded;
+  Eigen::VectorXf zero_mean_loaded;
+  EXPECT_EQ(hasher_fingerprint,
+    LoadCascadeHasher("cascade_hasher.bin", cascade_hasher_loaded, zero_mean_loaded));
+  EXPECT_MATRIX_NEAR(zero_mean, zero_mean_loaded, 0.0);
+
+  // The saved descriptions are rejected for other descriptors
+  HashedDescriptions hashed_loaded;
+  EXPECT_FALSE(LoadHashedDescriptions("hashed.chash", cascade_hasher_loaded,
+    hasher_fingerprint, 43, hashed_loaded));
+  EXPECT_TRUE(LoadHashedDescriptions("hashed.chash", cascade_hasher_loaded,
+    hasher_fingerprint, 42, hashed_loaded));
+
+  // Loaded data are identical to the data computed with the loaded hasher
+  const HashedDescriptions hashed_recomputed =
+    cascade_hasher_loaded.CreateHashedDescriptions(descriptions, zero_mean_loaded);
+  const auto same_bits = [](const stl::dynamic_bitset & a, const stl::dynamic_bitset & b)
+  {
+    return a.size() == b.size() && std::equal(a.data(), a.data() + a.num_blocks(), b.data());
+  };
+  EXPECT_EQ(hashed.hashed_desc.size(), hashed_loaded.hashed_desc.size());
+  for (size_t i = 0; i < hashed.hashed_desc.size(); ++i)
+  {
+    EXPECT_TRUE(same_bits(hashed.hashed_desc[i].hash_code, hashed_loaded.hashed_desc[i].hash_code));
+    EXPECT_TRUE(same_bits(hashed.hashed_desc[i].hash_code, hashed_recomputed.hashed_desc[i].hash_code));
+    EXPECT_TRUE(hashed.hashed_desc[i].bucket_ids == hashed_loaded.hashed_desc[i].bucket_ids);
+  }
+  EXPECT_TRUE(hashed.buckets == hashed_loaded.buckets);
+
+  // A file announcing more descriptions than it contains is rejected
+  {
+    std::fstream file("hashed.chash", std::ios::in | std::ios::out | std::ios::binary);
+    const uint64_t count = std::numeric_limits<uint64_t>::max() / 4;
+    file.seekp(sizeof(kHashedDescriptionsMagic) + 3 * sizeof(uint32_t) + 2 * sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  }
+  EXPECT_FALSE(LoadHashedDescriptions("hashed.chash", cascade_hasher_loaded,
+    hasher_fingerprint, 42, hashed_loaded));
+}
+
+TEST(Matching, Cascade_Hashing_Batched_Ranking)
+{
+  // The batched candidate ranking must give the same results as the reference implementation
+  using MatrixT = Eigen::Matrix<uint8_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  const MatrixT descriptions1 = (Eigen::MatrixXf::Random(400, 128).array() * 127.f + 128.f).cast<uint8_t>();
+  const MatrixT descriptions2 = (Eigen::MatrixXf::Random(300, 128).array() * 127.f + 128.f).cast<uint8_t>();
+
+  CascadeHasher cascade_hasher;
+  cascade_hasher.Init(128);
+  const Eigen::VectorXf zero_mean = CascadeHasher::GetZeroMeanDescriptor(descriptions1);
+  const HashedDescriptions hashed1 = cascade_hasher.CreateHashedDescriptions(descriptions1, zero_mean);
+  const HashedDescriptions hashed2 = cascade_hasher.CreateHashedDescriptions(descriptions2, zero_mean);
+
+  IndMatches reference_indices, batched_indices;
+  std::vector<int> reference_distances, batched_distances;
+  cascade_hasher.Match_HashedDescriptions_Histogram<MatrixT, int>(
+    hashed2, descriptions2, hashed1, descriptions1, &reference_indices, &reference_distances);
+  cascade_hasher.Match_HashedDescriptions<MatrixT, int>(
+    hashed2, descriptions2, hashed1, descriptions1, &batched_indices, &batched_distances);
+
+  EXPECT_TRUE(!reference_indices.empty());
+  EXPECT_TRUE(reference_indices == batched_indices);
+  EXPECT_TRUE(reference_distances == batched_distances);
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
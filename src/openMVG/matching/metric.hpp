@@ -12,11 +12,75 @@
 #include "openMVG/matching/metric_simd.hpp"
 #include "openMVG/matching/metric_hamming.hpp"
 #include "openMVG/numeric/accumulator_trait.hpp"
+#include <cmath>
 #include <cstdint>
+#include <type_traits>
 
 namespace openMVG {
 namespace matching {
 
+namespace internal {
+
+/// True if Iterator is a raw pointer to T (a contiguous array usable by the SIMD kernels)
+template <typename Iterator, typename T>
+struct is_pointer_to : std::integral_constant<bool,
+  std::is_pointer<Iterator>::value &&
+  std::is_same<typename std::remove_cv<
+    typename std::remove_pointer<Iterator>::type>::type, T>::value>
+{
+};
+
+template <typename ResultType, typename Iterator1, typename Iterator2>
+inline ResultType L2_Loop(Iterator1 a, Iterator2 b, size_t size)
+{
+  ResultType result = ResultType();
+  ResultType diff0, diff1, diff2, diff3;
+  Iterator1 last = a + size;
+  Iterator1 lastgroup = last - 3;
+
+  // Process 4 items for each loop for efficiency.
+  while (a < lastgroup) {
+    diff0 = a[0] - b[0];
+    diff1 = a[1] - b[1];
+    diff2 = a[2] - b[2];
+    diff3 = a[3] - b[3];
+    result += diff0 * diff0 + diff1 * diff1 + diff2 * diff2 + diff3 * diff3;
+    a += 4;
+    b += 4;
+  }
+  // Process last 0-3 elements.  Not needed for standard vector lengths.
+  while (a < last) {
+    diff0 = *a++ - *b++;
+    result += diff0 * diff0;
+  }
+  return result;
+}
+
+template <typename ResultType, typename Iterator1, typename Iterator2>
+inline ResultType L1_Loop(Iterator1 a, Iterator2 b, size_t size)
+{
+  ResultType result = ResultType();
+  Iterator1 last = a + size;
+  Iterator1 lastgroup = last - 3;
+
+  // Process 4 items for each loop for efficiency.
+  while (a < lastgroup) {
+    result += std::abs(a[0] - b[0]);
+    result += std::abs(a[1] - b[1]);
+    result += std::abs(a[2] - b[2]);
+    result += std::abs(a[3] - b[3]);
+    a += 4;
+    b += 4;
+  }
+  // Process last 0-3 elements.  Not needed for standard vector lengths.
+  while (a < last) {
+    result += std::abs(*a++ - *b++);
+  }
+  return result;
+}
+
+} // namespace internal
+
 /// Squared Euclidean distance functor
 template<class T>
 struct L2
@@ -27,31 +91,12 @@ struct L2
   template <typename Iterator1, typename Iterator2>
   inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
   {
-    ResultType result = ResultType();
-    ResultType diff0, diff1, diff2, diff3;
-    Iterator1 last = a + size;
-    Iterator1 lastgroup = last - 3;
-
-    // Process 4 items for each loop for efficiency.
-    while (a < lastgroup) {
-      diff0 = a[0] - b[0];
-      diff1 = a[1] - b[1];
-      diff2 = a[2] - b[2];
-      diff3 = a[3] - b[3];
-      result += diff0 * diff0 + diff1 * diff1 + diff2 * diff2 + diff3 * diff3;
-      a += 4;
-      b += 4;
-    }
-    // Process last 0-3 elements.  Not needed for standard vector lengths.
-    while (a < last) {
-      diff0 = *a++ - *b++;
-      result += diff0 * diff0;
-    }
-    return result;
+    return internal::L2_Loop<ResultType>(a, b, size);
   }
 };
 
 // Template specialization for the uint8_t type
+// (raw memory is processed by the best SIMD kernel of the running CPU)
 template<>
 struct L2<uint8_t>
 {
@@ -61,38 +106,32 @@ struct L2<uint8_t>
   template <typename Iterator1, typename Iterator2>
   inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
   {
-    #ifdef OPENMVG_USE_AVX2
-    if (size == 128)
-    {
-      return L2_AVX2(a, b, size);
-    }
-    #endif
+    return compute(a, b, size, std::integral_constant<bool,
+      internal::is_pointer_to<Iterator1, ElementType>::value &&
+      internal::is_pointer_to<Iterator2, ElementType>::value>());
+  }
 
-    ResultType result = ResultType();
-    ResultType diff0, diff1, diff2, diff3;
-    Iterator1 last = a + size;
-    Iterator1 lastgroup = last - 3;
+private:
+  static inline ResultType compute
+  (
+    const ElementType * a, const ElementType * b, size_t size, std::true_type
+  )
+  {
+    return GetMetricKernels().L2_uint8(a, b, size);
+  }
 
-    // Process 4 items for each loop for efficiency.
-    while (a < lastgroup) {
-      diff0 = a[0] - b[0];
-      diff1 = a[1] - b[1];
-      diff2 = a[2] - b[2];
-      diff3 = a[3] - b[3];
-      result += diff0 * diff0 + diff1 * diff1 + diff2 * diff2 + diff3 * diff3;
-      a += 4;
-      b += 4;
-    }
-    // Process last 0-3 elements.  Not needed for standard vector lengths.
-    while (a < last) {
-      diff0 = *a++ - *b++;
-      result += diff0 * diff0;
-    }
-    return result;
+  template <typename Iterator1, typename Iterator2>
+  static inline ResultType compute
+  (
+    Iterator1 a, Iterator2 b, size_t size, std::false_type
+  )
+  {
+    return internal::L2_Loop<ResultType>(a, b, size);
   }
 };
 
 // Template specialization for the float type
+// (raw memory is processed by the best SIMD kernel of the running CPU)
 template<>
 struct L2<float>
 {
@@ -102,34 +141,27 @@ struct L2<float>
   template <typename Iterator1, typename Iterator2>
   inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
   {
-    #ifdef OPENMVG_USE_AVX
-    if (size > 4 && size % 8)
-    {
-      return L2_AVX(a, b, size);
-    }
-    #endif
+    return compute(a, b, size, std::integral_constant<bool,
+      internal::is_pointer_to<Iterator1, ElementType>::value &&
+      internal::is_pointer_to<Iterator2, ElementType>::value>());
+  }
 
-    ResultType result = ResultType();
-    ResultType diff0, diff1, diff2, diff3;
-    Iterator1 last = a + size;
-    Iterator1 lastgroup = last - 3;
+private:
+  static inline ResultType compute
+  (
+    const ElementType * a, const ElementType * b, size_t size, std::true_type
+  )
+  {
+    return GetMetricKernels().L2_float(a, b, size);
+  }
 
-    // Process 4 items for each loop for efficiency.
-    while (a < lastgroup) {
-      diff0 = a[0] - b[0];
-      diff1 = a[1] - b[1];
-      diff2 = a[2] - b[2];
-      diff3 = a[3] - b[3];
-      result += diff0 * diff0 + diff1 * diff1 + diff2 * diff2 + diff3 * diff3;
-      a += 4;
-      b += 4;
-    }
-    // Process last 0-3 elements.  Not needed for standard vector lengths.
-    while (a < last) {
-      diff0 = *a++ - *b++;
-      result += diff0 * diff0;
-    }
-    return result;
+  template <typename Iterator1, typename Iterator2>
+  static inline ResultType compute
+  (
+    Iterator1 a, Iterator2 b, size_t size, std::false_type
+  )
+  {
+    return internal::L2_Loop<ResultType>(a, b, size);
   }
 };
 
@@ -142,27 +174,12 @@ struct L1
   template <typename Iterator1, typename Iterator2>
   inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
   {
-    ResultType result = ResultType();
-    Iterator1 last = a + size;
-    Iterator1 lastgroup = last - 3;
-
-    // Process 4 items for each loop for efficiency.
-    while (a < lastgroup) {
-      result += std::abs(a[0] - b[0]);
-      result += std::abs(a[1] - b[1]);
-      result += std::abs(a[2] - b[2]);
-      result += std::abs(a[3] - b[3]);
-      a += 4;
-      b += 4;
-    }
-    // Process last 0-3 elements.  Not needed for standard vector lengths.
-    while (a < last) {
-      result += std::abs(*a++ - *b++);
-    }
-    return result;
+    return internal::L1_Loop<ResultType>(a, b, size);
   }
 };
 
+// Template specialization for the uint8_t type
+// (raw memory is processed by the best SIMD kernel of the running CPU)
 template<>
 struct L1<uint8_t>
 {
@@ -172,24 +189,62 @@ struct L1<uint8_t>
   template <typename Iterator1, typename Iterator2>
   inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
   {
-    ResultType result = ResultType();
-    Iterator1 last = a + size;
-    Iterator1 lastgroup = last - 3;
+    return compute(a, b, size, std::integral_constant<bool,
+      internal::is_pointer_to<Iterator1, ElementType>::value &&
+      internal::is_pointer_to<Iterator2, ElementType>::value>());
+  }
 
-    // Process 4 items for each loop for efficiency.
-    while (a < lastgroup) {
-      result += std::abs(a[0] - b[0]);
-      result += std::abs(a[1] - b[1]);
-      result += std::abs(a[2] - b[2]);
-      result += std::abs(a[3] - b[3]);
-      a += 4;
-      b += 4;
-    }
-    // Process last 0-3 elements.  Not needed for standard vector lengths.
-    while (a < last) {
-      result += std::abs(*a++ - *b++);
-    }
-    return result;
+private:
+  static inline ResultType compute
+  (
+    const ElementType * a, const ElementType * b, size_t size, std::true_type
+  )
+  {
+    return GetMetricKernels().L1_uint8(a, b, size);
+  }
+
+  template <typename Iterator1, typename Iterator2>
+  static inline ResultType compute
+  (
+    Iterator1 a, Iterator2 b, size_t size, std::false_type
+  )
+  {
+    return internal::L1_Loop<ResultType>(a, b, size);
+  }
+};
+
+// Template specialization for the float type
+// (raw memory is processed by the best SIMD kernel of the running CPU)
+template<>
+struct L1<float>
+{
+  using ElementType = float;
+  using ResultType = typename Accumulator<ElementType>::Type;
+
+  template <typename Iterator1, typename Iterator2>
+  inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
+  {
+    return compute(a, b, size, std::integral_constant<bool,
+      internal::is_pointer_to<Iterator1, ElementType>::value &&
+      internal::is_pointer_to<Iterator2, ElementType>::value>());
+  }
+
+private:
+  static inline ResultType compute
+  (
+    const ElementType * a, const ElementType * b, size_t size, std::true_type
+  )
+  {
+    return GetMetricKernels().L1_float(a, b, size);
+  }
+
+  template <typename Iterator1, typename Iterator2>
+  static inline ResultType compute
+  (
+    Iterator1 a, Iterator2 b, size_t size, std::false_type
+  )
+  {
+    return internal::L1_Loop<ResultType>(a, b, size);
   }
 };
 
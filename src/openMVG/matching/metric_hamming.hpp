@@ -10,6 +10,7 @@
 #define OPENMVG_MATCHING_METRIC_HAMMING_HPP
 
 #include "openMVG/matching/metric.hpp"
+#include "openMVG/matching/metric_simd.hpp"
 
 #include <bitset>
 #include <cstdint>
@@ -22,7 +23,8 @@
 // Brief:
 // Hamming distance count the number of bits in common between descriptors
 //  by using a XOR operation + a count.
-// For maximal performance SSE4 must be enable for builtin popcount activation.
+// Byte arrays are processed by the SIMD kernels of metric_simd.hpp
+//  (selected at runtime), the other types rely on the builtin popcount.
 
 namespace openMVG {
 namespace matching {
@@ -92,6 +94,12 @@ struct Hamming
   template <typename Iterator1, typename Iterator2>
   inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
   {
+    // Byte arrays are processed by the best SIMD kernel of the running CPU
+    if (sizeof(ElementType) == 1)
+    {
+      return GetMetricKernels().Hamming(
+        reinterpret_cast<const uint8_t*>(a), reinterpret_cast<const uint8_t*>(b), size);
+    }
     if (size % sizeof(uint64_t) == 0)
     {
       const uint64_t* pa = reinterpret_cast<const uint64_t*>(a);
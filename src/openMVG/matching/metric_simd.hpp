@@ -7,18 +7,27 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 /*
-* Define fast AVX2 and SSE distance function mostly taylored for SIFT arrays
+* Define fast SSE, AVX2 and AVX-512 distance functions (L2, L1, Hamming).
+* - The kernels are compiled for their instruction set whatever the build flags
+*   (see OPENMVG_TARGET), so a generic build can use them.
+* - They support any descriptor length.
+* - GetMetricKernels() returns the best kernels supported by the running CPU.
 */
 
 #ifndef OPENMVG_MATCHING_METRIC_SIMD_HPP
 #define OPENMVG_MATCHING_METRIC_SIMD_HPP
 
 #include <array>
+#include <bitset>
+#include <cmath>
+#include <cstring>
 #include <numeric>
 
 #include <cstdint>
 #include <immintrin.h>
 
+#include "openMVG/system/cpu_instruction_set.hpp"
+
 namespace openMVG {
 namespace matching {
 
@@ -28,7 +37,198 @@ namespace matching {
 #define ALIGNED32 __attribute__((aligned(32)))
 #endif
 
-#ifdef OPENMVG_USE_AVX2
+//--
+// Scalar kernels (reference)
+//--
+
+inline int L2_Scalar
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  int result = 0;
+  for (size_t i = 0; i < size; ++i)
+  {
+    const int diff = a[i] - b[i];
+    result += diff * diff;
+  }
+  return result;
+}
+
+inline float L2_Scalar
+(
+  const float * a,
+  const float * b,
+  size_t size
+)
+{
+  float result = 0.f;
+  for (size_t i = 0; i < size; ++i)
+  {
+    const float diff = a[i] - b[i];
+    result += diff * diff;
+  }
+  return result;
+}
+
+inline int L1_Scalar
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  int result = 0;
+  for (size_t i = 0; i < size; ++i)
+    result += std::abs(a[i] - b[i]);
+  return result;
+}
+
+inline float L1_Scalar
+(
+  const float * a,
+  const float * b,
+  size_t size
+)
+{
+  float result = 0.f;
+  for (size_t i = 0; i < size; ++i)
+    result += std::abs(a[i] - b[i]);
+  return result;
+}
+
+inline unsigned int Hamming_Scalar
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  unsigned int result = 0;
+  for (size_t i = 0; i < size; ++i)
+    result += std::bitset<8>(a[i] ^ b[i]).count();
+  return result;
+}
+
+//--
+// SSE4.2 kernels (16 bytes per iteration)
+//--
+
+OPENMVG_TARGET("sse4.2")
+inline int L2_SSE42
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  __m128i acc = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+  {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    // |a - b| without overflow
+    const __m128i d = _mm_sub_epi8(_mm_max_epu8(va, vb), _mm_min_epu8(va, vb));
+    const __m128i dl = _mm_unpacklo_epi8(d, _mm_setzero_si128());
+    const __m128i dh = _mm_unpackhi_epi8(d, _mm_setzero_si128());
+    acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_madd_epi16(dl, dl), _mm_madd_epi16(dh, dh)));
+  }
+  acc = _mm_hadd_epi32(acc, acc);
+  acc = _mm_hadd_epi32(acc, acc);
+  return _mm_cvtsi128_si32(acc) + L2_Scalar(a + i, b + i, size - i);
+}
+
+OPENMVG_TARGET("sse4.2")
+inline float L2_SSE42
+(
+  const float * a,
+  const float * b,
+  size_t size
+)
+{
+  __m128 acc = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+  {
+    const __m128 d = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+    acc = _mm_add_ps(acc, _mm_mul_ps(d, d));
+  }
+  acc = _mm_hadd_ps(acc, acc);
+  acc = _mm_hadd_ps(acc, acc);
+  return _mm_cvtss_f32(acc) + L2_Scalar(a + i, b + i, size - i);
+}
+
+OPENMVG_TARGET("sse4.2")
+inline int L1_SSE42
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  __m128i acc = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+  {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+  }
+  const int result = _mm_cvtsi128_si32(acc) + _mm_extract_epi32(acc, 2);
+  return result + L1_Scalar(a + i, b + i, size - i);
+}
+
+OPENMVG_TARGET("sse4.2")
+inline float L1_SSE42
+(
+  const float * a,
+  const float * b,
+  size_t size
+)
+{
+  const __m128 sign_mask = _mm_set1_ps(-0.f);
+  __m128 acc = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+  {
+    const __m128 d = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+    acc = _mm_add_ps(acc, _mm_andnot_ps(sign_mask, d));
+  }
+  acc = _mm_hadd_ps(acc, acc);
+  acc = _mm_hadd_ps(acc, acc);
+  return _mm_cvtss_f32(acc) + L1_Scalar(a + i, b + i, size - i);
+}
+
+OPENMVG_TARGET("sse4.2,popcnt")
+inline unsigned int Hamming_SSE42
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  uint64_t result = 0;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+  {
+    uint64_t wa, wb;
+    std::memcpy(&wa, a + i, sizeof(wa));
+    std::memcpy(&wb, b + i, sizeof(wb));
+    result += _mm_popcnt_u64(wa ^ wb);
+  }
+  for (; i < size; ++i)
+    result += _mm_popcnt_u32(a[i] ^ b[i]);
+  return static_cast<unsigned int>(result);
+}
+
+//--
+// AVX/AVX2 kernels (32 bytes per iteration)
+//--
+
+OPENMVG_TARGET("avx2")
 inline int L2_AVX2
 (
   const uint8_t * a,
@@ -39,14 +239,16 @@ inline int L2_AVX2
   // Accumulator
   __m256i acc (_mm256_setzero_si256());
 
-  const ALIGNED32 __m256i* ad = reinterpret_cast<const ALIGNED32 __m256i*>(a);
-  const ALIGNED32 __m256i* bd = reinterpret_cast<const ALIGNED32 __m256i*>(b);
-
   // Compute (A-B) * (A-B) on 32 components per iteration
-  for (int i = 0; i < 4; ++i) {
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32)
+  {
+    // Descriptors stored in a contiguous array are not necessary aligned
+    const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
     // In order to avoid overflow, process low and high order value
-    const __m256i min = _mm256_min_epu8(ad[i], bd[i]);
-    const __m256i max = _mm256_max_epu8(ad[i], bd[i]);
+    const __m256i min = _mm256_min_epu8(va, vb);
+    const __m256i max = _mm256_max_epu8(va, vb);
     const __m256i d = _mm256_sub_epi8(max, min);
 
     // Squared elements in range [0,15]
@@ -61,11 +263,11 @@ inline int L2_AVX2
   __m128i l = _mm256_extracti128_si256(acc, 0);
   __m128i h = _mm256_extracti128_si256(acc, 1);
   __m128i r = _mm_hadd_epi32(_mm_add_epi32(h, l), _mm_setzero_si128());
-  return _mm_extract_epi32(r, 0) + _mm_extract_epi32(r, 1);
+  return _mm_extract_epi32(r, 0) + _mm_extract_epi32(r, 1)
+    + L2_Scalar(a + i, b + i, size - i);
 }
-#endif // OPENMVG_USE_AVX2
 
-#ifdef OPENMVG_USE_AVX
+OPENMVG_TARGET("avx")
 inline float L2_AVX
 (
   const float * a,
@@ -76,17 +278,441 @@ inline float L2_AVX
   // Accumulator
   __m256 acc (_mm256_setzero_ps());
 
-  // Compute (A-B) * (A-B) on 16 components per iteration
-  for (int j = 0; j < size; j += 8)
+  // Compute (A-B) * (A-B) on 8 components per iteration
+  size_t j = 0;
+  for (; j + 8 <= size; j += 8)
   {
     const __m256 t0 = _mm256_sub_ps(_mm256_loadu_ps(a + j), _mm256_loadu_ps(b + j));
     acc = _mm256_add_ps(acc, _mm256_mul_ps(t0, t0));
   }
   float ALIGNED32 acc_float[8];
   _mm256_store_ps(acc_float, acc);
-  return std::accumulate(acc_float, acc_float + 8, 0.f);
+  return std::accumulate(acc_float, acc_float + 8, 0.f)
+    + L2_Scalar(a + j, b + j, size - j);
+}
+
+OPENMVG_TARGET("avx2")
+inline int L1_AVX2
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  __m256i acc = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32)
+  {
+    const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+  }
+  const int result = static_cast<int>(
+    _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+    _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3));
+  return result + L1_Scalar(a + i, b + i, size - i);
+}
+
+OPENMVG_TARGET("avx")
+inline float L1_AVX
+(
+  const float * a,
+  const float * b,
+  size_t size
+)
+{
+  const __m256 sign_mask = _mm256_set1_ps(-0.f);
+  __m256 acc = _mm256_setzero_ps();
+  size_t j = 0;
+  for (; j + 8 <= size; j += 8)
+  {
+    const __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + j), _mm256_loadu_ps(b + j));
+    acc = _mm256_add_ps(acc, _mm256_andnot_ps(sign_mask, d));
+  }
+  float ALIGNED32 acc_float[8];
+  _mm256_store_ps(acc_float, acc);
+  return std::accumulate(acc_float, acc_float + 8, 0.f)
+    + L1_Scalar(a + j, b + j, size - j);
+}
+
+// Popcount with a nibble lookup table (vpshufb) and a sum of absolute differences
+OPENMVG_TARGET("avx2,popcnt")
+inline unsigned int Hamming_AVX2
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  const __m256i lookup = _mm256_setr_epi8(
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i acc = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32)
+  {
+    const __m256i x = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+    const __m256i lo = _mm256_and_si256(x, low_mask);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask);
+    const __m256i bytes_count = _mm256_add_epi8(
+      _mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes_count, _mm256_setzero_si256()));
+  }
+  const uint64_t result =
+    _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+    _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+  return static_cast<unsigned int>(result) + Hamming_SSE42(a + i, b + i, size - i);
+}
+
+//--
+// AVX-512 kernels (64 bytes per iteration, the tail is processed with masked loads)
+//--
+
+/// Mask of the n first lanes (n <= 64)
+inline uint64_t AVX512_TailMask(const size_t n)
+{
+  return n >= 64 ? ~uint64_t(0) : ((uint64_t(1) << n) - 1);
+}
+
+OPENMVG_TARGET("avx512f,avx512bw,avx512vnni")
+inline int L2_AVX512VNNI
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  __m512i acc = _mm512_setzero_si512();
+  for (size_t i = 0; i < size; i += 64)
+  {
+    const __mmask64 mask = AVX512_TailMask(size - i);
+    const __m512i va = _mm512_maskz_loadu_epi8(mask, a + i);
+    const __m512i vb = _mm512_maskz_loadu_epi8(mask, b + i);
+    const __m512i d = _mm512_sub_epi8(_mm512_max_epu8(va, vb), _mm512_min_epu8(va, vb));
+    const __m512i dl = _mm512_unpacklo_epi8(d, _mm512_setzero_si512());
+    const __m512i dh = _mm512_unpackhi_epi8(d, _mm512_setzero_si512());
+    // acc += dl * dl + dh * dh (16 bits products accumulated in 32 bits)
+    acc = _mm512_dpwssd_epi32(acc, dl, dl);
+    acc = _mm512_dpwssd_epi32(acc, dh, dh);
+  }
+  return _mm512_reduce_add_epi32(acc);
+}
+
+OPENMVG_TARGET("avx512f")
+inline float L2_AVX512
+(
+  const float * a,
+  const float * b,
+  size_t size
+)
+{
+  __m512 acc = _mm512_setzero_ps();
+  for (size_t i = 0; i < size; i += 16)
+  {
+    const __mmask16 mask = static_cast<__mmask16>(AVX512_TailMask(size - i));
+    const __m512 d = _mm512_sub_ps(
+      _mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+    acc = _mm512_fmadd_ps(d, d, acc);
+  }
+  return _mm512_reduce_add_ps(acc);
+}
+
+OPENMVG_TARGET("avx512f,avx512bw")
+inline int L1_AVX512
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  __m512i acc = _mm512_setzero_si512();
+  for (size_t i = 0; i < size; i += 64)
+  {
+    const __mmask64 mask = AVX512_TailMask(size - i);
+    acc = _mm512_add_epi64(acc, _mm512_sad_epu8(
+      _mm512_maskz_loadu_epi8(mask, a + i), _mm512_maskz_loadu_epi8(mask, b + i)));
+  }
+  return static_cast<int>(_mm512_reduce_add_epi64(acc));
+}
+
+OPENMVG_TARGET("avx512f")
+inline float L1_AVX512
+(
+  const float * a,
+  const float * b,
+  size_t size
+)
+{
+  __m512 acc = _mm512_setzero_ps();
+  for (size_t i = 0; i < size; i += 16)
+  {
+    const __mmask16 mask = static_cast<__mmask16>(AVX512_TailMask(size - i));
+    const __m512 d = _mm512_sub_ps(
+      _mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+    acc = _mm512_add_ps(acc, _mm512_abs_ps(d));
+  }
+  return _mm512_reduce_add_ps(acc);
+}
+
+OPENMVG_TARGET("avx512f,avx512bw,avx512vpopcntdq")
+inline unsigned int Hamming_AVX512
+(
+  const uint8_t * a,
+  const uint8_t * b,
+  size_t size
+)
+{
+  __m512i acc = _mm512_setzero_si512();
+  for (size_t i = 0; i < size; i += 64)
+  {
+    const __mmask64 mask = AVX512_TailMask(size - i);
+    const __m512i x = _mm512_xor_si512(
+      _mm512_maskz_loadu_epi8(mask, a + i), _mm512_maskz_loadu_epi8(mask, b + i));
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+  }
+  return static_cast<unsigned int>(_mm512_reduce_add_epi64(acc));
+}
+
+//--
+// Batched Hamming distances between a query hash code and candidate hash codes.
+// The codes are stored as nb_words 64 bits words, codes[id * nb_words + w].
+// distances[i] = Hamming(query, code of ids[i])
+//--
+
+inline void HammingDistances_Scalar
+(
+  const uint64_t * query,
+  const uint64_t * codes,
+  const int nb_words,
+  const int * ids,
+  const int count,
+  uint16_t * distances
+)
+{
+  for (int i = 0; i < count; ++i)
+  {
+    const uint64_t * code = codes + static_cast<size_t>(ids[i]) * nb_words;
+    size_t distance = 0;
+    for (int w = 0; w < nb_words; ++w)
+      distance += std::bitset<64>(query[w] ^ code[w]).count();
+    distances[i] = static_cast<uint16_t>(distance);
+  }
+}
+
+// Same code, compiled to use the hardware popcount instruction
+OPENMVG_TARGET("popcnt")
+inline void HammingDistances_POPCNT
+(
+  const uint64_t * query,
+  const uint64_t * codes,
+  const int nb_words,
+  const int * ids,
+  const int count,
+  uint16_t * distances
+)
+{
+  for (int i = 0; i < count; ++i)
+  {
+    const uint64_t * code = codes + static_cast<size_t>(ids[i]) * nb_words;
+    uint64_t distance = 0;
+    for (int w = 0; w < nb_words; ++w)
+      distance += _mm_popcnt_u64(query[w] ^ code[w]);
+    distances[i] = static_cast<uint16_t>(distance);
+  }
+}
+
+// 128 bits codes (nb_words == 2): two candidates per register,
+//  popcount with a nibble lookup table (vpshufb) and a sum of absolute differences
+OPENMVG_TARGET("avx2")
+inline void HammingDistances128_AVX2
+(
+  const uint64_t * query,
+  const uint64_t * codes,
+  const int * ids,
+  const int count,
+  uint16_t * distances
+)
+{
+  const __m256i lookup = _mm256_setr_epi8(
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  const __m128i q128 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(query));
+  const __m256i q = _mm256_broadcastsi128_si256(q128);
+
+  int i = 0;
+  for (; i + 1 < count; i += 2)
+  {
+    const __m128i c0 = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(codes + static_cast<size_t>(ids[i]) * 2));
+    const __m128i c1 = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(codes + static_cast<size_t>(ids[i + 1]) * 2));
+    const __m256i x = _mm256_xor_si256(q,
+      _mm256_inserti128_si256(_mm256_castsi128_si256(c0), c1, 1));
+    const __m256i lo = _mm256_and_si256(x, low_mask);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask);
+    const __m256i bytes_count = _mm256_add_epi8(
+      _mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    // 4 partial sums: [c0 w0, c0 w1, c1 w0, c1 w1]
+    const __m256i sums = _mm256_sad_epu8(bytes_count, _mm256_setzero_si256());
+    distances[i] = static_cast<uint16_t>(
+      _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1));
+    distances[i + 1] = static_cast<uint16_t>(
+      _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+  }
+  if (i < count)
+    HammingDistances_POPCNT(query, codes, 2, ids + i, count - i, distances + i);
+}
+
+// 128 bits codes (nb_words == 2): four candidates per register
+OPENMVG_TARGET("avx512f,avx512vpopcntdq")
+inline void HammingDistances128_AVX512
+(
+  const uint64_t * query,
+  const uint64_t * codes,
+  const int * ids,
+  const int count,
+  uint16_t * distances
+)
+{
+  const __m512i q = _mm512_broadcast_i32x4(
+    _mm_loadu_si128(reinterpret_cast<const __m128i*>(query)));
+  // Sum the two words of each candidate: add the odd lanes to the even lanes
+  const __m512i odd_lanes = _mm512_setr_epi64(1, 1, 3, 3, 5, 5, 7, 7);
+
+  int i = 0;
+  for (; i + 3 < count; i += 4)
+  {
+    __m512i c = _mm512_castsi128_si512(_mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(codes + static_cast<size_t>(ids[i]) * 2)));
+    c = _mm512_inserti32x4(c, _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(codes + static_cast<size_t>(ids[i + 1]) * 2)), 1);
+    c = _mm512_inserti32x4(c, _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(codes + static_cast<size_t>(ids[i + 2]) * 2)), 2);
+    c = _mm512_inserti32x4(c, _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(codes + static_cast<size_t>(ids[i + 3]) * 2)), 3);
+    const __m512i bits_count = _mm512_popcnt_epi64(_mm512_xor_si512(q, c));
+    const __m512i sums = _mm512_add_epi64(bits_count,
+      _mm512_permutexvar_epi64(odd_lanes, bits_count));
+    // Sums are in the even lanes
+    const __m256i sums32 = _mm512_cvtepi64_epi32(sums);
+    ALIGNED32 int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums32);
+    distances[i] = static_cast<uint16_t>(lanes[0]);
+    distances[i + 1] = static_cast<uint16_t>(lanes[2]);
+    distances[i + 2] = static_cast<uint16_t>(lanes[4]);
+    distances[i + 3] = static_cast<uint16_t>(lanes[6]);
+  }
+  if (i < count)
+    HammingDistances_POPCNT(query, codes, 2, ids + i, count - i, distances + i);
+}
+
+// Batched Hamming distances using the best kernel supported by the CPU
+inline void HammingDistances
+(
+  const uint64_t * query,
+  const uint64_t * codes,
+  const int nb_words,
+  const int * ids,
+  const int count,
+  uint16_t * distances
+)
+{
+  static const system::CpuInstructionSet cpu_instruction_set;
+  if (nb_words == 2)
+  {
+    if (cpu_instruction_set.supportAVX512VPOPCNTDQ())
+      return HammingDistances128_AVX512(query, codes, ids, count, distances);
+    if (cpu_instruction_set.supportAVX2() && cpu_instruction_set.supportPOPCNT())
+      return HammingDistances128_AVX2(query, codes, ids, count, distances);
+  }
+  if (cpu_instruction_set.supportPOPCNT())
+    return HammingDistances_POPCNT(query, codes, nb_words, ids, count, distances);
+  HammingDistances_Scalar(query, codes, nb_words, ids, count, distances);
+}
+
+//--
+// Runtime selection of the kernels
+//--
+
+/// Instruction set levels of the metric kernels
+enum class EMetricKernelLevel
+{
+  SCALAR,
+  SSE42,  // SSE4.2 + POPCNT
+  AVX2,   // AVX2 + POPCNT
+  AVX512  // AVX-512 F/BW (+ VNNI, VPOPCNTDQ if available)
+};
+
+/// A set of distance kernels
+struct Metric_Kernels
+{
+  EMetricKernelLevel level;
+  int (*L2_uint8)(const uint8_t *, const uint8_t *, size_t);
+  float (*L2_float)(const float *, const float *, size_t);
+  int (*L1_uint8)(const uint8_t *, const uint8_t *, size_t);
+  float (*L1_float)(const float *, const float *, size_t);
+  unsigned int (*Hamming)(const uint8_t *, const uint8_t *, size_t);
+};
+
+/// Return the highest kernel level supported by a CPU
+inline EMetricKernelLevel SupportedMetricKernelLevel
+(
+  const system::CpuInstructionSet & cpu_instruction_set
+)
+{
+  if (cpu_instruction_set.supportAVX512BW() && cpu_instruction_set.supportAVX2()
+      && cpu_instruction_set.supportPOPCNT())
+    return EMetricKernelLevel::AVX512;
+  if (cpu_instruction_set.supportAVX2() && cpu_instruction_set.supportPOPCNT())
+    return EMetricKernelLevel::AVX2;
+  if (cpu_instruction_set.supportSSE42() && cpu_instruction_set.supportPOPCNT())
+    return EMetricKernelLevel::SSE42;
+  return EMetricKernelLevel::SCALAR;
+}
+
+/// Return the kernels of a given level
+/// (the level must be supported by the CPU, see SupportedMetricKernelLevel)
+inline Metric_Kernels MetricKernels
+(
+  const EMetricKernelLevel level,
+  const system::CpuInstructionSet & cpu_instruction_set = system::CpuInstructionSet()
+)
+{
+  using L2_uint8_t = int (*)(const uint8_t *, const uint8_t *, size_t);
+  using L2_float_t = float (*)(const float *, const float *, size_t);
+  switch (level)
+  {
+    case EMetricKernelLevel::AVX512:
+      return {
+        level,
+        cpu_instruction_set.supportAVX512VNNI() ? L2_AVX512VNNI : L2_uint8_t(L2_AVX2),
+        L2_AVX512,
+        L1_AVX512,
+        L1_AVX512,
+        cpu_instruction_set.supportAVX512VPOPCNTDQ() ? Hamming_AVX512 : Hamming_AVX2};
+    case EMetricKernelLevel::AVX2:
+      return {level, L2_AVX2, L2_AVX, L1_AVX2, L1_AVX, Hamming_AVX2};
+    case EMetricKernelLevel::SSE42:
+      return {level, L2_SSE42, L2_float_t(L2_SSE42), L1_SSE42, L1_SSE42, Hamming_SSE42};
+    default:
+      return {level, L2_Scalar, L2_float_t(L2_Scalar), L1_Scalar, L1_Scalar, Hamming_Scalar};
+  }
+}
+
+/// Return the best kernels supported by the running CPU (selected once)
+inline const Metric_Kernels & GetMetricKernels()
+{
+  static const Metric_Kernels kernels = []()
+  {
+    const system::CpuInstructionSet cpu_instruction_set;
+    return MetricKernels(SupportedMetricKernelLevel(cpu_instruction_set), cpu_instruction_set);
+  }();
+  return kernels;
 }
-#endif // OPENMVG_USE_AVX
 
 }  // namespace matching
 }  // namespace openMVG
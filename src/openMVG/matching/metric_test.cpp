@@ -12,7 +12,9 @@
 
 #include "testing/testing.h"
 
+#include <cstdlib>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -139,11 +141,14 @@ TEST(Metric, L2DIM128)
     const unsigned int GTL2 = (a.cast<int>()-b.cast<int>()).squaredNorm();
     const L2<uint8_t> metricL2{};
     EXPECT_EQ(GTL2, metricL2(a.data(), b.data(), 128));
+    openMVG::system::CpuInstructionSet cpu_instruction_set;
     #ifdef OPENMVG_USE_AVX2
-      openMVG::system::CpuInstructionSet cpu_instruction_set;
       EXPECT_TRUE(cpu_instruction_set.supportAVX2());
-      EXPECT_EQ(GTL2, L2_AVX2(a.data(), b.data(), 128));
     #endif
+    if (cpu_instruction_set.supportAVX2())
+    {
+      EXPECT_EQ(GTL2, L2_AVX2(a.data(), b.data(), 128));
+    }
   }
 
   // Test SIFT like descriptor (float)
@@ -162,6 +167,49 @@ TEST(Metric, L2DIM128)
   }
 }
 
+TEST(Metric, HammingDistancesBatch)
+{
+  // 128 bits hash codes
+  const int nb_words = 2, nb_codes = 100, nb_candidates = 37;
+  std::vector<uint64_t> codes(nb_codes * nb_words);
+  for (size_t i = 0; i < codes.size(); ++i)
+    codes[i] = (uint64_t(std::rand()) << 32) ^ uint64_t(std::rand()) ^ (uint64_t(std::rand()) << 50);
+  std::vector<int> ids(nb_candidates);
+  for (int i = 0; i < nb_candidates; ++i)
+    ids[i] = (i * 7) % nb_codes;
+
+  const uint64_t * query = &codes[5 * nb_words];
+  std::vector<uint16_t> gt_distances(nb_candidates), distances(nb_candidates);
+  const Hamming<uint8_t> metricHamming{};
+  for (int i = 0; i < nb_candidates; ++i)
+    gt_distances[i] = metricHamming(
+      reinterpret_cast<const uint8_t*>(query),
+      reinterpret_cast<const uint8_t*>(&codes[ids[i] * nb_words]),
+      nb_words * sizeof(uint64_t));
+
+  HammingDistances_Scalar(query, codes.data(), nb_words, ids.data(), nb_candidates, distances.data());
+  EXPECT_TRUE(gt_distances == distances);
+  HammingDistances(query, codes.data(), nb_words, ids.data(), nb_candidates, distances.data());
+  EXPECT_TRUE(gt_distances == distances);
+
+  const openMVG::system::CpuInstructionSet cpu_instruction_set;
+  if (cpu_instruction_set.supportPOPCNT())
+  {
+    HammingDistances_POPCNT(query, codes.data(), nb_words, ids.data(), nb_candidates, distances.data());
+    EXPECT_TRUE(gt_distances == distances);
+  }
+  if (cpu_instruction_set.supportAVX2() && cpu_instruction_set.supportPOPCNT())
+  {
+    HammingDistances128_AVX2(query, codes.data(), ids.data(), nb_candidates, distances.data());
+    EXPECT_TRUE(gt_distances == distances);
+  }
+  if (cpu_instruction_set.supportAVX512VPOPCNTDQ())
+  {
+    HammingDistances128_AVX512(query, codes.data(), ids.data(), nb_candidates, distances.data());
+    EXPECT_TRUE(gt_distances == distances);
+  }
+}
+
 TEST(Metric, L1DIM128) {
     using VecUC128 = Eigen::Matrix<uint8_t, 128, 1>;
     const VecUC128 a = VecUC128::Random();
@@ -172,6 +220,47 @@ TEST(Metric, L1DIM128) {
 }
 
 
+TEST(Metric, KernelLevels)
+{
+  // Every kernel level supported by the CPU must match the scalar kernels,
+  //  for any descriptor length (SIMD body + tail)
+  const openMVG::system::CpuInstructionSet cpu_instruction_set;
+  const EMetricKernelLevel supported_level = SupportedMetricKernelLevel(cpu_instruction_set);
+  const Metric_Kernels reference = MetricKernels(EMetricKernelLevel::SCALAR);
+  for (const size_t size : {1, 7, 16, 37, 64, 100, 128, 131, 256})
+  {
+    std::vector<uint8_t> a(size), b(size);
+    std::vector<float> fa(size), fb(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+      a[i] = std::rand() % 256;
+      b[i] = std::rand() % 256;
+      fa[i] = std::rand() / float(RAND_MAX) - .5f;
+      fb[i] = std::rand() / float(RAND_MAX) - .5f;
+    }
+    for (const EMetricKernelLevel level :
+      {EMetricKernelLevel::SSE42, EMetricKernelLevel::AVX2, EMetricKernelLevel::AVX512})
+    {
+      if (level > supported_level)
+        continue;
+      const Metric_Kernels kernels = MetricKernels(level, cpu_instruction_set);
+      EXPECT_EQ(reference.L2_uint8(a.data(), b.data(), size), kernels.L2_uint8(a.data(), b.data(), size));
+      EXPECT_EQ(reference.L1_uint8(a.data(), b.data(), size), kernels.L1_uint8(a.data(), b.data(), size));
+      EXPECT_EQ(reference.Hamming(a.data(), b.data(), size), kernels.Hamming(a.data(), b.data(), size));
+      EXPECT_NEAR(reference.L2_float(fa.data(), fb.data(), size), kernels.L2_float(fa.data(), fb.data(), size), 1e-4);
+      EXPECT_NEAR(reference.L1_float(fa.data(), fb.data(), size), kernels.L1_float(fa.data(), fb.data(), size), 1e-4);
+    }
+
+    // The functors dispatch raw memory to the kernels and keep the generic loop for iterators
+    EXPECT_EQ(reference.L2_uint8(a.data(), b.data(), size), L2<uint8_t>()(a.data(), b.data(), size));
+    EXPECT_EQ(reference.L2_uint8(a.data(), b.data(), size), L2<uint8_t>()(a.cbegin(), b.cbegin(), size));
+    EXPECT_EQ(reference.L1_uint8(a.data(), b.data(), size), L1<uint8_t>()(a.data(), b.data(), size));
+    EXPECT_EQ(reference.Hamming(a.data(), b.data(), size), Hamming<uint8_t>()(a.data(), b.data(), size));
+    EXPECT_NEAR(reference.L2_float(fa.data(), fb.data(), size), L2<float>()(fa.cbegin(), fb.cbegin(), size), 1e-4);
+    EXPECT_NEAR(reference.L1_float(fa.data(), fb.data(), size), L1<float>()(fa.data(), fb.data(), size), 1e-4);
+  }
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -8,6 +8,7 @@
 
 #include "openMVG/matching/regions_matcher.hpp"
 #include "openMVG/matching/matcher_brute_force.hpp"
+#include "openMVG/matching/matcher_brute_force_gemm.hpp"
 #include "openMVG/matching/matcher_cascade_hashing.hpp"
 #include "openMVG/matching/matcher_kdtree_flann.hpp"
 #include "openMVG/matching/matcher_hnsw.hpp"
@@ -54,7 +55,8 @@ void DistanceRatioMatch
 std::unique_ptr<RegionsMatcher> RegionMatcherFactory
 (
   matching::EMatcherType eMatcherType,
-  const features::Regions & regions
+  const features::Regions & regions,
+  const HNSWParams & hnsw_params
 )
 {
   // Handle invalid request
@@ -79,6 +81,20 @@ std::unique_ptr<RegionsMatcher> RegionMatcherFactory
           region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true));
         }
         break;
+        case BRUTE_FORCE_L2_GEMM:
+        {
+          using MetricT = L2<unsigned char>;
+          using MatcherT = ArrayMatcherBruteForceGemm<unsigned char, MetricT>;
+          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true));
+        }
+        break;
+        case BRUTE_FORCE_L2_GEMM_MUTUAL:
+        {
+          using MetricT = L2<unsigned char>;
+          using MatcherT = ArrayMatcherBruteForceGemm<unsigned char, MetricT, true>;
+          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true));
+        }
+        break;
         case ANN_L2:
         {
           using MetricT = flann::L2<unsigned char>;
@@ -90,14 +106,14 @@ std::unique_ptr<RegionsMatcher> RegionMatcherFactory
         {
           using MetricT = L2<unsigned char>;
           using MatcherT = HNSWMatcher<unsigned char, MetricT, HNSWMETRIC::L2_HNSW>;
-          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true));
+          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true, hnsw_params));
         }
         break;
         case HNSW_L1: 
         {
           using MetricT = L1<unsigned char>;
           using MatcherT = HNSWMatcher<unsigned char, MetricT, HNSWMETRIC::L1_HNSW>;
-          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, false));
+          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, false, hnsw_params));
         }
         break;
         case CASCADE_HASHING_L2:
@@ -123,6 +139,20 @@ std::unique_ptr<RegionsMatcher> RegionMatcherFactory
           region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true));
         }
         break;
+        case BRUTE_FORCE_L2_GEMM:
+        {
+          using MetricT = L2<float>;
+          using MatcherT = ArrayMatcherBruteForceGemm<float, MetricT>;
+          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true));
+        }
+        break;
+        case BRUTE_FORCE_L2_GEMM_MUTUAL:
+        {
+          using MetricT = L2<float>;
+          using MatcherT = ArrayMatcherBruteForceGemm<float, MetricT, true>;
+          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true));
+        }
+        break;
         case ANN_L2:
         {
           using MetricT = flann::L2<float>;
@@ -134,7 +164,7 @@ std::unique_ptr<RegionsMatcher> RegionMatcherFactory
         {
           using MetricT = L2<float>;
           using MatcherT = HNSWMatcher<float, MetricT, HNSWMETRIC::L2_HNSW>;
-          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true));
+          region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, true, hnsw_params));
         }
         break;
         case CASCADE_HASHING_L2:
@@ -192,7 +222,7 @@ std::unique_ptr<RegionsMatcher> RegionMatcherFactory
       {
         using MetricT = Hamming<unsigned char>;
         using MatcherT = HNSWMatcher<unsigned char, MetricT, HNSWMETRIC::HAMMING_HNSW>;
-        region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, false));
+        region_matcher.reset(new matching::RegionsMatcherT<MatcherT>(regions, false, hnsw_params));
       }
       break;
       default:
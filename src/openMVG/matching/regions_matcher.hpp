@@ -9,6 +9,8 @@
 #ifndef OPENMVG_MATCHING_REGION_MATCHER_HPP
 #define OPENMVG_MATCHING_REGION_MATCHER_HPP
 
+#include <limits>
+#include <utility>
 #include <vector>
 
 #include "openMVG/features/regions.hpp"
@@ -81,19 +83,45 @@ class RegionsMatcher
     const features::Regions & query_regions,
     matching::IndMatches & vec_putative_matches
   ) = 0;
+
+  /**
+   * @brief Match the regions of several images to the database with the
+   *  distance ratio test (see MatchDistanceRatio).
+   * The queries of all the images are searched at once, so the matcher can
+   *  use all the cores even if there is only a few regions per image.
+   * @param[out] vec_putative_matches The matches of each query image.
+   * @return True if some matches are found.
+   */
+  virtual bool MatchDistanceRatioBatch
+  (
+    const float dist_ratio,
+    const std::vector<const features::Regions *> & query_regions,
+    std::vector<matching::IndMatches> & vec_putative_matches
+  )
+  {
+    vec_putative_matches.resize(query_regions.size());
+    bool b_found = false;
+    for (size_t i = 0; i < query_regions.size(); ++i)
+    {
+      b_found |= MatchDistanceRatio(dist_ratio, *query_regions[i], vec_putative_matches[i]);
+    }
+    return b_found;
+  }
 };
 
 /**
  * @brief Create a region matcher according a matcher type and the regions type.
  * @param[in] matcher_type The Matcher type.
  * @param[in] regions The database regions.
+ * @param[in] hnsw_params The parameters of the HNSW matchers.
  * @return The created RegionsMatcher or an empty smart pointer if the a matcher
  * for the region type asked matcher type cannot be created.
  */
 std::unique_ptr<RegionsMatcher> RegionMatcherFactory
 (
   matching::EMatcherType matcher_type,
-  const features::Regions & regions
+  const features::Regions & regions,
+  const HNSWParams & hnsw_params = HNSWParams()
 );
 
 /**
@@ -105,30 +133,34 @@ class RegionsMatcherT : public RegionsMatcher
 {
 private:
   ArrayMatcherT matcher_;
-  const features::Regions * regions_;
+  bool b_database_; // Store if the matcher has been initialized with some regions
   const bool b_squared_metric_; // Store if the metric is squared or not
 public:
   using Scalar = typename ArrayMatcherT::ScalarT;
   using DistanceType = typename ArrayMatcherT::DistanceType;
 
-  RegionsMatcherT(): regions_(nullptr), b_squared_metric_(false) {}
+  RegionsMatcherT(): b_database_(false), b_squared_metric_(false) {}
 
   /**
    * @brief Init the matcher with some reference regions.
+   * @param[in] matcher_args The arguments of the ArrayMatcherT constructor.
    */
+  template <typename... MatcherArgs>
   RegionsMatcherT
   (
     const features::Regions & regions,
-    bool b_squared_metric = false
+    bool b_squared_metric = false,
+    MatcherArgs&&... matcher_args
   ):
-    regions_(&regions),
+    matcher_(std::forward<MatcherArgs>(matcher_args)...),
+    b_database_(true),
     b_squared_metric_(b_squared_metric)
   {
-    if (regions_->RegionCount() == 0)
+    if (regions.RegionCount() == 0)
       return;
 
-    const Scalar * tab = reinterpret_cast<const Scalar *>(regions_->DescriptorRawData());
-    matcher_.Build(tab, regions_->RegionCount(), regions_->DescriptorLength());
+    const Scalar * tab = reinterpret_cast<const Scalar *>(regions.DescriptorRawData());
+    matcher_.Build(tab, regions.RegionCount(), regions.DescriptorLength());
   }
 
   bool Match
@@ -137,7 +169,7 @@ public:
     matching::IndMatches & matches
   ) override
   {
-    if (!regions_)
+    if (!b_database_)
       return false;
 
     const Scalar * queries = reinterpret_cast<const Scalar *>(query_regions.DescriptorRawData());
@@ -148,10 +180,16 @@ public:
     if (!matcher_.SearchNeighbours(queries, query_regions.RegionCount(), &matches, &distances, 1))
       return false;
 
-    for ( auto & match : matches )
+    // Queries without a valid neighbor are reported with the maximal distance
+    //  (i.e. rejected by the mutual nearest neighbor check)
+    size_t valid_count = 0;
+    for (size_t i = 0; i < matches.size(); ++i)
     {
-      std::swap(match.i_, match.j_);
+      if (distances[i] == std::numeric_limits<DistanceType>::max())
+        continue;
+      matches[valid_count++] = {matches[i].j_, matches[i].i_};
     }
+    matches.resize(valid_count);
 
     return (!matches.empty());
   }
@@ -166,7 +204,7 @@ public:
     matching::IndMatches & matches
   ) override
   {
-    if (!regions_)
+    if (!b_database_)
       return false;
 
     const Scalar * queries = reinterpret_cast<const Scalar *>(query_regions.DescriptorRawData());
@@ -183,6 +221,67 @@ public:
                                    number_neighbor))
       return false;
 
+    DistanceRatioFilter(distance_ratio, nn_matches, nn_distances, matches);
+    return (!matches.empty());
+  }
+
+  /**
+   * @brief Match the regions of several images to the database of internal
+   *  regions with a single search.
+   */
+  bool MatchDistanceRatioBatch
+  (
+    const float distance_ratio,
+    const std::vector<const features::Regions *> & query_regions,
+    std::vector<matching::IndMatches> & matches
+  ) override
+  {
+    matches.assign(query_regions.size(), {});
+    if (!b_database_ || query_regions.empty())
+      return false;
+
+    std::vector<const Scalar *> queries;
+    std::vector<int> query_counts;
+    queries.reserve(query_regions.size());
+    query_counts.reserve(query_regions.size());
+    for (const features::Regions * regions : query_regions)
+    {
+      queries.push_back(reinterpret_cast<const Scalar *>(regions->DescriptorRawData()));
+      query_counts.push_back(regions->RegionCount());
+    }
+
+    // Search the 2 closest neighbours for each query descriptor of all the images
+    const size_t number_neighbor = 2;
+    std::vector<matching::IndMatches> nn_matches;
+    std::vector<std::vector<DistanceType>> nn_distances;
+    if (!matcher_.SearchNeighboursBatch(queries,
+                                        query_counts,
+                                        query_regions.front()->DescriptorLength(),
+                                        &nn_matches,
+                                        &nn_distances,
+                                        number_neighbor))
+      return false;
+
+    bool b_found = false;
+    for (size_t i = 0; i < query_regions.size(); ++i)
+    {
+      DistanceRatioFilter(distance_ratio, nn_matches[i], nn_distances[i], matches[i]);
+      b_found |= !matches[i].empty();
+    }
+    return b_found;
+  }
+
+private:
+  /// Keep the (database, query) matches that pass the distance ratio test
+  void DistanceRatioFilter
+  (
+    const float distance_ratio,
+    const matching::IndMatches & nn_matches,
+    const std::vector<DistanceType> & nn_distances,
+    matching::IndMatches & matches
+  ) const
+  {
+    const size_t number_neighbor = 2;
     std::vector<int> nn_ratio_indexes;
     // Filter the matches using a distance ratio test:
     //   The probability that a match is correct is determined by taking
@@ -202,8 +301,6 @@ public:
       matches.emplace_back(nn_matches[index * number_neighbor].j_,
                            nn_matches[index * number_neighbor].i_);
     }
-
-    return (!matches.empty());
   }
 };
 
@@ -7,8 +7,11 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include "openMVG/matching_image_collection/Cascade_Hashing_Matcher_Regions.hpp"
+#include "openMVG/matching_image_collection/Matches_Buffer.hpp"
+#include "openMVG/matching_image_collection/Pair_Scheduler.hpp"
 
 #include "openMVG/matching/cascade_hasher.hpp"
+#include "openMVG/matching/cascade_hasher_io.hpp"
 #include "openMVG/features/feature.hpp"
 #include "openMVG/matching/matching_filters.hpp"
 #include "openMVG/matching/indMatchDecoratorXY.hpp"
@@ -17,6 +20,11 @@
 #include "openMVG/system/progressinterface.hpp"
 #include "openMVG/types.hpp"
 
+#include "third_party/stlplus3/filesystemSimplified/file_system.hpp"
+
+#include <cstring>
+#include <map>
+#include <set>
 
 namespace openMVG {
 namespace matching_image_collection {
@@ -27,56 +35,106 @@ using namespace openMVG::features;
 Cascade_Hashing_Matcher_Regions
 ::Cascade_Hashing_Matcher_Regions
 (
-  float distRatio
-):Matcher(), f_dist_ratio_(distRatio)
+  float distRatio,
+  bool cache_hashes
+):Matcher(), f_dist_ratio_(distRatio), b_cache_hashes_(cache_hashes)
 {
 }
 
 namespace impl
 {
+/// Maximal number of views of a block of pairs matched together when the
+///  regions provider does not limit the number of views.
+static const std::size_t kHashedViewsPerBlock = 256;
+
+/// Key identifying the regions files of a view (0 if there is none).
+/// It is built from the size and modification date of the files, so checking
+///  that cached data still match the regions does not require to read them.
+inline uint64_t RegionsFilesKey
+(
+  const std::string & feat_directory,
+  const std::string & basename,
+  const std::size_t dimension
+)
+{
+  uint64_t key = FingerprintBytes(&dimension, sizeof(dimension));
+  bool found = false;
+  for (const char * extension : {"regions", "feat", "desc"})
+  {
+    const std::string filename =
+      stlplus::create_filespec(feat_directory, basename, extension);
+    if (!stlplus::is_file(filename))
+      continue;
+    found = true;
+    const uint64_t size = stlplus::file_size(filename);
+    const int64_t modified = stlplus::file_modified(filename);
+    key = FingerprintBytes(extension, std::strlen(extension), key);
+    key = FingerprintBytes(&size, sizeof(size), key);
+    key = FingerprintBytes(&modified, sizeof(modified), key);
+  }
+  return (found && key != 0) ? key : 0;
+}
+
 template <typename ScalarT>
 void Match
 (
   const sfm::Regions_Provider & regions_provider,
   const Pair_Set & pairs,
   float fDistRatio,
+  bool bCacheHashes,
   PairWiseMatchesContainer & map_PutativeMatches, // the pairwise photometric corresponding points
   system::ProgressInterface * my_progress_bar
 )
 {
   if (!my_progress_bar)
     my_progress_bar = &system::ProgressInterface::dummy();
-  my_progress_bar->Restart(pairs.size(), "- Matching -");
 
   // Collect used view indexes
   std::set<IndexT> used_index;
-  // Sort pairs according the first index to minimize later memory swapping
-  using Map_vectorT = std::map<IndexT, std::vector<IndexT>>;
-  Map_vectorT map_Pairs;
   for (const auto & pair_idx : pairs)
   {
-    map_Pairs[pair_idx.first].push_back(pair_idx.second);
     used_index.insert(pair_idx.first);
     used_index.insert(pair_idx.second);
   }
+  // Group pairs according the first index and order the groups to minimize
+  //  later memory swapping
+  const Pair_Schedule schedule = SchedulePairs(pairs, regions_provider.view_capacity());
 
   using BaseMat = Eigen::Matrix<ScalarT, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 
   // Init the cascade hasher
   CascadeHasher cascade_hasher;
+  size_t dimension = 0;
   if (!used_index.empty())
   {
     const IndexT I = *used_index.begin();
     const std::shared_ptr<features::Regions> regionsI = regions_provider.get(I);
-    const size_t dimension = regionsI->DescriptorLength();
-    cascade_hasher.Init(dimension);
+    dimension = regionsI->DescriptorLength();
   }
 
-  std::map<IndexT, HashedDescriptions> hashed_base_;
+  // Hashing data saved by a previous run are stored in the regions directory
+  const std::string & feat_directory = regions_provider.feat_directory();
+  bCacheHashes = bCacheHashes && !feat_directory.empty();
+  const std::string sHasherFilename =
+    stlplus::create_filespec(feat_directory, "cascade_hasher", "bin");
+  uint64_t hasher_fingerprint = 0;
 
-  // Compute the zero mean descriptor that will be used for hashing (one for all the image regions)
+  // Reuse the hasher and the zero mean descriptor of a previous run:
+  //  the hashed descriptions computed by this run stay valid.
   Eigen::VectorXf zero_mean_descriptor;
+  if (bCacheHashes && stlplus::file_exists(sHasherFilename))
+  {
+    hasher_fingerprint =
+      LoadCascadeHasher(sHasherFilename, cascade_hasher, zero_mean_descriptor);
+    if (hasher_fingerprint != 0 && static_cast<size_t>(cascade_hasher.NbHashCode()) != dimension)
+      hasher_fingerprint = 0;
+  }
+
+  if (hasher_fingerprint == 0)
   {
+    cascade_hasher.Init(dimension);
+
+    // Compute the zero mean descriptor that will be used for hashing (one for all the image regions)
     Eigen::MatrixXf matForZeroMean;
     for (int i =0; i < used_index.size(); ++i)
     {
@@ -99,70 +157,183 @@ void Match
       }
     }
     zero_mean_descriptor = CascadeHasher::GetZeroMeanDescriptor(matForZeroMean);
+
+    if (bCacheHashes && !used_index.empty())
+    {
+      hasher_fingerprint =
+        SaveCascadeHasher(sHasherFilename, cascade_hasher, zero_mean_descriptor);
+      if (hasher_fingerprint == 0)
+      {
+        OPENMVG_LOG_WARNING << "Cannot save the cascade hasher: " << sHasherFilename;
+      }
+    }
   }
+  bCacheHashes = bCacheHashes && hasher_fingerprint != 0;
 
-  // Index the input regions
-#ifdef OPENMVG_USE_OPENMP
-  #pragma omp parallel for schedule(dynamic)
-#endif
-  for (int i =0; i < used_index.size(); ++i)
+  // Return the hashed descriptions of a view: reuse its sidecar file if it is
+  //  still valid, else hash its descriptors (and update the sidecar file).
+  const auto hash_view = [&](const IndexT I, bool & bReused)
   {
-    std::set<IndexT>::const_iterator iter = used_index.begin();
-    std::advance(iter, i);
-    const IndexT I = *iter;
+    bReused = false;
     const std::shared_ptr<features::Regions> regionsI = regions_provider.get(I);
     const ScalarT * tabI =
       reinterpret_cast<const ScalarT*>(regionsI->DescriptorRawData());
     const size_t dimension = regionsI->DescriptorLength();
-
     Eigen::Map<BaseMat> mat_I( (ScalarT*)tabI, regionsI->RegionCount(), dimension);
-#ifdef OPENMVG_USE_OPENMP
-    #pragma omp critical
-#endif
+
+    HashedDescriptions view_hashes;
+    const std::string basename = regions_provider.basename(I);
+    const uint64_t regions_key =
+      (bCacheHashes && !basename.empty())
+      ? RegionsFilesKey(feat_directory, basename, dimension) : 0;
+    if (regions_key == 0)
+      return cascade_hasher.CreateHashedDescriptions(mat_I, zero_mean_descriptor);
+
+    const std::string sHashFilename =
+      stlplus::create_filespec(feat_directory, basename, "chash");
+    bReused = LoadHashedDescriptions(sHashFilename, cascade_hasher,
+      hasher_fingerprint, regions_key, view_hashes);
+    if (!bReused)
+    {
+      view_hashes =
+        cascade_hasher.CreateHashedDescriptions(mat_I, zero_mean_descriptor);
+      if (!SaveHashedDescriptions(sHashFilename, view_hashes,
+            hasher_fingerprint, regions_key))
+      {
+        OPENMVG_LOG_WARNING << "Cannot save the hashed descriptions: " << sHashFilename;
+      }
+    }
+    return view_hashes;
+  };
+
+  // Split the schedule in blocks of consecutive groups using a bounded number
+  //  of views. The hashed descriptions of a view are computed (or loaded) once,
+  //  for the first block using it, and released after the last one.
+  const std::size_t block_view_count =
+    regions_provider.view_capacity() > 0
+    ? regions_provider.view_capacity() : kHashedViewsPerBlock;
+  std::vector<std::size_t> block_starts(1, 0);
+  {
+    std::set<IndexT> block_views;
+    for (std::size_t group_id = 0; group_id < schedule.size(); ++group_id)
+    {
+      std::set<IndexT> group_views(schedule[group_id].second.cbegin(),
+                                   schedule[group_id].second.cend());
+      group_views.insert(schedule[group_id].first);
+      std::size_t new_view_count = 0;
+      for (const IndexT view_id : group_views)
+        new_view_count += block_views.count(view_id) == 0;
+      if (!block_views.empty()
+          && block_views.size() + new_view_count > block_view_count)
+      {
+        block_starts.push_back(group_id);
+        block_views.clear();
+      }
+      block_views.insert(group_views.cbegin(), group_views.cend());
+    }
+    block_starts.push_back(schedule.size());
+  }
+  std::map<IndexT, std::size_t> last_block; // last block using each view
+  for (std::size_t block_id = 0; block_id + 1 < block_starts.size(); ++block_id)
+  {
+    for (std::size_t group_id = block_starts[block_id];
+         group_id < block_starts[block_id + 1]; ++group_id)
     {
-      hashed_base_[I] =
-        std::move(cascade_hasher.CreateHashedDescriptions(mat_I, zero_mean_descriptor));
+      last_block[schedule[group_id].first] = block_id;
+      for (const IndexT J : schedule[group_id].second)
+        last_block[J] = block_id;
     }
   }
 
   // Perform matching between all the pairs
-  for (const auto & pair_it : map_Pairs)
+  my_progress_bar->Restart(pairs.size(), "- Matching -");
+  Matches_Buffer matches_buffer;
+  std::map<IndexT, HashedDescriptions> hashed_descriptions;
+  int hashed_count = 0, reused_count = 0;
+  for (std::size_t block_id = 0; block_id + 1 < block_starts.size(); ++block_id)
   {
     if (my_progress_bar->hasBeenCanceled())
       break;
-    const IndexT I = pair_it.first;
-    const std::vector<IndexT> & indexToCompare = pair_it.second;
 
-    const std::shared_ptr<features::Regions> regionsI = regions_provider.get(I);
-    if (regionsI->RegionCount() == 0)
+    // Flatten the groups of the block in a list of pair tasks, so the threads
+    //  share the work over all the pairs (and not only over the pairs of a group)
+    std::vector<Pair> pair_tasks;
+    std::vector<int> task_group; // index of the schedule group of each task
+    std::set<IndexT> block_views;
+    for (int group_id = static_cast<int>(block_starts[block_id]);
+         group_id < static_cast<int>(block_starts[block_id + 1]); ++group_id)
     {
-      (*my_progress_bar) += indexToCompare.size();
-      continue;
+      block_views.insert(schedule[group_id].first);
+      for (const IndexT J : schedule[group_id].second)
+      {
+        pair_tasks.emplace_back(schedule[group_id].first, J);
+        task_group.push_back(group_id);
+        block_views.insert(J);
+      }
     }
 
-    const std::vector<features::PointFeature> pointFeaturesI = regionsI->GetRegionsPositions();
-    const ScalarT * tabI =
-      reinterpret_cast<const ScalarT*>(regionsI->DescriptorRawData());
-    const size_t dimension = regionsI->DescriptorLength();
-    Eigen::Map<BaseMat> mat_I( (ScalarT*)tabI, regionsI->RegionCount(), dimension);
+    // Release the hashed descriptions of the views that are no longer used,
+    //  and create the entries of the new ones
+    // (the map entries are created first, so the threads fill distinct entries)
+    for (auto it = hashed_descriptions.begin(); it != hashed_descriptions.end();)
+    {
+      if (last_block.at(it->first) < block_id)
+        it = hashed_descriptions.erase(it);
+      else
+        ++it;
+    }
+    std::vector<std::pair<IndexT, HashedDescriptions*>> hashed_entries;
+    for (const IndexT I : block_views)
+    {
+      if (hashed_descriptions.count(I) == 0)
+        hashed_entries.emplace_back(I, &hashed_descriptions[I]);
+    }
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic) reduction(+:reused_count)
+#endif
+    for (int i = 0; i < static_cast<int>(hashed_entries.size()); ++i)
+    {
+      bool bReused = false;
+      *hashed_entries[i].second = hash_view(hashed_entries[i].first, bReused);
+      if (bReused)
+        ++reused_count;
+    }
+    hashed_count += static_cast<int>(hashed_entries.size());
 
 #ifdef OPENMVG_USE_OPENMP
     #pragma omp parallel for schedule(dynamic)
 #endif
-    for (int j = 0; j < (int)indexToCompare.size(); ++j)
+    for (int task_id = 0; task_id < static_cast<int>(pair_tasks.size()); ++task_id)
     {
       if (my_progress_bar->hasBeenCanceled())
         continue;
-      const size_t J = indexToCompare[j];
-      const std::shared_ptr<features::Regions> regionsJ = regions_provider.get(J);
+      const IndexT I = pair_tasks[task_id].first;
+      const IndexT J = pair_tasks[task_id].second;
 
-      if (regionsI->Type_id() != regionsJ->Type_id())
+      // Let the regions provider load the views of the next group in advance
+      const int group_id = task_group[task_id];
+      const bool is_group_start = task_id == 0 || task_group[task_id - 1] != group_id;
+      if (is_group_start && group_id + 1 < static_cast<int>(schedule.size()))
+      {
+        const Pair_Group & next_group = schedule[group_id + 1];
+        std::vector<IndexT> next_views(1, next_group.first);
+        next_views.insert(next_views.end(), next_group.second.cbegin(), next_group.second.cend());
+        regions_provider.prefetch(next_views);
+      }
+
+      const std::shared_ptr<features::Regions> regionsI = regions_provider.get(I);
+      const std::shared_ptr<features::Regions> regionsJ = regions_provider.get(J);
+      if (regionsI->RegionCount() == 0
+          || regionsI->Type_id() != regionsJ->Type_id())
       {
         ++(*my_progress_bar);
         continue;
       }
 
       // Matrix representation of the query input data;
+      const size_t dimension = regionsI->DescriptorLength();
+      const ScalarT * tabI = reinterpret_cast<const ScalarT*>(regionsI->DescriptorRawData());
+      Eigen::Map<BaseMat> mat_I( (ScalarT*)tabI, regionsI->RegionCount(), dimension);
       const ScalarT * tabJ = reinterpret_cast<const ScalarT*>(regionsJ->DescriptorRawData());
       Eigen::Map<BaseMat> mat_J( (ScalarT*)tabJ, regionsJ->RegionCount(), dimension);
 
@@ -174,8 +345,8 @@ void Match
 
       // Match the query descriptors to the database
       cascade_hasher.Match_HashedDescriptions<BaseMat, ResultType>(
-        hashed_base_[J], mat_J,
-        hashed_base_[I], mat_I,
+        hashed_descriptions.at(J), mat_J,
+        hashed_descriptions.at(I), mat_I,
         &pvec_indices, &pvec_distances);
 
       std::vector<int> vec_nn_ratio_idx;
@@ -202,27 +373,31 @@ void Match
       matching::IndMatch::getDeduplicated(vec_putative_matches);
 
       // Remove matches that have the same (X,Y) coordinates
+      const std::vector<features::PointFeature> pointFeaturesI = regionsI->GetRegionsPositions();
       const std::vector<features::PointFeature> pointFeaturesJ = regionsJ->GetRegionsPositions();
       matching::IndMatchDecorator<float> matchDeduplicator(vec_putative_matches,
         pointFeaturesI, pointFeaturesJ);
       matchDeduplicator.getDeduplicated(vec_putative_matches);
 
-#ifdef OPENMVG_USE_OPENMP
-#pragma omp critical
-#endif
+      if (!vec_putative_matches.empty())
       {
-        if (!vec_putative_matches.empty())
-        {
-          map_PutativeMatches.insert(
-            {
-              {I,J},
-              std::move(vec_putative_matches)
-            });
-        }
+        matches_buffer.push({I,J}, std::move(vec_putative_matches));
       }
+      my_progress_bar->AddWork(
+        static_cast<uint64_t>(regionsI->RegionCount()) * regionsJ->RegionCount());
       ++(*my_progress_bar);
     }
   }
+  matches_buffer.merge(map_PutativeMatches);
+  if (bCacheHashes)
+  {
+    OPENMVG_LOG_INFO << "Cascade hashing: reused " << reused_count << "/"
+      << hashed_count << " hashed descriptions.";
+  }
+
+  OPENMVG_LOG_INFO << "Matching throughput: "
+    << my_progress_bar->StepsPerSecond() << " pairs/s, "
+    << my_progress_bar->WorkPerSecond() << " descriptor pairs/s";
 }
 } // namespace impl
 
@@ -249,6 +424,7 @@ void Cascade_Hashing_Matcher_Regions::Match
       *regions_provider.get(),
       pairs,
       f_dist_ratio_,
+      b_cache_hashes_,
       map_PutativeMatches,
       my_progress_bar);
   }
@@ -259,6 +435,7 @@ void Cascade_Hashing_Matcher_Regions::Match
       *regions_provider.get(),
       pairs,
       f_dist_ratio_,
+      b_cache_hashes_,
       map_PutativeMatches,
       my_progress_bar);
   }
@@ -25,13 +25,19 @@ namespace matching_image_collection {
 ///  a threshold over the distance ratio of the 2 nearest neighbours.
 /// Using a Cascade Hashing matching
 /// Cascade hashing tables are computed once and used for all the regions.
+/// The hashed descriptions of a view are computed once, when its first pair is
+///  matched, and released after its last pair.
+/// If cache_hashes is enabled, the hasher and the hashed descriptions are saved
+///  next to the regions files and reused by the next runs (only the new or
+///  modified regions - according their files size and date - are hashed).
 ///
 class Cascade_Hashing_Matcher_Regions : public Matcher
 {
   public:
   explicit Cascade_Hashing_Matcher_Regions
   (
-    float dist_ratio
+    float dist_ratio,
+    bool cache_hashes = false
   );
 
   /// Find corresponding points between some pair of view Ids
@@ -45,6 +51,8 @@ class Cascade_Hashing_Matcher_Regions : public Matcher
   private:
   // Distance ratio used to discard spurious correspondence
   float f_dist_ratio_;
+  // Save/reuse the hashed descriptions in the regions directory
+  bool b_cache_hashes_;
 };
 
 } // namespace matching_image_collection
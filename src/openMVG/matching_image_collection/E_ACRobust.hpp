@@ -41,10 +41,14 @@ struct GeometricFilter_EMatrix_AC
   GeometricFilter_EMatrix_AC
   (
     double dPrecision = std::numeric_limits<double>::infinity(),
-    uint32_t iteration = 1024
+    uint32_t iteration = 1024,
+    const robust::ACRANSAC_Options & acransac_options = robust::ACRANSAC_Options(),
+    bool b_prosac = false
   ):
     m_dPrecision(dPrecision),
     m_stIteration(iteration),
+    m_acransac_options(acransac_options),
+    m_b_prosac(b_prosac),
     m_E(Mat3::Identity()),
     m_dPrecision_robust(std::numeric_limits<double>::infinity())
   {
@@ -103,6 +107,9 @@ struct GeometricFilter_EMatrix_AC
 
     Mat2X xI,xJ;
     MatchesPairToMat(pairIndex, vec_PutativeMatches, sfm_data, regions_provider, xI, xJ);
+    Mat3X xI_bearing_vector, xJ_bearing_vector;
+    MatchesPairToBearingVectors(pairIndex, vec_PutativeMatches, sfm_data, regions_provider,
+      xI, xJ, xI_bearing_vector, xJ_bearing_vector);
 
     //--
     // Robust estimation
@@ -120,17 +127,21 @@ struct GeometricFilter_EMatrix_AC
       * ptrPinhole_J = dynamic_cast<const cameras::Pinhole_Intrinsic*>(cam_J);
 
     KernelType kernel(
-      xI, (*cam_I)(xI),
+      xI, xI_bearing_vector,
       sfm_data->GetViews().at(iIndex)->ui_width, sfm_data->GetViews().at(iIndex)->ui_height,
-      xJ, (*cam_J)(xJ),
+      xJ, xJ_bearing_vector,
       sfm_data->GetViews().at(jIndex)->ui_width, sfm_data->GetViews().at(jIndex)->ui_height,
       ptrPinhole_I->K(), ptrPinhole_J->K());
 
     // Robustly estimate the Essential matrix with A Contrario ransac
     const double upper_bound_precision = Square(m_dPrecision);
     std::vector<uint32_t> vec_inliers;
+    robust::ACRANSAC_Options acransac_options = m_acransac_options;
+    if (m_b_prosac)
+      MatchesPairToScores(pairIndex, vec_PutativeMatches, regions_provider,
+        acransac_options.sample_scores);
     const auto ACRansacOut =
-      openMVG::robust::ACRANSAC(kernel, vec_inliers, m_stIteration, &m_E, upper_bound_precision);
+      openMVG::robust::ACRANSAC(kernel, acransac_options, vec_inliers, m_stIteration, &m_E, upper_bound_precision);
 
     if (vec_inliers.size() > KernelType::MINIMUM_SAMPLES *2.5)
     {
@@ -200,10 +211,8 @@ struct GeometricFilter_EMatrix_AC
         regionsI = regions_provider->get(iIndex),
         regionsJ = regions_provider->get(jIndex);
 
-      geometry_aware::GuidedMatching<
-        Mat3,
+      geometry_aware::GuidedMatching_Fundamental_Grid<
         openMVG::fundamental::kernel::EpipolarDistanceError>(
-          //openMVG::fundamental::kernel::SymmetricEpipolarDistanceError>(
           F,
           cam_I, *regionsI,
           cam_J, *regionsJ,
@@ -215,6 +224,8 @@ struct GeometricFilter_EMatrix_AC
 
   double m_dPrecision;    // upper_bound precision used for robust estimation
   uint32_t m_stIteration; // maximal number of iteration for robust estimation
+  robust::ACRANSAC_Options m_acransac_options; // accelerations of the robust estimation
+  bool m_b_prosac; // PROSAC sampling ordered by the descriptor distance of the matches
   //
   //-- Stored data
   Mat3 m_E;
@@ -37,9 +37,13 @@ struct GeometricFilter_ESphericalMatrix_AC_Angular
 {
   GeometricFilter_ESphericalMatrix_AC_Angular(
     const double precision_upper_bound,
-    const size_t iteration)
+    const size_t iteration,
+    const robust::ACRANSAC_Options & acransac_options = robust::ACRANSAC_Options(),
+    bool b_prosac = false)
     : m_precision_upper_bound(precision_upper_bound),
       m_stIteration(iteration),
+      m_acransac_options(acransac_options),
+      m_b_prosac(b_prosac),
       m_E(Mat3::Identity()),
       m_precision_upper_bound_robust(std::numeric_limits<double>::infinity())
   {
@@ -94,9 +98,9 @@ struct GeometricFilter_ESphericalMatrix_AC_Angular
     Mat2X xI,xJ;
     MatchesPairToMat(pairIndex, vec_PutativeMatches, sfm_data, regions_provider, xI, xJ);
 
-    const Mat3X
-      xI_bearing_vector = (*cam_I)(xI),
-      xJ_bearing_vector = (*cam_J)(xJ);
+    Mat3X xI_bearing_vector, xJ_bearing_vector;
+    MatchesPairToBearingVectors(pairIndex, vec_PutativeMatches, sfm_data, regions_provider,
+      xI, xJ, xI_bearing_vector, xJ_bearing_vector);
 
     //--
     // Robust estimation
@@ -119,8 +123,12 @@ struct GeometricFilter_ESphericalMatrix_AC_Angular
      (m_precision_upper_bound != std::numeric_limits<double>::infinity())?
         D2R(m_precision_upper_bound) : std::numeric_limits<double>::infinity();
     std::vector<uint32_t> vec_inliers;
+    robust::ACRANSAC_Options acransac_options = m_acransac_options;
+    if (m_b_prosac)
+      MatchesPairToScores(pairIndex, vec_PutativeMatches, regions_provider,
+        acransac_options.sample_scores);
     const auto ac_ransac_output =
-      ACRANSAC(kernel, vec_inliers, m_stIteration, &m_E, upper_bound_precision);
+      ACRANSAC(kernel, acransac_options, vec_inliers, m_stIteration, &m_E, upper_bound_precision);
 
     const double & threshold = ac_ransac_output.first;
 
@@ -177,6 +185,10 @@ struct GeometricFilter_ESphericalMatrix_AC_Angular
   double m_precision_upper_bound = std::numeric_limits<double>::infinity();
   // maximal number of iteration for robust estimation
   size_t m_stIteration = 1024;
+  // accelerations of the robust estimation
+  robust::ACRANSAC_Options m_acransac_options;
+  // PROSAC sampling ordered by the descriptor distance of the matches
+  bool m_b_prosac = false;
 
   //
   //-- Stored data
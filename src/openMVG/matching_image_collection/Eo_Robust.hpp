@@ -91,6 +91,9 @@ struct GeometricFilter_EOMatrix_RA
 
       Mat2X xI,xJ;
       MatchesPairToMat(pairIndex, vec_PutativeMatches, sfm_data, regions_provider, xI, xJ);
+      Mat3X xI_bearing_vector, xJ_bearing_vector;
+      MatchesPairToBearingVectors(pairIndex, vec_PutativeMatches, sfm_data, regions_provider,
+        xI, xJ, xI_bearing_vector, xJ_bearing_vector);
 
       // Update precision if required (normalization from image to camera plane):
       if (m_dPrecision != std::numeric_limits<double>::infinity())
@@ -112,10 +115,10 @@ struct GeometricFilter_EOMatrix_RA
           Mat3>;
 
       const KernelType kernel(
-        (*cam_I)(xI),
+        xI_bearing_vector,
         sfm_data->GetViews().at(iIndex)->ui_width,
         sfm_data->GetViews().at(iIndex)->ui_height,
-        (*cam_J)(xJ),
+        xJ_bearing_vector,
         sfm_data->GetViews().at(jIndex)->ui_width,
         sfm_data->GetViews().at(jIndex)->ui_height
       );
@@ -33,10 +33,14 @@ struct GeometricFilter_FMatrix_AC
   GeometricFilter_FMatrix_AC
   (
     double dPrecision = std::numeric_limits<double>::infinity(),
-    uint32_t iteration = 1024
+    uint32_t iteration = 1024,
+    const robust::ACRANSAC_Options & acransac_options = robust::ACRANSAC_Options(),
+    bool b_prosac = false
   ):
     m_dPrecision(dPrecision),
     m_stIteration(iteration),
+    m_acransac_options(acransac_options),
+    m_b_prosac(b_prosac),
     m_F(Mat3::Identity()),
     m_dPrecision_robust(std::numeric_limits<double>::infinity()){}
 
@@ -85,8 +89,12 @@ struct GeometricFilter_FMatrix_AC
     // Robustly estimate the Fundamental matrix with A Contrario ransac
     const double upper_bound_precision = Square(m_dPrecision);
     std::vector<uint32_t> vec_inliers;
+    robust::ACRANSAC_Options acransac_options = m_acransac_options;
+    if (m_b_prosac)
+      MatchesPairToScores(pairIndex, vec_PutativeMatches, regions_provider,
+        acransac_options.sample_scores);
     const std::pair<double,double> ACRansacOut =
-      ACRANSAC(kernel, vec_inliers, m_stIteration, &m_F, upper_bound_precision);
+      ACRANSAC(kernel, acransac_options, vec_inliers, m_stIteration, &m_F, upper_bound_precision);
 
     if (vec_inliers.size() > KernelType::MINIMUM_SAMPLES *2.5)
     {
@@ -137,10 +145,8 @@ struct GeometricFilter_FMatrix_AC
         regionsJ = regions_provider->get(jIndex);
 
       // Check the features correspondences that agree in the geometric and photometric domain
-      geometry_aware::GuidedMatching<
-        Mat3,
+      geometry_aware::GuidedMatching_Fundamental_Grid<
         openMVG::fundamental::kernel::EpipolarDistanceError>(
-          //openMVG::fundamental::kernel::SymmetricEpipolarDistanceError>(
           m_F,
           cam_I, *regionsI,
           cam_J, *regionsJ,
@@ -152,6 +158,8 @@ struct GeometricFilter_FMatrix_AC
 
   double m_dPrecision;    // upper_bound precision used for robust estimation
   uint32_t m_stIteration; // maximal number of iteration for robust estimation
+  robust::ACRANSAC_Options m_acransac_options; // accelerations of the robust estimation
+  bool m_b_prosac; // PROSAC sampling ordered by the descriptor distance of the matches
   //
   //-- Stored data
   Mat3 m_F;
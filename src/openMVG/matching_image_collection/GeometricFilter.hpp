@@ -11,13 +11,19 @@
 
 #include <algorithm>
 #include <map>
+#include <memory>
+#include <set>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "openMVG/features/feature.hpp"
 #include "openMVG/matching/indMatch.hpp"
+#include "openMVG/matching_image_collection/Matches_Buffer.hpp"
+#include "openMVG/matching_image_collection/View_Features_Cache.hpp"
+#include "openMVG/sfm/pipelines/sfm_regions_provider.hpp"
 #include "openMVG/system/progressinterface.hpp"
 
-namespace openMVG { namespace sfm { struct Regions_Provider; } }
 namespace openMVG { namespace sfm { struct SfM_Data; } }
 
 namespace openMVG {
@@ -26,16 +32,77 @@ namespace matching_image_collection {
 
 using namespace openMVG::matching;
 
+namespace detail {
+
+/// Tell if a GeometryFunctor provides a Robust_estimation overload using the
+///  View_Features_Cache (the functors that do not are used with the regions provider)
+template <typename GeometryFunctor, typename = void>
+struct Has_View_Features_Cache_Estimation : std::false_type {};
+
+template <typename GeometryFunctor>
+struct Has_View_Features_Cache_Estimation<GeometryFunctor,
+  decltype(void(std::declval<GeometryFunctor &>().Robust_estimation(
+    std::declval<const sfm::SfM_Data *>(),
+    std::declval<const std::shared_ptr<View_Features_Cache> &>(),
+    std::declval<const Pair>(),
+    std::declval<const IndMatches &>(),
+    std::declval<IndMatches &>())))> : std::true_type {};
+
+template <typename GeometryFunctor>
+bool Robust_estimation
+(
+  GeometryFunctor & functor,
+  const sfm::SfM_Data * sfm_data,
+  const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+  const std::shared_ptr<View_Features_Cache> & view_features_cache,
+  const Pair pair,
+  const IndMatches & putative_matches,
+  IndMatches & geometric_inliers,
+  std::true_type // the functor can use the View_Features_Cache
+)
+{
+  if (view_features_cache)
+    return functor.Robust_estimation(sfm_data, view_features_cache, pair,
+      putative_matches, geometric_inliers);
+  return functor.Robust_estimation(sfm_data, regions_provider, pair,
+    putative_matches, geometric_inliers);
+}
+
+template <typename GeometryFunctor>
+bool Robust_estimation
+(
+  GeometryFunctor & functor,
+  const sfm::SfM_Data * sfm_data,
+  const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+  const std::shared_ptr<View_Features_Cache> & /*view_features_cache*/,
+  const Pair pair,
+  const IndMatches & putative_matches,
+  IndMatches & geometric_inliers,
+  std::false_type
+)
+{
+  return functor.Robust_estimation(sfm_data, regions_provider, pair,
+    putative_matches, geometric_inliers);
+}
+
+} // namespace detail
+
 /// Allow to keep only geometrically coherent matches
 /// -> It discards pairs that do not lead to a valid robust model estimation
+/// If the regions provider keeps all the regions in memory and the
+///  GeometryFunctor supports it, the undistorted feature positions of the
+///  views are computed once (View_Features_Cache) and gathered by index for
+///  each pair.
 struct ImageCollectionGeometricFilter
 {
   ImageCollectionGeometricFilter
   (
     const sfm::SfM_Data * sfm_data,
-    const std::shared_ptr<sfm::Regions_Provider> & regions_provider
+    const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+    const bool b_view_features_cache = true
   ):sfm_data_(sfm_data),
-    regions_provider_(regions_provider)
+    regions_provider_(regions_provider),
+    b_view_features_cache_(b_view_features_cache)
   {}
 
   /// Perform robust model estimation (with optional guided_matching) for all
@@ -51,6 +118,20 @@ struct ImageCollectionGeometricFilter
     system::ProgressInterface *progress_bar = nullptr
   );
 
+  /// Same as above, but the geometric matches are moved to the given container
+  /// while the pairs are processed (i.e. a PairWiseMatches_Writer can be used
+  /// to stream them to disk instead of keeping them in memory).
+  template<typename GeometryFunctor>
+  void Robust_model_estimation
+  (
+    const GeometryFunctor & functor,
+    const PairWiseMatches & putative_matches,
+    PairWiseMatchesContainer & geometric_matches,
+    const bool b_guided_matching = false,
+    const double d_distance_ratio = 0.6,
+    system::ProgressInterface *progress_bar = nullptr
+  );
+
   const PairWiseMatches & Get_geometric_matches() const
   {
     return _map_GeometricMatches;
@@ -60,6 +141,8 @@ struct ImageCollectionGeometricFilter
   const sfm::SfM_Data * sfm_data_;
   const std::shared_ptr<sfm::Regions_Provider> & regions_provider_;
   PairWiseMatches _map_GeometricMatches;
+  const bool b_view_features_cache_;
+  std::shared_ptr<View_Features_Cache> view_features_cache_;
 };
 
 template<typename GeometryFunctor>
@@ -71,34 +154,82 @@ void ImageCollectionGeometricFilter::Robust_model_estimation
   const double d_distance_ratio,
   system::ProgressInterface * my_progress_bar
 )
+{
+  Robust_model_estimation(functor, putative_matches, _map_GeometricMatches,
+    b_guided_matching, d_distance_ratio, my_progress_bar);
+}
+
+template<typename GeometryFunctor>
+void ImageCollectionGeometricFilter::Robust_model_estimation
+(
+  const GeometryFunctor & functor,
+  const PairWiseMatches & putative_matches,
+  PairWiseMatchesContainer & geometric_matches,
+  const bool b_guided_matching,
+  const double d_distance_ratio,
+  system::ProgressInterface * my_progress_bar
+)
 {
   if (!my_progress_bar)
     my_progress_bar = &system::ProgressInterface::dummy();
+
+  // Undistorted feature positions of the views, computed once for all their pairs
+  //  (only if the regions of all the views can be kept in memory)
+  std::shared_ptr<View_Features_Cache> view_features_cache;
+  if (detail::Has_View_Features_Cache_Estimation<GeometryFunctor>::value
+      && b_view_features_cache_ && regions_provider_->view_capacity() == 0)
+  {
+    std::set<IndexT> view_ids;
+    for (const auto & pair_matches_it : putative_matches)
+    {
+      view_ids.insert(pair_matches_it.first.first);
+      view_ids.insert(pair_matches_it.first.second);
+    }
+    if (!view_features_cache_)
+      view_features_cache_ = std::make_shared<View_Features_Cache>();
+    if (view_features_cache_->Build(*sfm_data_, *regions_provider_, view_ids))
+      view_features_cache = view_features_cache_;
+  }
+
   my_progress_bar->Restart( putative_matches.size(), "- Geometric filtering -" );
 
+  // Flat index of the pairs to process
+  std::vector<const PairWiseMatches::value_type *> pair_matches;
+  pair_matches.reserve(putative_matches.size());
+  for (const auto & pair_matches_it : putative_matches)
+    pair_matches.push_back(&pair_matches_it);
+
+  // Number of filtered pairs a thread keeps before moving them to the output
+  const std::size_t flush_count = 64;
+
+  // Each thread stores its results, they are moved to the output by chunks
+  Matches_Buffer matches_buffer;
 #ifdef OPENMVG_USE_OPENMP
 #pragma omp parallel for schedule(dynamic)
 #endif
-  for (int i = 0; i < (int)putative_matches.size(); ++i)
+  for (int i = 0; i < (int)pair_matches.size(); ++i)
   {
     if (my_progress_bar->hasBeenCanceled())
       continue;
-    auto iter = putative_matches.begin();
-    advance(iter,i);
+    const auto iter = pair_matches[i];
 
-    Pair current_pair = iter->first;
+    const Pair current_pair = iter->first;
     const std::vector<IndMatch> & vec_PutativeMatches = iter->second;
 
     //-- Apply the geometric filter (robust model estimation)
     {
       IndMatches putative_inliers;
       GeometryFunctor geometricFilter = functor; // use a copy since we are in a multi-thread context
-      if (geometricFilter.Robust_estimation(
+      const bool b_valid_model = detail::Robust_estimation(
+        geometricFilter,
         sfm_data_,
         regions_provider_,
+        view_features_cache,
         iter->first,
         vec_PutativeMatches,
-        putative_inliers))
+        putative_inliers,
+        detail::Has_View_Features_Cache_Estimation<GeometryFunctor>());
+      if (b_valid_model)
       {
         if (b_guided_matching)
         {
@@ -115,16 +246,13 @@ void ImageCollectionGeometricFilter::Robust_model_estimation
           std::swap(putative_inliers, guided_geometric_inliers);
         }
 
-#ifdef OPENMVG_USE_OPENMP
-#pragma omp critical
-#endif
-        {
-          _map_GeometricMatches.insert( {current_pair, std::move(putative_inliers)});
-        }
+        matches_buffer.push(current_pair, std::move(putative_inliers));
+        matches_buffer.flush(geometric_matches, flush_count);
       }
     }
     ++(*my_progress_bar);
   }
+  matches_buffer.merge(geometric_matches);
 }
 
 } // namespace matching_image_collection
@@ -7,6 +7,7 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include "openMVG/matching_image_collection/Geometric_Filter_utils.hpp"
+#include "openMVG/matching_image_collection/View_Features_Cache.hpp"
 
 #include "openMVG/cameras/Camera_Intrinsics.hpp"
 #include "openMVG/features/feature.hpp"
@@ -123,5 +124,186 @@ void MatchesPairToMat
     x_I, x_J);
 }
 
+void MatchesPairToMat
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const sfm::SfM_Data * /*sfm_data*/,
+  const std::shared_ptr<View_Features_Cache> & view_features_cache,
+  Mat2X & x_I,
+  Mat2X & x_J
+)
+{
+  const Mat2X
+    * positions_I = view_features_cache->Positions(pairIndex.first),
+    * positions_J = view_features_cache->Positions(pairIndex.second);
+  if (!positions_I || !positions_J)
+  {
+    x_I.resize(2, 0);
+    x_J.resize(2, 0);
+    return;
+  }
+
+  const size_t n = putativeMatches.size();
+  x_I.resize(2, n);
+  x_J.resize(2, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    x_I.col(i) = positions_I->col(putativeMatches[i].i_);
+    x_J.col(i) = positions_J->col(putativeMatches[i].j_);
+  }
+}
+
+namespace {
+
+void BearingVectorsFromIntrinsics
+(
+  const Pair pairIndex,
+  const sfm::SfM_Data * sfm_data,
+  const Mat2X & x_I,
+  const Mat2X & x_J,
+  Mat3X & bearing_I,
+  Mat3X & bearing_J
+)
+{
+  const cameras::IntrinsicBase
+    * cam_I = sfm_data->GetIntrinsics().at(
+      sfm_data->GetViews().at(pairIndex.first)->id_intrinsic).get(),
+    * cam_J = sfm_data->GetIntrinsics().at(
+      sfm_data->GetViews().at(pairIndex.second)->id_intrinsic).get();
+  bearing_I = (*cam_I)(x_I);
+  bearing_J = (*cam_J)(x_J);
+}
+
+} // namespace
+
+void MatchesPairToBearingVectors
+(
+  const Pair pairIndex,
+  const matching::IndMatches & /*putativeMatches*/,
+  const sfm::SfM_Data * sfm_data,
+  const std::shared_ptr<sfm::Regions_Provider> & /*regions_provider*/,
+  const Mat2X & x_I,
+  const Mat2X & x_J,
+  Mat3X & bearing_I,
+  Mat3X & bearing_J
+)
+{
+  BearingVectorsFromIntrinsics(pairIndex, sfm_data, x_I, x_J, bearing_I, bearing_J);
+}
+
+void MatchesPairToBearingVectors
+(
+  const Pair pairIndex,
+  const matching::IndMatches & /*putativeMatches*/,
+  const sfm::SfM_Data * sfm_data,
+  const std::shared_ptr<sfm::Features_Provider> & /*features_provider*/,
+  const Mat2X & x_I,
+  const Mat2X & x_J,
+  Mat3X & bearing_I,
+  Mat3X & bearing_J
+)
+{
+  BearingVectorsFromIntrinsics(pairIndex, sfm_data, x_I, x_J, bearing_I, bearing_J);
+}
+
+void MatchesPairToBearingVectors
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const sfm::SfM_Data * sfm_data,
+  const std::shared_ptr<View_Features_Cache> & view_features_cache,
+  const Mat2X & x_I,
+  const Mat2X & x_J,
+  Mat3X & bearing_I,
+  Mat3X & bearing_J
+)
+{
+  const Mat3X
+    * bearing_vectors_I = view_features_cache->BearingVectors(pairIndex.first),
+    * bearing_vectors_J = view_features_cache->BearingVectors(pairIndex.second);
+  if (!bearing_vectors_I || !bearing_vectors_J)
+  {
+    BearingVectorsFromIntrinsics(pairIndex, sfm_data, x_I, x_J, bearing_I, bearing_J);
+    return;
+  }
+
+  const size_t n = putativeMatches.size();
+  bearing_I.resize(3, n);
+  bearing_J.resize(3, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    bearing_I.col(i) = bearing_vectors_I->col(putativeMatches[i].i_);
+    bearing_J.col(i) = bearing_vectors_J->col(putativeMatches[i].j_);
+  }
+}
+
+namespace
+{
+bool RegionsPairToScores
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const sfm::Regions_Provider & regions_provider,
+  std::vector<float> & scores
+)
+{
+  scores.clear();
+  const std::shared_ptr<features::Regions>
+    regionsI = regions_provider.get(pairIndex.first),
+    regionsJ = regions_provider.get(pairIndex.second);
+  if (!regionsI || !regionsJ || regionsI->Type_id() != regionsJ->Type_id())
+    return false;
+
+  scores.resize(putativeMatches.size());
+  for (size_t i = 0; i < putativeMatches.size(); ++i)
+  {
+    scores[i] = static_cast<float>(regionsI->SquaredDescriptorDistance(
+      putativeMatches[i].i_, regionsJ.get(), putativeMatches[i].j_));
+  }
+  return true;
+}
+} // namespace
+
+bool MatchesPairToScores
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+  std::vector<float> & scores
+)
+{
+  return RegionsPairToScores(pairIndex, putativeMatches, *regions_provider, scores);
+}
+
+bool MatchesPairToScores
+(
+  const Pair /*pairIndex*/,
+  const matching::IndMatches & /*putativeMatches*/,
+  const std::shared_ptr<sfm::Features_Provider> & /*features_provider*/,
+  std::vector<float> & scores
+)
+{
+  scores.clear();
+  return false;
+}
+
+bool MatchesPairToScores
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const std::shared_ptr<View_Features_Cache> & view_features_cache,
+  std::vector<float> & scores
+)
+{
+  if (!view_features_cache->regions_provider())
+  {
+    scores.clear();
+    return false;
+  }
+  return RegionsPairToScores(pairIndex, putativeMatches,
+    *view_features_cache->regions_provider(), scores);
+}
+
 } // namespace matching_image_collection
 } // namespace openMVG
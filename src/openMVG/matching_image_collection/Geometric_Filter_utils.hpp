@@ -13,11 +13,15 @@
 #include <openMVG/features/feature_container.hpp>
 #include <openMVG/numeric/eigen_alias_definition.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace openMVG { namespace cameras { struct IntrinsicBase; } }
 namespace openMVG { namespace sfm { struct Regions_Provider; } }
 namespace openMVG { namespace sfm { struct Features_Provider; } }
 namespace openMVG { namespace sfm { struct SfM_Data; } }
 namespace openMVG { namespace sfm { struct View; } }
+namespace openMVG { namespace matching_image_collection { class View_Features_Cache; } }
 
 namespace openMVG {
 
@@ -82,6 +86,115 @@ void MatchesPairToMat
   Mat2X & x_J
 );
 
+/**
+* @brief Gather the un-distorted feature positions for the pair pairIndex from the View_Features_Cache
+*  (the positions of the views are undistorted once, for all the pairs)
+* @param[in] pairIndex Pair from which you need to extract the corresponding points
+* @param[in] putativeMatches Matches of the 'pairIndex' pair
+* @param[in] sfm_data SfM_Data scene container
+* @param[in] view_features_cache Interface that provides the undistorted features positions
+* @param[out] x_I Pixel perfect features from the Inth image putativeMatches matches
+* @param[out] x_J Pixel perfect features from the Jnth image putativeMatches matches
+*/
+void MatchesPairToMat
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const sfm::SfM_Data * sfm_data,
+  const std::shared_ptr<View_Features_Cache> & view_features_cache,
+  Mat2X & x_I,
+  Mat2X & x_J
+);
+
+/**
+* @brief Get the bearing vectors of the putative matches of the pair pairIndex
+*  (computed from their un-distorted positions with the view intrinsics)
+* @param[in] pairIndex Pair from which you need to extract the corresponding bearing vectors
+* @param[in] putativeMatches Matches of the 'pairIndex' pair
+* @param[in] sfm_data SfM_Data scene container (the views must have a valid intrinsic)
+* @param[in] regions_provider Interface that provides the features positions
+* @param[in] x_I Pixel perfect features from the Inth image putativeMatches matches
+* @param[in] x_J Pixel perfect features from the Jnth image putativeMatches matches
+* @param[out] bearing_I Bearing vectors of the Inth image putativeMatches matches
+* @param[out] bearing_J Bearing vectors of the Jnth image putativeMatches matches
+*/
+void MatchesPairToBearingVectors
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const sfm::SfM_Data * sfm_data,
+  const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+  const Mat2X & x_I,
+  const Mat2X & x_J,
+  Mat3X & bearing_I,
+  Mat3X & bearing_J
+);
+
+/// Same as above with the Features_Provider interface
+void MatchesPairToBearingVectors
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const sfm::SfM_Data * sfm_data,
+  const std::shared_ptr<sfm::Features_Provider> & features_provider,
+  const Mat2X & x_I,
+  const Mat2X & x_J,
+  Mat3X & bearing_I,
+  Mat3X & bearing_J
+);
+
+/// Same as above with the View_Features_Cache interface
+///  (the bearing vectors are gathered from the per view bearing vectors)
+void MatchesPairToBearingVectors
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const sfm::SfM_Data * sfm_data,
+  const std::shared_ptr<View_Features_Cache> & view_features_cache,
+  const Mat2X & x_I,
+  const Mat2X & x_J,
+  Mat3X & bearing_I,
+  Mat3X & bearing_J
+);
+
+/**
+* @brief Get the PROSAC scores of the putative matches of the pair pairIndex
+*  (lower is better): the squared descriptor distance of each correspondence.
+*  The putative matches files do not store the distance ratio computed by the
+*  matchers, the ratio numerator is used instead to rank the correspondences.
+* @param[in] pairIndex Pair from which you need to extract the scores
+* @param[in] putativeMatches Matches of the 'pairIndex' pair
+* @param[in] regions_provider Interface that provides the descriptors
+* @param[out] scores One score per putative match
+* @return false if the descriptors are not available (the scores are then empty)
+*/
+bool MatchesPairToScores
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const std::shared_ptr<sfm::Regions_Provider> & regions_provider,
+  std::vector<float> & scores
+);
+
+/// Same as above with the Features_Provider interface (no descriptor: return false)
+bool MatchesPairToScores
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const std::shared_ptr<sfm::Features_Provider> & features_provider,
+  std::vector<float> & scores
+);
+
+/// Same as above with the View_Features_Cache interface
+///  (the descriptors are read from the regions provider the cache was built from)
+bool MatchesPairToScores
+(
+  const Pair pairIndex,
+  const matching::IndMatches & putativeMatches,
+  const std::shared_ptr<View_Features_Cache> & view_features_cache,
+  std::vector<float> & scores
+);
+
 } //namespace matching_image_collection
 } // namespace openMVG
 
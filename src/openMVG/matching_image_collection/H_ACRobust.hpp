@@ -37,10 +37,14 @@ struct GeometricFilter_HMatrix_AC
   GeometricFilter_HMatrix_AC
   (
     double dPrecision = std::numeric_limits<double>::infinity(),
-    uint32_t iteration = 1024
+    uint32_t iteration = 1024,
+    const robust::ACRANSAC_Options & acransac_options = robust::ACRANSAC_Options(),
+    bool b_prosac = false
   ):
     m_dPrecision(dPrecision),
     m_stIteration(iteration),
+    m_acransac_options(acransac_options),
+    m_b_prosac(b_prosac),
     m_H(Mat3::Identity()),
     m_dPrecision_robust(std::numeric_limits<double>::infinity())
   {
@@ -91,8 +95,12 @@ struct GeometricFilter_HMatrix_AC
     // Robustly estimate the Homography matrix with A Contrario ransac
     const double upper_bound_precision = Square(m_dPrecision);
     std::vector<uint32_t> vec_inliers;
+    robust::ACRANSAC_Options acransac_options = m_acransac_options;
+    if (m_b_prosac)
+      MatchesPairToScores(pairIndex, vec_PutativeMatches, regions_provider,
+        acransac_options.sample_scores);
     const std::pair<double,double> ACRansacOut =
-      ACRANSAC(kernel, vec_inliers, m_stIteration, &m_H, upper_bound_precision);
+      ACRANSAC(kernel, acransac_options, vec_inliers, m_stIteration, &m_H, upper_bound_precision);
 
     if (vec_inliers.size() > KernelType::MINIMUM_SAMPLES *2.5)
     {
@@ -174,7 +182,7 @@ struct GeometricFilter_HMatrix_AC
         PointsToMat(cam_I, pointsFeaturesI, xI);
         PointsToMat(cam_J, pointsFeaturesJ, xJ);
 
-        geometry_aware::GuidedMatching
+        geometry_aware::GuidedMatching_Homography_Grid
           <Mat3, openMVG::homography::kernel::AsymmetricError>(
           m_H, xI, xJ, Square(m_dPrecision_robust), matches);
 
@@ -188,7 +196,7 @@ struct GeometricFilter_HMatrix_AC
       else
       {
         // Filtering based on region positions and regions descriptors
-        geometry_aware::GuidedMatching<
+        geometry_aware::GuidedMatching_Homography_Grid<
           Mat3,
           openMVG::homography::kernel::AsymmetricError>(
             m_H,
@@ -203,6 +211,8 @@ struct GeometricFilter_HMatrix_AC
 
   double m_dPrecision;    // upper_bound precision used for robust estimation
   uint32_t m_stIteration; // maximal number of iteration for robust estimation
+  robust::ACRANSAC_Options m_acransac_options; // accelerations of the robust estimation
+  bool m_b_prosac; // PROSAC sampling ordered by the descriptor distance of the matches
   //
   //-- Stored data
   Mat3 m_H;
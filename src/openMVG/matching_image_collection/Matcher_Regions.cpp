@@ -8,24 +8,39 @@
 
 #include "openMVG/matching_image_collection/Matcher_Regions.hpp"
 #include "openMVG/matching_image_collection/Matcher.hpp"
+#include "openMVG/matching_image_collection/Matches_Buffer.hpp"
+#include "openMVG/matching_image_collection/Pair_Scheduler.hpp"
+#include "openMVG/matching_image_collection/Regions_Matcher_Cache.hpp"
 #include "openMVG/matching/regions_matcher.hpp"
 #include "openMVG/sfm/pipelines/sfm_regions_provider.hpp"
 #include "openMVG/system/progressinterface.hpp"
 #include "openMVG/system/logger.hpp"
 
+#include "third_party/stlplus3/filesystemSimplified/file_system.hpp"
+
 namespace openMVG {
 namespace matching_image_collection {
 
 using namespace openMVG::matching;
 using namespace openMVG::features;
 
+// Maximal number of query descriptors searched in a batch
+//  (bounds the memory used by the concatenated descriptors)
+static const std::size_t kMaxBatchQueryCount = 1 << 19;
+
 Matcher_Regions::Matcher_Regions
 (
-  float distRatio, EMatcherType eMatcherType
+  float distRatio, EMatcherType eMatcherType,
+  const HNSWParams & hnsw_params,
+  std::size_t hnsw_index_cache_size,
+  bool b_save_hnsw_index
 ):
   Matcher(),
   f_dist_ratio_(distRatio),
-  eMatcherType_(eMatcherType)
+  eMatcherType_(eMatcherType),
+  hnsw_params_(hnsw_params),
+  hnsw_index_cache_size_(hnsw_index_cache_size),
+  b_save_hnsw_index_(b_save_hnsw_index)
 {
 }
 
@@ -45,21 +60,39 @@ void Matcher_Regions::Match(
 
   my_progress_bar->Restart(pairs.size(), "- Matching -");
 
-  // Sort pairs according the first index to minimize the MatcherT build operations
-  using Map_vectorT = std::map<IndexT, std::vector<IndexT>>;
-  Map_vectorT map_Pairs;
-  for (const auto & pair_it : pairs)
-  {
-    map_Pairs[pair_it.first].push_back(pair_it.second);
-  }
+  // Group pairs according the first index to minimize the MatcherT build operations
+  // (the groups are ordered to keep the used regions in the provider memory budget)
+  const Pair_Schedule schedule = SchedulePairs(pairs, regions_provider->view_capacity());
+
+  // Matchers that are multi-threaded internally search the partner views of
+  //  a group in batches (the cascade hashing matcher is run per pair in parallel)
+  const bool b_batch_query = (eMatcherType_ != CASCADE_HASHING_L2);
+
+  // The HNSW graphs own a copy of the descriptors, they can be kept
+  //  to be reused by the next groups of the same view
+  const bool b_hnsw = (eMatcherType_ == HNSW_L2 || eMatcherType_ == HNSW_L1
+    || eMatcherType_ == HNSW_HAMMING);
+  Regions_Matcher_Cache matcher_cache(b_hnsw ? hnsw_index_cache_size_ : 0);
+  const bool b_save_hnsw_index = b_hnsw && b_save_hnsw_index_
+    && !regions_provider->feat_directory().empty();
 
   // Perform matching between all the pairs
-  for (const auto & pairs_it : map_Pairs)
+  Matches_Buffer matches_buffer;
+  for (auto pairs_it = schedule.cbegin(); pairs_it != schedule.cend(); ++pairs_it)
   {
     if (my_progress_bar->hasBeenCanceled())
       continue;
-    const IndexT I = pairs_it.first;
-    const auto & indexToCompare = pairs_it.second;
+    const IndexT I = pairs_it->first;
+    const auto & indexToCompare = pairs_it->second;
+
+    // Let the regions provider load the views of the next group in advance
+    const auto next_it = std::next(pairs_it);
+    if (next_it != schedule.cend())
+    {
+      std::vector<IndexT> next_views(1, next_it->first);
+      next_views.insert(next_views.end(), next_it->second.cbegin(), next_it->second.cend());
+      regions_provider->prefetch(next_views);
+    }
 
     const std::shared_ptr<features::Regions> regionsI = regions_provider->get(I);
     if (regionsI->RegionCount() == 0)
@@ -69,11 +102,70 @@ void Matcher_Regions::Match(
     }
 
     // Initialize the matching interface
-    const std::unique_ptr<RegionsMatcher> matcher =
-      RegionMatcherFactory(eMatcherType_, *regionsI.get());
+    const std::shared_ptr<RegionsMatcher> matcher = matcher_cache.get(I,
+      [&]()
+      {
+        HNSWParams hnsw_params = hnsw_params_;
+        if (b_save_hnsw_index)
+        {
+          hnsw_params.index_filename = stlplus::create_filespec(
+            regions_provider->feat_directory(), regions_provider->basename(I),
+            eMatcherType_ == HNSW_L1 ? "hnsw_l1" :
+            eMatcherType_ == HNSW_HAMMING ? "hnsw_hamming" : "hnsw_l2");
+        }
+        return RegionMatcherFactory(eMatcherType_, *regionsI.get(), hnsw_params);
+      });
     if (!matcher)
       continue;
 
+    if (b_batch_query)
+    {
+      // Search the regions of several views at once in the index of I
+      //  (the matcher uses all the cores for the whole batch)
+      for (size_t j_start = 0; j_start < indexToCompare.size();)
+      {
+        std::vector<IndexT> batch_views;
+        std::vector<std::shared_ptr<features::Regions>> batch_regions;
+        std::size_t batch_query_count = 0;
+        size_t j = j_start;
+        for (; j < indexToCompare.size() && batch_query_count < kMaxBatchQueryCount; ++j)
+        {
+          const IndexT J = indexToCompare[j];
+          std::shared_ptr<features::Regions> regionsJ = regions_provider->get(J);
+          if (!regionsJ || regionsJ->RegionCount() == 0
+              || regionsI->Type_id() != regionsJ->Type_id())
+          {
+            ++(*my_progress_bar);
+            continue;
+          }
+          batch_query_count += regionsJ->RegionCount();
+          batch_views.push_back(J);
+          batch_regions.push_back(std::move(regionsJ));
+        }
+        j_start = j;
+        if (batch_views.empty())
+          continue;
+
+        std::vector<const features::Regions *> query_regions;
+        for (const auto & regionsJ : batch_regions)
+          query_regions.push_back(regionsJ.get());
+        std::vector<IndMatches> vec_putative_matches;
+        matcher->MatchDistanceRatioBatch(f_dist_ratio_, query_regions, vec_putative_matches);
+
+        for (size_t k = 0; k < batch_views.size(); ++k)
+        {
+          if (k < vec_putative_matches.size() && !vec_putative_matches[k].empty())
+          {
+            matches_buffer.push({I, batch_views[k]}, std::move(vec_putative_matches[k]));
+          }
+          my_progress_bar->AddWork(
+            static_cast<uint64_t>(regionsI->RegionCount()) * batch_regions[k]->RegionCount());
+          ++(*my_progress_bar);
+        }
+      }
+      continue;
+    }
+
 #ifdef OPENMVG_USE_OPENMP
     #pragma omp parallel for schedule(dynamic) if (b_multithreaded_pair_search)
 #endif
@@ -92,18 +184,26 @@ void Matcher_Regions::Match(
       IndMatches vec_putative_matches;
       matcher->MatchDistanceRatio(f_dist_ratio_, *regionsJ.get(), vec_putative_matches);
 
-#ifdef OPENMVG_USE_OPENMP
-  #pragma omp critical
-#endif
+      if (!vec_putative_matches.empty())
       {
-        if (!vec_putative_matches.empty())
-        {
-          map_PutativeMatches.insert( { {I,J}, std::move(vec_putative_matches) } );
-        }
+        matches_buffer.push({I,J}, std::move(vec_putative_matches));
       }
+      my_progress_bar->AddWork(
+        static_cast<uint64_t>(regionsI->RegionCount()) * regionsJ->RegionCount());
       ++(*my_progress_bar);
     }
   }
+  matches_buffer.merge(map_PutativeMatches);
+
+  if (b_hnsw)
+  {
+    OPENMVG_LOG_INFO << "HNSW graphs: " << matcher_cache.miss_count() << " initialized, "
+      << matcher_cache.hit_count() << " reused from memory";
+  }
+
+  OPENMVG_LOG_INFO << "Matching throughput: "
+    << my_progress_bar->StepsPerSecond() << " pairs/s, "
+    << my_progress_bar->WorkPerSecond() << " descriptor pairs/s";
 }
 
 } // namespace matching_image_collection
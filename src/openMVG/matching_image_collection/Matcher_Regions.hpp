@@ -28,10 +28,18 @@ namespace matching_image_collection {
 class Matcher_Regions : public Matcher
 {
   public:
+  /// @param hnsw_params the parameters of the HNSW matchers
+  /// @param hnsw_index_cache_size number of HNSW graphs kept in memory
+  ///  to be reused by the next pairs of a view
+  /// @param b_save_hnsw_index save the HNSW graph of each view next to its
+  ///  regions file (and reuse it in the next runs)
   Matcher_Regions
   (
     float dist_ratio,
-    matching::EMatcherType eMatcherType
+    matching::EMatcherType eMatcherType,
+    const matching::HNSWParams & hnsw_params = matching::HNSWParams(),
+    std::size_t hnsw_index_cache_size = 32,
+    bool b_save_hnsw_index = false
   );
 
   /// Find corresponding points between some pair of view Ids
@@ -48,6 +56,10 @@ class Matcher_Regions : public Matcher
   float f_dist_ratio_;
   // Matcher Type
   matching::EMatcherType eMatcherType_;
+  // HNSW graphs parameters and reuse
+  matching::HNSWParams hnsw_params_;
+  std::size_t hnsw_index_cache_size_;
+  bool b_save_hnsw_index_;
 };
 
 } // namespace matching_image_collection
@@ -0,0 +1,104 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_MATCHING_IMAGE_COLLECTION_MATCHES_BUFFER_HPP
+#define OPENMVG_MATCHING_IMAGE_COLLECTION_MATCHES_BUFFER_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "openMVG/matching/indMatch.hpp"
+
+#ifdef OPENMVG_USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace openMVG {
+namespace matching_image_collection {
+
+/// Per thread storage of the pairwise matches computed in a parallel loop.
+/// Each thread appends its results to its own buffer (no synchronization),
+///  the buffers are merged once in the output container at the end.
+class Matches_Buffer
+{
+public:
+  Matches_Buffer()
+  {
+#ifdef OPENMVG_USE_OPENMP
+    buffers_.resize(omp_get_max_threads());
+#else
+    buffers_.resize(1);
+#endif
+  }
+
+  /// Store the matches of a pair (must be called by a thread of the team
+  ///  that was active when the buffer has been created)
+  void push(const Pair & pair, matching::IndMatches && matches)
+  {
+    buffers_[thread_id()].emplace_back(pair, std::move(matches));
+  }
+
+  /// Move the matches stored by the calling thread to the output container
+  ///  once it holds at least min_count pairs (the insertions are serialized).
+  /// Used to stream the results while the parallel loop is running.
+  void flush(matching::PairWiseMatchesContainer & map_putative_matches, std::size_t min_count)
+  {
+    auto & buffer = buffers_[thread_id()];
+    if (buffer.empty() || buffer.size() < min_count)
+      return;
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp critical(Matches_Buffer_flush)
+#endif
+    {
+      for (auto & pair_matches : buffer)
+        map_putative_matches.insert(std::move(pair_matches));
+    }
+    buffer.clear();
+  }
+
+  /// Move the stored matches to the output container (in pair order)
+  void merge(matching::PairWiseMatchesContainer & map_putative_matches)
+  {
+    std::vector<std::pair<Pair, matching::IndMatches>> all_matches;
+    std::size_t count = 0;
+    for (const auto & buffer : buffers_)
+      count += buffer.size();
+    all_matches.reserve(count);
+    for (auto & buffer : buffers_)
+    {
+      std::move(buffer.begin(), buffer.end(), std::back_inserter(all_matches));
+      buffer.clear();
+    }
+    std::sort(all_matches.begin(), all_matches.end(),
+      [](const std::pair<Pair, matching::IndMatches> & a,
+         const std::pair<Pair, matching::IndMatches> & b)
+      {
+        return a.first < b.first;
+      });
+    for (auto & pair_matches : all_matches)
+      map_putative_matches.insert(std::move(pair_matches));
+  }
+
+private:
+  static int thread_id()
+  {
+#ifdef OPENMVG_USE_OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+  }
+
+  std::vector<std::vector<std::pair<Pair, matching::IndMatches>>> buffers_;
+};
+
+} // namespace matching_image_collection
+} // namespace openMVG
+
+#endif // OPENMVG_MATCHING_IMAGE_COLLECTION_MATCHES_BUFFER_HPP
@@ -0,0 +1,159 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/matching_image_collection/Pair_Scheduler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <unordered_map>
+
+namespace openMVG {
+namespace matching_image_collection {
+
+namespace {
+
+/// Position of the cell (x,y) along the Hilbert curve covering a side x side grid
+/// (side must be a power of two)
+uint64_t HilbertIndex(const uint64_t side, uint64_t x, uint64_t y)
+{
+  uint64_t d = 0;
+  for (uint64_t s = side / 2; s > 0; s /= 2)
+  {
+    const uint64_t rx = (x & s) > 0;
+    const uint64_t ry = (y & s) > 0;
+    d += s * s * ((3 * rx) ^ ry);
+    // Rotate the quadrant
+    if (ry == 0)
+    {
+      if (rx == 1)
+      {
+        x = s - 1 - x;
+        y = s - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+} // namespace
+
+Pair_Schedule SchedulePairs
+(
+  const Pair_Set & pairs,
+  const std::size_t view_capacity
+)
+{
+  Pair_Schedule schedule;
+
+  if (view_capacity == 0)
+  {
+    // Group the pairs according the first index
+    std::map<IndexT, std::vector<IndexT>> map_Pairs;
+    for (const auto & pair_it : pairs)
+    {
+      map_Pairs[pair_it.first].push_back(pair_it.second);
+    }
+    schedule.reserve(map_Pairs.size());
+    for (auto & group_it : map_Pairs)
+    {
+      schedule.emplace_back(group_it.first, std::move(group_it.second));
+    }
+    return schedule;
+  }
+
+  // List the used views (their rank defines their block)
+  std::vector<IndexT> views;
+  views.reserve(pairs.size() * 2);
+  for (const auto & pair_it : pairs)
+  {
+    views.push_back(pair_it.first);
+    views.push_back(pair_it.second);
+  }
+  std::sort(views.begin(), views.end());
+  views.erase(std::unique(views.begin(), views.end()), views.end());
+
+  // Two blocks must fit in the cache
+  const uint64_t block_size = std::max<std::size_t>(1, view_capacity / 2);
+  const uint64_t block_count = (views.size() + block_size - 1) / block_size;
+  uint64_t side = 1;
+  while (side < block_count)
+    side *= 2;
+
+  const auto block_of = [&](const IndexT view_id) -> uint64_t
+  {
+    return std::distance(views.cbegin(),
+      std::lower_bound(views.cbegin(), views.cend(), view_id)) / block_size;
+  };
+
+  // Bucket the pairs per tile. A tile and its transposed tile use the same
+  // views, so they are merged (the pair graph is undirected).
+  std::map<uint64_t, std::map<IndexT, std::vector<IndexT>>> tiles;
+  for (const auto & pair_it : pairs)
+  {
+    const uint64_t block_i = block_of(pair_it.first);
+    const uint64_t block_j = block_of(pair_it.second);
+    const uint64_t tile_id = HilbertIndex(side,
+      std::min(block_i, block_j), std::max(block_i, block_j));
+    tiles[tile_id][pair_it.first].push_back(pair_it.second);
+  }
+
+  for (auto & tile_it : tiles)
+  {
+    for (auto & group_it : tile_it.second)
+    {
+      schedule.emplace_back(group_it.first, std::move(group_it.second));
+    }
+  }
+  return schedule;
+}
+
+std::size_t CountScheduleLoads
+(
+  const Pair_Schedule & schedule,
+  const std::size_t view_capacity
+)
+{
+  std::size_t load_count = 0;
+  std::list<IndexT> lru; // most recently used first
+  std::unordered_map<IndexT, std::list<IndexT>::iterator> cached;
+
+  const auto access = [&](const IndexT view_id)
+  {
+    const auto it = cached.find(view_id);
+    if (it != cached.end())
+    {
+      lru.splice(lru.begin(), lru, it->second);
+      return;
+    }
+    ++load_count;
+    lru.push_front(view_id);
+    cached[view_id] = lru.begin();
+    if (view_capacity != 0 && lru.size() > view_capacity)
+    {
+      cached.erase(lru.back());
+      lru.pop_back();
+    }
+  };
+
+  for (const auto & group : schedule)
+  {
+    for (const IndexT J : group.second)
+    {
+      // The first view is used during the whole group
+      access(group.first);
+      access(J);
+    }
+  }
+  return load_count;
+}
+
+} // namespace matching_image_collection
+} // namespace openMVG
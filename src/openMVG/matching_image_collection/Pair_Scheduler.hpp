@@ -0,0 +1,61 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_MATCHING_IMAGE_COLLECTION_PAIR_SCHEDULER_HPP
+#define OPENMVG_MATCHING_IMAGE_COLLECTION_PAIR_SCHEDULER_HPP
+
+#include <utility>
+#include <vector>
+
+#include "openMVG/types.hpp"
+
+namespace openMVG {
+namespace matching_image_collection {
+
+/// A group of pairs sharing the same first view: (I, [J0, J1, ...])
+using Pair_Group = std::pair<IndexT, std::vector<IndexT>>;
+/// Ordered list of pair groups to be matched
+using Pair_Schedule = std::vector<Pair_Group>;
+
+/**
+ * @brief Order the pairs to match so that the views required by consecutive
+ *  pairs fit in a regions cache able to store `view_capacity` views.
+ *
+ * - view_capacity == 0 (all the regions are in memory): pairs are grouped by
+ *   first index in increasing order.
+ * - else the (used) view indexes are split in blocks of view_capacity / 2 views.
+ *   The tiles (block_i, block_j) of the pair adjacency matrix are visited along
+ *   a Hilbert curve, so two consecutive tiles share one of their blocks and the
+ *   views of a tile stay resident while it is processed. Inside a tile, pairs
+ *   are grouped by first index.
+ *
+ * @param pairs The pairs to match
+ * @param view_capacity The number of views that can be kept in memory
+ * @return The ordered list of pair groups
+ */
+Pair_Schedule SchedulePairs
+(
+  const Pair_Set & pairs,
+  const std::size_t view_capacity = 0
+);
+
+/**
+ * @brief Count the number of view loads required by a schedule if the views
+ *  are stored in a LRU cache of `view_capacity` views (0: unlimited).
+ *  Used to compare pair orderings.
+ */
+std::size_t CountScheduleLoads
+(
+  const Pair_Schedule & schedule,
+  const std::size_t view_capacity
+);
+
+} // namespace matching_image_collection
+} // namespace openMVG
+
+#endif // OPENMVG_MATCHING_IMAGE_COLLECTION_PAIR_SCHEDULER_HPP
@@ -0,0 +1,65 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/matching_image_collection/Pair_Builder.hpp"
+#include "openMVG/matching_image_collection/Pair_Scheduler.hpp"
+#include "testing/testing.h"
+
+using namespace openMVG;
+using namespace openMVG::matching_image_collection;
+
+// Check that a schedule lists each input pair exactly once
+bool checkSchedule(const Pair_Set & pairs, const Pair_Schedule & schedule)
+{
+  Pair_Set scheduled_pairs;
+  std::size_t count = 0;
+  for (const auto & group : schedule)
+  {
+    for (const IndexT J : group.second)
+    {
+      scheduled_pairs.insert({group.first, J});
+      ++count;
+    }
+  }
+  return count == pairs.size() && scheduled_pairs == pairs;
+}
+
+TEST(Pair_Scheduler, FirstIndexGrouping)
+{
+  const Pair_Set pairs = exhaustivePairs(6);
+  const Pair_Schedule schedule = SchedulePairs(pairs);
+  EXPECT_TRUE(checkSchedule(pairs, schedule));
+  // One group per first index (the last view has no partner with a larger index)
+  EXPECT_EQ(5, schedule.size());
+  for (IndexT i = 0; i < schedule.size(); ++i)
+  {
+    EXPECT_EQ(i, schedule[i].first);
+  }
+}
+
+TEST(Pair_Scheduler, BlockedOrdering)
+{
+  const Pair_Set pairs = exhaustivePairs(200);
+  const std::size_t view_capacity = 40;
+
+  const Pair_Schedule legacy_schedule = SchedulePairs(pairs);
+  const Pair_Schedule blocked_schedule = SchedulePairs(pairs, view_capacity);
+  EXPECT_TRUE(checkSchedule(pairs, blocked_schedule));
+
+  // The blocked ordering requires fewer loads with a bounded cache
+  const std::size_t legacy_loads = CountScheduleLoads(legacy_schedule, view_capacity);
+  const std::size_t blocked_loads = CountScheduleLoads(blocked_schedule, view_capacity);
+  EXPECT_TRUE(blocked_loads < legacy_loads / 2);
+
+  // With an unbounded cache each view is loaded once
+  EXPECT_EQ(200, CountScheduleLoads(blocked_schedule, 0));
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -0,0 +1,81 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_MATCHING_IMAGE_COLLECTION_REGIONS_MATCHER_CACHE_HPP
+#define OPENMVG_MATCHING_IMAGE_COLLECTION_REGIONS_MATCHER_CACHE_HPP
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "openMVG/matching/regions_matcher.hpp"
+#include "openMVG/types.hpp"
+
+namespace openMVG {
+namespace matching_image_collection {
+
+/// Keep the search structures (RegionsMatcher) built for the last used views.
+/// - At most max_size matchers are kept, the least recently used one is released first,
+/// - The cached matchers must not reference the regions data (i.e. HNSW graphs),
+/// - Not thread safe: get() must be called from a single thread.
+class Regions_Matcher_Cache
+{
+public:
+  using Matcher_Factory = std::function<std::unique_ptr<matching::RegionsMatcher>()>;
+
+  /// @param max_size maximum number of kept matchers (0: no caching)
+  explicit Regions_Matcher_Cache(const std::size_t max_size) : max_size_(max_size) {}
+
+  /// Return the matcher of a view, create it with the factory if it is not cached
+  std::shared_ptr<matching::RegionsMatcher> get
+  (
+    const IndexT view_id,
+    const Matcher_Factory & factory
+  )
+  {
+    const auto it = entries_.find(view_id);
+    if (it != entries_.end())
+    {
+      // Move the element to the front of the LRU list
+      lru_.splice(lru_.begin(), lru_, it->second.second);
+      ++hit_count_;
+      return it->second.first;
+    }
+    ++miss_count_;
+    std::shared_ptr<matching::RegionsMatcher> matcher = factory();
+    if (!matcher || max_size_ == 0)
+      return matcher;
+
+    if (entries_.size() >= max_size_)
+    {
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+    }
+    lru_.push_front(view_id);
+    entries_[view_id] = {matcher, lru_.begin()};
+    return matcher;
+  }
+
+  std::size_t hit_count() const { return hit_count_; }
+  std::size_t miss_count() const { return miss_count_; }
+
+private:
+  const std::size_t max_size_;
+  std::map<IndexT,
+    std::pair<std::shared_ptr<matching::RegionsMatcher>, std::list<IndexT>::iterator>> entries_;
+  std::list<IndexT> lru_; // most recently used first
+  std::size_t hit_count_ = 0;
+  std::size_t miss_count_ = 0;
+};
+
+} // namespace matching_image_collection
+} // namespace openMVG
+
+#endif // OPENMVG_MATCHING_IMAGE_COLLECTION_REGIONS_MATCHER_CACHE_HPP
@@ -0,0 +1,111 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/matching_image_collection/View_Features_Cache.hpp"
+
+#include "openMVG/cameras/Camera_Intrinsics.hpp"
+#include "openMVG/features/feature.hpp"
+#include "openMVG/sfm/pipelines/sfm_regions_provider.hpp"
+#include "openMVG/sfm/sfm_data.hpp"
+#include "openMVG/system/logger.hpp"
+
+#include <vector>
+
+namespace openMVG {
+namespace matching_image_collection {
+
+bool View_Features_Cache::Build
+(
+  const sfm::SfM_Data & sfm_data,
+  const sfm::Regions_Provider & regions_provider,
+  const std::set<IndexT> & view_ids
+)
+{
+  regions_provider_ = &regions_provider;
+
+  // Allocate the entries of the new views (the map is not modified in the parallel loop)
+  std::vector<std::pair<IndexT, View_Features *>> new_views;
+  for (const IndexT view_id : view_ids)
+  {
+    if (views_.count(view_id))
+      continue;
+    View_Features * view_features = new View_Features;
+    views_[view_id].reset(view_features);
+    new_views.emplace_back(view_id, view_features);
+  }
+
+  std::vector<char> valid_views(new_views.size(), 1);
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < static_cast<int>(new_views.size()); ++i)
+  {
+    const IndexT view_id = new_views[i].first;
+    View_Features & view_features = *new_views[i].second;
+
+    const auto view_it = sfm_data.GetViews().find(view_id);
+    const std::shared_ptr<features::Regions> regions = regions_provider.get(view_id);
+    if (view_it == sfm_data.GetViews().end() || !regions)
+    {
+      valid_views[i] = 0;
+      continue;
+    }
+
+    // Retrieve the view camera intrinsic if any
+    const auto intrinsic_it = sfm_data.GetIntrinsics().find(view_it->second->id_intrinsic);
+    view_features.cam = (intrinsic_it != sfm_data.GetIntrinsics().end()) ?
+      intrinsic_it->second.get() : nullptr;
+
+    // Undistorted feature positions (same computation as MatchesPointsToMat)
+    const features::PointFeatures features = regions->GetRegionsPositions();
+    view_features.positions.resize(2, features.size());
+    for (size_t j = 0; j < features.size(); ++j)
+    {
+      if (view_features.cam)
+        view_features.positions.col(j) =
+          view_features.cam->get_ud_pixel(features[j].coords().cast<double>());
+      else
+        view_features.positions.col(j) = features[j].coords().cast<double>();
+    }
+  }
+
+  // Remove the views whose regions cannot be retrieved
+  bool b_ok = true;
+  for (size_t i = 0; i < new_views.size(); ++i)
+  {
+    if (!valid_views[i])
+    {
+      OPENMVG_LOG_ERROR << "Cannot retrieve the regions of the view: " << new_views[i].first;
+      views_.erase(new_views[i].first);
+      b_ok = false;
+    }
+  }
+  return b_ok;
+}
+
+const Mat2X * View_Features_Cache::Positions(const IndexT view_id) const
+{
+  const auto it = views_.find(view_id);
+  return (it != views_.end()) ? &it->second->positions : nullptr;
+}
+
+const Mat3X * View_Features_Cache::BearingVectors(const IndexT view_id) const
+{
+  const auto it = views_.find(view_id);
+  if (it == views_.end() || !it->second->cam)
+    return nullptr;
+  const View_Features & view_features = *it->second;
+  std::call_once(view_features.bearing_vectors_flag, [&view_features]
+  {
+    view_features.bearing_vectors = (*view_features.cam)(view_features.positions);
+  });
+  return &view_features.bearing_vectors;
+}
+
+} // namespace matching_image_collection
+} // namespace openMVG
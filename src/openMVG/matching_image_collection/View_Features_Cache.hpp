@@ -0,0 +1,71 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_MATCHING_IMAGE_COLLECTION_VIEW_FEATURES_CACHE_HPP
+#define OPENMVG_MATCHING_IMAGE_COLLECTION_VIEW_FEATURES_CACHE_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+
+#include "openMVG/numeric/eigen_alias_definition.hpp"
+#include "openMVG/types.hpp"
+
+namespace openMVG { namespace cameras { struct IntrinsicBase; } }
+namespace openMVG { namespace sfm { struct Regions_Provider; } }
+namespace openMVG { namespace sfm { struct SfM_Data; } }
+
+namespace openMVG {
+namespace matching_image_collection {
+
+/// Undistorted feature positions (and bearing vectors) of a set of views.
+/// They are computed once per view and shared (read only) by the geometric
+///  filtering of all the pairs the view belongs to: the point arrays of a
+///  pair are then gathered by feature index (see MatchesPairToMat).
+class View_Features_Cache
+{
+public:
+  /// Compute the undistorted feature positions of the views that are not cached yet
+  /// @return false if the regions of a view cannot be retrieved
+  bool Build
+  (
+    const sfm::SfM_Data & sfm_data,
+    const sfm::Regions_Provider & regions_provider,
+    const std::set<IndexT> & view_ids
+  );
+
+  /// Undistorted positions of the features of a view (nullptr if not cached)
+  const Mat2X * Positions(const IndexT view_id) const;
+
+  /// Bearing vectors of the features of a view (nullptr if not cached or
+  ///  if the view has no intrinsic). They are computed on the first request.
+  /// Thread safe.
+  const Mat3X * BearingVectors(const IndexT view_id) const;
+
+  std::size_t size() const { return views_.size(); }
+
+  /// The regions provider the positions were computed from (nullptr before Build)
+  const sfm::Regions_Provider * regions_provider() const { return regions_provider_; }
+
+private:
+  struct View_Features
+  {
+    const cameras::IntrinsicBase * cam = nullptr;
+    Mat2X positions;
+    mutable Mat3X bearing_vectors;
+    mutable std::once_flag bearing_vectors_flag;
+  };
+  std::map<IndexT, std::unique_ptr<View_Features>> views_;
+  const sfm::Regions_Provider * regions_provider_ = nullptr;
+};
+
+} // namespace matching_image_collection
+} // namespace openMVG
+
+#endif // OPENMVG_MATCHING_IMAGE_COLLECTION_VIEW_FEATURES_CACHE_HPP
@@ -139,7 +139,7 @@ class VLAD : public VLADBase
         const auto descriptor_id = centroid_id_and_descriptor_list.j_;
 
         const auto residual =
-            cast_query_regions->Descriptors()[descriptor_id].template cast<double>() -
+            cast_query_regions->DescriptorsData()[descriptor_id].template cast<double>() -
             cast_centroid_regions->Descriptors()[centroid_id].template cast<double>();
 
         switch (vlad_normalization_type) {
@@ -0,0 +1,310 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/multiview/solver_batched_errors.hpp"
+#include "openMVG/system/cpu_instruction_set.hpp"
+
+#include <cmath>
+#include <immintrin.h>
+
+namespace openMVG {
+namespace batched {
+
+namespace {
+
+bool SupportAVX2()
+{
+  static const bool b_avx2 = system::CpuInstructionSet().supportAVX2();
+  return b_avx2;
+}
+
+// The remaining points (less than a register) use the same scalar expression
+
+inline double EpipolarError
+(
+  const Mat3 & F,
+  const double x0, const double x1,
+  const double y0, const double y1,
+  const EEpipolarError error_type
+)
+{
+  const double F_x0 = F(0,0) * x0 + F(0,1) * x1 + F(0,2);
+  const double F_x1 = F(1,0) * x0 + F(1,1) * x1 + F(1,2);
+  const double F_x2 = F(2,0) * x0 + F(2,1) * x1 + F(2,2);
+  const double r = y0 * F_x0 + y1 * F_x1 + F_x2;
+  const double F_x_norm = F_x0 * F_x0 + F_x1 * F_x1;
+  if (error_type == EEpipolarError::ONE_SIDED)
+    return r * r / F_x_norm;
+  const double Ft_y0 = F(0,0) * y0 + F(1,0) * y1 + F(2,0);
+  const double Ft_y1 = F(0,1) * y0 + F(1,1) * y1 + F(2,1);
+  const double Ft_y_norm = Ft_y0 * Ft_y0 + Ft_y1 * Ft_y1;
+  if (error_type == EEpipolarError::SAMPSON)
+    return r * r / (F_x_norm + Ft_y_norm);
+  return r * r * (1.0 / F_x_norm + 1.0 / Ft_y_norm) / 4.0;
+}
+
+OPENMVG_TARGET("avx2")
+void EpipolarErrors_AVX2_Impl
+(
+  const Mat3 & F,
+  const double * x0, const double * x1,
+  const double * y0, const double * y1,
+  const Eigen::Index count,
+  const EEpipolarError error_type,
+  double * errors
+)
+{
+  const __m256d F00 = _mm256_set1_pd(F(0,0)), F01 = _mm256_set1_pd(F(0,1)), F02 = _mm256_set1_pd(F(0,2));
+  const __m256d F10 = _mm256_set1_pd(F(1,0)), F11 = _mm256_set1_pd(F(1,1)), F12 = _mm256_set1_pd(F(1,2));
+  const __m256d F20 = _mm256_set1_pd(F(2,0)), F21 = _mm256_set1_pd(F(2,1)), F22 = _mm256_set1_pd(F(2,2));
+  const __m256d one = _mm256_set1_pd(1.0), quarter = _mm256_set1_pd(0.25);
+  Eigen::Index i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m256d vx0 = _mm256_loadu_pd(x0 + i), vx1 = _mm256_loadu_pd(x1 + i);
+    const __m256d vy0 = _mm256_loadu_pd(y0 + i), vy1 = _mm256_loadu_pd(y1 + i);
+    // F * x
+    const __m256d F_x0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(F00, vx0), _mm256_mul_pd(F01, vx1)), F02);
+    const __m256d F_x1 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(F10, vx0), _mm256_mul_pd(F11, vx1)), F12);
+    const __m256d F_x2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(F20, vx0), _mm256_mul_pd(F21, vx1)), F22);
+    const __m256d r = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vy0, F_x0), _mm256_mul_pd(vy1, F_x1)), F_x2);
+    const __m256d r2 = _mm256_mul_pd(r, r);
+    const __m256d F_x_norm = _mm256_add_pd(_mm256_mul_pd(F_x0, F_x0), _mm256_mul_pd(F_x1, F_x1));
+    __m256d error;
+    if (error_type == EEpipolarError::ONE_SIDED)
+    {
+      error = _mm256_div_pd(r2, F_x_norm);
+    }
+    else
+    {
+      // F^t * y
+      const __m256d Ft_y0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(F00, vy0), _mm256_mul_pd(F10, vy1)), F20);
+      const __m256d Ft_y1 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(F01, vy0), _mm256_mul_pd(F11, vy1)), F21);
+      const __m256d Ft_y_norm = _mm256_add_pd(_mm256_mul_pd(Ft_y0, Ft_y0), _mm256_mul_pd(Ft_y1, Ft_y1));
+      if (error_type == EEpipolarError::SAMPSON)
+        error = _mm256_div_pd(r2, _mm256_add_pd(F_x_norm, Ft_y_norm));
+      else
+        error = _mm256_mul_pd(_mm256_mul_pd(r2,
+          _mm256_add_pd(_mm256_div_pd(one, F_x_norm), _mm256_div_pd(one, Ft_y_norm))), quarter);
+    }
+    _mm256_storeu_pd(errors + i, error);
+  }
+  for (; i < count; ++i)
+    errors[i] = EpipolarError(F, x0[i], x1[i], y0[i], y1[i], error_type);
+}
+
+inline double HomographyError
+(
+  const Mat3 & H,
+  const double x0, const double x1,
+  const double y0, const double y1
+)
+{
+  const double H_x0 = H(0,0) * x0 + H(0,1) * x1 + H(0,2);
+  const double H_x1 = H(1,0) * x0 + H(1,1) * x1 + H(1,2);
+  const double H_x2 = H(2,0) * x0 + H(2,1) * x1 + H(2,2);
+  const double d0 = y0 - H_x0 / H_x2, d1 = y1 - H_x1 / H_x2;
+  return d0 * d0 + d1 * d1;
+}
+
+OPENMVG_TARGET("avx2")
+void HomographyErrors_AVX2_Impl
+(
+  const Mat3 & H,
+  const double * x0, const double * x1,
+  const double * y0, const double * y1,
+  const Eigen::Index count,
+  double * errors
+)
+{
+  const __m256d H00 = _mm256_set1_pd(H(0,0)), H01 = _mm256_set1_pd(H(0,1)), H02 = _mm256_set1_pd(H(0,2));
+  const __m256d H10 = _mm256_set1_pd(H(1,0)), H11 = _mm256_set1_pd(H(1,1)), H12 = _mm256_set1_pd(H(1,2));
+  const __m256d H20 = _mm256_set1_pd(H(2,0)), H21 = _mm256_set1_pd(H(2,1)), H22 = _mm256_set1_pd(H(2,2));
+  Eigen::Index i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m256d vx0 = _mm256_loadu_pd(x0 + i), vx1 = _mm256_loadu_pd(x1 + i);
+    const __m256d H_x0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(H00, vx0), _mm256_mul_pd(H01, vx1)), H02);
+    const __m256d H_x1 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(H10, vx0), _mm256_mul_pd(H11, vx1)), H12);
+    const __m256d H_x2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(H20, vx0), _mm256_mul_pd(H21, vx1)), H22);
+    const __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(y0 + i), _mm256_div_pd(H_x0, H_x2));
+    const __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(y1 + i), _mm256_div_pd(H_x1, H_x2));
+    _mm256_storeu_pd(errors + i, _mm256_add_pd(_mm256_mul_pd(d0, d0), _mm256_mul_pd(d1, d1)));
+  }
+  for (; i < count; ++i)
+    errors[i] = HomographyError(H, x0[i], x1[i], y0[i], y1[i]);
+}
+
+inline double ResectionError
+(
+  const Mat34 & P,
+  const double x0, const double x1,
+  const double X0, const double X1, const double X2
+)
+{
+  const double P_X0 = P(0,0) * X0 + P(0,1) * X1 + P(0,2) * X2 + P(0,3);
+  const double P_X1 = P(1,0) * X0 + P(1,1) * X1 + P(1,2) * X2 + P(1,3);
+  const double P_X2 = P(2,0) * X0 + P(2,1) * X1 + P(2,2) * X2 + P(2,3);
+  const double d0 = x0 - P_X0 / P_X2, d1 = x1 - P_X1 / P_X2;
+  return d0 * d0 + d1 * d1;
+}
+
+OPENMVG_TARGET("avx2")
+void ResectionErrors_AVX2_Impl
+(
+  const Mat34 & P,
+  const double * x0, const double * x1,
+  const double * X0, const double * X1, const double * X2,
+  const Eigen::Index count,
+  double * errors
+)
+{
+  __m256d P_coeffs[3][4];
+  for (int r = 0; r < 3; ++r)
+    for (int c = 0; c < 4; ++c)
+      P_coeffs[r][c] = _mm256_set1_pd(P(r, c));
+  Eigen::Index i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m256d vX0 = _mm256_loadu_pd(X0 + i), vX1 = _mm256_loadu_pd(X1 + i), vX2 = _mm256_loadu_pd(X2 + i);
+    __m256d P_X[3];
+    for (int r = 0; r < 3; ++r)
+    {
+      P_X[r] = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(P_coeffs[r][0], vX0), _mm256_mul_pd(P_coeffs[r][1], vX1)),
+        _mm256_add_pd(_mm256_mul_pd(P_coeffs[r][2], vX2), P_coeffs[r][3]));
+    }
+    const __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(x0 + i), _mm256_div_pd(P_X[0], P_X[2]));
+    const __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(x1 + i), _mm256_div_pd(P_X[1], P_X[2]));
+    _mm256_storeu_pd(errors + i, _mm256_add_pd(_mm256_mul_pd(d0, d0), _mm256_mul_pd(d1, d1)));
+  }
+  for (; i < count; ++i)
+    errors[i] = ResectionError(P, x0[i], x1[i], X0[i], X1[i], X2[i]);
+}
+
+/// Cosine of the angle between x2 and the epipolar plane normal E x1
+inline double AngularErrorCosine
+(
+  const Mat3 & E,
+  const double x10, const double x11, const double x12,
+  const double x20, const double x21, const double x22
+)
+{
+  const double Em1_0 = E(0,0) * x10 + E(0,1) * x11 + E(0,2) * x12;
+  const double Em1_1 = E(1,0) * x10 + E(1,1) * x11 + E(1,2) * x12;
+  const double Em1_2 = E(2,0) * x10 + E(2,1) * x11 + E(2,2) * x12;
+  return (x20 * Em1_0 + x21 * Em1_1 + x22 * Em1_2)
+    / std::sqrt(Em1_0 * Em1_0 + Em1_1 * Em1_1 + Em1_2 * Em1_2);
+}
+
+OPENMVG_TARGET("avx2")
+void AngularErrorCosines_AVX2_Impl
+(
+  const Mat3 & E,
+  const double * const x1[3],
+  const double * const x2[3],
+  const Eigen::Index count,
+  double * cosines
+)
+{
+  __m256d E_coeffs[3][3];
+  for (int r = 0; r < 3; ++r)
+    for (int c = 0; c < 3; ++c)
+      E_coeffs[r][c] = _mm256_set1_pd(E(r, c));
+  Eigen::Index i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m256d vx10 = _mm256_loadu_pd(x1[0] + i), vx11 = _mm256_loadu_pd(x1[1] + i),
+      vx12 = _mm256_loadu_pd(x1[2] + i);
+    __m256d dot = _mm256_setzero_pd(), norm = _mm256_setzero_pd();
+    for (int r = 0; r < 3; ++r)
+    {
+      const __m256d Em1 = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(E_coeffs[r][0], vx10), _mm256_mul_pd(E_coeffs[r][1], vx11)),
+        _mm256_mul_pd(E_coeffs[r][2], vx12));
+      dot = _mm256_add_pd(dot, _mm256_mul_pd(_mm256_loadu_pd(x2[r] + i), Em1));
+      norm = _mm256_add_pd(norm, _mm256_mul_pd(Em1, Em1));
+    }
+    _mm256_storeu_pd(cosines + i, _mm256_div_pd(dot, _mm256_sqrt_pd(norm)));
+  }
+  for (; i < count; ++i)
+  {
+    cosines[i] = AngularErrorCosine(E,
+      x1[0][i], x1[1][i], x1[2][i], x2[0][i], x2[1][i], x2[2][i]);
+  }
+}
+
+} // namespace
+
+bool EpipolarErrors_AVX2
+(
+  const Mat3 & F,
+  const RMat & x,
+  const RMat & y,
+  const EEpipolarError error_type,
+  double * errors
+)
+{
+  if (!SupportAVX2())
+    return false;
+  EpipolarErrors_AVX2_Impl(F, x.row(0).data(), x.row(1).data(),
+    y.row(0).data(), y.row(1).data(), x.cols(), error_type, errors);
+  return true;
+}
+
+bool HomographyErrors_AVX2
+(
+  const Mat3 & H,
+  const RMat & x,
+  const RMat & y,
+  double * errors
+)
+{
+  if (!SupportAVX2())
+    return false;
+  HomographyErrors_AVX2_Impl(H, x.row(0).data(), x.row(1).data(),
+    y.row(0).data(), y.row(1).data(), x.cols(), errors);
+  return true;
+}
+
+bool ResectionErrors_AVX2
+(
+  const Mat34 & P,
+  const RMat & x,
+  const RMat & X,
+  double * errors
+)
+{
+  if (!SupportAVX2())
+    return false;
+  ResectionErrors_AVX2_Impl(P, x.row(0).data(), x.row(1).data(),
+    X.row(0).data(), X.row(1).data(), X.row(2).data(), x.cols(), errors);
+  return true;
+}
+
+bool AngularErrors_AVX2
+(
+  const Mat3 & E,
+  const RMat & x1,
+  const RMat & x2,
+  double * errors
+)
+{
+  if (!SupportAVX2())
+    return false;
+  const double * const x1_rows[3] = {x1.row(0).data(), x1.row(1).data(), x1.row(2).data()};
+  const double * const x2_rows[3] = {x2.row(0).data(), x2.row(1).data(), x2.row(2).data()};
+  AngularErrorCosines_AVX2_Impl(E, x1_rows, x2_rows, x1.cols(), errors);
+  // There is no vectorized asin
+  for (Eigen::Index i = 0; i < x1.cols(); ++i)
+    errors[i] = std::abs(std::asin(errors[i]));
+  return true;
+}
+
+} // namespace batched
+} // namespace openMVG
@@ -0,0 +1,73 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_MULTIVIEW_SOLVER_BATCHED_ERRORS_HPP
+#define OPENMVG_MULTIVIEW_SOLVER_BATCHED_ERRORS_HPP
+
+#include "openMVG/numeric/eigen_alias_definition.hpp"
+
+/*
+* AVX2 kernels of the batched (SoA) Errors functions of the solvers.
+* - The points are stored one coordinate per row (SoA layout).
+* - The kernels are compiled for AVX2 whatever the build flags
+*   (see OPENMVG_TARGET), they are selected once at runtime.
+* - They return false, without computing anything, if the running CPU does
+*   not support AVX2: the caller then uses its generic Eigen expression.
+*/
+
+namespace openMVG {
+namespace batched {
+
+/// The epipolar errors of a fundamental matrix
+enum class EEpipolarError
+{
+  SAMPSON,
+  SYMMETRIC, // symmetric epipolar distance
+  ONE_SIDED  // epipolar distance in the second image
+};
+
+bool EpipolarErrors_AVX2
+(
+  const Mat3 & F,
+  const RMat & x,
+  const RMat & y,
+  const EEpipolarError error_type,
+  double * errors
+);
+
+/// Asymmetric homography error: |y - H(x)|^2
+bool HomographyErrors_AVX2
+(
+  const Mat3 & H,
+  const RMat & x,
+  const RMat & y,
+  double * errors
+);
+
+/// Squared pixel reprojection error: |x - P(X)|^2
+bool ResectionErrors_AVX2
+(
+  const Mat34 & P,
+  const RMat & x,
+  const RMat & X,
+  double * errors
+);
+
+/// Angular error of an essential matrix on bearing vectors: |asin(x2.(E x1)/|E x1|)|
+bool AngularErrors_AVX2
+(
+  const Mat3 & E,
+  const RMat & x1,
+  const RMat & x2,
+  double * errors
+);
+
+} // namespace batched
+} // namespace openMVG
+
+#endif // OPENMVG_MULTIVIEW_SOLVER_BATCHED_ERRORS_HPP
@@ -7,6 +7,7 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include "openMVG/multiview/solver_essential_eight_point.hpp"
+#include "openMVG/multiview/solver_batched_errors.hpp"
 #include "openMVG/numeric/extract_columns.hpp"
 #include "openMVG/multiview/solver_fundamental_kernel.hpp"
 
@@ -59,4 +60,23 @@ double AngularError::Error
   return std::abs(std::asin(angleVal));
 }
 
+void AngularError::Errors
+(
+  const Mat3 & model,
+  const RMat & x1,
+  const RMat & x2,
+  Eigen::Ref<Vec> errors
+)
+{
+  if (batched::AngularErrors_AVX2(model, x1, x2, errors.data()))
+    return;
+  const auto x10 = x1.row(0).array(), x11 = x1.row(1).array(), x12 = x1.row(2).array();
+  const auto Em1_0 = model(0,0) * x10 + model(0,1) * x11 + model(0,2) * x12;
+  const auto Em1_1 = model(1,0) * x10 + model(1,1) * x11 + model(1,2) * x12;
+  const auto Em1_2 = model(2,0) * x10 + model(2,1) * x11 + model(2,2) * x12;
+  errors.transpose().array() =
+    ((x2.row(0).array() * Em1_0 + x2.row(1).array() * Em1_1 + x2.row(2).array() * Em1_2)
+      / (Em1_0.square() + Em1_1.square() + Em1_2.square()).sqrt()).asin().abs();
+}
+
 } // namespace openMVG
@@ -39,6 +39,15 @@ struct AngularError
     const Vec3 & x1,
     const Vec3 & x2
   );
+
+  // Batched version: x1, x2 store one coordinate per row (SoA layout)
+  static void Errors
+  (
+    const Mat3 & model,
+    const RMat & x1,
+    const RMat & x2,
+    Eigen::Ref<Vec> errors
+  );
 };
 
 } // namespace openMVG
@@ -152,6 +152,25 @@ TEST(ThreePointsRelativePoseUpright, RelativePose_Kernel_IdFocal) {
   }
 }
 
+TEST(AngularError, Batched_Errors) {
+  // Odd number of points to exercise the non vectorized tail
+  const int n = 1001;
+  const Mat3 E = CrossProductMatrix(Vec3(0.1, -0.2, 1.0).normalized())
+    * RotationAroundY(0.2);
+  Mat x1 = Mat::Random(3, n), x2 = Mat::Random(3, n);
+  x1.row(2).array() += 2.0;
+  x2.row(2).array() += 2.0;
+  x1.colwise().normalize();
+  x2.colwise().normalize();
+
+  const RMat x1_soa = x1, x2_soa = x2;
+  Vec errors(n);
+  AngularError::Errors(E, x1_soa, x2_soa, errors);
+  for (int i = 0; i < n; ++i) {
+    EXPECT_NEAR(AngularError::Error(E, x1.col(i), x2.col(i)), errors(i), 1e-10);
+  }
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
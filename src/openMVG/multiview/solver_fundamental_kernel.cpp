@@ -28,6 +28,7 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include "openMVG/multiview/solver_fundamental_kernel.hpp"
+#include "openMVG/multiview/solver_batched_errors.hpp"
 #include "openMVG/numeric/numeric.h"
 #include "openMVG/numeric/poly.h"
 
@@ -165,6 +166,69 @@ double EpipolarDistanceError::Error
   return Square(F_x.dot(y.homogeneous())) /  F_x.head<2>().squaredNorm();
 }
 
+// The batched versions use the AVX2 kernels when the CPU supports them.
+// Else they compute the epipolar lines coordinate-wise on the point rows:
+//  the expressions are evaluated lazily in a single vectorized pass.
+
+void SampsonError::Errors
+(
+  const Mat3 &F, const RMat &x, const RMat &y, Eigen::Ref<Vec> errors
+)
+{
+  if (batched::EpipolarErrors_AVX2(F, x, y, batched::EEpipolarError::SAMPSON, errors.data()))
+    return;
+  const auto x0 = x.row(0).array(), x1 = x.row(1).array();
+  const auto y0 = y.row(0).array(), y1 = y.row(1).array();
+  // F * x
+  const auto F_x0 = F(0,0) * x0 + F(0,1) * x1 + F(0,2);
+  const auto F_x1 = F(1,0) * x0 + F(1,1) * x1 + F(1,2);
+  const auto F_x2 = F(2,0) * x0 + F(2,1) * x1 + F(2,2);
+  // F^t * y
+  const auto Ft_y0 = F(0,0) * y0 + F(1,0) * y1 + F(2,0);
+  const auto Ft_y1 = F(0,1) * y0 + F(1,1) * y1 + F(2,1);
+  errors.transpose().array() = (y0 * F_x0 + y1 * F_x1 + F_x2).square()
+    / (F_x0.square() + F_x1.square() + Ft_y0.square() + Ft_y1.square());
+}
+
+void SymmetricEpipolarDistanceError::Errors
+(
+  const Mat3 &F, const RMat &x, const RMat &y, Eigen::Ref<Vec> errors
+)
+{
+  if (batched::EpipolarErrors_AVX2(F, x, y, batched::EEpipolarError::SYMMETRIC, errors.data()))
+    return;
+  const auto x0 = x.row(0).array(), x1 = x.row(1).array();
+  const auto y0 = y.row(0).array(), y1 = y.row(1).array();
+  // F * x
+  const auto F_x0 = F(0,0) * x0 + F(0,1) * x1 + F(0,2);
+  const auto F_x1 = F(1,0) * x0 + F(1,1) * x1 + F(1,2);
+  const auto F_x2 = F(2,0) * x0 + F(2,1) * x1 + F(2,2);
+  // F^t * y
+  const auto Ft_y0 = F(0,0) * y0 + F(1,0) * y1 + F(2,0);
+  const auto Ft_y1 = F(0,1) * y0 + F(1,1) * y1 + F(2,1);
+  errors.transpose().array() = (y0 * F_x0 + y1 * F_x1 + F_x2).square()
+    * ((F_x0.square() + F_x1.square()).inverse()
+      + (Ft_y0.square() + Ft_y1.square()).inverse())
+    / 4.0;
+}
+
+void EpipolarDistanceError::Errors
+(
+  const Mat3 &F, const RMat &x, const RMat &y, Eigen::Ref<Vec> errors
+)
+{
+  if (batched::EpipolarErrors_AVX2(F, x, y, batched::EEpipolarError::ONE_SIDED, errors.data()))
+    return;
+  const auto x0 = x.row(0).array(), x1 = x.row(1).array();
+  const auto y0 = y.row(0).array(), y1 = y.row(1).array();
+  // F * x
+  const auto F_x0 = F(0,0) * x0 + F(0,1) * x1 + F(0,2);
+  const auto F_x1 = F(1,0) * x0 + F(1,1) * x1 + F(1,2);
+  const auto F_x2 = F(2,0) * x0 + F(2,1) * x1 + F(2,2);
+  errors.transpose().array() = (y0 * F_x0 + y1 * F_x1 + F_x2).square()
+    / (F_x0.square() + F_x1.square());
+}
+
 }  // namespace kernel
 }  // namespace fundamental
 }  // namespace openMVG
@@ -92,17 +92,25 @@ inline void EncodeEpipolarEquation(const TMatX &x1, const TMatX &x2, TMatA *A) {
   }
 }
 
+// The batched Errors functions compute the error of all the correspondences at once.
+// The points are stored one coordinate per row (2xN RowMajor: SoA layout).
+// They use the AVX2 kernels of solver_batched_errors.hpp if the running CPU
+//  supports them (selected at runtime), else a generic Eigen expression.
+
 /// Compute SampsonError related to the Fundamental matrix and 2 correspondences
 struct SampsonError {
   static double Error(const Mat3 &F, const Vec2 &x, const Vec2 &y);
+  static void Errors(const Mat3 &F, const RMat &x, const RMat &y, Eigen::Ref<Vec> errors);
 };
 
 struct SymmetricEpipolarDistanceError {
   static double Error(const Mat3 &F, const Vec2 &x, const Vec2 &y);
+  static void Errors(const Mat3 &F, const RMat &x, const RMat &y, Eigen::Ref<Vec> errors);
 };
 
 struct EpipolarDistanceError {
   static double Error(const Mat3 &F, const Vec2 &x, const Vec2 &y);
+  static void Errors(const Mat3 &F, const RMat &x, const RMat &y, Eigen::Ref<Vec> errors);
 };
 
 //-- Kernel solver for the 8pt Fundamental Matrix Estimation
@@ -34,6 +34,7 @@
 
 #include "testing/testing.h"
 
+#include <algorithm>
 #include <numeric>
 
 using namespace openMVG;
@@ -141,6 +142,35 @@ TEST(EightPointTest_Normalized, EasyCase) {
   EXPECT_TRUE(ExpectKernelProperties<Kernel>(x1, x2));
 }
 
+// Check that the batched (SoA) errors match the per correspondence errors
+template <class ErrorT>
+bool ExpectBatchedErrors(const Mat3 &F, const Mat &x1, const Mat &x2) {
+  const RMat x1_soa = x1, x2_soa = x2;
+  Vec errors(x1.cols());
+  ErrorT::Errors(F, x1_soa, x2_soa, errors);
+  bool bOk = true;
+  for (int i = 0; i < x1.cols(); ++i) {
+    const double expected = ErrorT::Error(F, x1.col(i), x2.col(i));
+    bOk &= std::abs(errors(i) - expected) <= 1e-10 * std::max(1.0, expected);
+  }
+  return bOk;
+}
+
+TEST(FundamentalErrors, Batched) {
+  // Odd number of points to exercise the non vectorized tail
+  const int n = 1001;
+  const Mat x1 = Mat::Random(2, n) * 100.0;
+  const Mat x2 = Mat::Random(2, n) * 100.0;
+  Mat3 F;
+  F << 1e-6, -2e-5,  3e-3,
+       4e-5,  1e-6, -6e-3,
+      -7e-3,  8e-3,  1.0;
+
+  EXPECT_TRUE(ExpectBatchedErrors<fundamental::kernel::SampsonError>(F, x1, x2));
+  EXPECT_TRUE(ExpectBatchedErrors<fundamental::kernel::SymmetricEpipolarDistanceError>(F, x1, x2));
+  EXPECT_TRUE(ExpectBatchedErrors<fundamental::kernel::EpipolarDistanceError>(F, x1, x2));
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "openMVG/multiview/projection.hpp"
+#include "openMVG/multiview/solver_batched_errors.hpp"
 #include "openMVG/multiview/two_view_kernel.hpp"
 
 namespace openMVG {
@@ -60,6 +61,19 @@ struct AsymmetricError {
   static double Error(const Mat &H, const Vec2 &x, const Vec2 &y) {
     return (y - Vec3( H * x.homogeneous()).hnormalized() ).squaredNorm();
   }
+
+  /// Batched version: x, y store one coordinate per row (SoA layout)
+  static void Errors(const Mat &H, const RMat &x, const RMat &y, Eigen::Ref<Vec> errors) {
+    if (batched::HomographyErrors_AVX2(H, x, y, errors.data()))
+      return;
+    const auto x0 = x.row(0).array(), x1 = x.row(1).array();
+    const auto H_x0 = H(0,0) * x0 + H(0,1) * x1 + H(0,2);
+    const auto H_x1 = H(1,0) * x0 + H(1,1) * x1 + H(1,2);
+    const auto H_x2 = H(2,0) * x0 + H(2,1) * x1 + H(2,2);
+    errors.transpose().array() =
+      (y.row(0).array() - H_x0 / H_x2).square() +
+      (y.row(1).array() - H_x1 / H_x2).square();
+  }
 };
 
 // Kernel that works on original data point
@@ -31,6 +31,7 @@
 
 #include "testing/testing.h"
 
+#include <algorithm>
 #include <vector>
 
 using namespace std;
@@ -114,6 +115,25 @@ TEST(HomographyKernelTest, Fitting_Normalized) {
   }
 }
 
+TEST(HomographyKernelTest, Batched_Errors) {
+  // Odd number of points to exercise the non vectorized tail
+  const int n = 1001;
+  const Mat x = Mat::Random(2, n) * 100.0;
+  const Mat y = Mat::Random(2, n) * 100.0;
+  Mat3 H;
+  H << 1, -2e-1,  3,
+       4e-1,  5, -6,
+      -7e-4,  8e-4,  1;
+
+  const RMat x_soa = x, y_soa = y;
+  Vec errors(n);
+  homography::kernel::AsymmetricError::Errors(H, x_soa, y_soa, errors);
+  for (int i = 0; i < n; ++i) {
+    const double expected = homography::kernel::AsymmetricError::Error(H, x.col(i), y.col(i));
+    EXPECT_NEAR(expected, errors(i), 1e-10 * std::max(1.0, expected));
+  }
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -6,6 +6,7 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include "openMVG/multiview/projection.hpp"
 #include "openMVG/multiview/solver_resection_kernel.hpp"
 #include "openMVG/multiview/solver_resection_p3p.hpp"
 #include "openMVG/multiview/solver_resection_up2p_kukelova.hpp"
@@ -13,8 +14,27 @@
 
 #include "testing/testing.h"
 
+#include <algorithm>
+
 using namespace openMVG;
 
+TEST(SquaredPixelReprojectionError, Batched_Errors) {
+  // Odd number of points to exercise the non vectorized tail
+  const int n = 1001;
+  Mat34 P;
+  P_From_KRt(Mat3::Identity() * 1000.0, RotationAroundY(0.2), Vec3(0.1, -0.2, 5.0), &P);
+  const Mat3X X = Mat3X::Random(3, n);
+  const Mat2X x = Project(P, X) + Mat2X::Random(2, n);
+
+  const RMat x_soa = x, X_soa = X;
+  Vec errors(n);
+  resection::SquaredPixelReprojectionError::Errors(P, x_soa, X_soa, errors);
+  for (int i = 0; i < n; ++i) {
+    const double expected = resection::SquaredPixelReprojectionError::Error(P, x.col(i), X.col(i));
+    EXPECT_NEAR(expected, errors(i), 1e-10 * std::max(1.0, expected));
+  }
+}
+
 TEST(Resection_Kernel_DLT, Multiview) {
 
   const int nViews = 3;
@@ -9,6 +9,8 @@
 #ifndef OPENMVG_MULTIVIEW_RESECTION_METRICS_HPP
 #define OPENMVG_MULTIVIEW_RESECTION_METRICS_HPP
 
+#include "openMVG/multiview/solver_batched_errors.hpp"
+
 namespace openMVG {
 namespace resection {
 
@@ -36,6 +38,26 @@ struct SquaredPixelReprojectionError {
   {
     return (x - (P * X.homogeneous()).hnormalized()).squaredNorm();
   }
+
+  // Batched version: x, X store one coordinate per row (SoA layout)
+  static inline void Errors
+  (
+    const Mat34 & P,
+    const RMat & x,
+    const RMat & X,
+    Eigen::Ref<Vec> errors
+  )
+  {
+    if (batched::ResectionErrors_AVX2(P, x, X, errors.data()))
+      return;
+    const auto X0 = X.row(0).array(), X1 = X.row(1).array(), X2 = X.row(2).array();
+    const auto P_X0 = P(0,0) * X0 + P(0,1) * X1 + P(0,2) * X2 + P(0,3);
+    const auto P_X1 = P(1,0) * X0 + P(1,1) * X1 + P(1,2) * X2 + P(1,3);
+    const auto P_X2 = P(2,0) * X0 + P(2,1) * X1 + P(2,2) * X2 + P(2,3);
+    errors.transpose().array() =
+      (x.row(0).array() - P_X0 / P_X2).square() +
+      (x.row(1).array() - P_X1 / P_X2).square();
+  }
 };
 
 struct AngularReprojectionError {
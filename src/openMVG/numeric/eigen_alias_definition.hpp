@@ -109,6 +109,10 @@ namespace openMVG
   /// Unconstrained vector using double internal format
   using Vec = Eigen::VectorXd;
 
+  /// Unconstrained matrix using double internal format with RowMajor storage
+  /// (one coordinate per row: structure of arrays layout for point sets)
+  using RMat = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
   /// Unconstrained vector using unsigned int internal format
   using Vecu = Eigen::Matrix<unsigned int, Eigen::Dynamic, 1>;
 
@@ -10,7 +10,10 @@
 #define OPENMVG_ROBUST_ESTIMATION_GUIDED_MATCHING_HPP
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <numeric>
 #include <vector>
 
 #include "openMVG/cameras/Camera_Intrinsics.hpp"
@@ -392,6 +395,363 @@ void GuidedMatching_Fundamental_Fast(
   }
 }
 
+/// Uniform grid bucketing of 2D points.
+/// The point indices are stored cell by cell in a single array
+///  (cell_offsets_ gives the range of each cell).
+/// Used to retrieve the points that lie close to a position or to a line
+///  without looking at all the points.
+class Point_Grid
+{
+public:
+  /// Build the grid of the points
+  /// The cell size is enlarged if required to keep the number of cells
+  ///  in the order of the number of points (at most 4 cells per point, even
+  ///  for degenerate point sets, i.e. aligned points).
+  /// The non finite points are not stored in the grid.
+  Point_Grid(const std::vector<Vec2> & points, double cell_size)
+  {
+    size_t finite_count = 0;
+    Vec2 min_pt = Vec2::Zero(), max_pt = Vec2::Zero();
+    for (const Vec2 & pt : points)
+    {
+      if (!pt.allFinite())
+        continue;
+      min_pt = finite_count ? min_pt.cwiseMin(pt) : pt;
+      max_pt = finite_count ? max_pt.cwiseMax(pt) : pt;
+      ++finite_count;
+    }
+    if (finite_count == 0)
+      return;
+
+    const Vec2 extent = max_pt - min_pt;
+    cell_size = std::max(cell_size, 0.5 * std::sqrt(extent.prod() / finite_count));
+    if (!(cell_size > 0.0))
+      cell_size = 1.0;
+    const double max_cell_count = 4.0 * finite_count;
+    while ((std::floor(extent(0) / cell_size) + 1.0)
+           * (std::floor(extent(1) / cell_size) + 1.0) > max_cell_count)
+      cell_size *= 2.0;
+
+    origin_ = min_pt;
+    cell_size_ = cell_size;
+    cols_ = static_cast<int>(extent(0) / cell_size_) + 1;
+    rows_ = static_cast<int>(extent(1) / cell_size_) + 1;
+
+    // Count the points per cell and fill the cells
+    const uint32_t kNoCell = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> point_cells(points.size(), kNoCell);
+    cell_offsets_.assign(static_cast<size_t>(cols_) * rows_ + 1, 0);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      if (!points[i].allFinite())
+        continue;
+      const int col = std::min(static_cast<int>((points[i](0) - origin_(0)) / cell_size_), cols_ - 1);
+      const int row = std::min(static_cast<int>((points[i](1) - origin_(1)) / cell_size_), rows_ - 1);
+      point_cells[i] = static_cast<uint32_t>(row) * cols_ + col;
+      ++cell_offsets_[point_cells[i] + 1];
+    }
+    std::partial_sum(cell_offsets_.begin(), cell_offsets_.end(), cell_offsets_.begin());
+    std::vector<uint32_t> cell_fill(cell_offsets_.begin(), cell_offsets_.end() - 1);
+    indices_.resize(finite_count);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      if (point_cells[i] != kNoCell)
+        indices_[cell_fill[point_cells[i]]++] = static_cast<IndexT>(i);
+    }
+  }
+
+  /// Number of cells of the grid
+  size_t CellCount() const { return static_cast<size_t>(cols_) * rows_; }
+
+  /// Append the points of the cells that intersect the [min_pt, max_pt] box
+  void Box(const Vec2 & min_pt, const Vec2 & max_pt, std::vector<IndexT> & candidates) const
+  {
+    int col_start, col_stop, row_start, row_stop;
+    if (!CellRange(min_pt(0), max_pt(0), origin_(0), cols_, col_start, col_stop) ||
+        !CellRange(min_pt(1), max_pt(1), origin_(1), rows_, row_start, row_stop))
+      return;
+    for (int row = row_start; row <= row_stop; ++row)
+      AppendCells(row * cols_ + col_start, row * cols_ + col_stop, candidates);
+  }
+
+  /// Append the points of the cells that intersect the band of the given
+  ///  half width around the line (a*x + b*y + c = 0)
+  void Band(const Vec3 & line, const double half_width, std::vector<IndexT> & candidates) const
+  {
+    const double norm = line.head<2>().norm();
+    if (!(norm > 0.0) || !std::isfinite(norm))
+      return;
+    const Vec3 l = line / norm;
+    if (std::abs(l(1)) >= std::abs(l(0)))
+    {
+      // Close to horizontal line: scan the columns and find the rows the band crosses
+      const double half_height = half_width / std::abs(l(1));
+      for (int col = 0; col < cols_; ++col)
+      {
+        const double
+          x0 = origin_(0) + col * cell_size_,
+          x1 = x0 + cell_size_,
+          y0 = -(l(0) * x0 + l(2)) / l(1),
+          y1 = -(l(0) * x1 + l(2)) / l(1);
+        int row_start, row_stop;
+        if (!CellRange(std::min(y0, y1) - half_height, std::max(y0, y1) + half_height,
+                       origin_(1), rows_, row_start, row_stop))
+          continue;
+        for (int row = row_start; row <= row_stop; ++row)
+          AppendCells(row * cols_ + col, row * cols_ + col, candidates);
+      }
+    }
+    else
+    {
+      // Close to vertical line: scan the rows and find the columns the band crosses
+      const double half_width_x = half_width / std::abs(l(0));
+      for (int row = 0; row < rows_; ++row)
+      {
+        const double
+          y0 = origin_(1) + row * cell_size_,
+          y1 = y0 + cell_size_,
+          x0 = -(l(1) * y0 + l(2)) / l(0),
+          x1 = -(l(1) * y1 + l(2)) / l(0);
+        int col_start, col_stop;
+        if (!CellRange(std::min(x0, x1) - half_width_x, std::max(x0, x1) + half_width_x,
+                       origin_(0), cols_, col_start, col_stop))
+          continue;
+        AppendCells(row * cols_ + col_start, row * cols_ + col_stop, candidates);
+      }
+    }
+  }
+
+private:
+  /// Compute the cell range covered by the [lo, hi] interval along an axis
+  /// Return false if the interval does not intersect the grid
+  bool CellRange
+  (
+    const double lo, const double hi,
+    const double origin, const int count,
+    int & start, int & stop
+  ) const
+  {
+    const double
+      lo_cell = std::floor((lo - origin) / cell_size_),
+      hi_cell = std::floor((hi - origin) / cell_size_);
+    if (!(hi_cell >= 0.0) || !(lo_cell < count))
+      return false;
+    start = static_cast<int>(std::max(lo_cell, 0.0));
+    stop = static_cast<int>(std::min(hi_cell, count - 1.0));
+    return true;
+  }
+
+  /// Append the points of the [cell_start, cell_stop] consecutive cells
+  void AppendCells(const int cell_start, const int cell_stop, std::vector<IndexT> & candidates) const
+  {
+    candidates.insert(candidates.end(),
+      indices_.begin() + cell_offsets_[cell_start],
+      indices_.begin() + cell_offsets_[cell_stop + 1]);
+  }
+
+  Vec2 origin_ = Vec2::Zero();
+  double cell_size_ = 1.0;
+  int cols_ = 0, rows_ = 0;
+  std::vector<uint32_t> cell_offsets_;
+  std::vector<IndexT> indices_;
+};
+
+namespace internal {
+
+/// Undistorted positions of the regions (camera can be nullptr)
+inline std::vector<Vec2> UndistortedRegionsPositions
+(
+  const cameras::IntrinsicBase * cam,
+  const features::Regions & regions
+)
+{
+  std::vector<Vec2> positions(regions.RegionCount());
+  for (size_t i = 0; i < regions.RegionCount(); ++i) {
+    positions[i] = cam ? cam->get_ud_pixel(regions.GetRegionPosition(i)) : regions.GetRegionPosition(i);
+  }
+  return positions;
+}
+
+/// Guided matching over a candidate subset of the right regions.
+/// The CandidatesFunctor(i, candidates) appends the right regions that may
+///  agree with the model for the left region i. The model error is checked
+///  on each candidate, and the candidates are visited in index order, so the
+///  result is the same as the exhaustive GuidedMatching.
+template<
+  typename ModelArg,
+  typename ErrorArg,
+  typename CandidatesFunctor>
+void GuidedMatching_Candidates(
+  const ModelArg & mod,
+  const std::vector<Vec2> & lRegionsPos,
+  const features::Regions & lRegions,
+  const std::vector<Vec2> & rRegionsPos,
+  const features::Regions & rRegions,
+  double errorTh,
+  double distRatio,
+  const CandidatesFunctor & candidates_functor,
+  matching::IndMatches & vec_corresponding_index)
+{
+  std::vector<IndexT> candidates;
+  for (size_t i = 0; i < lRegionsPos.size(); ++i) {
+    candidates.clear();
+    candidates_functor(i, candidates);
+    std::sort(candidates.begin(), candidates.end());
+
+    distanceRatio<double> dR;
+    for (const IndexT j : candidates) {
+      // Compute the geometric error: error to the model
+      const double geomErr = ErrorArg::Error(mod, lRegionsPos[i], rRegionsPos[j]);
+      if (geomErr < errorTh) {
+        // Update the corresponding points & distance (if required)
+        dR.update(j, lRegions.SquaredDescriptorDistance(i, &rRegions, j));
+      }
+    }
+    // Add correspondence only iff the distance ratio is valid
+    if (dR.isValid(distRatio))  {
+      vec_corresponding_index.push_back(matching::IndMatch(i, dR.idx));
+    }
+  }
+
+  // Remove duplicates (when multiple points at same position exist)
+  matching::IndMatch::getDeduplicated(vec_corresponding_index);
+}
+
+} // namespace internal
+
+/// Guided Matching (features only) for a point transfer model (i.e. homography):
+///  The left points are transferred in the right image and only the right
+///  points of the neighboring grid cells are tested.
+///  ErrorArg must be the squared transfer distance in the right image
+///  (i.e. homography::kernel::AsymmetricError).
+/// Same result as the exhaustive GuidedMatching.
+template<
+  typename ModelArg, // The used model type
+  typename ErrorArg> // The metric to compute distance to the model
+void GuidedMatching_Homography_Grid(
+  const ModelArg & mod, // The model
+  const Mat & xLeft,    // The left data points
+  const Mat & xRight,   // The right data points
+  double errorTh,       // Maximal authorized error threshold (squared)
+  matching::IndMatches & vec_corresponding_index) // Ouput corresponding index
+{
+  assert(xLeft.rows() == 2 && xRight.rows() == 2);
+
+  std::vector<Vec2> rPoints(xRight.cols());
+  for (Mat::Index j = 0; j < xRight.cols(); ++j)
+    rPoints[j] = xRight.col(j);
+  const double radius = std::sqrt(errorTh);
+  const Point_Grid grid(rPoints, 2.0 * radius);
+
+  std::vector<IndexT> candidates;
+  for (Mat::Index i = 0; i < xLeft.cols(); ++i) {
+    const Vec2 xL = xLeft.col(i);
+    const Vec2 transferred = (mod * xL.homogeneous()).hnormalized();
+    if (!transferred.allFinite())
+      continue;
+    candidates.clear();
+    grid.Box((transferred.array() - radius).matrix(), (transferred.array() + radius).matrix(), candidates);
+    std::sort(candidates.begin(), candidates.end());
+
+    double min = std::numeric_limits<double>::max();
+    matching::IndMatch match;
+    for (const IndexT j : candidates) {
+      const double err = ErrorArg::Error(mod, xL, rPoints[j]);
+      if (err < errorTh && err < min) {
+        min = err;
+        match = matching::IndMatch(i, j);
+      }
+    }
+    if (min < errorTh)  {
+      vec_corresponding_index.push_back(match);
+    }
+  }
+
+  // Remove duplicates (when multiple points at same position exist)
+  matching::IndMatch::getDeduplicated(vec_corresponding_index);
+}
+
+/// Guided Matching (features + descriptors with distance ratio) for a point
+///  transfer model (i.e. homography):
+///  The left points are transferred in the right image and only the right
+///  regions of the neighboring grid cells are compared.
+///  ErrorArg must be the squared transfer distance in the right image
+///  (i.e. homography::kernel::AsymmetricError).
+/// Same result as the exhaustive GuidedMatching.
+template<
+  typename ModelArg,  // The used model type
+  typename ErrorArg   // The metric to compute distance to the model
+  >
+void GuidedMatching_Homography_Grid(
+  const ModelArg & mod, // The model
+  const cameras::IntrinsicBase * camL, // Optional camera (in order to undistord on the fly feature positions, can be nullptr)
+  const features::Regions & lRegions,  // regions (point features & corresponding descriptors)
+  const cameras::IntrinsicBase * camR, // Optional camera (in order to undistord on the fly feature positions, can be nullptr)
+  const features::Regions & rRegions,  // regions (point features & corresponding descriptors)
+  double errorTh,       // Maximal authorized error threshold (squared)
+  double distRatio,     // Maximal authorized distance ratio
+  matching::IndMatches & vec_corresponding_index) // Ouput corresponding index
+{
+  const std::vector<Vec2>
+    lRegionsPos = internal::UndistortedRegionsPositions(camL, lRegions),
+    rRegionsPos = internal::UndistortedRegionsPositions(camR, rRegions);
+
+  const double radius = std::sqrt(errorTh);
+  const Point_Grid grid(rRegionsPos, 2.0 * radius);
+
+  internal::GuidedMatching_Candidates<ModelArg, ErrorArg>(
+    mod,
+    lRegionsPos, lRegions,
+    rRegionsPos, rRegions,
+    errorTh, distRatio,
+    [&](const size_t i, std::vector<IndexT> & candidates)
+    {
+      const Vec2 transferred = (mod * lRegionsPos[i].homogeneous()).hnormalized();
+      if (transferred.allFinite())
+        grid.Box((transferred.array() - radius).matrix(), (transferred.array() + radius).matrix(), candidates);
+    },
+    vec_corresponding_index);
+}
+
+/// Guided Matching (features + descriptors with distance ratio) for an
+///  epipolar model (fundamental matrix, or essential matrix converted to F):
+///  Only the right regions of the grid cells crossed by the epipolar band
+///  (epipolar line +/- the threshold) are compared.
+///  ErrorArg must be the squared distance to the epipolar line in the right
+///  image (i.e. fundamental::kernel::EpipolarDistanceError).
+/// Same result as the exhaustive GuidedMatching, unlike
+///  GuidedMatching_Fundamental_Fast no epipole nor image size is required.
+template<
+  typename ErrorArg> // The metric to compute distance to the model
+void GuidedMatching_Fundamental_Grid(
+  const Mat3 & F,       // The fundamental matrix
+  const cameras::IntrinsicBase * camL, // Optional camera (in order to undistord on the fly feature positions, can be nullptr)
+  const features::Regions & lRegions,  // regions (point features & corresponding descriptors)
+  const cameras::IntrinsicBase * camR, // Optional camera (in order to undistord on the fly feature positions, can be nullptr)
+  const features::Regions & rRegions,  // regions (point features & corresponding descriptors)
+  double errorTh,       // Maximal authorized error threshold (squared)
+  double distRatio,     // Maximal authorized distance ratio
+  matching::IndMatches & vec_corresponding_index) // Ouput corresponding index
+{
+  const std::vector<Vec2>
+    lRegionsPos = internal::UndistortedRegionsPositions(camL, lRegions),
+    rRegionsPos = internal::UndistortedRegionsPositions(camR, rRegions);
+
+  const double half_width = std::sqrt(errorTh);
+  const Point_Grid grid(rRegionsPos, 2.0 * half_width);
+
+  internal::GuidedMatching_Candidates<Mat3, ErrorArg>(
+    F,
+    lRegionsPos, lRegions,
+    rRegionsPos, rRegions,
+    errorTh, distRatio,
+    [&](const size_t i, std::vector<IndexT> & candidates)
+    {
+      grid.Band(F * lRegionsPos[i].homogeneous(), half_width, candidates);
+    },
+    vec_corresponding_index);
+}
+
 } // namespace geometry_aware
 } // namespace openMVG
 
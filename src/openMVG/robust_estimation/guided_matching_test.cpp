@@ -0,0 +1,200 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/robust_estimation/guided_matching.hpp"
+#include "openMVG/features/regions_factory.hpp"
+#include "openMVG/multiview/solver_fundamental_kernel.hpp"
+#include "openMVG/multiview/solver_homography_kernel.hpp"
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace openMVG;
+using namespace openMVG::features;
+using namespace openMVG::geometry_aware;
+
+// Add a region to the container (with a random or a perturbed descriptor)
+static void AddRegion
+(
+  const Vec2 & pos,
+  const SIFT_Regions::DescriptorT * reference_desc,
+  std::mt19937 & random_generator,
+  SIFT_Regions & regions
+)
+{
+  std::uniform_int_distribution<int> desc_dist(0, 255), noise_dist(-4, 4);
+  SIFT_Regions::DescriptorT desc;
+  for (int k = 0; k < 128; ++k)
+  {
+    desc[k] = reference_desc ?
+      static_cast<unsigned char>(std::min(255, std::max(0, (*reference_desc)[k] + noise_dist(random_generator)))) :
+      static_cast<unsigned char>(desc_dist(random_generator));
+  }
+  regions.Features().emplace_back(pos(0), pos(1));
+  regions.Descriptors().push_back(desc);
+}
+
+// Build left/right regions: the first nb_inliers right regions are the
+//  transfer of the left regions (+ noise), the others are random
+template <typename TransferFunctor>
+static void GenerateRegions
+(
+  const int nb_points,
+  const int nb_inliers,
+  const TransferFunctor & transfer,
+  SIFT_Regions & lRegions,
+  SIFT_Regions & rRegions
+)
+{
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  std::uniform_real_distribution<double> pos_dist(0.0, 1000.0), noise_dist(-0.5, 0.5);
+  for (int i = 0; i < nb_points; ++i)
+  {
+    const Vec2 xL(pos_dist(random_generator), pos_dist(random_generator));
+    AddRegion(xL, nullptr, random_generator, lRegions);
+    if (i < nb_inliers)
+    {
+      const Vec2 xR = transfer(xL) + Vec2(noise_dist(random_generator), noise_dist(random_generator));
+      AddRegion(xR, &lRegions.Descriptors().back(), random_generator, rRegions);
+    }
+    else
+    {
+      AddRegion(Vec2(pos_dist(random_generator), pos_dist(random_generator)),
+                nullptr, random_generator, rRegions);
+    }
+  }
+}
+
+TEST(GuidedMatching, Homography_Grid)
+{
+  Mat3 H;
+  H << 0.9, 0.05, 20.,
+       -0.04, 1.1, -10.,
+       1e-5, -2e-5, 1.;
+
+  SIFT_Regions lRegions, rRegions;
+  GenerateRegions(2000, 1000,
+    [&H](const Vec2 & x) -> Vec2 { return (H * x.homogeneous()).hnormalized(); },
+    lRegions, rRegions);
+
+  matching::IndMatches exhaustive_matches, grid_matches;
+  GuidedMatching<Mat3, homography::kernel::AsymmetricError>(
+    H, nullptr, lRegions, nullptr, rRegions,
+    Square(20.0), Square(0.8), exhaustive_matches);
+  GuidedMatching_Homography_Grid<Mat3, homography::kernel::AsymmetricError>(
+    H, nullptr, lRegions, nullptr, rRegions,
+    Square(20.0), Square(0.8), grid_matches);
+
+  // The distance ratio requires a second candidate in the search radius
+  EXPECT_TRUE(exhaustive_matches.size() > 800);
+  CHECK(exhaustive_matches == grid_matches);
+
+  // Position only version
+  Mat xL(2, lRegions.RegionCount()), xR(2, rRegions.RegionCount());
+  for (size_t i = 0; i < lRegions.RegionCount(); ++i)
+    xL.col(i) = lRegions.GetRegionPosition(i);
+  for (size_t j = 0; j < rRegions.RegionCount(); ++j)
+    xR.col(j) = rRegions.GetRegionPosition(j);
+
+  exhaustive_matches.clear();
+  grid_matches.clear();
+  GuidedMatching<Mat3, homography::kernel::AsymmetricError>(
+    H, xL, xR, Square(2.0), exhaustive_matches);
+  GuidedMatching_Homography_Grid<Mat3, homography::kernel::AsymmetricError>(
+    H, xL, xR, Square(2.0), grid_matches);
+
+  EXPECT_TRUE(exhaustive_matches.size() > 900);
+  CHECK(exhaustive_matches == grid_matches);
+}
+
+TEST(GuidedMatching, Fundamental_Grid)
+{
+  // Two pinhole cameras observing a scene at a random depth
+  Mat3 K;
+  K << 1000., 0., 500.,
+       0., 1000., 500.,
+       0., 0., 1.;
+  const Mat3 R = RotationAroundY(0.1) * RotationAroundX(-0.05);
+  const Vec3 t(-1.0, 0.1, 0.05);
+  const Mat3 F = K.inverse().transpose() * CrossProductMatrix(t) * R * K.inverse();
+
+  std::mt19937 depth_generator(std::mt19937::default_seed);
+  std::uniform_real_distribution<double> depth_dist(5.0, 20.0);
+  SIFT_Regions lRegions, rRegions;
+  GenerateRegions(2000, 1000,
+    [&](const Vec2 & x) -> Vec2
+    {
+      const Vec3 X = depth_dist(depth_generator) * (K.inverse() * x.homogeneous());
+      return (K * (R * X + t)).hnormalized();
+    },
+    lRegions, rRegions);
+
+  for (const double threshold : {1.0, 4.0})
+  {
+    matching::IndMatches exhaustive_matches, grid_matches;
+    GuidedMatching<Mat3, fundamental::kernel::EpipolarDistanceError>(
+      F, nullptr, lRegions, nullptr, rRegions,
+      Square(threshold), Square(0.8), exhaustive_matches);
+    GuidedMatching_Fundamental_Grid<fundamental::kernel::EpipolarDistanceError>(
+      F, nullptr, lRegions, nullptr, rRegions,
+      Square(threshold), Square(0.8), grid_matches);
+
+    EXPECT_TRUE(exhaustive_matches.size() > 500);
+    CHECK(exhaustive_matches == grid_matches);
+  }
+}
+
+TEST(GuidedMatching, Grid_EmptyRegions)
+{
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  SIFT_Regions lRegions, rRegions;
+  AddRegion(Vec2(10., 10.), nullptr, random_generator, lRegions);
+
+  matching::IndMatches matches;
+  GuidedMatching_Fundamental_Grid<fundamental::kernel::EpipolarDistanceError>(
+    Mat3::Identity(), nullptr, lRegions, nullptr, rRegions,
+    Square(4.0), Square(0.8), matches);
+  EXPECT_EQ(0, matches.size());
+  GuidedMatching_Homography_Grid<Mat3, homography::kernel::AsymmetricError>(
+    Mat3::Identity(), nullptr, rRegions, nullptr, lRegions,
+    Square(4.0), Square(0.8), matches);
+  EXPECT_EQ(0, matches.size());
+}
+
+TEST(GuidedMatching, Grid_DegeneratePoints)
+{
+  // Aligned points spread over a large range, and a non finite point
+  std::vector<Vec2> points;
+  for (int i = 0; i < 100; ++i)
+    points.emplace_back(i * 1.0e4, 5.0);
+  points.emplace_back(std::numeric_limits<double>::infinity(), 5.0);
+
+  const Point_Grid grid(points, 1.0);
+  EXPECT_TRUE(grid.CellCount() <= 4 * points.size());
+
+  // The queries still return the points of the searched area
+  std::vector<IndexT> candidates;
+  grid.Box(Vec2(2.0e4 - 1.0, 4.0), Vec2(2.0e4 + 1.0, 6.0), candidates);
+  EXPECT_TRUE(std::find(candidates.cbegin(), candidates.cend(), 2) != candidates.cend());
+  EXPECT_TRUE(std::find(candidates.cbegin(), candidates.cend(), 100) == candidates.cend());
+  candidates.clear();
+  grid.Band(Vec3(0.0, 1.0, -5.0), 1.0, candidates);
+  EXPECT_EQ(100, candidates.size());
+
+  // Points at the same position
+  const Point_Grid single_cell_grid(std::vector<Vec2>(10, Vec2(3.0, 3.0)), 1.0);
+  EXPECT_EQ(1, single_cell_grid.CellCount());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
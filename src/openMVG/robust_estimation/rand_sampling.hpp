@@ -10,9 +10,13 @@
 #define OPENMVG_ROBUST_ESTIMATION_RAND_SAMPLING_HPP
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <random>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace openMVG {
@@ -100,6 +104,94 @@ bool UniformSample
 }
 
 
+/**
+* PROSAC sampling (progressive sample consensus):
+*  the samples are drawn from a growing subset of the best ranked data.
+*  The first samples use the top ranked data only, the sampling becomes
+*  uniform once max_iterations samples have been drawn.
+*
+* Ondrej Chum and Jiri Matas.
+* Matching with PROSAC - Progressive Sample Consensus. CVPR 2005.
+*/
+class ProsacSampler
+{
+public:
+  /**
+  * \param[in] ranking        Data indices sorted from the best to the worst ranked.
+  * \param[in] sample_size    The number of samples to produce per draw.
+  * \param[in] max_iterations The number of draws after which the sampling is uniform.
+  */
+  ProsacSampler
+  (
+    std::vector<uint32_t> ranking,
+    const uint32_t sample_size,
+    const uint32_t max_iterations
+  ):
+    ranking_(std::move(ranking)),
+    m_(sample_size),
+    N_(static_cast<uint32_t>(ranking_.size())),
+    n_(sample_size),
+    T_n_(max_iterations),
+    T_n_prime_(1),
+    t_(0)
+  {
+    // Average number of samples drawn from the m first data among T_N samples
+    for (uint32_t i = 0; i < m_ && i < N_; ++i)
+      T_n_ *= static_cast<double>(n_ - i) / (N_ - i);
+  }
+
+  /**
+  * Draw a sample.
+  * \param[in] random_generator The random number generator.
+  * \param[out] samples         sample_size data indices.
+  * \return true if the sampling can be performed
+  */
+  template <class RandomGeneratorT>
+  bool Sample
+  (
+    RandomGeneratorT &random_generator,
+    std::vector<uint32_t> *samples
+  )
+  {
+    if (m_ == 0 || N_ < m_)
+      return false;
+
+    ++t_;
+    // Grow the sampling subset
+    if (t_ > T_n_prime_ && n_ < N_)
+    {
+      const double T_n_next = T_n_ * (n_ + 1) / (n_ + 1 - m_);
+      T_n_prime_ += static_cast<uint32_t>(std::ceil(T_n_next - T_n_));
+      T_n_ = T_n_next;
+      ++n_;
+    }
+
+    if (t_ > T_n_prime_ || n_ == m_)
+    {
+      // Uniform sampling among the n_ best ranked data
+      UniformSample(m_, n_, random_generator, samples);
+    }
+    else
+    {
+      // The n_-th datum and m-1 data among the n_-1 best ranked data
+      UniformSample(m_ - 1, n_ - 1, random_generator, samples);
+      samples->push_back(n_ - 1);
+    }
+    for (auto & sample : *samples)
+      sample = ranking_[sample];
+    return true;
+  }
+
+private:
+  std::vector<uint32_t> ranking_;
+  const uint32_t m_;   // sample size
+  const uint32_t N_;   // data count
+  uint32_t n_;         // size of the sampling subset
+  double T_n_;         // average number of samples drawn from the n_ first data
+  uint32_t T_n_prime_; // iteration at which the sampling subset is grown
+  uint32_t t_;         // iteration counter
+};
+
 } // namespace robust
 } // namespace openMVG
 #endif // OPENMVG_ROBUST_ESTIMATION_RAND_SAMPLING_HPP
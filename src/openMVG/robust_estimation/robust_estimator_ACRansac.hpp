@@ -35,14 +35,32 @@
 //  Adaptive Structure from Motion with a contrario mode estimation.
 //  In 11th Asian Conference on Computer Vision (ACCV 2012)
 //--
+//
+// Optional accelerations (see ACRANSAC_Options):
+//--
+//  [4] Jiri Matas and Ondrej Chum.
+//  Randomized RANSAC with Sequential Probability Ratio Test.
+//  ICCV 2005.
+//--
+//  [5] Ondrej Chum and Jiri Matas.
+//  Matching with PROSAC - Progressive Sample Consensus.
+//  CVPR 2005.
+//--
+//  [6] Ondrej Chum, Jiri Matas and Josef Kittler.
+//  Locally Optimized RANSAC.
+//  DAGM 2003.
+//--
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <random>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -133,6 +151,11 @@ public:
     const bool bquantified_nfa_evaluation = false
   ):
     m_residuals(kernel.NumSamples()),
+    m_keys(bquantified_nfa_evaluation ? 0 : kernel.NumSamples()),
+    m_keys_tmp(m_keys.size()),
+    m_sorted_indices(m_keys.size()),
+    m_sorted_indices_tmp(m_keys.size()),
+    m_radix_histograms(bquantified_nfa_evaluation ? 0 : kRadixDigitCount * kRadixBinCount),
     m_kernel(kernel),
     m_bquantified_nfa_evaluation(bquantified_nfa_evaluation),
     m_max_threshold(dmaxThreshold)
@@ -168,11 +191,30 @@ public:
   );
 
 private:
+  /// The 32 bits radix keys are sorted with 3 digits of 11 bits (LSD order)
+  static const int kRadixDigitCount = 3;
+  static const int kRadixDigitBits = 11;
+  static const uint32_t kRadixBinCount = 1 << kRadixDigitBits;
+
+  /// Exhaustive NFA evaluation helpers:
+  /// Quantize the residuals and compute the histograms of the radix sort digits
+  void QuantizeResiduals();
+  /// Lower bound of the NFA of the current residuals (from the histogram of the
+  ///  most significant digit, i.e. without sorting the residuals)
+  double NFA_LowerBound() const;
+  /// Sort the residual indices by ascending quantized residual
+  void RadixSortResiduals();
 
   /// residual array
   std::vector<double> m_residuals;
-  /// [residual,index] array -> used in the exhaustive nfa computation mode
-  std::vector<std::pair<double,uint32_t>> m_sorted_residuals;
+
+  /// Preallocated arena used in the exhaustive nfa computation mode:
+  /// - residuals quantized as float bit patterns (same order as the float values),
+  /// - residual indices (sorted by ascending quantized residual),
+  /// - histograms of the radix sort digits.
+  std::vector<uint32_t> m_keys, m_keys_tmp;
+  std::vector<uint32_t> m_sorted_indices, m_sorted_indices_tmp;
+  std::vector<uint32_t> m_radix_histograms;
 
   /// Combinatorial log
   std::vector<float> m_logc_n, m_logc_k;
@@ -256,27 +298,33 @@ NFA_Interface<Kernel>::ComputeNFA_and_inliers
   }
   else // exhaustive computation
   {
+    QuantizeResiduals();
+
+    // The hypothesis cannot beat the current best NFA: skip the sort
+    if (nfa_threshold.first < std::numeric_limits<double>::infinity()
+        && NFA_LowerBound() >= nfa_threshold.first)
+      return false;
+
     // Residuals sorting (ascending order while keeping original point indexes)
-    {
-      m_sorted_residuals.clear();
-      m_sorted_residuals.reserve(m_kernel.NumSamples());
-      for (uint32_t i = 0; i < m_kernel.NumSamples(); ++i)
-      {
-        m_sorted_residuals.emplace_back(m_residuals[i], i);
-      }
-      std::sort(m_sorted_residuals.begin(), m_sorted_residuals.end());
-    }
+    RadixSortResiduals();
 
-    // Find best NFA and its index wrt square error threshold in m_sorted_residuals.
+    // Find best NFA and its index wrt square error threshold in m_sorted_indices.
+    // The quantized order can differ from the residual order for nearly equal
+    //  residuals, the running maximum keeps the residual threshold monotonic.
     using nfa_indexT = std::pair<double, uint32_t>;
     nfa_indexT current_best_nfa(std::numeric_limits<double>::infinity(), Kernel::MINIMUM_SAMPLES);
     const size_t n = m_kernel.NumSamples();
-    for (size_t k = Kernel::MINIMUM_SAMPLES + 1;
-        k <= n && m_sorted_residuals[k-1].first <= m_max_threshold;
-        ++k) // Compute the NFA for all k in [minimal_sample+1,n]
+    double residual_k = 0.0, best_residual = 0.0;
+    for (size_t i = 0; i < Kernel::MINIMUM_SAMPLES && i < n; ++i)
+      residual_k = std::max(residual_k, m_residuals[m_sorted_indices[i]]);
+    for (size_t k = Kernel::MINIMUM_SAMPLES + 1; k <= n; ++k)
+      // Compute the NFA for all k in [minimal_sample+1,n]
     {
+      residual_k = std::max(residual_k, m_residuals[m_sorted_indices[k-1]]);
+      if (!(residual_k <= m_max_threshold))
+        break;
       const double logalpha = m_kernel.logalpha0()
-        + m_kernel.multError() * log10(m_sorted_residuals[k-1].first
+        + m_kernel.multError() * log10(residual_k
         + std::numeric_limits<float>::epsilon());
       const nfa_indexT current_nfa( m_loge0
         + logalpha * (double)(k - Kernel::MINIMUM_SAMPLES)
@@ -284,7 +332,10 @@ NFA_Interface<Kernel>::ComputeNFA_and_inliers
         + m_logc_k[k], k);
 
       if (current_nfa.first < current_best_nfa.first)
+      {
         current_best_nfa = current_nfa;
+        best_residual = residual_k;
+      }
     }
 
     // If the current NFA is better than the previous
@@ -292,20 +343,299 @@ NFA_Interface<Kernel>::ComputeNFA_and_inliers
     if (current_best_nfa.first < nfa_threshold.first)
     {
       nfa_threshold.first = current_best_nfa.first;
-      nfa_threshold.second = m_sorted_residuals[current_best_nfa.second-1].first;
+      nfa_threshold.second = best_residual;
 
-      inliers.resize(current_best_nfa.second);
-      for (size_t i =0; i < current_best_nfa.second; ++i)
-      {
-        inliers[i] = m_sorted_residuals[i].second;
-      }
+      inliers.assign(m_sorted_indices.cbegin(),
+                     m_sorted_indices.cbegin() + current_best_nfa.second);
       return true;
     }
   }
   return false;
 }
+
+template <typename Kernel>
+void
+NFA_Interface<Kernel>::QuantizeResiduals()
+{
+  // The bit patterns of the positive float values have the same order as the values
+  std::fill(m_radix_histograms.begin(), m_radix_histograms.end(), 0);
+  uint32_t * histograms = m_radix_histograms.data();
+  for (size_t i = 0; i < m_residuals.size(); ++i)
+  {
+    const double residual = m_residuals[i];
+    uint32_t key = 0;
+    if (residual > 0)
+    {
+      const float value = static_cast<float>(residual);
+      std::memcpy(&key, &value, sizeof(key));
+    }
+    else if (residual != residual) // NaN values are sorted last
+    {
+      key = std::numeric_limits<uint32_t>::max();
+    }
+    m_keys[i] = key;
+    for (int digit = 0; digit < kRadixDigitCount; ++digit)
+      ++histograms[digit * kRadixBinCount
+        + ((key >> (digit * kRadixDigitBits)) & (kRadixBinCount - 1))];
+  }
+}
+
+template <typename Kernel>
+double
+NFA_Interface<Kernel>::NFA_LowerBound() const
+{
+  // The residuals of the data counted in the bin b of the most significant digit
+  //  are greater or equal than the lower value of the bin: replacing the residual
+  //  by this value in the NFA formula gives a lower bound of the NFA.
+  // (the sorted residuals and their logarithm are not required)
+  const int shift = (kRadixDigitCount - 1) * kRadixDigitBits;
+  const uint32_t * histogram = m_radix_histograms.data() + (kRadixDigitCount - 1) * kRadixBinCount;
+  const size_t n = m_kernel.NumSamples();
+  double lower_bound = std::numeric_limits<double>::infinity();
+  size_t k = 0;
+  for (uint32_t bin = 0; bin < kRadixBinCount && k < n; ++bin)
+  {
+    if (histogram[bin] == 0)
+      continue;
+    // Lowest residual of the bin (one float ulp below to absorb the float rounding)
+    float bin_residual = 0.f;
+    if (bin > 0)
+    {
+      const uint32_t bin_key = (bin << shift) - 1;
+      std::memcpy(&bin_residual, &bin_key, sizeof(bin_residual));
+    }
+    if (!(bin_residual <= m_max_threshold))
+      break;
+    const double logalpha = m_kernel.logalpha0()
+      + m_kernel.multError() * log10(bin_residual
+      + std::numeric_limits<float>::epsilon());
+    const size_t bin_end = k + histogram[bin];
+    for (k = std::max(k + 1, static_cast<size_t>(Kernel::MINIMUM_SAMPLES + 1));
+         k <= bin_end; ++k)
+    {
+      lower_bound = std::min(lower_bound, m_loge0
+        + logalpha * (double)(k - Kernel::MINIMUM_SAMPLES)
+        + m_logc_n[k]
+        + m_logc_k[k]);
+    }
+    k = bin_end;
+  }
+  return lower_bound;
+}
+
+template <typename Kernel>
+void
+NFA_Interface<Kernel>::RadixSortResiduals()
+{
+  // LSD radix sort of the (key, index) pairs, the prefix sums of the
+  //  digit histograms have been computed by QuantizeResiduals.
+  std::iota(m_sorted_indices.begin(), m_sorted_indices.end(), 0);
+  if (m_keys.empty())
+    return;
+  for (int digit = 0; digit < kRadixDigitCount; ++digit)
+  {
+    uint32_t * histogram = m_radix_histograms.data() + digit * kRadixBinCount;
+    const int shift = digit * kRadixDigitBits;
+    // Skip the pass if all the keys share the same digit
+    if (histogram[(m_keys[0] >> shift) & (kRadixBinCount - 1)] == m_keys.size())
+      continue;
+    uint32_t offset = 0;
+    for (uint32_t bin = 0; bin < kRadixBinCount; ++bin)
+    {
+      const uint32_t count = histogram[bin];
+      histogram[bin] = offset;
+      offset += count;
+    }
+    for (size_t i = 0; i < m_keys.size(); ++i)
+    {
+      const uint32_t position = histogram[(m_keys[i] >> shift) & (kRadixBinCount - 1)]++;
+      m_keys_tmp[position] = m_keys[i];
+      m_sorted_indices_tmp[position] = m_sorted_indices[i];
+    }
+    m_keys.swap(m_keys_tmp);
+    m_sorted_indices.swap(m_sorted_indices_tmp);
+  }
+}
+
+/// Detect if the kernel can compute the residual of a single datum:
+///  double Error(uint32_t sample, const Model & model) const
+template <typename Kernel>
+class HasSampleError
+{
+  template <typename T>
+  static auto check(int) -> decltype(
+    std::declval<const T &>().Error(uint32_t(0), std::declval<const typename T::Model &>()),
+    std::true_type());
+  template <typename T>
+  static std::false_type check(...);
+public:
+  static constexpr bool value = decltype(check<Kernel>(0))::value;
+};
+
+/// Sequential Probability Ratio Test [4]:
+///  the residuals of a hypothesis are evaluated in a random order and the
+///  hypothesis is rejected as soon as the likelihood ratio of "bad model"
+///  versus "good model" exceeds the decision threshold A.
+/// A datum is consistent with a model if its residual is below the
+///  threshold of the current best model.
+/// The test requires a kernel providing the Error(sample, model) function,
+///  else all the residuals are computed (i.e. no early rejection).
+class SPRT
+{
+public:
+  /**
+   * @param[in] nData number of data
+   * @param[in] fit_cost cost of a model fit in residual evaluation units
+   * @param[in] random_generator used to shuffle the evaluation order
+   */
+  template <typename RandomGeneratorT>
+  SPRT
+  (
+    const uint32_t nData,
+    const double fit_cost,
+    RandomGeneratorT & random_generator
+  ):
+    m_order(nData),
+    m_fit_cost(fit_cost)
+  {
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::shuffle(m_order.begin(), m_order.end(), random_generator);
+  }
+
+  /// Update the inlier ratio of the best model (probability that a datum is
+  ///  consistent with a good model)
+  void SetInlierRatio(const double epsilon)
+  {
+    m_epsilon = epsilon;
+    UpdateDecisionThreshold();
+  }
+
+  /**
+   * @brief Evaluate the residuals of a model until it is rejected.
+   * @param[in] threshold residual threshold of the consistent data
+   * @param[out] residuals all the residuals if the model is accepted
+   * @return false if the model is rejected
+   */
+  template <typename Kernel>
+  bool Evaluate
+  (
+    const Kernel & kernel,
+    const typename Kernel::Model & model,
+    const double threshold,
+    std::vector<double> & residuals
+  )
+  {
+    if (!HasSampleError<Kernel>::value || m_epsilon <= m_delta)
+    {
+      // The test cannot discriminate the models
+      kernel.Errors(model, residuals);
+      return true;
+    }
+
+    const double good_ratio = m_delta / m_epsilon;
+    const double bad_ratio = (1.0 - m_delta) / (1.0 - m_epsilon);
+    double lambda = 1.0;
+    uint32_t consistent_count = 0;
+    for (uint32_t i = 0; i < m_order.size(); ++i)
+    {
+      const uint32_t index = m_order[i];
+      residuals[index] = SampleError(kernel, index, model,
+        std::integral_constant<bool, HasSampleError<Kernel>::value>());
+      if (residuals[index] <= threshold)
+      {
+        ++consistent_count;
+        lambda *= good_ratio;
+      }
+      else
+      {
+        lambda *= bad_ratio;
+      }
+      if (lambda > m_A)
+      {
+        // Rejected: update the probability that a datum is consistent with a bad model
+        ++m_rejected_count;
+        m_delta += (static_cast<double>(consistent_count) / (i + 1) - m_delta) / m_rejected_count;
+        m_delta = std::min(std::max(m_delta, 1e-4), 0.5);
+        UpdateDecisionThreshold();
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  template <typename Kernel>
+  static double SampleError
+  (
+    const Kernel & kernel,
+    const uint32_t index,
+    const typename Kernel::Model & model,
+    std::true_type
+  )
+  {
+    return kernel.Error(index, model);
+  }
+
+  template <typename Kernel>
+  static double SampleError
+  (
+    const Kernel &,
+    const uint32_t,
+    const typename Kernel::Model &,
+    std::false_type
+  )
+  {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  /// Compute the decision threshold A (equation 8 in [4])
+  void UpdateDecisionThreshold()
+  {
+    if (m_epsilon <= m_delta)
+      return;
+    const double C = (1.0 - m_delta) * log((1.0 - m_delta) / (1.0 - m_epsilon))
+      + m_delta * log(m_delta / m_epsilon);
+    m_A = m_fit_cost * C + 1.0;
+    for (int i = 0; i < 10; ++i)
+      m_A = m_fit_cost * C + 1.0 + log(m_A);
+  }
+
+  /// Evaluation order of the data
+  std::vector<uint32_t> m_order;
+  /// Cost of a model fit in residual evaluation units
+  const double m_fit_cost;
+  /// Probability that a datum is consistent with a good/bad model
+  double m_epsilon = 0.0;
+  double m_delta = 0.05;
+  /// Decision threshold
+  double m_A = std::numeric_limits<double>::infinity();
+  uint32_t m_rejected_count = 0;
+};
+
 }  // namespace acransac_nfa_internal
 
+/// Options of the ACRANSAC accelerations (all disabled by default)
+struct ACRANSAC_Options
+{
+  /// Preemptive evaluation of the hypotheses with a Sequential Probability
+  ///  Ratio Test [4] once a meaningful model is found: a hypothesis whose
+  ///  support at the current best threshold is too weak is discarded before
+  ///  all its residuals are computed (and the NFA is not evaluated).
+  bool sprt = false;
+  /// Cost of a model fit in residual evaluation units (SPRT)
+  double sprt_fit_cost = 200.0;
+
+  /// PROSAC ordered sampling [5]: a score per datum, lower is better
+  ///  (i.e. the descriptor distance ratio of the correspondences).
+  ///  The samples are first drawn among the best ranked data.
+  ///  Empty: uniform sampling.
+  std::vector<float> sample_scores;
+
+  /// Local optimization [6]: number of samples drawn among the inliers of
+  ///  each new best model (0: disabled)
+  unsigned int local_optimization_iterations = 0;
+};
+
 /**
  * @brief ACRANSAC routine (ErrorThreshold, NFA)
  * If an upper bound of the threshold is provided:
@@ -314,6 +644,7 @@ NFA_Interface<Kernel>::ComputeNFA_and_inliers
  *  - The NFA is estimated by using all the residual errors.
  *
  * @param[in] kernel model and metric object
+ * @param[in] options the enabled accelerations (SPRT, PROSAC, local optimization)
  * @param[out] vec_inliers points that fit the estimated model
  * @param[in] nIter maximum number of consecutive iterations
  * @param[out] model returned model if found
@@ -326,6 +657,7 @@ template<typename Kernel>
 std::pair<double, double> ACRANSAC
 (
   const Kernel &kernel,
+  const ACRANSAC_Options & options,
   std::vector<uint32_t> & vec_inliers,
   const unsigned int num_max_iteration = 1024,
   typename Kernel::Model * model = nullptr,
@@ -378,12 +710,80 @@ std::pair<double, double> ACRANSAC
   // Random number generation
   std::mt19937 random_generator(std::mt19937::default_seed);
 
+  //--
+  // PROSAC: sample the best ranked data first
+  //  (used as long as the samples are drawn among all the data)
+  std::unique_ptr<ProsacSampler> prosac_sampler;
+  if (options.sample_scores.size() == nData)
+  {
+    std::vector<uint32_t> ranking(nData);
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::stable_sort(ranking.begin(), ranking.end(),
+      [&options](const uint32_t a, const uint32_t b)
+      { return options.sample_scores[a] < options.sample_scores[b]; });
+    prosac_sampler.reset(new ProsacSampler(std::move(ranking), sizeSample, nIter));
+  }
+  bool b_sample_all_data = true;
+
+  //--
+  // SPRT: preemptive evaluation of the hypotheses
+  std::unique_ptr<acransac_nfa_internal::SPRT> sprt;
+  if (options.sprt)
+    sprt.reset(new acransac_nfa_internal::SPRT(nData, options.sprt_fit_cost, random_generator));
+
+  // Evaluate the NFA of a model whose residuals are computed:
+  //  update the best model & inliers if the model is better
+  const auto update_best_model = [&](
+    const typename Kernel::Model & model_it,
+    const unsigned int iter) -> bool
+  {
+    // NFA evaluation; If better than the previous: update scoring & inliers indices
+    std::pair<double, double> nfa_threshold(minNFA, 0.0);
+    const bool b_better_model_found =
+      nfa_interface.ComputeNFA_and_inliers(vec_inliers, nfa_threshold);
+
+    if (b_better_model_found)
+    {
+      minNFA = nfa_threshold.first;
+      errorMax = nfa_threshold.second;
+      if (model) *model = model_it;
+      if (sprt && minNFA < 0)
+        sprt->SetInlierRatio(vec_inliers.size() / static_cast<double>(nData));
+
+      if (bVerbose)
+      {
+        std::ostringstream os;
+        os << "  nfa=" << minNFA
+          << " inliers=" << vec_inliers.size() << "/" << nData
+          << " precisionNormalized=" << errorMax
+          << " precision=" << kernel.unormalizeError(errorMax)
+          << " (iter=" << iter
+          << " ,sample=";
+        std::copy(vec_sample.begin(), vec_sample.end(),
+          std::ostream_iterator<uint32_t>(os, ","));
+        OPENMVG_LOG_INFO << os.str() << ")";
+      }
+    }
+    return b_better_model_found;
+  };
+
+  // Compute the residuals of a model (return false if rejected by the SPRT)
+  const auto compute_residuals = [&](const typename Kernel::Model & model_it) -> bool
+  {
+    if (sprt && bACRansacMode && minNFA < 0)
+      return sprt->Evaluate(kernel, model_it, errorMax, nfa_interface.residuals());
+    kernel.Errors(model_it, nfa_interface.residuals());
+    return true;
+  };
+
   //--
   // Main estimation loop.
   for (unsigned int iter = 0; iter < nIter && iter < num_max_iteration; ++iter)
   {
     // Get random samples
-    if (bACRansacMode)
+    if (prosac_sampler && b_sample_all_data)
+      prosac_sampler->Sample(random_generator, &vec_sample);
+    else if (bACRansacMode)
       UniformSample(sizeSample, random_generator, &vec_index, &vec_sample);
     else
       UniformSample(sizeSample, nData, random_generator, &vec_sample);
@@ -397,7 +797,8 @@ std::pair<double, double> ACRANSAC
     for (const auto& model_it : vec_models)
     {
       // Compute residual values
-      kernel.Errors(model_it, nfa_interface.residuals());
+      if (!compute_residuals(model_it))
+        continue;
 
       if (!bACRansacMode)
       {
@@ -412,33 +813,25 @@ std::pair<double, double> ACRANSAC
           bACRansacMode = true;
       }
 
-      if (bACRansacMode)
-      {
-        // NFA evaluation; If better than the previous: update scoring & inliers indices
-        std::pair<double, double> nfa_threshold(minNFA, 0.0);
-        const bool b_better_model_found =
-          nfa_interface.ComputeNFA_and_inliers(vec_inliers, nfa_threshold);
+      if (bACRansacMode && update_best_model(model_it, iter))
+        better = true;
+    }
 
-        if (b_better_model_found)
+    // Local optimization: draw samples among the inliers of the new best model
+    if (better && minNFA < 0 && options.local_optimization_iterations > 0
+        && vec_inliers.size() > sizeSample)
+    {
+      std::vector<uint32_t> lo_index;
+      for (unsigned int lo_iter = 0; lo_iter < options.local_optimization_iterations; ++lo_iter)
+      {
+        lo_index = vec_inliers; // the inliers can be updated by the previous iteration
+        UniformSample(sizeSample, random_generator, &lo_index, &vec_sample);
+        std::vector<typename Kernel::Model> lo_models;
+        kernel.Fit(vec_sample, &lo_models);
+        for (const auto& model_it : lo_models)
         {
-          better = true;
-          minNFA = nfa_threshold.first;
-          errorMax = nfa_threshold.second;
-          if (model) *model = model_it;
-
-          if (bVerbose)
-          {
-            std::ostringstream os;
-            os << "  nfa=" << minNFA
-              << " inliers=" << vec_inliers.size() << "/" << nData
-              << " precisionNormalized=" << errorMax
-              << " precision=" << kernel.unormalizeError(errorMax)
-              << " (iter=" << iter
-              << " ,sample=";
-            std::copy(vec_sample.begin(), vec_sample.end(),
-              std::ostream_iterator<uint32_t>(os, ","));
-            OPENMVG_LOG_INFO << os.str() << ")";
-          }
+          if (compute_residuals(model_it))
+            update_best_model(model_it, iter);
         }
       }
     }
@@ -464,6 +857,7 @@ std::pair<double, double> ACRANSAC
       {
         // ACRANSAC optimization: draw samples among best set of inliers so far
         vec_index = vec_inliers;
+        b_sample_all_data = false;
         if (nIterReserve) {
             // reduce the number of iteration
             // next iterations will be dedicated to local optimization
@@ -488,6 +882,25 @@ std::pair<double, double> ACRANSAC
   return {errorMax, minNFA};
 }
 
+/**
+ * @brief ACRANSAC routine (ErrorThreshold, NFA) without acceleration.
+ * See ACRANSAC(kernel, options, ...).
+ */
+template<typename Kernel>
+std::pair<double, double> ACRANSAC
+(
+  const Kernel &kernel,
+  std::vector<uint32_t> & vec_inliers,
+  const unsigned int num_max_iteration = 1024,
+  typename Kernel::Model * model = nullptr,
+  double precision = std::numeric_limits<double>::infinity(),
+  bool bVerbose = false
+)
+{
+  return ACRANSAC(kernel, ACRANSAC_Options(), vec_inliers,
+    num_max_iteration, model, precision, bVerbose);
+}
+
 } // namespace robust
 } // namespace openMVG
 #endif // OPENMVG_ROBUST_ESTIMATOR_ACRANSAC_HPP
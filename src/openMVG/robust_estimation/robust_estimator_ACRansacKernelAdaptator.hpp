@@ -25,12 +25,20 @@
 // Mainly it add correct data normalization and define the required functions
 //  by the ACRANSAC algorithm.
 //
+// If the error functor provides a batched version:
+//   static void Errors(const Model &, const RMat &, const RMat &, Eigen::Ref<Vec>)
+//  the adaptors keep a copy of the data in SoA layout (one coordinate per row)
+//  and evaluate all the residuals of a model in a single vectorized call.
+//
 
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "openMVG/multiview/conditioning.hpp"
 #include "openMVG/multiview/essential.hpp"
 #include "openMVG/numeric/extract_columns.hpp"
+#include "openMVG/numeric/numeric.h"
 
 namespace openMVG {
 namespace robust{
@@ -42,6 +50,52 @@ enum AContrarioParametrizationType
   RADIAN_ANGLE = 2
 };
 
+namespace internal {
+
+/// Detect if ErrorT provides the batched (SoA) Errors function for ModelT
+template <typename ErrorT, typename ModelT>
+class HasBatchedErrors
+{
+  template <typename T>
+  static auto check(int) -> decltype(
+    T::Errors(std::declval<const ModelT &>(), std::declval<const RMat &>(),
+      std::declval<const RMat &>(), std::declval<Eigen::Ref<Vec>>()),
+    std::true_type());
+  template <typename T>
+  static std::false_type check(...);
+public:
+  static constexpr bool value = decltype(check<ErrorT>(0))::value;
+};
+
+/// Call the batched Errors function (or do nothing if ErrorT has no such function)
+template <typename ErrorT, typename ModelT>
+typename std::enable_if<HasBatchedErrors<ErrorT, ModelT>::value>::type
+BatchedErrors
+(
+  const ModelT & model,
+  const RMat & x1,
+  const RMat & x2,
+  std::vector<double> & vec_errors
+)
+{
+  vec_errors.resize(x1.cols());
+  ErrorT::Errors(model, x1, x2, Eigen::Map<Vec>(vec_errors.data(), vec_errors.size()));
+}
+
+template <typename ErrorT, typename ModelT>
+typename std::enable_if<!HasBatchedErrors<ErrorT, ModelT>::value>::type
+BatchedErrors
+(
+  const ModelT &,
+  const RMat &,
+  const RMat &,
+  std::vector<double> &
+)
+{
+}
+
+} // namespace internal
+
 template <int PARAMETRIZATION = AContrarioParametrizationType::POINT_TO_LINE>
 struct ACParametrizationHelper
 {
@@ -127,6 +181,11 @@ public:
 
     NormalizePoints(x1, &x1_, &N1_, w1, h1);
     NormalizePoints(x2, &x2_, &N2_, w2, h2);
+    if (kBatchedErrors)
+    {
+      x1_soa_ = x1_;
+      x2_soa_ = x2_;
+    }
 
     // LogAlpha0 is used to make error data scale invariant
     logalpha0_ =
@@ -164,6 +223,11 @@ public:
     std::vector<double> & vec_errors
   ) const
   {
+    if (kBatchedErrors)
+    {
+      internal::BatchedErrors<ErrorT>(model, x1_soa_, x2_soa_, vec_errors);
+      return;
+    }
     vec_errors.resize(x1_.cols());
     for (uint32_t sample = 0; sample < x1_.cols(); ++sample)
       vec_errors[sample] = ErrorT::Error(model, x1_.col(sample), x2_.col(sample));
@@ -194,7 +258,10 @@ public:
   double unormalizeError(double val) const {return sqrt(val) / N2_(0,0);}
 
 private:
+  static constexpr bool kBatchedErrors = internal::HasBatchedErrors<ErrorT, Model>::value;
+
   Mat x1_, x2_;       // Normalized input data
+  RMat x1_soa_, x2_soa_; // Normalized input data (SoA layout, only for batched errors)
   Mat3 N1_, N2_;      // Matrix used to normalize data
   double logalpha0_;  // Alpha0 is used to make the error adaptive to the image size
   bool bPointToLine_; // Store if error model is pointToLine or point to point
@@ -235,6 +302,11 @@ public:
     assert(x2d_.cols() == x3D_.cols());
 
     NormalizePoints(x2d, &x2d_, &N1_, w, h);
+    if (kBatchedErrors)
+    {
+      x2d_soa_ = x2d_;
+      x3D_soa_ = x3D_;
+    }
   }
 
   enum { MINIMUM_SAMPLES = Solver::MINIMUM_SAMPLES };
@@ -262,6 +334,11 @@ public:
     std::vector<double> & vec_errors
   ) const
   {
+    if (kBatchedErrors)
+    {
+      internal::BatchedErrors<ErrorT>(model, x2d_soa_, x3D_soa_, vec_errors);
+      return;
+    }
     vec_errors.resize(x2d_.cols());
     for (uint32_t sample = 0; sample < x2d_.cols(); ++sample)
       vec_errors[sample] = ErrorT::Error(model, x2d_.col(sample), x3D_.col(sample));
@@ -281,8 +358,11 @@ public:
   double unormalizeError(double val) const {return sqrt(val) / N1_(0,0);}
 
 private:
+  static constexpr bool kBatchedErrors = internal::HasBatchedErrors<ErrorT, Model>::value;
+
   Mat x2d_;
   const Mat & x3D_;
+  RMat x2d_soa_, x3D_soa_; // Input data (SoA layout, only for batched errors)
   Mat3 N1_;          // Matrix used to normalize data
   double logalpha0_; // Alpha0 is used to make the error adaptive to the image size
 };
@@ -320,6 +400,11 @@ public:
     assert(bearing1_.cols() == bearing2_.cols());
 
     logalpha0_ = ACParametrizationHelper<AContrarioParametrizationType::POINT_TO_LINE>::LogAlpha0(w2, h2, 0.5);
+    if (kBatchedErrors)
+    {
+      x1_soa_ = x1_;
+      x2_soa_ = x2_;
+    }
   }
 
   enum { MINIMUM_SAMPLES = Solver::MINIMUM_SAMPLES };
@@ -355,6 +440,11 @@ public:
   {
     Mat3 F;
     FundamentalFromEssential(model, K1_, K2_, &F);
+    if (kBatchedErrors)
+    {
+      internal::BatchedErrors<ErrorT>(F, x1_soa_, x2_soa_, vec_errors);
+      return;
+    }
     vec_errors.resize(x1_.cols());
     for (uint32_t sample = 0; sample < x1_.cols(); ++sample)
       vec_errors[sample] = ErrorT::Error(F, this->x1_.col(sample), this->x2_.col(sample));
@@ -369,7 +459,10 @@ public:
   double unormalizeError(double val) const { return val; }
 
 private:
+  static constexpr bool kBatchedErrors = internal::HasBatchedErrors<ErrorT, Mat3>::value;
+
   Mat2X x1_, x2_;             // image points
+  RMat x1_soa_, x2_soa_;      // image points (SoA layout, only for batched errors)
   Mat3X bearing1_, bearing2_; // bearing vectors
   Mat3 N1_, N2_;              // Matrix used to normalize data
   double logalpha0_;          // Alpha0 is used to make the error adaptive to the image size
@@ -480,6 +573,11 @@ public:
     assert(3 == x1_.rows());
     assert(x1_.rows() == x2_.rows());
     assert(x1_.cols() == x2_.cols());
+    if (kBatchedErrors)
+    {
+      x1_soa_ = x1_;
+      x2_soa_ = x2_;
+    }
   }
 
   enum { MINIMUM_SAMPLES = Solver::MINIMUM_SAMPLES };
@@ -511,6 +609,13 @@ public:
     std::vector<double> & vec_errors
   ) const
   {
+    if (kBatchedErrors)
+    {
+      internal::BatchedErrors<ErrorT>(model, x1_soa_, x2_soa_, vec_errors);
+      for (double & error : vec_errors)
+        error = Square(error);
+      return;
+    }
     vec_errors.resize(x1_.cols());
     for (uint32_t sample = 0; sample < x1_.cols(); ++sample)
       vec_errors[sample] = Square(ErrorT::Error(model, x1_.col(sample), x2_.col(sample)));
@@ -534,7 +639,10 @@ public:
   double unormalizeError(double val) const {return sqrt(val);}
 
 private:
+  static constexpr bool kBatchedErrors = internal::HasBatchedErrors<ErrorT, Model>::value;
+
   Mat x1_, x2_;       // Normalized input data
+  RMat x1_soa_, x2_soa_; // Normalized input data (SoA layout, only for batched errors)
   double logalpha0_;  // Alpha0 is used to make the error scale invariant
 };
 
@@ -14,6 +14,7 @@
 #include "testing/testing.h"
 #include "third_party/vectorGraphics/svgDrawer.hpp"
 
+#include <algorithm>
 #include <iterator>
 #include <random>
 
@@ -364,6 +365,224 @@ TEST(RansacLineFitter, ACRANSACSimu) {
   }
 }
 
+/// Line kernel counting the evaluated residuals
+class ACRANSACCountingLineKernel :
+  public ACRANSACOneViewKernel<LineSolver, pointToLineError, Vec2>
+{
+public:
+  using BaseKernel = ACRANSACOneViewKernel<LineSolver, pointToLineError, Vec2>;
+  using BaseKernel::BaseKernel;
+
+  double Error(uint32_t sample, const Model &model) const {
+    ++residual_count;
+    return BaseKernel::Error(sample, model);
+  }
+
+  void Errors(const Model &model, std::vector<double> & vec_errors) const {
+    residual_count += NumSamples();
+    BaseKernel::Errors(model, vec_errors);
+  }
+
+  mutable size_t residual_count = 0;
+};
+
+// The accelerated variants find the model of the RealisticCase scenario
+TEST(RansacLineFitter, RealisticCase_Accelerated) {
+
+  constexpr int NbPoints = 100;
+  constexpr uint32_t nbPtToNoise = 30;
+  Mat2X xy(2, NbPoints);
+  Vec2 GTModel; // y = 6.3 x + (-2.0)
+  GTModel <<  -2.0, 6.3;
+  for (int i = 0; i < NbPoints; ++i) {
+    xy.col(i) << i, static_cast<double>(i)*GTModel[1] + GTModel[0];
+  }
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  std::normal_distribution<> d(0, 5);
+  vector<uint32_t> vec_samples;
+  UniformSample(nbPtToNoise, NbPoints, random_generator, &vec_samples);
+  // Scores of the data (as descriptor distance ratios): the outliers are worse ranked
+  std::vector<float> scores(NbPoints, 0.2f);
+  for (const uint32_t index : vec_samples)
+  {
+    xy.col(index) << d(random_generator), d(random_generator);
+    scores[index] = 0.8f;
+  }
+
+  ACRANSACOneViewKernel<LineSolver, pointToLineError, Vec2> lineKernel(xy, 12, 12);
+
+  for (int variant = 0; variant < 4; ++variant)
+  {
+    ACRANSAC_Options options;
+    options.sprt = (variant == 0 || variant == 3);
+    if (variant == 1 || variant == 3)
+      options.sample_scores = scores;
+    options.local_optimization_iterations = (variant == 2 || variant == 3) ? 10 : 0;
+
+    std::vector<uint32_t> vec_inliers;
+    Vec2 line;
+    ACRANSAC(lineKernel, options, vec_inliers, 300, &line);
+
+    CHECK_EQUAL(NbPoints-nbPtToNoise, vec_inliers.size());
+    EXPECT_NEAR(GTModel(0), line[0], 1e-9);
+    EXPECT_NEAR(GTModel(1), line[1], 1e-9);
+  }
+}
+
+// The ACRANSAC variants find a model as good as the plain ACRANSAC on noisy
+//  lines with outliers (ACRANSACSimu scenarios and a larger dataset with more
+//  outliers), the SPRT and PROSAC variants evaluate fewer residuals.
+TEST(RansacLineFitter, ACRANSACSimu_Accelerated) {
+
+  struct Scenario
+  {
+    int S; // image size
+    size_t nbPoints;
+    float outlierRatio;
+  };
+  const std::vector<Scenario> scenarios = {
+    {100, static_cast<size_t>(2.0 * 100 * sqrt(2.0)), .3f},
+    {1000, 2000, .6f}};
+
+  struct Variant
+  {
+    bool sprt, prosac;
+    unsigned int local_optimization_iterations;
+  };
+  // The first variant (plain ACRANSAC) is the baseline
+  const std::vector<Variant> variants = {
+    {false, false, 0},
+    {true, false, 0},
+    {false, true, 0},
+    {false, false, 10},
+    {true, true, 10}};
+
+  for (const Scenario & scenario : scenarios)
+  {
+    const int W = scenario.S, H = scenario.S;
+    std::vector<size_t> residual_counts(variants.size(), 0);
+    for (int i = 0; i < 10; ++i)
+    {
+      const double noise = i / 10. * 5. + std::numeric_limits<double>::epsilon();
+      Mat points;
+      generateLine(points, scenario.nbPoints, W, H, noise, scenario.outlierRatio);
+
+      // Scores: distance to the ground truth line plus some noise
+      std::mt19937 random_generator(i);
+      std::uniform_real_distribution<float> score_noise(0.f, 0.5f);
+      std::vector<float> scores(points.cols());
+      for (Mat::Index j = 0; j < points.cols(); ++j)
+      {
+        const double distance = std::abs(0.3 * points(0, j) + 50 - points(1, j));
+        scores[j] = std::min(0.5, distance / 20.) + score_noise(random_generator);
+      }
+
+      size_t baseline_inlier_count = 0;
+      for (size_t v = 0; v < variants.size(); ++v)
+      {
+        ACRANSAC_Options options;
+        options.sprt = variants[v].sprt;
+        if (variants[v].prosac)
+          options.sample_scores = scores;
+        options.local_optimization_iterations = variants[v].local_optimization_iterations;
+
+        ACRANSACCountingLineKernel lineKernel(points, W, H);
+        std::vector<uint32_t> vec_inliers;
+        Vec2 line;
+        const std::pair<double,double> ret =
+          ACRANSAC(lineKernel, options, vec_inliers, 1000, &line);
+        residual_counts[v] += lineKernel.residual_count;
+
+        // A model is found
+        EXPECT_TRUE(ret.first > 0.0);
+        EXPECT_TRUE(sqrt(ret.first) < noise*2+.5);
+        EXPECT_TRUE(vec_inliers.size() > (1.0 - scenario.outlierRatio) * scenario.nbPoints * 0.5);
+        // with an inlier count close to the baseline one
+        if (v == 0)
+          baseline_inlier_count = vec_inliers.size();
+        EXPECT_NEAR(static_cast<double>(baseline_inlier_count),
+          static_cast<double>(vec_inliers.size()), 0.1 * baseline_inlier_count);
+      }
+    }
+    // Fewer residual evaluations than the baseline
+    // (the local optimization spends some evaluations to refine the models)
+    for (size_t v = 1; v < variants.size(); ++v)
+    {
+      if (variants[v].sprt || variants[v].prosac)
+        EXPECT_TRUE(residual_counts[v] <= residual_counts[0]);
+      if (variants[v].sprt)
+        EXPECT_TRUE(residual_counts[v] < residual_counts[0]);
+    }
+  }
+}
+
+// The exhaustive NFA evaluation (radix sorted residuals) must find the same
+//  NFA, threshold and inliers as the evaluation on the sorted residuals,
+//  and must reject the residuals that cannot beat a better NFA.
+TEST(RansacLineFitter, NFA_Exhaustive) {
+  const int n = 2000;
+  using KernelType = ACRANSACOneViewKernel<LineSolver, pointToLineError, Vec2>;
+  const KernelType kernel(Mat2X::Zero(2, n), 1000, 1000);
+
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  std::uniform_real_distribution<double> inlier_distribution(0.0, 4.0);
+  std::uniform_real_distribution<double> outlier_distribution(0.0, 1e6);
+
+  acransac_nfa_internal::NFA_Interface<KernelType> nfa_interface(kernel);
+  std::vector<double> & residuals = nfa_interface.residuals();
+  for (int i = 0; i < n; ++i)
+    residuals[i] = (i % 3 == 0) ? outlier_distribution(random_generator)
+                                : inlier_distribution(random_generator);
+  residuals[5] = residuals[6]; // some equal residuals
+
+  // Reference evaluation
+  std::vector<float> logc_n, logc_k;
+  acransac_nfa_internal::makelogcombi(KernelType::MINIMUM_SAMPLES, n, logc_k, logc_n);
+  const double loge0 = log10((double)KernelType::MAX_MODELS * (n - KernelType::MINIMUM_SAMPLES));
+  std::vector<std::pair<double, uint32_t>> sorted_residuals;
+  for (int i = 0; i < n; ++i)
+    sorted_residuals.emplace_back(residuals[i], i);
+  std::sort(sorted_residuals.begin(), sorted_residuals.end());
+  double expected_nfa = std::numeric_limits<double>::infinity();
+  int expected_k = 0;
+  for (int k = KernelType::MINIMUM_SAMPLES + 1; k <= n; ++k)
+  {
+    const double logalpha = kernel.logalpha0() + kernel.multError()
+      * log10(sorted_residuals[k-1].first + std::numeric_limits<float>::epsilon());
+    const double nfa = loge0 + logalpha * (double)(k - KernelType::MINIMUM_SAMPLES)
+      + logc_n[k] + logc_k[k];
+    if (nfa < expected_nfa)
+    {
+      expected_nfa = nfa;
+      expected_k = k;
+    }
+  }
+
+  std::vector<uint32_t> inliers;
+  std::pair<double, double> nfa_threshold(std::numeric_limits<double>::infinity(), 0.0);
+  EXPECT_TRUE(nfa_interface.ComputeNFA_and_inliers(inliers, nfa_threshold));
+  EXPECT_NEAR(expected_nfa, nfa_threshold.first, 1e-9);
+  EXPECT_NEAR(sorted_residuals[expected_k - 1].first, nfa_threshold.second, 1e-12);
+  CHECK_EQUAL(expected_k, inliers.size());
+  std::sort(inliers.begin(), inliers.end());
+  for (const uint32_t index : inliers)
+    EXPECT_TRUE(residuals[index] <= nfa_threshold.second);
+
+  // A better NFA cannot be beaten (the inliers are left unchanged)
+  const double nfa = nfa_threshold.first;
+  inliers = {0};
+  nfa_threshold = {nfa - 1.0, 0.0};
+  EXPECT_FALSE(nfa_interface.ComputeNFA_and_inliers(inliers, nfa_threshold));
+  CHECK_EQUAL(1, inliers.size());
+  EXPECT_EQ(nfa - 1.0, nfa_threshold.first);
+
+  // A worse NFA is beaten
+  nfa_threshold = {nfa + 1.0, 0.0};
+  EXPECT_TRUE(nfa_interface.ComputeNFA_and_inliers(inliers, nfa_threshold));
+  EXPECT_NEAR(expected_nfa, nfa_threshold.first, 1e-9);
+  CHECK_EQUAL(expected_k, inliers.size());
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
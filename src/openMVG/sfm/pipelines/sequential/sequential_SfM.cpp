@@ -22,13 +22,16 @@
 #include "openMVG/stl/stl.hpp"
 #include "openMVG/system/logger.hpp"
 #include "openMVG/system/loggerprogress.hpp"
+#include "openMVG/system/timer.hpp"
 
 #include "third_party/histogram/histogram.hpp"
 #include "third_party/htmlDoc/htmlDoc.hpp"
 
 #include <ceres/types.h>
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <numeric>
 #include <utility>
 
 #ifdef _MSC_VER
@@ -184,14 +187,18 @@ bool SequentialSfMReconstructionEngine::Process() {
   // Compute robust Resection of remaining images
   // - group of images will be selected and resection + scene completion will be tried
   size_t resectionGroupIndex = 0;
+  last_global_ba_group_index_ = 0;
+  last_global_ba_nb_poses_ = sfm_data_.GetPoses().size();
+  ba_statistics_.clear();
+  ba_session_.reset();
   std::vector<uint32_t> vec_possible_resection_indexes;
   while (FindImagesWithPossibleResection(vec_possible_resection_indexes))
   {
-    bool bImageAdded = false;
     // Add images to the 3D reconstruction
+    std::set<IndexT> new_pose_ids;
+    const bool bImageAdded = Resection(vec_possible_resection_indexes, new_pose_ids);
     for (const auto & iter : vec_possible_resection_indexes)
     {
-      bImageAdded |= Resection(iter);
       set_remaining_view_id_.erase(iter);
     }
 
@@ -202,16 +209,58 @@ bool SequentialSfMReconstructionEngine::Process() {
       os << std::setw(8) << std::setfill('0') << resectionGroupIndex << "_Resection";
       Save(sfm_data_, stlplus::create_filespec(sOut_directory_, os.str(), ".ply"), ESfM_Data(ALL));
 
+      // Refine the whole scene or only the neighborhood of the new poses
+      std::set<IndexT> local_pose_ids;
+      if (!IsGlobalBundleAdjustmentScheduled(resectionGroupIndex))
+      {
+        local_pose_ids = LocalBundleAdjustmentPoses(new_pose_ids);
+        if (local_pose_ids.size() >= sfm_data_.GetPoses().size())
+          local_pose_ids.clear();
+      }
+      if (local_pose_ids.empty())
+      {
+        last_global_ba_group_index_ = resectionGroupIndex;
+        last_global_ba_nb_poses_ = sfm_data_.GetPoses().size();
+      }
+
       // Perform BA until all point are under the given precision
+      const system::Timer ba_timer;
+      size_t nb_ba_runs = 0;
       do
       {
-        BundleAdjustment();
+        BundleAdjustment(local_pose_ids);
+        ++nb_ba_runs;
       }
       while (badTrackRejector(4.0, 50));
       eraseUnstablePosesAndObservations(sfm_data_);
+
+      ba_statistics_.push_back({resectionGroupIndex, sfm_data_.GetPoses().size(),
+        local_pose_ids.size(), nb_ba_runs, ba_timer.elapsed()});
+      OPENMVG_LOG_INFO
+        << (local_pose_ids.empty() ? "Global" : "Local") << " bundle adjustment: "
+        << ba_statistics_.back().time << " s, "
+        << nb_ba_runs << " run(s), "
+        << (local_pose_ids.empty() ? sfm_data_.GetPoses().size() : local_pose_ids.size())
+        << " refined pose(s)";
     }
     ++resectionGroupIndex;
   }
+  // Refine the whole scene if the last bundle adjustment was local
+  if (!ba_statistics_.empty() && ba_statistics_.back().nb_refined_poses > 0)
+  {
+    const system::Timer ba_timer;
+    size_t nb_ba_runs = 0;
+    do
+    {
+      BundleAdjustment();
+      ++nb_ba_runs;
+    }
+    while (badTrackRejector(4.0, 50));
+    eraseUnstablePosesAndObservations(sfm_data_);
+    ba_statistics_.push_back({resectionGroupIndex, sfm_data_.GetPoses().size(),
+      0, nb_ba_runs, ba_timer.elapsed()});
+  }
+  ba_session_.reset(); // release the bundle adjustment problem
   // Ensure there is no remaining outliers
   if (badTrackRejector(4.0, 0))
   {
@@ -263,6 +312,44 @@ bool SequentialSfMReconstructionEngine::Process() {
     jsxGraph.setViewport(range);
     jsxGraph.close();
     html_doc_stream_->pushInfo(jsxGraph.toStr());
+
+    // Bundle adjustment statistics per resection group
+    if (!ba_statistics_.empty())
+    {
+      html_doc_stream_->pushInfo(htmlMarkup("h2","Bundle adjustment statistics"));
+      os.str("");
+      os << "<table border=\"1\">"
+        << "<tr><td>Resection group</td><td>#Poses</td><td>Type</td>"
+        << "<td>#Refined poses</td><td>#BA runs</td><td>Time (s)</td></tr>";
+      std::vector<double> vec_ba_times;
+      double total_time = 0.0;
+      for (const auto & ba_statistics : ba_statistics_)
+      {
+        os << "<tr>"
+          << "<td>" << ba_statistics.resection_group_index << "</td>"
+          << "<td>" << ba_statistics.nb_poses << "</td>"
+          << "<td>" << (ba_statistics.nb_refined_poses > 0 ? "local" : "global") << "</td>"
+          << "<td>" << (ba_statistics.nb_refined_poses > 0 ? ba_statistics.nb_refined_poses : ba_statistics.nb_poses) << "</td>"
+          << "<td>" << ba_statistics.nb_runs << "</td>"
+          << "<td>" << ba_statistics.time << "</td>"
+          << "</tr>";
+        vec_ba_times.push_back(ba_statistics.time);
+        total_time += ba_statistics.time;
+      }
+      os << "</table><br>"
+        << "Total bundle adjustment time (s): " << total_time << "<br>";
+      html_doc_stream_->pushInfo(os.str());
+
+      htmlDocument::JSXGraphWrapper jsxGraph_ba;
+      jsxGraph_ba.init("BundleAdjustmentTimes",600,300);
+      jsxGraph_ba.addYChart(vec_ba_times, "line,point");
+      jsxGraph_ba.UnsuspendUpdate();
+      std::vector<double> vec_ba_index(vec_ba_times.size());
+      std::iota(vec_ba_index.begin(), vec_ba_index.end(), 0.0);
+      jsxGraph_ba.setViewport(autoJSXGraphViewport<double>(vec_ba_index, vec_ba_times));
+      jsxGraph_ba.close();
+      html_doc_stream_->pushInfo(jsxGraph_ba.toStr());
+    }
   }
   return true;
 }
@@ -776,49 +863,26 @@ bool SequentialSfMReconstructionEngine::FindImagesWithPossibleResection(
   if (set_remaining_view_id_.empty() || sfm_data_.GetLandmarks().empty())
     return false;
 
-  // Collect tracksIds
-  std::set<uint32_t> reconstructed_trackId;
+  // Collect tracksIds (sorted)
+  std::vector<uint32_t> reconstructed_trackId;
+  reconstructed_trackId.reserve(sfm_data_.GetLandmarks().size());
   std::transform(sfm_data_.GetLandmarks().cbegin(), sfm_data_.GetLandmarks().cend(),
-    std::inserter(reconstructed_trackId, reconstructed_trackId.begin()),
+    std::back_inserter(reconstructed_trackId),
     stl::RetrieveKey());
+  std::sort(reconstructed_trackId.begin(), reconstructed_trackId.end());
+
+  // Count for each remaining view the common possible putative point
+  //  with the already 3D reconstructed trackId (2D - 3D possible content)
+  const std::vector<uint32_t> remaining_view_ids(set_remaining_view_id_.cbegin(), set_remaining_view_id_.cend());
+  std::vector<uint32_t> vec_trackCount;
+  shared_track_visibility_helper_->CountTracksInImages(
+    remaining_view_ids, reconstructed_trackId, vec_trackCount);
 
   Pair_Vec vec_putative; // ImageId, NbPutativeCommonPoint
-#ifdef OPENMVG_USE_OPENMP
-  #pragma omp parallel
-#endif
-  for (std::set<uint32_t>::const_iterator iter = set_remaining_view_id_.begin();
-        iter != set_remaining_view_id_.end(); ++iter)
+  vec_putative.reserve(remaining_view_ids.size());
+  for (size_t i = 0; i < remaining_view_ids.size(); ++i)
   {
-#ifdef OPENMVG_USE_OPENMP
-  #pragma omp single nowait
-#endif
-    {
-      const uint32_t viewId = *iter;
-
-      // Compute 2D - 3D possible content
-      openMVG::tracks::STLMAPTracks map_tracksCommon;
-      shared_track_visibility_helper_->GetTracksInImages({viewId}, map_tracksCommon);
-
-      if (!map_tracksCommon.empty())
-      {
-        std::set<uint32_t> set_tracksIds;
-        tracks::TracksUtilsMap::GetTracksIdVector(map_tracksCommon, &set_tracksIds);
-
-        // Count the common possible putative point
-        //  with the already 3D reconstructed trackId
-        std::vector<uint32_t> vec_trackIdForResection;
-        std::set_intersection(set_tracksIds.cbegin(), set_tracksIds.cend(),
-          reconstructed_trackId.cbegin(), reconstructed_trackId.cend(),
-          std::back_inserter(vec_trackIdForResection));
-
-#ifdef OPENMVG_USE_OPENMP
-        #pragma omp critical
-#endif
-        {
-          vec_putative.emplace_back(viewId, vec_trackIdForResection.size());
-        }
-      }
-    }
+    vec_putative.emplace_back(remaining_view_ids[i], vec_trackCount[i]);
   }
 
   // Sort by the number of matches to the 3D scene.
@@ -848,35 +912,82 @@ bool SequentialSfMReconstructionEngine::FindImagesWithPossibleResection(
 }
 
 /**
- * @brief Add one image to the 3D reconstruction. To the resectioning of
- * the camera and triangulate all the new possible tracks.
- * @param[in] viewIndex: image index to add to the reconstruction.
+ * @brief Add a group of images to the 3D reconstruction.
+ * The images are localized concurrently against the current scene, then the
+ * poses are added and the new tracks triangulated in the input order (the
+ * result does not depend on the number of threads).
+ * @param[in] view_ids: image indexes to add to the reconstruction.
+ * @param[out] new_pose_ids: pose ids of the added images.
+ * @return true if at least one image was added.
+ */
+bool SequentialSfMReconstructionEngine::Resection
+(
+  const std::vector<uint32_t> & view_ids,
+  std::set<IndexT> & new_pose_ids
+)
+{
+  // Snapshot of the reconstructed tracks ids (sorted)
+  std::vector<uint32_t> reconstructed_trackId;
+  reconstructed_trackId.reserve(sfm_data_.GetLandmarks().size());
+  std::transform(sfm_data_.GetLandmarks().cbegin(), sfm_data_.GetLandmarks().cend(),
+    std::back_inserter(reconstructed_trackId),
+    stl::RetrieveKey());
+  std::sort(reconstructed_trackId.begin(), reconstructed_trackId.end());
+
+  // Localize the views (the scene is read only)
+  std::vector<ResectionResult, Eigen::aligned_allocator<ResectionResult>> resections(view_ids.size());
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < static_cast<int>(view_ids.size()); ++i)
+  {
+    resections[i].valid = ComputeResection(view_ids[i], reconstructed_trackId, resections[i]);
+  }
+
+  // Update the scene (sequentially, in the input order)
+  bool bImageAdded = false;
+  for (size_t i = 0; i < view_ids.size(); ++i)
+  {
+    if (AddResectionToScene(view_ids[i], resections[i]))
+    {
+      bImageAdded = true;
+      new_pose_ids.insert(sfm_data_.GetViews().at(view_ids[i])->id_pose);
+    }
+    // Release the memory of the processed view
+    resections[i] = ResectionResult();
+  }
+  return bImageAdded;
+}
+
+/**
+ * @brief Compute the pose of an image from its 2D/3D matches with the scene.
+ * The scene is not modified (this function can be called concurrently).
+ * @param[in] viewIndex: image index to localize.
+ * @param[in] reconstructed_trackId: sorted ids of the reconstructed tracks.
+ * @param[out] resection: the pose, the intrinsic and the matching data.
  *
  * A. Compute 2D/3D matches
  * B. Look if intrinsic data is known or not
  * C. Do the resectioning: compute the camera pose.
  * D. Refine the pose of the found camera
- * E. Update the global scene with the new camera
- * F. Update the observations into the global scene structure
- * G. Triangulate new possible 2D tracks
  */
-bool SequentialSfMReconstructionEngine::Resection(const uint32_t viewIndex)
+bool SequentialSfMReconstructionEngine::ComputeResection
+(
+  const uint32_t viewIndex,
+  const std::vector<uint32_t> & reconstructed_trackId,
+  ResectionResult & resection
+) const
 {
   using namespace tracks;
 
   // A. Compute 2D/3D matches
   // A1. list tracks ids used by the view
-  openMVG::tracks::STLMAPTracks map_tracksCommon;
+  openMVG::tracks::STLMAPTracks & map_tracksCommon = resection.map_tracksCommon;
   shared_track_visibility_helper_->GetTracksInImages({viewIndex}, map_tracksCommon);
   std::set<uint32_t> set_tracksIds;
   TracksUtilsMap::GetTracksIdVector(map_tracksCommon, &set_tracksIds);
 
   // A2. intersects the track list with the reconstructed
-  std::set<uint32_t> reconstructed_trackId;
-  std::transform(sfm_data_.GetLandmarks().cbegin(), sfm_data_.GetLandmarks().cend(),
-    std::inserter(reconstructed_trackId, reconstructed_trackId.begin()),
-    stl::RetrieveKey());
-
   // Get the ids of the already reconstructed tracks
   std::set<uint32_t> set_trackIdForResection;
   std::set_intersection(set_tracksIds.cbegin(), set_tracksIds.cend(),
@@ -900,13 +1011,13 @@ bool SequentialSfMReconstructionEngine::Resection(const uint32_t viewIndex)
     &vec_featIdForResection);
 
   // Localize the image inside the SfM reconstruction
-  Image_Localizer_Match_Data resection_data;
+  Image_Localizer_Match_Data & resection_data = resection.resection_data;
   resection_data.pt2D.resize(2, set_trackIdForResection.size());
   resection_data.pt3D.resize(3, set_trackIdForResection.size());
 
   // B. Look if the intrinsic data is known or not
   const View * view_I = sfm_data_.GetViews().at(viewIndex).get();
-  std::shared_ptr<cameras::IntrinsicBase> optional_intrinsic;
+  std::shared_ptr<cameras::IntrinsicBase> & optional_intrinsic = resection.intrinsic;
   if (sfm_data_.GetIntrinsics().count(view_I->id_intrinsic))
   {
     optional_intrinsic = sfm_data_.GetIntrinsics().at(view_I->id_intrinsic);
@@ -931,7 +1042,8 @@ bool SequentialSfMReconstructionEngine::Resection(const uint32_t viewIndex)
   // C. Do the resectioning: compute the camera pose
   OPENMVG_LOG_INFO << "-- Trying robust Resection of view: " << viewIndex;
 
-  geometry::Pose3 pose;
+  geometry::Pose3 & pose = resection.pose;
+  resection.nb_putatives = vec_featIdForResection.size();
   const bool bResection = sfm::SfM_Localizer::Localize
   (
     optional_intrinsic ? resection_method_ : resection::SolverType::DLT_6POINTS,
@@ -942,36 +1054,13 @@ bool SequentialSfMReconstructionEngine::Resection(const uint32_t viewIndex)
   );
   resection_data.pt2D = std::move(pt2D_original); // restore original image domain points
 
-  if (!sLogging_file_.empty())
-  {
-    using namespace htmlDocument;
-    std::ostringstream os;
-    os << "Resection of Image index: <" << viewIndex << "> image: "
-      << view_I->s_Img_path <<"<br> \n";
-    html_doc_stream_->pushInfo(htmlMarkup("h1",os.str()));
-
-    os.str("");
-    os
-      << "-------------------------------" << "<br>"
-      << "-- Robust Resection of camera index: <" << viewIndex << "> image: "
-      <<  view_I->s_Img_path <<"<br>"
-      << "-- Threshold: " << resection_data.error_max << "<br>"
-      << "-- Resection status: " << (bResection ? "OK" : "FAILED") << "<br>"
-      << "-- Nb points used for Resection: " << vec_featIdForResection.size() << "<br>"
-      << "-- Nb points validated by robust estimation: " << resection_data.vec_inliers.size() << "<br>"
-      << "-- % points validated: "
-      << resection_data.vec_inliers.size()/static_cast<float>(vec_featIdForResection.size()) << "<br>"
-      << "-------------------------------" << "<br>";
-    html_doc_stream_->pushInfo(os.str());
-  }
-
   if (!bResection)
     return false;
 
   // D. Refine the pose of the found camera.
   // We use a local scene with only the 3D points and the new camera.
   {
-    const bool b_new_intrinsic = (optional_intrinsic == nullptr);
+    const bool b_new_intrinsic = resection.new_intrinsic = (optional_intrinsic == nullptr);
     // A valid pose has been found (try to refine it):
     // If no valid intrinsic as input:
     //  init a new one from the projection matrix decomposition
@@ -1028,30 +1117,75 @@ bool SequentialSfMReconstructionEngine::Resection(const uint32_t viewIndex)
       OPENMVG_LOG_ERROR << "Unable to refine the pose of the view id: " << viewIndex;
       return false;
     }
+  }
+  return true;
+}
 
-    // E. Update the global scene with:
-    // - the new found camera pose
-    sfm_data_.poses[view_I->id_pose] = pose;
-    // - track the view's AContrario robust estimation found threshold
-    map_ACThreshold_.insert({viewIndex, resection_data.error_max});
-    // - intrinsic parameters (if the view has no intrinsic group add a new one)
-    if (b_new_intrinsic)
+/**
+ * @brief Add a localized image to the 3D reconstruction.
+ * @param[in] viewIndex: image index to add to the reconstruction.
+ * @param[in] resection: the result of ComputeResection.
+ *
+ * E. Update the global scene with the new camera
+ * F. Update the observations into the global scene structure
+ * G. Triangulate new possible 2D tracks
+ */
+bool SequentialSfMReconstructionEngine::AddResectionToScene
+(
+  const uint32_t viewIndex,
+  const ResectionResult & resection
+)
+{
+  const View * view_I = sfm_data_.GetViews().at(viewIndex).get();
+  // Log the robust resection (if one was tried)
+  if (!sLogging_file_.empty() && resection.nb_putatives > 0)
+  {
+    using namespace htmlDocument;
+    std::ostringstream os;
+    os << "Resection of Image index: <" << viewIndex << "> image: "
+      << view_I->s_Img_path <<"<br> \n";
+    html_doc_stream_->pushInfo(htmlMarkup("h1",os.str()));
+
+    os.str("");
+    os
+      << "-------------------------------" << "<br>"
+      << "-- Robust Resection of camera index: <" << viewIndex << "> image: "
+      <<  view_I->s_Img_path <<"<br>"
+      << "-- Threshold: " << resection.resection_data.error_max << "<br>"
+      << "-- Resection status: " << (resection.valid ? "OK" : "FAILED") << "<br>"
+      << "-- Nb points used for Resection: " << resection.nb_putatives << "<br>"
+      << "-- Nb points validated by robust estimation: " << resection.resection_data.vec_inliers.size() << "<br>"
+      << "-- % points validated: "
+      << resection.resection_data.vec_inliers.size()/static_cast<float>(resection.nb_putatives) << "<br>"
+      << "-------------------------------" << "<br>";
+    html_doc_stream_->pushInfo(os.str());
+  }
+
+  if (!resection.valid)
+    return false;
+
+  // E. Update the global scene with:
+  // - the new found camera pose
+  sfm_data_.poses[view_I->id_pose] = resection.pose;
+  // - track the view's AContrario robust estimation found threshold
+  map_ACThreshold_.insert({viewIndex, resection.resection_data.error_max});
+  // - intrinsic parameters (if the view has no intrinsic group add a new one)
+  if (resection.new_intrinsic)
+  {
+    // Since the view have not yet an intrinsic group before, create a new one
+    IndexT new_intrinsic_id = 0;
+    if (!sfm_data_.GetIntrinsics().empty())
     {
-      // Since the view have not yet an intrinsic group before, create a new one
-      IndexT new_intrinsic_id = 0;
-      if (!sfm_data_.GetIntrinsics().empty())
-      {
-        // Since some intrinsic Id already exists,
-        //  we have to create a new unique identifier following the existing one
-        std::set<IndexT> existing_intrinsicId;
-          std::transform(sfm_data_.GetIntrinsics().cbegin(), sfm_data_.GetIntrinsics().cend(),
-          std::inserter(existing_intrinsicId, existing_intrinsicId.begin()),
-          stl::RetrieveKey());
-        new_intrinsic_id = (*existing_intrinsicId.rbegin())+1;
-      }
-      sfm_data_.views.at(viewIndex)->id_intrinsic = new_intrinsic_id;
-      sfm_data_.intrinsics[new_intrinsic_id] = optional_intrinsic;
+      // Since some intrinsic Id already exists,
+      //  we have to create a new unique identifier following the existing one
+      std::set<IndexT> existing_intrinsicId;
+      std::transform(sfm_data_.GetIntrinsics().cbegin(), sfm_data_.GetIntrinsics().cend(),
+        std::inserter(existing_intrinsicId, existing_intrinsicId.begin()),
+        stl::RetrieveKey());
+      new_intrinsic_id = (*existing_intrinsicId.rbegin())+1;
     }
+    sfm_data_.views.at(viewIndex)->id_intrinsic = new_intrinsic_id;
+    sfm_data_.intrinsics[new_intrinsic_id] = resection.intrinsic;
   }
 
   // F. List tracks that share content with this view and add observations and new 3D track if required.
@@ -1068,7 +1202,7 @@ bool SequentialSfMReconstructionEngine::Resection(const uint32_t viewIndex)
     const std::set<IndexT> valid_views = Get_Valid_Views(sfm_data_);
 
     // Go through each track and look if we must add new view observations or new 3D points
-    for (const std::pair<uint32_t, tracks::submapTrack>& trackIt : map_tracksCommon)
+    for (const std::pair<uint32_t, tracks::submapTrack>& trackIt : resection.map_tracksCommon)
     {
       const uint32_t trackId = trackIt.first;
       const tracks::submapTrack & track = trackIt.second;
@@ -1186,8 +1320,61 @@ bool SequentialSfMReconstructionEngine::Resection(const uint32_t viewIndex)
   return true;
 }
 
+bool SequentialSfMReconstructionEngine::IsGlobalBundleAdjustmentScheduled
+(
+  const size_t resection_group_index
+) const
+{
+  return !use_local_ba_
+    || (global_ba_period_ > 0 && resection_group_index - last_global_ba_group_index_ >= global_ba_period_)
+    || sfm_data_.GetPoses().size() >= global_ba_growth_ratio_ * last_global_ba_nb_poses_;
+}
+
+std::set<IndexT> SequentialSfMReconstructionEngine::LocalBundleAdjustmentPoses
+(
+  const std::set<IndexT> & new_pose_ids
+) const
+{
+  // Count the landmarks that the other poses share with the new poses
+  Hash_Map<IndexT, IndexT> covisibility;
+  for (const auto & landmark_it : sfm_data_.GetLandmarks())
+  {
+    const Observations & obs = landmark_it.second.obs;
+    const bool b_seen_by_new_pose = std::any_of(obs.cbegin(), obs.cend(),
+      [&](const Observations::value_type & obs_it)
+      {
+        return new_pose_ids.count(sfm_data_.GetViews().at(obs_it.first)->id_pose) > 0;
+      });
+    if (!b_seen_by_new_pose)
+      continue;
+    for (const auto & obs_it : obs)
+    {
+      const IndexT pose_id = sfm_data_.GetViews().at(obs_it.first)->id_pose;
+      if (new_pose_ids.count(pose_id) == 0)
+        ++covisibility[pose_id];
+    }
+  }
+
+  // Keep the most covisible poses
+  std::vector<std::pair<IndexT, IndexT>> covisible_poses(covisibility.cbegin(), covisibility.cend());
+  const size_t nb_covisible_poses = std::min<size_t>(local_ba_nb_covisible_poses_, covisible_poses.size());
+  std::partial_sort(covisible_poses.begin(), covisible_poses.begin() + nb_covisible_poses, covisible_poses.end(),
+    [](const std::pair<IndexT, IndexT> & a, const std::pair<IndexT, IndexT> & b)
+    {
+      return a.second > b.second || (a.second == b.second && a.first < b.first);
+    });
+
+  std::set<IndexT> pose_ids(new_pose_ids);
+  for (size_t i = 0; i < nb_covisible_poses; ++i)
+    pose_ids.insert(covisible_poses[i].first);
+  return pose_ids;
+}
+
 /// Bundle adjustment to refine Structure; Motion and Intrinsics
-bool SequentialSfMReconstructionEngine::BundleAdjustment()
+bool SequentialSfMReconstructionEngine::BundleAdjustment
+(
+  const std::set<IndexT> & local_pose_ids
+)
 {
   Bundle_Adjustment_Ceres::BA_Ceres_options options;
   if ( sfm_data_.GetPoses().size() > 100 &&
@@ -1204,7 +1391,6 @@ bool SequentialSfMReconstructionEngine::BundleAdjustment()
   {
     options.linear_solver_type_ = ceres::DENSE_SCHUR;
   }
-  Bundle_Adjustment_Ceres bundle_adjustment_obj(options);
   const Optimize_Options ba_refine_options
     ( ReconstructionEngine::intrinsic_refinement_options_,
       Extrinsic_Parameter_Type::ADJUST_ALL, // Adjust camera motion
@@ -1212,6 +1398,18 @@ bool SequentialSfMReconstructionEngine::BundleAdjustment()
       Control_Point_Parameter(),
       this->b_use_motion_prior_
     );
+  if (local_pose_ids.empty() && !this->b_use_motion_prior_)
+  {
+    // The global bundle adjustments share the same problem: only the
+    //  blocks of the scene parts that changed since the last one are updated
+    if (!ba_session_)
+      ba_session_.reset(new Bundle_Adjustment_Ceres_Session(ba_refine_options, options));
+    ba_session_->ceres_options() = options;
+    return ba_session_->Adjust(sfm_data_);
+  }
+  Bundle_Adjustment_Ceres bundle_adjustment_obj(options);
+  if (!local_pose_ids.empty())
+    return bundle_adjustment_obj.AdjustLocal(sfm_data_, local_pose_ids, ba_refine_options);
   return bundle_adjustment_obj.Adjust(sfm_data_, ba_refine_options);
 }
 
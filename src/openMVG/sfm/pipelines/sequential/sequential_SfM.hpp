@@ -9,14 +9,17 @@
 #ifndef OPENMVG_SFM_LOCALIZATION_SEQUENTIAL_SFM_HPP
 #define OPENMVG_SFM_LOCALIZATION_SEQUENTIAL_SFM_HPP
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "openMVG/sfm/pipelines/sfm_engine.hpp"
 #include "openMVG/cameras/cameras.hpp"
+#include "openMVG/geometry/pose3.hpp"
 #include "openMVG/multiview/solver_resection.hpp"
 #include "openMVG/multiview/triangulation_method.hpp"
+#include "openMVG/sfm/pipelines/localization/SfM_Localizer.hpp"
 #include "openMVG/tracks/tracks.hpp"
 
 namespace htmlDocument { class htmlDocumentStream; }
@@ -25,6 +28,7 @@ namespace { template <typename T> class Histogram; }
 namespace openMVG {
 namespace sfm {
 
+class Bundle_Adjustment_Ceres_Session;
 struct Features_Provider;
 struct Matches_Provider;
 
@@ -82,6 +86,32 @@ public:
     resection_method_ = method;
   }
 
+  /**
+   * Configure the local bundle adjustment mode.
+   * After a resection group, only the new poses, their most covisible poses
+   *  and the landmarks they see are refined. The global bundle adjustment is
+   *  run periodically and at the end of the reconstruction.
+   *
+   * @param use_local_ba Enable the local bundle adjustment
+   * @param nb_covisible_poses Number of covisible poses refined with the new poses
+   * @param global_ba_period Run a global BA every global_ba_period resection groups (0: disabled)
+   * @param global_ba_growth_ratio Run a global BA when the number of poses has grown
+   *  by this ratio since the last global BA
+   */
+  void SetLocalBundleAdjustment
+  (
+    const bool use_local_ba,
+    const unsigned int nb_covisible_poses = 20,
+    const unsigned int global_ba_period = 10,
+    const double global_ba_growth_ratio = 1.25
+  )
+  {
+    use_local_ba_ = use_local_ba;
+    local_ba_nb_covisible_poses_ = nb_covisible_poses;
+    global_ba_period_ = global_ba_period;
+    global_ba_growth_ratio_ = global_ba_growth_ratio;
+  }
+
 protected:
 
 
@@ -93,11 +123,43 @@ private:
   /// List the images that the greatest number of matches to the current 3D reconstruction.
   bool FindImagesWithPossibleResection(std::vector<uint32_t> & vec_possible_indexes);
 
-  /// Add a single Image to the scene and triangulate new possible tracks.
-  bool Resection(const uint32_t imageIndex);
+  /// Result of the localization of an image against the scene
+  struct ResectionResult
+  {
+    bool valid = false;
+    geometry::Pose3 pose;
+    std::shared_ptr<cameras::IntrinsicBase> intrinsic;
+    bool new_intrinsic = false; // the intrinsic must be added to the scene
+    size_t nb_putatives = 0;    // number of 2D/3D matches
+    Image_Localizer_Match_Data resection_data;
+    tracks::STLMAPTracks map_tracksCommon; // tracks seen by the image
+  };
+
+  /// Add a group of Images to the scene: the images are localized in parallel,
+  ///  then added one after the other (see AddResectionToScene).
+  bool Resection(const std::vector<uint32_t> & imageIndexes, std::set<IndexT> & new_pose_ids);
+
+  /// Localize an Image against the scene (the scene is not modified).
+  bool ComputeResection
+  (
+    const uint32_t imageIndex,
+    const std::vector<uint32_t> & reconstructed_trackIds,
+    ResectionResult & resection
+  ) const;
+
+  /// Add a localized Image to the scene and triangulate new possible tracks.
+  bool AddResectionToScene(const uint32_t imageIndex, const ResectionResult & resection);
 
   /// Bundle adjustment to refine Structure; Motion and Intrinsics
-  bool BundleAdjustment();
+  /// If local_pose_ids is not empty only these poses and the landmarks they see are refined
+  bool BundleAdjustment(const std::set<IndexT> & local_pose_ids = std::set<IndexT>());
+
+  /// List the poses to refine with a local bundle adjustment:
+  ///  the new poses and the poses that share the most landmarks with them
+  std::set<IndexT> LocalBundleAdjustmentPoses(const std::set<IndexT> & new_pose_ids) const;
+
+  /// Tell if the global bundle adjustment must be used for the current resection group
+  bool IsGlobalBundleAdjustmentScheduled(const size_t resection_group_index) const;
 
   /// Discard track with too large residual error
   bool badTrackRejector(double dPrecision, size_t count = 0);
@@ -131,6 +193,28 @@ private:
   ETriangulationMethod triangulation_method_ = ETriangulationMethod::DEFAULT;
 
   resection::SolverType resection_method_ = resection::SolverType::DEFAULT;
+
+  // Local bundle adjustment parameters
+  bool use_local_ba_ = false;
+  unsigned int local_ba_nb_covisible_poses_ = 20;
+  unsigned int global_ba_period_ = 10;
+  double global_ba_growth_ratio_ = 1.25;
+
+  // Bundle adjustment statistics of a resection group
+  struct BundleAdjustmentStatistics
+  {
+    size_t resection_group_index;
+    size_t nb_poses;
+    size_t nb_refined_poses; // 0 for a global bundle adjustment
+    size_t nb_runs;          // number of BA/outlier rejection iterations
+    double time;             // in seconds
+  };
+  std::vector<BundleAdjustmentStatistics> ba_statistics_;
+
+  // Problem reused by the successive global bundle adjustments
+  std::unique_ptr<Bundle_Adjustment_Ceres_Session> ba_session_;
+  size_t last_global_ba_group_index_ = 0;
+  size_t last_global_ba_nb_poses_ = 0;
 };
 
 } // namespace sfm
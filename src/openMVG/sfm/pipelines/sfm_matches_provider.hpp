@@ -9,6 +9,7 @@
 #ifndef OPENMVG_SFM_SFM_MATCHES_PROVIDER_HPP
 #define OPENMVG_SFM_SFM_MATCHES_PROVIDER_HPP
 
+#include <set>
 #include <string>
 
 #include "openMVG/matching/indMatch.hpp"
@@ -36,26 +37,15 @@ struct Matches_Provider
     {
       return false;
     }
-    if (!matching::Load(pairWise_matches_, matchesfile)) {
+    // Keep only the pairs of the views defined in SfM_Data
+    //  (the other pairs are not read for the .cbin files)
+    std::set<IndexT> view_ids;
+    for (const auto & view_it : sfm_data.GetViews())
+      view_ids.insert(view_it.first);
+    if (!matching::Load(pairWise_matches_, matchesfile, view_ids)) {
       OPENMVG_LOG_ERROR<< "Unable to read the matches file:" << matchesfile;
       return false;
     }
-    // Filter to keep only the one defined in SfM_Data
-    {
-      const Views & views = sfm_data.GetViews();
-      matching::PairWiseMatches matches_saved;
-      for (matching::PairWiseMatches::const_iterator iter = pairWise_matches_.begin();
-        iter != pairWise_matches_.end();
-        ++iter)
-      {
-        if (views.find(iter->first.first) != views.end() &&
-          views.find(iter->first.second) != views.end())
-        {
-          matches_saved.insert(*iter);
-        }
-      }
-      pairWise_matches_.swap(matches_saved);
-    }
     return true;
   }
 
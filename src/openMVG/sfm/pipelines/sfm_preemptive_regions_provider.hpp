@@ -35,6 +35,7 @@ public:
     if (!my_progress_bar)
       my_progress_bar = &system::ProgressInterface::dummy();
     region_type_.reset(region_type->EmptyClone());
+    init_view_basenames(sfm_data, feat_directory);
 
     my_progress_bar->Restart(sfm_data.GetViews().size(), "- Regions ---- Loading -");
     // Read for each view the corresponding regions and store them
@@ -56,11 +57,9 @@ public:
       {
         const std::string sImageName = stlplus::create_filespec(sfm_data.s_root_path, iter->second->s_Img_path);
         const std::string basename = stlplus::basename_part(sImageName);
-        const std::string featFile = stlplus::create_filespec(feat_directory, basename, ".feat");
-        const std::string descFile = stlplus::create_filespec(feat_directory, basename, ".desc");
 
         std::unique_ptr<features::Regions> regions_ptr(region_type->EmptyClone());
-        if (!regions_ptr->Load(featFile, descFile))
+        if (!LoadRegionsFromDirectory(feat_directory, basename, *regions_ptr))
         {
           OPENMVG_LOG_ERROR << "Invalid regions files for the view: " << sImageName;
           bContinue = false;
@@ -10,8 +10,10 @@
 #define OPENMVG_SFM_SFM_REGIONS_PROVIDER_HPP
 
 #include <atomic>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "openMVG/features/image_describer.hpp"
 #include "openMVG/features/regions_factory.hpp"
@@ -25,6 +27,33 @@
 namespace openMVG {
 namespace sfm {
 
+/// Load the regions related to an image basename from a feature directory.
+/// The single file binary format (.regions) is used if it exists and is not
+///  older than the .feat & .desc files (i.e. they were not computed again
+///  since the conversion), else the regions are read from the .feat & .desc files.
+inline bool LoadRegionsFromDirectory
+(
+  const std::string & feat_directory,
+  const std::string & basename,
+  features::Regions & regions
+)
+{
+  const std::string regionsFile = stlplus::create_filespec(feat_directory, basename, ".regions");
+  const std::string featFile = stlplus::create_filespec(feat_directory, basename, ".feat");
+  const std::string descFile = stlplus::create_filespec(feat_directory, basename, ".desc");
+  if (stlplus::is_file(regionsFile))
+  {
+    const time_t regions_time = stlplus::file_modified(regionsFile);
+    const bool b_outdated =
+      (stlplus::is_file(featFile) && stlplus::file_modified(featFile) > regions_time)
+      || (stlplus::is_file(descFile) && stlplus::file_modified(descFile) > regions_time);
+    if (!b_outdated)
+      return regions.LoadBinary(regionsFile);
+    OPENMVG_LOG_WARNING << regionsFile << " is older than the .feat/.desc files: it is not used.";
+  }
+  return regions.Load(featFile, descFile);
+}
+
 /// Abstract Regions provider
 /// Allow to load and return the regions related to a view
 struct Regions_Provider
@@ -84,6 +113,33 @@ public:
     return {};
   }
 
+  /// Return the directory the regions are loaded from
+  const std::string & feat_directory() const
+  {
+    return feat_directory_;
+  }
+
+  /// Return the basename of the regions files of a view (empty if unknown)
+  std::string basename(const IndexT x) const
+  {
+    const auto it = map_id_string_.find(x);
+    return (it != map_id_string_.cend()) ? it->second : std::string();
+  }
+
+  /// Return the number of views whose regions can be kept in memory
+  /// at the same time (0: no limit)
+  virtual std::size_t view_capacity() const
+  {
+    return 0;
+  }
+
+  /// Hint the provider about the views that will be requested soon.
+  /// Providers that load the regions on demand can use it to load them in
+  ///  background. The default provider has all the regions in memory.
+  virtual void prefetch(const std::vector<IndexT> & view_ids) const
+  {
+  }
+
   // Load Regions related to a provided SfM_Data View container
   virtual bool load(
     const SfM_Data & sfm_data,
@@ -94,6 +150,7 @@ public:
     if (!my_progress_bar)
       my_progress_bar = &system::ProgressInterface::dummy();
     region_type_.reset(region_type->EmptyClone());
+    init_view_basenames(sfm_data, feat_directory);
 
     my_progress_bar->Restart(sfm_data.GetViews().size(), "- Regions Loading -");
     // Read for each view the corresponding regions and store them
@@ -115,11 +172,9 @@ public:
       {
         const std::string sImageName = stlplus::create_filespec(sfm_data.s_root_path, iter->second->s_Img_path);
         const std::string basename = stlplus::basename_part(sImageName);
-        const std::string featFile = stlplus::create_filespec(feat_directory, basename, ".feat");
-        const std::string descFile = stlplus::create_filespec(feat_directory, basename, ".desc");
 
         std::unique_ptr<features::Regions> regions_ptr(region_type->EmptyClone());
-        if (!regions_ptr->Load(featFile, descFile))
+        if (!LoadRegionsFromDirectory(feat_directory, basename, *regions_ptr))
         {
           OPENMVG_LOG_ERROR << "Invalid regions files for the view: " << sImageName;
           bContinue = false;
@@ -138,9 +193,31 @@ public:
   }
 
 protected:
+
+  /// Build the association table from view id to regions files basename
+  void init_view_basenames
+  (
+    const SfM_Data & sfm_data,
+    const std::string & feat_directory
+  )
+  {
+    feat_directory_ = feat_directory;
+    map_id_string_.clear();
+    for (const auto & iterViews : sfm_data.GetViews())
+    {
+      const openMVG::IndexT id = iterViews.second->id_view;
+      assert( id == iterViews.first);
+      map_id_string_[id] = stlplus::basename_part(iterViews.second->s_Img_path);
+    }
+  }
+
   /// Regions per ViewId of the considered SfM_Data container
+  ///  (storage of the providers keeping all the regions in memory)
   mutable Hash_Map<IndexT, std::shared_ptr<features::Regions>> cache_;
   std::unique_ptr<openMVG::features::Regions> region_type_;
+
+  std::string feat_directory_; // The regions file directory
+  std::map<openMVG::IndexT, std::string> map_id_string_; // association of the view id & its basename
 }; // Regions_Provider
 
 } // namespace sfm
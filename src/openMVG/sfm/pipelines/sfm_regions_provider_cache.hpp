@@ -11,12 +11,19 @@
 
 #include "openMVG/sfm/pipelines/sfm_regions_provider.hpp"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
-#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <list>
 #include <map>
 #include <mutex>
+#include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "openMVG/system/logger.hpp"
 
@@ -24,52 +31,145 @@ namespace openMVG {
 namespace sfm {
 
 /// Regions provider Cache
-/// Store only a given count of regions in memory
+/// Store only a given count (and/or a given memory budget) of regions in memory.
+/// - Regions are loaded on demand, outside of any lock, so concurrent threads
+///   asking for different views load them in parallel,
+/// - The cache is split in shards (one mutex per shard),
+/// - When the cache is full the least recently used regions that are no
+///   longer referenced outside of the cache are released,
+/// - A background thread can load in advance the views announced by prefetch().
 struct Regions_Provider_Cache : public Regions_Provider
 {
 public:
 
+  /// @param max_cache_size maximum number of regions kept in memory (0: no limit)
+  /// @param max_cache_bytes memory budget of the cached regions in bytes (0: no limit)
   explicit Regions_Provider_Cache
   (
-    const unsigned int max_cache_size
+    const unsigned int max_cache_size,
+    const std::size_t max_cache_bytes = 0
   ): Regions_Provider(),
-     max_cache_size_(max_cache_size)
+     max_cache_size_(max_cache_size),
+     max_cache_bytes_(max_cache_bytes)
   {
   }
 
+  ~Regions_Provider_Cache() override
+  {
+    {
+      std::lock_guard<std::mutex> lock(prefetch_mutex_);
+      stop_prefetch_ = true;
+    }
+    prefetch_condition_.notify_all();
+    if (prefetch_thread_.joinable())
+      prefetch_thread_.join();
+  }
+
   std::shared_ptr<features::Regions> get(const IndexT x) const override
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = cache_.find(x);
-    std::shared_ptr<features::Regions> ret;
+    Cache_Shard & shard = shards_[x % kShardCount];
 
-    if (it == end(cache_))
+    std::promise<std::shared_ptr<features::Regions>> promise;
+    std::shared_future<std::shared_ptr<features::Regions>> future;
+    bool load_request = false;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      const auto it = shard.entries.find(x);
+      if (it != shard.entries.end())
+      {
+        // Move the element to the front of the LRU list
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru_it);
+        future = it->second.regions;
+        ++hit_count_;
+      }
+      else
+      {
+        // Register the element as "being loaded" for the concurrent requests
+        future = promise.get_future().share();
+        shard.lru.push_front(x);
+        shard.entries[x] = {future, shard.lru.begin(), 0, true};
+        ++miss_count_;
+        if (!shard.loaded_once.insert(x).second)
+          ++reload_count_;
+        ++cached_count_;
+        load_request = true;
+      }
+    }
+
+    if (!load_request)
+      return future.get();
+
+    // Load the ressource link to this ID (outside of any lock)
+    std::shared_ptr<features::Regions> ret;
+    try
     {
-      // Load the ressource link to this ID
-      const std::string id =
-        stlplus::create_filespec(feat_directory_, map_id_string_.at(x));
-      const std::string featFile = id + ".feat";
-      const std::string descFile = id + ".desc";
       ret.reset(region_type_->EmptyClone());
-      if (ret->Load(featFile, descFile))
+      if (!LoadRegionsFromDirectory(feat_directory_, map_id_string_.at(x), *ret))
       {
-        cache_[x] = ret;
+        // Invalid ressource -> an empty smart pointer is returned
+        ret.reset();
       }
-      // else -> Invalid ressource -> an empty smart poiter is returned
     }
-    else
+    catch (...)
     {
-      ret = it->second;
+      // Forget the element (a later request loads it again) and forward the
+      //  error to the concurrent requests waiting for it
+      erase_loading(shard, x);
+      promise.set_exception(std::current_exception());
+      throw;
     }
-    // If the cache is too large:
-    //  - try to prune elements that are no longer used
-    if (size() > max_cache_size_)
+    if (!ret)
     {
-      prune(true); // Prune only one cached object
+      erase_loading(shard, x);
+      promise.set_value(ret);
+      return ret;
     }
+    promise.set_value(ret);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      Cache_Entry & entry = shard.entries.at(x);
+      entry.bytes = ret->MemorySize();
+      entry.loading = false;
+      cached_bytes_ += entry.bytes;
+    }
+    // If the cache is too large:
+    //  - try to prune the least recently used elements that are no longer used
+    prune(x);
     return ret;
   }
 
+  /// Return the number of views that fit in the cache.
+  /// For a memory budget, the size of the regions is estimated from the
+  ///  cached ones, or from the size of the regions files of the first view if
+  ///  nothing is cached yet (the cache is left unchanged).
+  std::size_t view_capacity() const override
+  {
+    std::size_t capacity = max_cache_size_;
+    if (max_cache_bytes_ != 0 && !map_id_string_.empty())
+    {
+      const std::size_t count = cached_count_, bytes = cached_bytes_;
+      const std::size_t mean_bytes = std::max<std::size_t>(1,
+        (count != 0 && bytes != 0) ?
+          bytes / count : regions_files_size(map_id_string_.cbegin()->second));
+      const std::size_t budget_capacity = std::max<std::size_t>(1, max_cache_bytes_ / mean_bytes);
+      capacity = (capacity == 0) ? budget_capacity : std::min(capacity, budget_capacity);
+    }
+    return capacity;
+  }
+
+  /// Load in background the regions of the given views.
+  /// The request replaces the views that are not yet loaded from a previous call.
+  void prefetch(const std::vector<IndexT> & view_ids) const override
+  {
+    {
+      std::lock_guard<std::mutex> lock(prefetch_mutex_);
+      prefetch_queue_.assign(view_ids.cbegin(), view_ids.cend());
+      if (!prefetch_thread_.joinable())
+        prefetch_thread_ = std::thread(&Regions_Provider_Cache::prefetch_loop, this);
+    }
+    prefetch_condition_.notify_one();
+  }
+
   // Initialize the regions_provider_cache
   bool load
   (
@@ -79,57 +179,166 @@ public:
     system::ProgressInterface *
   ) override
   {
-    OPENMVG_LOG_INFO << "Initialization of the Regions_Provider_Cache. #Elements in the cache: "<< max_cache_size_;
+    OPENMVG_LOG_INFO << "Initialization of the Regions_Provider_Cache.\n"
+      << "#Elements in the cache: "
+      << ((max_cache_size_ == 0) ? "unlimited" : std::to_string(max_cache_size_)) << "\n"
+      << "Memory budget (MB): "
+      << ((max_cache_bytes_ == 0) ? "unlimited" : std::to_string(max_cache_bytes_ >> 20));
 
-    feat_directory_ = feat_directory;
     region_type_.reset(region_type->EmptyClone());
 
     // Build an association table from view id to feature & descriptor files
-    for (const auto & iterViews : sfm_data.GetViews())
-    {
-      const openMVG::IndexT id = iterViews.second->id_view;
-      assert( id == iterViews.first);
-      map_id_string_[id] = stlplus::basename_part(iterViews.second->s_Img_path);
-    }
+    init_view_basenames(sfm_data, feat_directory);
 
     return true;
   }
 
+  //-- Cache statistics
+  std::size_t hit_count() const { return hit_count_; }
+  std::size_t miss_count() const { return miss_count_; }
+  std::size_t eviction_count() const { return eviction_count_; }
+  /// Number of loads of views that were already loaded once (then evicted)
+  std::size_t reload_count() const { return reload_count_; }
+  std::size_t cached_bytes() const { return cached_bytes_; }
+
 private:
 
-  mutable std::mutex mutex_; // To deal with multithread concurrent access
+  static const std::size_t kShardCount = 16;
+
+  struct Cache_Entry
+  {
+    std::shared_future<std::shared_ptr<features::Regions>> regions;
+    std::list<IndexT>::iterator lru_it; // position in the shard LRU list
+    std::size_t bytes; // memory size of the loaded regions
+    bool loading; // true until the regions are loaded
+  };
+
+  struct Cache_Shard
+  {
+    std::mutex mutex;
+    Hash_Map<IndexT, Cache_Entry> entries;
+    std::list<IndexT> lru; // most recently used first
+    std::set<IndexT> loaded_once; // views loaded at least once
+  };
+
+  mutable std::array<Cache_Shard, kShardCount> shards_;
 
-  std::string feat_directory_; // The regions file directory
-  std::map<openMVG::IndexT, std::string> map_id_string_; // association of the view id & its basename
   const unsigned int max_cache_size_;
+  const std::size_t max_cache_bytes_;
+
+  mutable std::atomic<std::size_t> cached_count_{0};
+  mutable std::atomic<std::size_t> cached_bytes_{0};
+  mutable std::atomic<std::size_t> hit_count_{0};
+  mutable std::atomic<std::size_t> miss_count_{0};
+  mutable std::atomic<std::size_t> eviction_count_{0};
+  mutable std::atomic<std::size_t> reload_count_{0};
+
+  // Background loading
+  mutable std::mutex prefetch_mutex_;
+  mutable std::condition_variable prefetch_condition_;
+  mutable std::deque<IndexT> prefetch_queue_;
+  mutable std::thread prefetch_thread_;
+  bool stop_prefetch_ = false;
 
 private:
 
-  /// @brief Prune smart_ptr that are only referenced into the cache (not longer used externally)
+  bool is_full() const
+  {
+    return (max_cache_size_ != 0 && cached_count_ > max_cache_size_)
+      || (max_cache_bytes_ != 0 && cached_bytes_ > max_cache_bytes_);
+  }
+
+  bool has_room() const
+  {
+    return (max_cache_size_ == 0 || cached_count_ < max_cache_size_)
+      && (max_cache_bytes_ == 0 || cached_bytes_ < max_cache_bytes_);
+  }
+
+  /// Remove an element whose loading failed
+  void erase_loading(Cache_Shard & shard, const IndexT x) const
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.entries.find(x);
+    shard.lru.erase(it->second.lru_it);
+    shard.entries.erase(it);
+    --cached_count_;
+  }
+
+  /// Size of the regions files of a view (an estimate of its regions memory size)
+  std::size_t regions_files_size(const std::string & basename) const
+  {
+    const std::string regions_file =
+      stlplus::create_filespec(feat_directory_, basename, ".regions");
+    if (stlplus::is_file(regions_file))
+      return stlplus::file_size(regions_file);
+    return stlplus::file_size(stlplus::create_filespec(feat_directory_, basename, ".feat"))
+      + stlplus::file_size(stlplus::create_filespec(feat_directory_, basename, ".desc"));
+  }
+
+  bool is_cached(const IndexT x) const
+  {
+    Cache_Shard & shard = shards_[x % kShardCount];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.entries.count(x) != 0;
+  }
+
+  /// @brief Release the least recently used regions that are no longer used
+  ///  externally until the cache fits in its budget.
+  /// The shard of the last requested element is visited first.
   /// @return the number of removed elements
-  std::size_t prune(bool bPruneOnlyOne = false) const
+  std::size_t prune(const IndexT last_requested) const
   {
     std::size_t count = 0;
-    for (auto it = begin(cache_); it != end(cache_);)
+    const std::size_t first_shard = last_requested % kShardCount;
+    for (std::size_t s = 0; s < kShardCount && is_full(); ++s)
     {
-      if (it->second.use_count() == 1)
+      Cache_Shard & shard = shards_[(first_shard + s) % kShardCount];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (auto lru_it = shard.lru.end(); lru_it != shard.lru.begin() && is_full();)
       {
-        cache_.erase(it++);
+        --lru_it;
+        const auto it = shard.entries.find(*lru_it);
+        // Skip elements that are being loaded or that are still referenced
+        if (it->second.loading || it->second.regions.get().use_count() != 1)
+          continue;
+        cached_bytes_ -= it->second.bytes;
+        --cached_count_;
+        ++eviction_count_;
+        shard.entries.erase(it);
+        lru_it = shard.lru.erase(lru_it);
         ++count;
-        if (bPruneOnlyOne)
-        {
-          break;
-        }
-      }
-      else
-      {
-        ++it;
       }
     }
     return count;
   }
 
-  std::size_t size() const { return cache_.size(); }
+  void prefetch_loop() const
+  {
+    while (true)
+    {
+      IndexT x;
+      {
+        std::unique_lock<std::mutex> lock(prefetch_mutex_);
+        prefetch_condition_.wait(lock,
+          [this]{ return stop_prefetch_ || !prefetch_queue_.empty(); });
+        if (stop_prefetch_)
+          return;
+        x = prefetch_queue_.front();
+        prefetch_queue_.pop_front();
+      }
+      // Do not evict regions that are (or will soon be) used to load new ones
+      if (!has_room() || is_cached(x) || map_id_string_.count(x) == 0)
+        continue;
+      try
+      {
+        get(x);
+      }
+      catch (...)
+      {
+        // The error is reported to the thread that requests the view
+      }
+    }
+  }
 
 }; // Regions_Provider_Cache
 
@@ -26,6 +26,7 @@
 #include "openMVG/sfm/sfm_data_triangulation.hpp"
 
 #include "openMVG/sfm/sfm_filters.hpp"
+#include "openMVG/sfm/sfm_landmark_soa.hpp"
 
 //-----------------
 // SfM pipelines
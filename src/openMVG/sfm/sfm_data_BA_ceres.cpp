@@ -6,6 +6,9 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+// The <cereal/archives> headers are special and must be included first.
+#include <cereal/archives/binary.hpp>
+
 #include "openMVG/sfm/sfm_data_BA_ceres.hpp"
 
 #ifdef OPENMVG_USE_OPENMP
@@ -20,17 +23,31 @@
 #include "openMVG/geometry/Similarity3_Kernel.hpp"
 //- Robust estimation - LMeds (since no threshold can be defined)
 #include "openMVG/robust_estimation/robust_estimator_LMeds.hpp"
+#include "openMVG/sfm/sfm_data_BA_ceres_camera_analytic_functor.hpp"
 #include "openMVG/sfm/sfm_data_BA_ceres_camera_functor.hpp"
 #include "openMVG/sfm/sfm_data_transform.hpp"
 #include "openMVG/sfm/sfm_data.hpp"
+#include "openMVG/sfm/sfm_landmark_io.hpp"
+#include "openMVG/sfm/sfm_landmark_soa.hpp"
 #include "openMVG/system/logger.hpp"
 #include "openMVG/types.hpp"
 
+#include "third_party/stlplus3/filesystemSimplified/file_system.hpp"
+
 #include <ceres/rotation.h>
 #include <ceres/types.h>
 
+#include <cereal/types/map.hpp>
+#include <cereal/types/unordered_map.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <set>
 
 namespace openMVG {
 namespace sfm {
@@ -82,10 +99,31 @@ struct PoseCenterConstraintCostFunction
 ceres::CostFunction * IntrinsicsToCostFunction
 (
   IntrinsicBase * intrinsic,
-  const Vec2 & observation,
-  const double weight
+  const Eigen::Ref<const Vec2> & observation,
+  const double weight,
+  const bool b_analytic_jacobians
 )
 {
+  if (b_analytic_jacobians)
+  {
+    switch (intrinsic->getType())
+    {
+      case PINHOLE_CAMERA:
+        return analytic::ResidualErrorAnalytic_Pinhole_Intrinsic::Create(observation, weight);
+      case PINHOLE_CAMERA_RADIAL1:
+        return analytic::ResidualErrorAnalytic_Pinhole_Intrinsic_Radial_K1::Create(observation, weight);
+      case PINHOLE_CAMERA_RADIAL3:
+        return analytic::ResidualErrorAnalytic_Pinhole_Intrinsic_Radial_K3::Create(observation, weight);
+      case PINHOLE_CAMERA_BROWN:
+        return analytic::ResidualErrorAnalytic_Pinhole_Intrinsic_Brown_T2::Create(observation, weight);
+      case PINHOLE_CAMERA_FISHEYE:
+        return analytic::ResidualErrorAnalytic_Pinhole_Intrinsic_Fisheye::Create(observation, weight);
+      case CAMERA_SPHERICAL:
+        return analytic::ResidualErrorAnalytic_Intrinsic_Spherical::Create(intrinsic, observation, weight);
+      default:
+        return {};
+    }
+  }
   switch (intrinsic->getType())
   {
     case PINHOLE_CAMERA:
@@ -114,7 +152,8 @@ Bundle_Adjustment_Ceres::BA_Ceres_options::BA_Ceres_options
   nb_threads_(1),
   parameter_tolerance_(1e-8), //~= numeric_limits<float>::epsilon()
   bUse_loss_function_(true),
-  max_num_iterations_(500)
+  max_num_iterations_(500),
+  bUse_analytic_jacobians_(false)
 {
   #ifdef OPENMVG_USE_OPENMP
     nb_threads_ = omp_get_max_threads();
@@ -164,10 +203,213 @@ Bundle_Adjustment_Ceres::ceres_options()
   return ceres_options_;
 }
 
-bool Bundle_Adjustment_Ceres::Adjust
+// Parameter blocks setup & solver configuration
+
+/// Add a pose parameter block [angle axis, translation] and its parametrization
+static void AddPoseParameterBlock
+(
+  ceres::Problem & problem,
+  double * parameter_block,
+  const Extrinsic_Parameter_Type extrinsics_opt,
+  const bool b_constant
+)
+{
+  problem.AddParameterBlock(parameter_block, 6);
+  if (extrinsics_opt == Extrinsic_Parameter_Type::NONE || b_constant)
+  {
+    // set the whole parameter block as constant for best performance
+    problem.SetParameterBlockConstant(parameter_block);
+  }
+  else  // Subset parametrization
+  {
+    std::vector<int> vec_constant_extrinsic;
+    // If we adjust only the translation, we must set ROTATION as constant
+    if (extrinsics_opt == Extrinsic_Parameter_Type::ADJUST_TRANSLATION)
+    {
+      // Subset rotation parametrization
+      vec_constant_extrinsic.insert(vec_constant_extrinsic.end(), {0,1,2});
+    }
+    // If we adjust only the rotation, we must set TRANSLATION as constant
+    if (extrinsics_opt == Extrinsic_Parameter_Type::ADJUST_ROTATION)
+    {
+      // Subset translation parametrization
+      vec_constant_extrinsic.insert(vec_constant_extrinsic.end(), {3,4,5});
+    }
+    if (!vec_constant_extrinsic.empty())
+    {
+      ceres::SubsetParameterization *subset_parameterization =
+        new ceres::SubsetParameterization(6, vec_constant_extrinsic);
+      problem.SetParameterization(parameter_block, subset_parameterization);
+    }
+  }
+}
+
+/// Add an intrinsic parameter block and its parametrization
+static void AddIntrinsicParameterBlock
+(
+  ceres::Problem & problem,
+  std::vector<double> & parameters,
+  const IntrinsicBase & intrinsic,
+  const Intrinsic_Parameter_Type intrinsics_opt
+)
+{
+  double * parameter_block = &parameters[0];
+  problem.AddParameterBlock(parameter_block, parameters.size());
+  if (intrinsics_opt == Intrinsic_Parameter_Type::NONE)
+  {
+    // set the whole parameter block as constant for best performance
+    problem.SetParameterBlockConstant(parameter_block);
+  }
+  else
+  {
+    const std::vector<int> vec_constant_intrinsic =
+      intrinsic.subsetParameterization(intrinsics_opt);
+    if (!vec_constant_intrinsic.empty())
+    {
+      ceres::SubsetParameterization *subset_parameterization =
+        new ceres::SubsetParameterization(
+          parameters.size(), vec_constant_intrinsic);
+      problem.SetParameterization(parameter_block, subset_parameterization);
+    }
+  }
+}
+
+/// Pose to [angle axis, translation] parameters
+static void PoseToParameters(const Pose3 & pose, double * parameters)
+{
+  const Mat3 R = pose.rotation();
+  const Vec3 t = pose.translation();
+  ceres::RotationMatrixToAngleAxis((const double*)R.data(), parameters);
+  parameters[3] = t(0);
+  parameters[4] = t(1);
+  parameters[5] = t(2);
+}
+
+/// Update a pose with refined [angle axis, translation] parameters
+static void UpdatePoseFromParameters
+(
+  const double * parameters,
+  const Extrinsic_Parameter_Type extrinsics_opt,
+  Pose3 & pose
+)
+{
+  Mat3 R_refined;
+  ceres::AngleAxisToRotationMatrix(parameters, R_refined.data());
+  const Vec3 t_refined(parameters[3], parameters[4], parameters[5]);
+  if (extrinsics_opt == Extrinsic_Parameter_Type::ADJUST_ROTATION)
+  {
+      // Update only rotation
+      pose.rotation() = R_refined;
+  }
+  else if (extrinsics_opt == Extrinsic_Parameter_Type::ADJUST_TRANSLATION)
+  {
+      // Update only translation
+      Vec3 C_refined = -R_refined.transpose() * t_refined;
+      pose.center() = C_refined;
+  }
+  else
+  {
+      // Update rotation + translation
+      pose = Pose3(R_refined, -R_refined.transpose() * t_refined);
+  }
+}
+
+/// Configure a BA engine
+///  Make Ceres automatically detect the bundle structure.
+static ceres::Solver::Options SolverOptions
+(
+  const Bundle_Adjustment_Ceres::BA_Ceres_options & ceres_options_
+)
+{
+  ceres::Solver::Options ceres_config_options;
+  ceres_config_options.max_num_iterations = ceres_options_.max_num_iterations_;
+  ceres_config_options.preconditioner_type =
+    static_cast<ceres::PreconditionerType>(ceres_options_.preconditioner_type_);
+  ceres_config_options.linear_solver_type =
+    static_cast<ceres::LinearSolverType>(ceres_options_.linear_solver_type_);
+  ceres_config_options.sparse_linear_algebra_library_type =
+    static_cast<ceres::SparseLinearAlgebraLibraryType>(ceres_options_.sparse_linear_algebra_library_type_);
+  ceres_config_options.minimizer_progress_to_stdout = ceres_options_.bVerbose_;
+  ceres_config_options.logging_type = ceres::SILENT;
+  ceres_config_options.num_threads = ceres_options_.nb_threads_;
+#if CERES_VERSION_MAJOR < 2
+  ceres_config_options.num_linear_solver_threads = ceres_options_.nb_threads_;
+#endif
+  ceres_config_options.parameter_tolerance = ceres_options_.parameter_tolerance_;
+  return ceres_config_options;
+}
+
+// Structure access used by the bundle adjustment (Landmarks or Landmarks_SoA)
+
+/// Call add_observation(view id, observation data, X data) for each observation
+/// (the cost functors keep the observation address: it must not be a temporary)
+template <typename ObservationFunctor>
+static bool ForEachStructureObservation
+(
+  Landmarks & structure,
+  ObservationFunctor && add_observation
+)
+{
+  for (auto & structure_landmark_it : structure)
+  {
+    for (const auto & obs_it : structure_landmark_it.second.obs)
+    {
+      if (!add_observation(obs_it.first, obs_it.second.x.data(), structure_landmark_it.second.X.data()))
+        return false;
+    }
+  }
+  return true;
+}
+
+template <typename ObservationFunctor>
+static bool ForEachStructureObservation
+(
+  Landmarks_SoA & structure,
+  ObservationFunctor && add_observation
+)
+{
+  for (std::size_t i = 0; i < structure.size(); ++i)
+  {
+    for (uint64_t obs = structure.obs_offsets[i]; obs < structure.obs_offsets[i + 1]; ++obs)
+    {
+      if (!add_observation(structure.obs_view_ids[obs], structure.obs_x.col(obs).data(), structure.X.col(i).data()))
+        return false;
+    }
+  }
+  return true;
+}
+
+/// Call f(X data) for each landmark
+template <typename PointFunctor>
+static void ForEachStructurePoint(Landmarks & structure, PointFunctor && f)
+{
+  for (auto & structure_landmark_it : structure)
+    f(structure_landmark_it.second.X.data());
+}
+
+template <typename PointFunctor>
+static void ForEachStructurePoint(Landmarks_SoA & structure, PointFunctor && f)
+{
+  for (std::size_t i = 0; i < structure.size(); ++i)
+    f(structure.X.col(i).data());
+}
+
+/// The Landmarks structure is transformed along with the SfM_Data scene
+static void ApplySimilarityToStructure(const Similarity3 &, Landmarks &) {}
+
+static void ApplySimilarityToStructure(const Similarity3 & sim, Landmarks_SoA & structure)
+{
+  ApplySimilarity(sim, structure);
+}
+
+template <typename Structure>
+static bool Adjust_Structure
 (
   SfM_Data & sfm_data,     // the SfM scene to refine
-  const Optimize_Options & options
+  Structure & structure,   // the landmarks to refine
+  const Optimize_Options & options,
+  const Bundle_Adjustment_Ceres::BA_Ceres_options & ceres_options_,
+  const std::set<IndexT> & constant_pose_ids = std::set<IndexT>() // poses held as constant
 )
 {
   //----------
@@ -223,6 +465,7 @@ bool Bundle_Adjustment_Ceres::Adjust
 
           // Apply the found transformation to the SfM Data Scene
           openMVG::sfm::ApplySimilarity(sim, sfm_data);
+          ApplySimilarityToStructure(sim, structure);
 
           // Move entire scene to center for better numerical stability
           Vec3 pose_centroid = Vec3::Zero();
@@ -232,6 +475,7 @@ bool Bundle_Adjustment_Ceres::Adjust
           }
           sim_to_center = openMVG::geometry::Similarity3(openMVG::sfm::Pose3(Mat3::Identity(), pose_centroid), 1.0);
           openMVG::sfm::ApplySimilarity(sim_to_center, sfm_data, true);
+          ApplySimilarityToStructure(sim_to_center, structure);
         }
       }
       else
@@ -252,44 +496,12 @@ bool Bundle_Adjustment_Ceres::Adjust
   {
     const IndexT indexPose = pose_it.first;
 
-    const Pose3 & pose = pose_it.second;
-    const Mat3 R = pose.rotation();
-    const Vec3 t = pose.translation();
-
-    double angleAxis[3];
-    ceres::RotationMatrixToAngleAxis((const double*)R.data(), angleAxis);
     // angleAxis + translation
-    map_poses[indexPose] = {angleAxis[0], angleAxis[1], angleAxis[2], t(0), t(1), t(2)};
-
-    double * parameter_block = &map_poses.at(indexPose)[0];
-    problem.AddParameterBlock(parameter_block, 6);
-    if (options.extrinsics_opt == Extrinsic_Parameter_Type::NONE)
-    {
-      // set the whole parameter block as constant for best performance
-      problem.SetParameterBlockConstant(parameter_block);
-    }
-    else  // Subset parametrization
-    {
-      std::vector<int> vec_constant_extrinsic;
-      // If we adjust only the translation, we must set ROTATION as constant
-      if (options.extrinsics_opt == Extrinsic_Parameter_Type::ADJUST_TRANSLATION)
-      {
-        // Subset rotation parametrization
-        vec_constant_extrinsic.insert(vec_constant_extrinsic.end(), {0,1,2});
-      }
-      // If we adjust only the rotation, we must set TRANSLATION as constant
-      if (options.extrinsics_opt == Extrinsic_Parameter_Type::ADJUST_ROTATION)
-      {
-        // Subset translation parametrization
-        vec_constant_extrinsic.insert(vec_constant_extrinsic.end(), {3,4,5});
-      }
-      if (!vec_constant_extrinsic.empty())
-      {
-        ceres::SubsetParameterization *subset_parameterization =
-          new ceres::SubsetParameterization(6, vec_constant_extrinsic);
-        problem.SetParameterization(parameter_block, subset_parameterization);
-      }
-    }
+    std::vector<double> & parameters = map_poses[indexPose];
+    parameters.resize(6);
+    PoseToParameters(pose_it.second, &parameters[0]);
+    AddPoseParameterBlock(problem, &parameters[0], options.extrinsics_opt,
+      constant_pose_ids.count(indexPose) > 0);
   }
 
   // Setup Intrinsics data & subparametrization
@@ -302,25 +514,8 @@ bool Bundle_Adjustment_Ceres::Adjust
       map_intrinsics[indexCam] = intrinsic_it.second->getParams();
       if (!map_intrinsics.at(indexCam).empty())
       {
-        double * parameter_block = &map_intrinsics.at(indexCam)[0];
-        problem.AddParameterBlock(parameter_block, map_intrinsics.at(indexCam).size());
-        if (options.intrinsics_opt == Intrinsic_Parameter_Type::NONE)
-        {
-          // set the whole parameter block as constant for best performance
-          problem.SetParameterBlockConstant(parameter_block);
-        }
-        else
-        {
-          const std::vector<int> vec_constant_intrinsic =
-            intrinsic_it.second->subsetParameterization(options.intrinsics_opt);
-          if (!vec_constant_intrinsic.empty())
-          {
-            ceres::SubsetParameterization *subset_parameterization =
-              new ceres::SubsetParameterization(
-                map_intrinsics.at(indexCam).size(), vec_constant_intrinsic);
-            problem.SetParameterization(parameter_block, subset_parameterization);
-          }
-        }
+        AddIntrinsicParameterBlock(problem, map_intrinsics.at(indexCam),
+          *intrinsic_it.second, options.intrinsics_opt);
       }
     }
     else
@@ -337,48 +532,47 @@ bool Bundle_Adjustment_Ceres::Adjust
       : nullptr;
 
   // For all visibility add reprojections errors:
-  for (auto & structure_landmark_it : sfm_data.structure)
-  {
-    const Observations & obs = structure_landmark_it.second.obs;
-
-    for (const auto & obs_it : obs)
+  const bool b_structure_residuals = ForEachStructureObservation(structure,
+    [&](const IndexT view_id, const double * x, double * X) -> bool
     {
       // Build the residual block corresponding to the track observation:
-      const View * view = sfm_data.views.at(obs_it.first).get();
+      const View * view = sfm_data.views.at(view_id).get();
 
       // Each Residual block takes a point and a camera as input and outputs a 2
       // dimensional residual. Internally, the cost function stores the observed
       // image location and compares the reprojection against the observation.
       ceres::CostFunction* cost_function =
         IntrinsicsToCostFunction(sfm_data.intrinsics.at(view->id_intrinsic).get(),
-                                 obs_it.second.x);
+          Eigen::Map<const Vec2>(x), 0.0, ceres_options_.bUse_analytic_jacobians_);
 
-      if (cost_function)
+      if (!cost_function)
       {
-        if (!map_intrinsics.at(view->id_intrinsic).empty())
-        {
-          problem.AddResidualBlock(cost_function,
-            p_LossFunction,
-            &map_intrinsics.at(view->id_intrinsic)[0],
-            &map_poses.at(view->id_pose)[0],
-            structure_landmark_it.second.X.data());
-        }
-        else
-        {
-          problem.AddResidualBlock(cost_function,
-            p_LossFunction,
-            &map_poses.at(view->id_pose)[0],
-            structure_landmark_it.second.X.data());
-        }
+        OPENMVG_LOG_ERROR << "Cannot create a CostFunction for this camera model.";
+        return false;
+      }
+      if (!map_intrinsics.at(view->id_intrinsic).empty())
+      {
+        problem.AddResidualBlock(cost_function,
+          p_LossFunction,
+          &map_intrinsics.at(view->id_intrinsic)[0],
+          &map_poses.at(view->id_pose)[0],
+          X);
       }
       else
       {
-        OPENMVG_LOG_ERROR << "Cannot create a CostFunction for this camera model.";
-        return false;
+        problem.AddResidualBlock(cost_function,
+          p_LossFunction,
+          &map_poses.at(view->id_pose)[0],
+          X);
       }
-    }
-    if (options.structure_opt == Structure_Parameter_Type::NONE)
-      problem.SetParameterBlockConstant(structure_landmark_it.second.X.data());
+      return true;
+    });
+  if (!b_structure_residuals)
+    return false;
+  if (options.structure_opt == Structure_Parameter_Type::NONE)
+  {
+    ForEachStructurePoint(structure,
+      [&](double * X) { problem.SetParameterBlockConstant(X); });
   }
 
   if (options.control_point_opt.bUse_control_points)
@@ -401,7 +595,8 @@ bool Bundle_Adjustment_Ceres::Adjust
           IntrinsicsToCostFunction(
             sfm_data.intrinsics.at(view->id_intrinsic).get(),
             obs_it.second.x,
-            options.control_point_opt.weight);
+            options.control_point_opt.weight,
+            ceres_options_.bUse_analytic_jacobians_);
 
         if (cost_function)
         {
@@ -459,22 +654,7 @@ bool Bundle_Adjustment_Ceres::Adjust
   }
 
   // Configure a BA engine and run it
-  //  Make Ceres automatically detect the bundle structure.
-  ceres::Solver::Options ceres_config_options;
-  ceres_config_options.max_num_iterations = ceres_options_.max_num_iterations_;
-  ceres_config_options.preconditioner_type =
-    static_cast<ceres::PreconditionerType>(ceres_options_.preconditioner_type_);
-  ceres_config_options.linear_solver_type =
-    static_cast<ceres::LinearSolverType>(ceres_options_.linear_solver_type_);
-  ceres_config_options.sparse_linear_algebra_library_type =
-    static_cast<ceres::SparseLinearAlgebraLibraryType>(ceres_options_.sparse_linear_algebra_library_type_);
-  ceres_config_options.minimizer_progress_to_stdout = ceres_options_.bVerbose_;
-  ceres_config_options.logging_type = ceres::SILENT;
-  ceres_config_options.num_threads = ceres_options_.nb_threads_;
-#if CERES_VERSION_MAJOR < 2
-  ceres_config_options.num_linear_solver_threads = ceres_options_.nb_threads_;
-#endif
-  ceres_config_options.parameter_tolerance = ceres_options_.parameter_tolerance_;
+  const ceres::Solver::Options ceres_config_options = SolverOptions(ceres_options_);
 
   // Solve BA
   ceres::Solver::Summary summary;
@@ -498,7 +678,7 @@ bool Bundle_Adjustment_Ceres::Adjust
         << " #views: " << sfm_data.views.size() << "\n"
         << " #poses: " << sfm_data.poses.size() << "\n"
         << " #intrinsics: " << sfm_data.intrinsics.size() << "\n"
-        << " #tracks: " << sfm_data.structure.size() << "\n"
+        << " #tracks: " << structure.size() << "\n"
         << " #residuals: " << summary.num_residuals << "\n"
         << " Initial RMSE: " << std::sqrt( summary.initial_cost / summary.num_residuals) << "\n"
         << " Final RMSE: " << std::sqrt( summary.final_cost / summary.num_residuals) << "\n"
@@ -513,28 +693,11 @@ bool Bundle_Adjustment_Ceres::Adjust
       for (auto & pose_it : sfm_data.poses)
       {
         const IndexT indexPose = pose_it.first;
+        if (constant_pose_ids.count(indexPose))
+          continue;
 
-        Mat3 R_refined;
-        ceres::AngleAxisToRotationMatrix(&map_poses.at(indexPose)[0], R_refined.data());
-        Vec3 t_refined(map_poses.at(indexPose)[3], map_poses.at(indexPose)[4], map_poses.at(indexPose)[5]);
         // Update the pose
-        Pose3 & pose = pose_it.second;
-        if (options.extrinsics_opt == Extrinsic_Parameter_Type::ADJUST_ROTATION)
-        {
-            // Update only rotation
-            pose.rotation() = R_refined;
-        }
-        else if (options.extrinsics_opt == Extrinsic_Parameter_Type::ADJUST_TRANSLATION)
-        {
-            // Update only translation
-            Vec3 C_refined = -R_refined.transpose() * t_refined;
-            pose.center() = C_refined;
-        }
-        else
-        {
-            // Update rotation + translation
-            pose = Pose3(R_refined, -R_refined.transpose() * t_refined);
-        }
+        UpdatePoseFromParameters(&map_poses.at(indexPose)[0], options.extrinsics_opt, pose_it.second);
       }
     }
 
@@ -556,6 +719,7 @@ bool Bundle_Adjustment_Ceres::Adjust
     {
       // set back to the original scene centroid
       openMVG::sfm::ApplySimilarity(sim_to_center.inverse(), sfm_data, true);
+      ApplySimilarityToStructure(sim_to_center.inverse(), structure);
 
       //--
       // - Compute some fitting statistics
@@ -590,5 +754,1287 @@ bool Bundle_Adjustment_Ceres::Adjust
   }
 }
 
+bool Bundle_Adjustment_Ceres::Adjust
+(
+  SfM_Data & sfm_data,     // the SfM scene to refine
+  const Optimize_Options & options
+)
+{
+  return Adjust_Structure(sfm_data, sfm_data.structure, options, ceres_options_);
+}
+
+bool Bundle_Adjustment_Ceres::Adjust
+(
+  SfM_Data & sfm_data,     // the SfM scene to refine
+  Landmarks_SoA & structure,
+  const Optimize_Options & options
+)
+{
+  return Adjust_Structure(sfm_data, structure, options, ceres_options_);
+}
+
+bool Bundle_Adjustment_Ceres::AdjustLocal
+(
+  SfM_Data & sfm_data,     // the SfM scene to refine
+  const std::set<IndexT> & pose_ids,
+  const Optimize_Options & options
+)
+{
+  // Build a sub scene with:
+  // - the landmarks seen by the refined poses,
+  // - the views & poses that observe these landmarks,
+  //   (the poses that are not in pose_ids are held as constant)
+  SfM_Data local_scene;
+  for (const auto & landmark_it : sfm_data.structure)
+  {
+    const Observations & obs = landmark_it.second.obs;
+    const bool b_refined = std::any_of(obs.cbegin(), obs.cend(),
+      [&](const Observations::value_type & obs_it)
+      {
+        return pose_ids.count(sfm_data.views.at(obs_it.first)->id_pose) > 0;
+      });
+    if (!b_refined)
+      continue;
+    local_scene.structure.insert(landmark_it);
+    for (const auto & obs_it : obs)
+    {
+      const std::shared_ptr<View> & view = sfm_data.views.at(obs_it.first);
+      local_scene.views.insert({view->id_view, view});
+      local_scene.poses.insert({view->id_pose, sfm_data.poses.at(view->id_pose)});
+      local_scene.intrinsics.insert({view->id_intrinsic, sfm_data.intrinsics.at(view->id_intrinsic)});
+    }
+  }
+  if (local_scene.structure.empty())
+    return false;
+
+  std::set<IndexT> constant_pose_ids;
+  for (const auto & pose_it : local_scene.poses)
+  {
+    if (pose_ids.count(pose_it.first) == 0)
+      constant_pose_ids.insert(pose_it.first);
+  }
+
+  // The motion priors and the GCP are defined for the whole scene.
+  // The intrinsics are shared with the constant poses: refining them from the
+  //  local observations only would bias the rest of the scene.
+  Optimize_Options local_options(options);
+  local_options.intrinsics_opt = Intrinsic_Parameter_Type::NONE;
+  local_options.use_motion_priors_opt = false;
+  local_options.control_point_opt.bUse_control_points = false;
+
+  if (!Adjust_Structure(local_scene, local_scene.structure, local_options, ceres_options_, constant_pose_ids))
+    return false;
+
+  // Get back the refined poses & landmarks
+  for (const IndexT pose_id : pose_ids)
+  {
+    const auto pose_it = local_scene.poses.find(pose_id);
+    if (pose_it != local_scene.poses.end())
+      sfm_data.poses.at(pose_id) = pose_it->second;
+  }
+  for (const auto & landmark_it : local_scene.structure)
+  {
+    sfm_data.structure.at(landmark_it.first).X = landmark_it.second.X;
+  }
+  return true;
+}
+
+//----
+//-- Bundle_Adjustment_Ceres_Session
+//----
+
+struct Bundle_Adjustment_Ceres_Session::Problem_Data
+{
+  struct Pose_Block
+  {
+    std::array<double, 6> parameters; // angle axis + translation
+    std::array<double, 6> synchronized_parameters; // value at the last synchronization
+    Pose3 pose; // pose corresponding to synchronized_parameters
+  };
+
+  struct Intrinsic_Block
+  {
+    std::vector<double> parameters;
+    std::vector<double> synchronized_parameters;
+    EINTRINSIC type; // the camera model of the cost functions
+  };
+
+  struct Observation_Block
+  {
+    Vec2 x; // the cost functor keeps a pointer to this observation
+    IndexT id_intrinsic; // parameter blocks of the residual block
+    IndexT id_pose;
+    ceres::ResidualBlockId residual_block_id;
+  };
+
+  struct Landmark_Block
+  {
+    Vec3 X;
+    Hash_Map<IndexT, Observation_Block> obs; // view id -> residual block
+  };
+
+  std::unique_ptr<ceres::LossFunction> loss_function;
+  Hash_Map<IndexT, Pose_Block> poses;
+  Hash_Map<IndexT, Intrinsic_Block> intrinsics;
+  Hash_Map<IndexT, Landmark_Block> landmarks;
+  // Declared last: destroyed first (it refers to the blocks above)
+  std::unique_ptr<ceres::Problem> problem;
+};
+
+Bundle_Adjustment_Ceres_Session::Bundle_Adjustment_Ceres_Session
+(
+  const Optimize_Options & options,
+  const Bundle_Adjustment_Ceres::BA_Ceres_options & ceres_options
+)
+: options_(options),
+  ceres_options_(ceres_options),
+  data_(new Problem_Data)
+{
+  if (options_.use_motion_priors_opt || options_.control_point_opt.bUse_control_points)
+  {
+    OPENMVG_LOG_WARNING
+      << "The motion priors and the GCP are not used by a bundle adjustment session.";
+  }
+
+  // The residual blocks are often removed (fast removal) and share the same loss
+  ceres::Problem::Options problem_options;
+  problem_options.enable_fast_removal = true;
+  problem_options.loss_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+  data_->problem.reset(new ceres::Problem(problem_options));
+  if (ceres_options_.bUse_loss_function_)
+    data_->loss_function.reset(new ceres::HuberLoss(Square(4.0)));
+}
+
+Bundle_Adjustment_Ceres_Session::~Bundle_Adjustment_Ceres_Session() = default;
+
+Bundle_Adjustment_Ceres::BA_Ceres_options &
+Bundle_Adjustment_Ceres_Session::ceres_options()
+{
+  return ceres_options_;
+}
+
+std::size_t Bundle_Adjustment_Ceres_Session::NbResidualBlocks() const
+{
+  return data_->problem->NumResidualBlocks();
+}
+
+bool Bundle_Adjustment_Ceres_Session::Synchronize
+(
+  const SfM_Data & sfm_data
+)
+{
+  // Check the camera models first: the problem is left unchanged on failure
+  for (const auto & intrinsic_it : sfm_data.intrinsics)
+  {
+    if (!isValid(intrinsic_it.second->getType()))
+    {
+      OPENMVG_LOG_ERROR << "Unsupported camera type.";
+      return false;
+    }
+  }
+
+  ceres::Problem & problem = *data_->problem;
+
+  // Poses: add the new ones, update the parameters of the modified ones
+  for (const auto & pose_it : sfm_data.poses)
+  {
+    auto block_it = data_->poses.find(pose_it.first);
+    if (block_it == data_->poses.end())
+    {
+      Problem_Data::Pose_Block & block = data_->poses[pose_it.first];
+      PoseToParameters(pose_it.second, block.parameters.data());
+      block.synchronized_parameters = block.parameters;
+      block.pose = pose_it.second;
+      AddPoseParameterBlock(problem, block.parameters.data(), options_.extrinsics_opt, false);
+    }
+    else
+    {
+      Problem_Data::Pose_Block & block = block_it->second;
+      if (block.pose.rotation() != pose_it.second.rotation() ||
+          block.pose.center() != pose_it.second.center())
+      {
+        PoseToParameters(pose_it.second, block.parameters.data());
+        block.pose = pose_it.second;
+      }
+      block.synchronized_parameters = block.parameters;
+    }
+  }
+
+  // Intrinsics: add the new ones, update the parameters of the modified ones.
+  // An intrinsic replaced by another camera model is rebuilt, along with the
+  // residual blocks using it.
+  for (const auto & intrinsic_it : sfm_data.intrinsics)
+  {
+    const std::vector<double> parameters = intrinsic_it.second->getParams();
+    auto block_it = data_->intrinsics.find(intrinsic_it.first);
+    if (block_it != data_->intrinsics.end()
+        && (block_it->second.type != intrinsic_it.second->getType()
+            || block_it->second.parameters.size() != parameters.size()))
+    {
+      for (auto & landmark_block_it : data_->landmarks)
+      {
+        Hash_Map<IndexT, Problem_Data::Observation_Block> & obs = landmark_block_it.second.obs;
+        for (auto obs_block_it = obs.begin(); obs_block_it != obs.end();)
+        {
+          if (obs_block_it->second.id_intrinsic == intrinsic_it.first)
+          {
+            problem.RemoveResidualBlock(obs_block_it->second.residual_block_id);
+            obs_block_it = obs.erase(obs_block_it);
+          }
+          else
+            ++obs_block_it;
+        }
+      }
+      if (!block_it->second.parameters.empty())
+        problem.RemoveParameterBlock(&block_it->second.parameters[0]);
+      data_->intrinsics.erase(block_it);
+      block_it = data_->intrinsics.end();
+    }
+    if (block_it == data_->intrinsics.end())
+    {
+      Problem_Data::Intrinsic_Block & block = data_->intrinsics[intrinsic_it.first];
+      block.parameters = block.synchronized_parameters = parameters;
+      block.type = intrinsic_it.second->getType();
+      if (!block.parameters.empty())
+      {
+        AddIntrinsicParameterBlock(problem, block.parameters,
+          *intrinsic_it.second, options_.intrinsics_opt);
+      }
+    }
+    else
+    {
+      Problem_Data::Intrinsic_Block & block = block_it->second;
+      if (block.synchronized_parameters != parameters)
+      {
+        // the parameter block address is kept (same camera model)
+        std::copy(parameters.cbegin(), parameters.cend(), block.parameters.begin());
+        block.synchronized_parameters = parameters;
+      }
+    }
+  }
+
+  // Landmarks: remove the deleted ones (and their residual blocks)
+  for (auto block_it = data_->landmarks.begin(); block_it != data_->landmarks.end();)
+  {
+    if (sfm_data.structure.count(block_it->first) == 0)
+    {
+      problem.RemoveParameterBlock(block_it->second.X.data());
+      block_it = data_->landmarks.erase(block_it);
+    }
+    else
+      ++block_it;
+  }
+
+  // Landmarks: add the new ones, update the point & the observations of the others
+  for (const auto & landmark_it : sfm_data.structure)
+  {
+    const Landmark & landmark = landmark_it.second;
+    auto block_it = data_->landmarks.find(landmark_it.first);
+    const bool b_new_landmark = (block_it == data_->landmarks.end());
+    Problem_Data::Landmark_Block & block =
+      b_new_landmark ? data_->landmarks[landmark_it.first] : block_it->second;
+    block.X = landmark.X;
+    if (b_new_landmark)
+    {
+      problem.AddParameterBlock(block.X.data(), 3);
+      if (options_.structure_opt == Structure_Parameter_Type::NONE)
+        problem.SetParameterBlockConstant(block.X.data());
+    }
+
+    // Remove the residual blocks of the deleted or modified observations
+    //  (moved point, or view moved to another intrinsic or pose)
+    for (auto obs_block_it = block.obs.begin(); obs_block_it != block.obs.end();)
+    {
+      const auto obs_it = landmark.obs.find(obs_block_it->first);
+      const View * view = obs_it != landmark.obs.end() ?
+        sfm_data.views.at(obs_it->first).get() : nullptr;
+      if (!view || obs_it->second.x != obs_block_it->second.x
+          || view->id_intrinsic != obs_block_it->second.id_intrinsic
+          || view->id_pose != obs_block_it->second.id_pose)
+      {
+        problem.RemoveResidualBlock(obs_block_it->second.residual_block_id);
+        obs_block_it = block.obs.erase(obs_block_it);
+      }
+      else
+        ++obs_block_it;
+    }
+
+    // Add the residual blocks of the new observations
+    for (const auto & obs_it : landmark.obs)
+    {
+      if (block.obs.count(obs_it.first))
+        continue;
+
+      const View * view = sfm_data.views.at(obs_it.first).get();
+      Problem_Data::Observation_Block & obs_block = block.obs[obs_it.first];
+      obs_block.x = obs_it.second.x;
+      obs_block.id_intrinsic = view->id_intrinsic;
+      obs_block.id_pose = view->id_pose;
+      ceres::CostFunction * cost_function =
+        IntrinsicsToCostFunction(sfm_data.intrinsics.at(view->id_intrinsic).get(), obs_block.x,
+          0.0, ceres_options_.bUse_analytic_jacobians_);
+      if (!cost_function)
+      {
+        block.obs.erase(obs_it.first);
+        OPENMVG_LOG_ERROR << "Cannot create a CostFunction for this camera model.";
+        return false;
+      }
+      std::vector<double> & intrinsic_parameters =
+        data_->intrinsics.at(view->id_intrinsic).parameters;
+      if (!intrinsic_parameters.empty())
+      {
+        obs_block.residual_block_id = problem.AddResidualBlock(cost_function,
+          data_->loss_function.get(),
+          &intrinsic_parameters[0],
+          data_->poses.at(view->id_pose).parameters.data(),
+          block.X.data());
+      }
+      else
+      {
+        obs_block.residual_block_id = problem.AddResidualBlock(cost_function,
+          data_->loss_function.get(),
+          data_->poses.at(view->id_pose).parameters.data(),
+          block.X.data());
+      }
+    }
+  }
+
+  // Poses & intrinsics: remove the deleted ones
+  //  (no residual block is left on them in a consistent scene)
+  for (auto block_it = data_->poses.begin(); block_it != data_->poses.end();)
+  {
+    if (sfm_data.poses.count(block_it->first) == 0)
+    {
+      problem.RemoveParameterBlock(block_it->second.parameters.data());
+      block_it = data_->poses.erase(block_it);
+    }
+    else
+      ++block_it;
+  }
+  for (auto block_it = data_->intrinsics.begin(); block_it != data_->intrinsics.end();)
+  {
+    if (sfm_data.intrinsics.count(block_it->first) == 0)
+    {
+      if (!block_it->second.parameters.empty())
+        problem.RemoveParameterBlock(&block_it->second.parameters[0]);
+      block_it = data_->intrinsics.erase(block_it);
+    }
+    else
+      ++block_it;
+  }
+  return true;
+}
+
+void Bundle_Adjustment_Ceres_Session::WriteBack
+(
+  SfM_Data & sfm_data
+)
+{
+  if (options_.extrinsics_opt != Extrinsic_Parameter_Type::NONE)
+  {
+    for (auto & pose_it : data_->poses)
+    {
+      Problem_Data::Pose_Block & block = pose_it.second;
+      if (block.parameters == block.synchronized_parameters)
+        continue;
+      Pose3 & pose = sfm_data.poses.at(pose_it.first);
+      UpdatePoseFromParameters(block.parameters.data(), options_.extrinsics_opt, pose);
+      // With a partial update (rotation or center only) the translation changed
+      if (options_.extrinsics_opt != Extrinsic_Parameter_Type::ADJUST_ALL)
+        PoseToParameters(pose, block.parameters.data());
+      block.synchronized_parameters = block.parameters;
+      block.pose = pose;
+    }
+  }
+
+  if (options_.intrinsics_opt != Intrinsic_Parameter_Type::NONE)
+  {
+    for (auto & intrinsic_it : data_->intrinsics)
+    {
+      Problem_Data::Intrinsic_Block & block = intrinsic_it.second;
+      if (block.parameters == block.synchronized_parameters)
+        continue;
+      sfm_data.intrinsics.at(intrinsic_it.first)->updateFromParams(block.parameters);
+      block.synchronized_parameters = block.parameters;
+    }
+  }
+
+  if (options_.structure_opt != Structure_Parameter_Type::NONE)
+  {
+    for (const auto & landmark_it : data_->landmarks)
+    {
+      sfm_data.structure.at(landmark_it.first).X = landmark_it.second.X;
+    }
+  }
+}
+
+bool Bundle_Adjustment_Ceres_Session::Adjust
+(
+  SfM_Data & sfm_data
+)
+{
+  const std::size_t nb_residual_blocks = NbResidualBlocks();
+  if (!Synchronize(sfm_data))
+    return false;
+
+  ceres::Solver::Summary summary;
+  ceres::Solve(SolverOptions(ceres_options_), data_->problem.get(), &summary);
+  if (ceres_options_.bCeres_summary_)
+    OPENMVG_LOG_INFO << summary.FullReport();
+
+  if (!summary.IsSolutionUsable())
+  {
+    OPENMVG_LOG_ERROR << "IsSolutionUsable is false. Bundle Adjustment failed.";
+    return false;
+  }
+  if (ceres_options_.bVerbose_)
+  {
+    // Display statistics about the minimization
+    OPENMVG_LOG_INFO
+      << "\nBundle Adjustment statistics (approximated RMSE):\n"
+      << " #views: " << sfm_data.views.size() << "\n"
+      << " #poses: " << sfm_data.poses.size() << "\n"
+      << " #intrinsics: " << sfm_data.intrinsics.size() << "\n"
+      << " #tracks: " << sfm_data.structure.size() << "\n"
+      << " #residuals: " << summary.num_residuals << "\n"
+      << " #residual blocks (previous call): " << nb_residual_blocks << "\n"
+      << " Initial RMSE: " << std::sqrt( summary.initial_cost / summary.num_residuals) << "\n"
+      << " Final RMSE: " << std::sqrt( summary.final_cost / summary.num_residuals) << "\n"
+      << " Time (s): " << summary.total_time_in_seconds;
+  }
+  WriteBack(sfm_data);
+  return true;
+}
+
+//----
+//-- Bundle_Adjustment_Ceres_Partitioned
+//----
+
+/// Consensus cost function: weights .* (x - center)
+class ConsensusCostFunction : public ceres::CostFunction
+{
+public:
+  ConsensusCostFunction
+  (
+    const std::vector<double> & center,
+    const std::vector<double> & weights
+  ): center_(center), weights_(weights)
+  {
+    set_num_residuals(center_.size());
+    mutable_parameter_block_sizes()->push_back(center_.size());
+  }
+
+  bool Evaluate
+  (
+    double const * const * parameters,
+    double * residuals,
+    double ** jacobians
+  ) const override
+  {
+    const int size = center_.size();
+    for (int i = 0; i < size; ++i)
+      residuals[i] = weights_[i] * (parameters[0][i] - center_[i]);
+    if (jacobians != nullptr && jacobians[0] != nullptr)
+    {
+      std::fill(jacobians[0], jacobians[0] + size * size, 0.0);
+      for (int i = 0; i < size; ++i)
+        jacobians[0][i * size + i] = weights_[i];
+    }
+    return true;
+  }
+
+private:
+  const std::vector<double> center_;
+  const std::vector<double> weights_;
+};
+
+/// Local copy of a parameter block shared by several clusters
+struct Consensus_Block
+{
+  std::vector<double> x;       // local value
+  std::vector<double> u;       // scaled dual variable
+  std::vector<double> weights; // diagonal of the local Gauss-Newton Hessian
+};
+
+/// Parameters and landmarks of a cluster
+struct Cluster_Data
+{
+  Hash_Map<IndexT, std::vector<double>> poses;      // angle axis + translation
+  Hash_Map<IndexT, std::vector<double>> intrinsics;
+  Hash_Map<IndexT, Consensus_Block> shared_poses;
+  Hash_Map<IndexT, Consensus_Block> shared_intrinsics;
+  Hash_Map<IndexT, Consensus_Block> shared_landmarks;
+  Landmarks landmarks;          // the observations of the cluster poses (in memory mode)
+  std::string landmark_file;    // the landmarks are stored in this file (out-of-core mode)
+  std::size_t landmark_count = 0;
+};
+
+/// Append the landmarks to a binary file
+static bool AppendLandmarks
+(
+  const std::string & filename,
+  const Landmarks & landmarks
+)
+{
+  std::ofstream stream(filename, std::ios::out | std::ios::binary | std::ios::app);
+  if (!stream)
+    return false;
+  cereal::BinaryOutputArchive archive(stream);
+  for (const auto & landmark_it : landmarks)
+    archive(landmark_it.first, landmark_it.second);
+  return static_cast<bool>(stream);
+}
+
+/// Replace the landmarks of a binary file. The landmarks are written to a
+///  temporary file that replaces the existing one only once it is complete.
+static bool RewriteLandmarks
+(
+  const std::string & filename,
+  const Landmarks & landmarks
+)
+{
+  const std::string temporary_filename = filename + ".tmp";
+  stlplus::file_delete(temporary_filename);
+  if (!AppendLandmarks(temporary_filename, landmarks))
+  {
+    stlplus::file_delete(temporary_filename);
+    return false;
+  }
+  if (stlplus::file_rename(temporary_filename, filename))
+    return true;
+  // rename does not replace an existing file on every platform
+  return stlplus::file_delete(filename)
+    && stlplus::file_rename(temporary_filename, filename);
+}
+
+/// Load landmark_count landmarks from a binary file
+static bool LoadLandmarks
+(
+  const std::string & filename,
+  const std::size_t landmark_count,
+  Landmarks & landmarks
+)
+{
+  std::ifstream stream(filename, std::ios::in | std::ios::binary);
+  if (!stream)
+    return false;
+  cereal::BinaryInputArchive archive(stream);
+  for (std::size_t i = 0; i < landmark_count; ++i)
+  {
+    IndexT id;
+    Landmark landmark;
+    archive(id, landmark);
+    landmarks.emplace(id, std::move(landmark));
+  }
+  return static_cast<bool>(stream);
+}
+
+/// Add the consensus terms of the shared blocks to the problem
+static void AddConsensusTerms
+(
+  ceres::Problem & problem,
+  const Hash_Map<IndexT, Consensus_Block> & shared_blocks,
+  const Hash_Map<IndexT, std::vector<double>> & consensus,
+  const double rho,
+  const std::function<double*(IndexT)> & parameter_block
+)
+{
+  for (const auto & block_it : shared_blocks)
+  {
+    const Consensus_Block & block = block_it.second;
+    const std::vector<double> & z = consensus.at(block_it.first);
+    std::vector<double> center(z.size()), weights(z.size());
+    for (std::size_t i = 0; i < z.size(); ++i)
+    {
+      center[i] = z[i] - block.u[i];
+      weights[i] = std::sqrt(rho * block.weights[i]);
+    }
+    problem.AddResidualBlock(new ConsensusCostFunction(center, weights),
+      nullptr, parameter_block(block_it.first));
+  }
+}
+
+/// Update the consensus values (weighted average of the cluster values) and
+///  the dual variables. Accumulate the weighted squared norms of the primal
+///  (cluster disagreement) and dual (consensus change) residuals.
+static void UpdateConsensus
+(
+  std::vector<Cluster_Data> & clusters,
+  Hash_Map<IndexT, Consensus_Block> Cluster_Data::* shared_blocks,
+  Hash_Map<IndexT, std::vector<double>> & consensus,
+  double & primal_residual,
+  double & dual_residual
+)
+{
+  Hash_Map<IndexT, std::pair<std::vector<double>, std::vector<double>>> sums;
+  for (const Cluster_Data & cluster : clusters)
+  {
+    for (const auto & block_it : cluster.*shared_blocks)
+    {
+      const Consensus_Block & block = block_it.second;
+      auto & sum = sums[block_it.first];
+      sum.first.resize(block.x.size(), 0.0);
+      sum.second.resize(block.x.size(), 0.0);
+      for (std::size_t i = 0; i < block.x.size(); ++i)
+      {
+        sum.first[i] += block.weights[i] * (block.x[i] + block.u[i]);
+        sum.second[i] += block.weights[i];
+      }
+    }
+  }
+  Hash_Map<IndexT, std::vector<double>> previous_consensus;
+  for (const auto & sum_it : sums)
+  {
+    std::vector<double> & z = consensus.at(sum_it.first);
+    previous_consensus[sum_it.first] = z;
+    for (std::size_t i = 0; i < z.size(); ++i)
+    {
+      if (sum_it.second.second[i] > 0.0)
+        z[i] = sum_it.second.first[i] / sum_it.second.second[i];
+    }
+  }
+
+  for (Cluster_Data & cluster : clusters)
+  {
+    for (auto & block_it : cluster.*shared_blocks)
+    {
+      Consensus_Block & block = block_it.second;
+      const std::vector<double> & z = consensus.at(block_it.first);
+      const std::vector<double> & previous_z = previous_consensus.at(block_it.first);
+      for (std::size_t i = 0; i < z.size(); ++i)
+      {
+        block.u[i] += block.x[i] - z[i];
+        primal_residual += block.weights[i] * Square(block.x[i] - z[i]);
+        dual_residual += block.weights[i] * Square(z[i] - previous_z[i]);
+      }
+    }
+  }
+}
+
+/// Scale the dual variables (after a change of the consensus penalty)
+static void ScaleDualVariables
+(
+  std::vector<Cluster_Data> & clusters,
+  const double scale
+)
+{
+  for (Cluster_Data & cluster : clusters)
+  {
+    for (auto * shared_blocks : {&cluster.shared_poses, &cluster.shared_intrinsics, &cluster.shared_landmarks})
+    {
+      for (auto & block_it : *shared_blocks)
+      {
+        for (double & u : block_it.second.u)
+          u *= scale;
+      }
+    }
+  }
+}
+
+Bundle_Adjustment_Ceres_Partitioned::Partition_Options::Partition_Options()
+: max_cluster_size_(100),
+  min_shared_landmarks_(50),
+  max_outer_iterations_(100),
+  max_inner_iterations_(10),
+  rho_(0.1),
+  consensus_tolerance_(1e-2),
+  max_loaded_clusters_(0)
+{
+}
+
+Bundle_Adjustment_Ceres_Partitioned::Bundle_Adjustment_Ceres_Partitioned
+(
+  const Partition_Options & partition_options,
+  const Bundle_Adjustment_Ceres::BA_Ceres_options & ceres_options
+)
+: partition_options_(partition_options),
+  ceres_options_(ceres_options)
+{
+}
+
+Bundle_Adjustment_Ceres_Partitioned::Partition_Options &
+Bundle_Adjustment_Ceres_Partitioned::partition_options()
+{
+  return partition_options_;
+}
+
+Bundle_Adjustment_Ceres::BA_Ceres_options &
+Bundle_Adjustment_Ceres_Partitioned::ceres_options()
+{
+  return ceres_options_;
+}
+
+std::vector<Bundle_Adjustment_Ceres_Partitioned::Pose_Cluster>
+Bundle_Adjustment_Ceres_Partitioned::PartitionPoses
+(
+  const SfM_Data & sfm_data,
+  const unsigned int max_cluster_size,
+  const unsigned int min_shared_landmarks
+)
+{
+  // View graph: number of landmarks shared by each pair of poses
+  std::map<IndexT, std::map<IndexT, unsigned int>> pose_graph;
+  std::vector<IndexT> landmark_poses;
+  for (const auto & landmark_it : sfm_data.structure)
+  {
+    landmark_poses.clear();
+    for (const auto & obs_it : landmark_it.second.obs)
+    {
+      const View * view = sfm_data.views.at(obs_it.first).get();
+      if (sfm_data.IsPoseAndIntrinsicDefined(view))
+        landmark_poses.push_back(view->id_pose);
+    }
+    std::sort(landmark_poses.begin(), landmark_poses.end());
+    landmark_poses.erase(std::unique(landmark_poses.begin(), landmark_poses.end()),
+      landmark_poses.end());
+    for (std::size_t i = 0; i < landmark_poses.size(); ++i)
+    {
+      for (std::size_t j = i + 1; j < landmark_poses.size(); ++j)
+      {
+        ++pose_graph[landmark_poses[i]][landmark_poses[j]];
+        ++pose_graph[landmark_poses[j]][landmark_poses[i]];
+      }
+    }
+  }
+
+  // Region growing: add the pose the most connected to the cluster
+  std::vector<Pose_Cluster> clusters;
+  std::set<IndexT> assigned_poses;
+  for (const auto & pose_it : sfm_data.poses)
+  {
+    if (assigned_poses.count(pose_it.first) > 0)
+      continue;
+    Pose_Cluster cluster;
+    std::map<IndexT, unsigned int> candidates; // pose -> landmarks shared with the cluster
+    IndexT pose_id = pose_it.first;
+    while (true)
+    {
+      cluster.poses.insert(pose_id);
+      assigned_poses.insert(pose_id);
+      candidates.erase(pose_id);
+      if (cluster.poses.size() >= max_cluster_size)
+        break;
+      for (const auto & edge_it : pose_graph[pose_id])
+      {
+        if (assigned_poses.count(edge_it.first) == 0)
+          candidates[edge_it.first] += edge_it.second;
+      }
+      if (candidates.empty())
+        break;
+      pose_id = std::max_element(candidates.cbegin(), candidates.cend(),
+        [](const std::pair<IndexT, unsigned int> & a, const std::pair<IndexT, unsigned int> & b)
+        {
+          return a.second < b.second;
+        })->first;
+    }
+    clusters.push_back(std::move(cluster));
+  }
+
+  // Overlap: the neighbouring poses that share enough landmarks with the cluster
+  for (Pose_Cluster & cluster : clusters)
+  {
+    std::map<IndexT, unsigned int> neighbours;
+    for (const IndexT pose_id : cluster.poses)
+    {
+      for (const auto & edge_it : pose_graph[pose_id])
+      {
+        if (cluster.poses.count(edge_it.first) == 0)
+          neighbours[edge_it.first] += edge_it.second;
+      }
+    }
+    for (const auto & neighbour_it : neighbours)
+    {
+      if (neighbour_it.second >= min_shared_landmarks)
+        cluster.overlap_poses.insert(neighbour_it.first);
+    }
+  }
+  return clusters;
+}
+
+bool Bundle_Adjustment_Ceres_Partitioned::Adjust
+(
+  SfM_Data & sfm_data,
+  const Optimize_Options & options
+)
+{
+  if (options.use_motion_priors_opt || options.control_point_opt.bUse_control_points)
+  {
+    OPENMVG_LOG_WARNING
+      << "The motion priors and the GCP are not used by the partitioned bundle adjustment.";
+  }
+
+  const std::vector<Pose_Cluster> pose_clusters = PartitionPoses(sfm_data,
+    partition_options_.max_cluster_size_, partition_options_.min_shared_landmarks_);
+  const bool b_out_of_core = !partition_options_.temporary_directory_.empty();
+  if (b_out_of_core && !stlplus::folder_exists(partition_options_.temporary_directory_)
+      && !stlplus::folder_create(partition_options_.temporary_directory_))
+  {
+    OPENMVG_LOG_ERROR << "Cannot create the directory: " << partition_options_.temporary_directory_;
+    return false;
+  }
+
+  // Clusters of each pose & setup of the local parameters
+  std::vector<Cluster_Data> clusters(pose_clusters.size());
+  Hash_Map<IndexT, std::vector<std::size_t>> clusters_per_pose;
+  for (std::size_t k = 0; k < pose_clusters.size(); ++k)
+  {
+    for (const auto * poses : {&pose_clusters[k].poses, &pose_clusters[k].overlap_poses})
+    {
+      for (const IndexT pose_id : *poses)
+      {
+        clusters_per_pose[pose_id].push_back(k);
+        std::vector<double> & parameters = clusters[k].poses[pose_id];
+        parameters.resize(6);
+        PoseToParameters(sfm_data.poses.at(pose_id), parameters.data());
+      }
+    }
+    if (b_out_of_core)
+    {
+      clusters[k].landmark_file = stlplus::create_filespec(
+        partition_options_.temporary_directory_, "cluster_" + std::to_string(k), "bin");
+      stlplus::file_delete(clusters[k].landmark_file);
+    }
+  }
+  Hash_Map<IndexT, std::set<std::size_t>> clusters_per_intrinsic;
+  for (const auto & view_it : sfm_data.views)
+  {
+    const View * view = view_it.second.get();
+    if (!sfm_data.IsPoseAndIntrinsicDefined(view) || clusters_per_pose.count(view->id_pose) == 0)
+      continue;
+    if (!isValid(sfm_data.intrinsics.at(view->id_intrinsic)->getType()))
+    {
+      OPENMVG_LOG_ERROR << "Unsupported camera type.";
+      return false;
+    }
+    for (const std::size_t k : clusters_per_pose.at(view->id_pose))
+    {
+      clusters_per_intrinsic[view->id_intrinsic].insert(k);
+      if (clusters[k].intrinsics.count(view->id_intrinsic) == 0)
+        clusters[k].intrinsics[view->id_intrinsic] =
+          sfm_data.intrinsics.at(view->id_intrinsic)->getParams();
+    }
+  }
+
+  // Consensus values of the shared blocks (the constant blocks are not shared)
+  Hash_Map<IndexT, std::vector<double>> pose_consensus, intrinsic_consensus, landmark_consensus;
+  const auto share_block = [](Cluster_Data & cluster,
+    Hash_Map<IndexT, Consensus_Block> Cluster_Data::* shared_blocks,
+    const IndexT id, const std::vector<double> & x)
+  {
+    Consensus_Block & block = (cluster.*shared_blocks)[id];
+    block.x = x;
+    block.u.assign(x.size(), 0.0);
+    block.weights.assign(x.size(), 0.0);
+  };
+  if (options.extrinsics_opt != Extrinsic_Parameter_Type::NONE)
+  {
+    for (const auto & pose_it : clusters_per_pose)
+    {
+      if (pose_it.second.size() < 2)
+        continue;
+      for (const std::size_t k : pose_it.second)
+      {
+        pose_consensus[pose_it.first] = clusters[k].poses.at(pose_it.first);
+        share_block(clusters[k], &Cluster_Data::shared_poses, pose_it.first,
+          pose_consensus.at(pose_it.first));
+      }
+    }
+  }
+  if (options.intrinsics_opt != Intrinsic_Parameter_Type::NONE)
+  {
+    for (const auto & intrinsic_it : clusters_per_intrinsic)
+    {
+      const std::vector<double> params = sfm_data.intrinsics.at(intrinsic_it.first)->getParams();
+      if (intrinsic_it.second.size() < 2 || params.empty())
+        continue;
+      intrinsic_consensus[intrinsic_it.first] = params;
+      for (const std::size_t k : intrinsic_it.second)
+        share_block(clusters[k], &Cluster_Data::shared_intrinsics, intrinsic_it.first, params);
+    }
+  }
+
+  // Distribute the observations of the landmarks to the clusters of their poses.
+  // In the out-of-core mode, the landmarks are appended to the cluster files by
+  // chunks. Once all the cluster files are written, the distributed observations
+  // are removed from the scene (the observations of the views that are not
+  // refined are kept in the scene).
+  const auto is_refined_view = [&](const IndexT view_id)
+  {
+    const View * view = sfm_data.views.at(view_id).get();
+    return sfm_data.IsPoseAndIntrinsicDefined(view) && clusters_per_pose.count(view->id_pose) > 0;
+  };
+  const std::size_t chunk_size = 4096;
+  std::size_t observation_count = 0;
+  std::vector<std::size_t> landmark_clusters;
+  const auto delete_cluster_files = [&]()
+  {
+    for (const Cluster_Data & cluster : clusters)
+      stlplus::file_delete(cluster.landmark_file);
+  };
+  for (const auto & landmark_it : sfm_data.structure)
+  {
+    landmark_clusters.clear();
+    for (const auto & obs_it : landmark_it.second.obs)
+    {
+      if (!is_refined_view(obs_it.first))
+        continue;
+      const View * view = sfm_data.views.at(obs_it.first).get();
+      ++observation_count;
+      for (const std::size_t k : clusters_per_pose.at(view->id_pose))
+      {
+        Landmark & landmark = clusters[k].landmarks[landmark_it.first];
+        landmark.X = landmark_it.second.X;
+        landmark.obs[obs_it.first] = obs_it.second;
+        landmark_clusters.push_back(k);
+      }
+    }
+    std::sort(landmark_clusters.begin(), landmark_clusters.end());
+    landmark_clusters.erase(std::unique(landmark_clusters.begin(), landmark_clusters.end()),
+      landmark_clusters.end());
+    for (const std::size_t k : landmark_clusters)
+    {
+      ++clusters[k].landmark_count;
+      if (landmark_clusters.size() > 1 && options.structure_opt != Structure_Parameter_Type::NONE)
+      {
+        const std::vector<double> X(landmark_it.second.X.data(), landmark_it.second.X.data() + 3);
+        landmark_consensus[landmark_it.first] = X;
+        share_block(clusters[k], &Cluster_Data::shared_landmarks, landmark_it.first, X);
+      }
+      if (b_out_of_core && clusters[k].landmarks.size() == chunk_size)
+      {
+        if (!AppendLandmarks(clusters[k].landmark_file, clusters[k].landmarks))
+        {
+          OPENMVG_LOG_ERROR << "Cannot write the file: " << clusters[k].landmark_file;
+          delete_cluster_files();
+          return false;
+        }
+        clusters[k].landmarks.clear();
+      }
+    }
+  }
+  if (b_out_of_core)
+  {
+    for (Cluster_Data & cluster : clusters)
+    {
+      if (!AppendLandmarks(cluster.landmark_file, cluster.landmarks))
+      {
+        OPENMVG_LOG_ERROR << "Cannot write the file: " << cluster.landmark_file;
+        delete_cluster_files();
+        return false;
+      }
+      cluster.landmarks = Landmarks();
+    }
+    // The landmarks are saved: remove their distributed observations from the scene
+    for (auto landmark_it = sfm_data.structure.begin(); landmark_it != sfm_data.structure.end();)
+    {
+      Observations & obs = landmark_it->second.obs;
+      const std::size_t obs_count = obs.size();
+      for (auto obs_it = obs.begin(); obs_it != obs.end();)
+      {
+        if (is_refined_view(obs_it->first))
+          obs_it = obs.erase(obs_it);
+        else
+          ++obs_it;
+      }
+      if (obs.empty() && obs_count > 0)
+        landmark_it = sfm_data.structure.erase(landmark_it);
+      else
+        ++landmark_it;
+    }
+  }
+
+  // Consensus penalty (adapted to balance the primal and dual residuals)
+  double rho = partition_options_.rho_;
+
+  // Refine a cluster with its consensus terms
+  const unsigned int inner_iterations = clusters.size() > 1 ?
+    partition_options_.max_inner_iterations_ : ceres_options_.max_num_iterations_;
+  const auto refine_cluster = [&](Cluster_Data & cluster, const bool b_first_iteration) -> bool
+  {
+    Landmarks landmarks;
+    if (b_out_of_core)
+    {
+      if (!LoadLandmarks(cluster.landmark_file, cluster.landmark_count, landmarks))
+        return false;
+    }
+    else
+    {
+      std::swap(landmarks, cluster.landmarks);
+    }
+
+    ceres::Problem problem;
+    for (auto & pose_it : cluster.poses)
+      AddPoseParameterBlock(problem, pose_it.second.data(), options.extrinsics_opt, false);
+    for (auto & intrinsic_it : cluster.intrinsics)
+    {
+      if (!intrinsic_it.second.empty())
+        AddIntrinsicParameterBlock(problem, intrinsic_it.second,
+          *sfm_data.intrinsics.at(intrinsic_it.first), options.intrinsics_opt);
+    }
+
+    ceres::LossFunction * p_LossFunction =
+      ceres_options_.bUse_loss_function_ ?
+        new ceres::HuberLoss(Square(4.0))
+        : nullptr;
+
+    // Reprojection errors. The observations of a pose are shared by all its
+    // clusters: they are weighted so that the clusters sum to the whole problem.
+    for (auto & landmark_it : landmarks)
+    {
+      Landmark & landmark = landmark_it.second;
+      Consensus_Block * landmark_block = nullptr;
+      if (b_first_iteration && cluster.shared_landmarks.count(landmark_it.first) > 0)
+        landmark_block = &cluster.shared_landmarks.at(landmark_it.first);
+      for (const auto & obs_it : landmark.obs)
+      {
+        const View * view = sfm_data.views.at(obs_it.first).get();
+        IntrinsicBase * intrinsic = sfm_data.intrinsics.at(view->id_intrinsic).get();
+        const std::size_t pose_cluster_count = clusters_per_pose.at(view->id_pose).size();
+        ceres::CostFunction * cost_function = IntrinsicsToCostFunction(intrinsic,
+          obs_it.second.x,
+          pose_cluster_count > 1 ? 1.0 / std::sqrt(pose_cluster_count) : 0.0,
+          ceres_options_.bUse_analytic_jacobians_);
+        if (!cost_function)
+        {
+          OPENMVG_LOG_ERROR << "Cannot create a CostFunction for this camera model.";
+          return false;
+        }
+
+        std::vector<double*> parameter_blocks;
+        std::vector<Consensus_Block*> consensus_blocks;
+        std::vector<double> & intrinsic_parameters = cluster.intrinsics.at(view->id_intrinsic);
+        if (!intrinsic_parameters.empty())
+        {
+          parameter_blocks.push_back(intrinsic_parameters.data());
+          consensus_blocks.push_back(b_first_iteration &&
+            cluster.shared_intrinsics.count(view->id_intrinsic) > 0 ?
+            &cluster.shared_intrinsics.at(view->id_intrinsic) : nullptr);
+        }
+        parameter_blocks.push_back(cluster.poses.at(view->id_pose).data());
+        consensus_blocks.push_back(b_first_iteration &&
+          cluster.shared_poses.count(view->id_pose) > 0 ?
+          &cluster.shared_poses.at(view->id_pose) : nullptr);
+        parameter_blocks.push_back(landmark.X.data());
+        consensus_blocks.push_back(landmark_block);
+
+        // Curvature of the reprojection error w.r.t. the shared parameters
+        if (std::any_of(consensus_blocks.cbegin(), consensus_blocks.cend(),
+              [](const Consensus_Block * block) { return block != nullptr; }))
+        {
+          const auto & block_sizes = cost_function->parameter_block_sizes();
+          std::vector<std::vector<double>> jacobians(block_sizes.size());
+          std::vector<double*> jacobian_ptrs(block_sizes.size(), nullptr);
+          for (std::size_t i = 0; i < block_sizes.size(); ++i)
+          {
+            if (consensus_blocks[i] == nullptr)
+              continue;
+            jacobians[i].resize(cost_function->num_residuals() * block_sizes[i]);
+            jacobian_ptrs[i] = jacobians[i].data();
+          }
+          std::vector<double> residuals(cost_function->num_residuals());
+          if (cost_function->Evaluate(parameter_blocks.data(), residuals.data(), jacobian_ptrs.data()))
+          {
+            for (std::size_t i = 0; i < block_sizes.size(); ++i)
+            {
+              if (consensus_blocks[i] == nullptr)
+                continue;
+              for (int r = 0; r < cost_function->num_residuals(); ++r)
+                for (int c = 0; c < block_sizes[i]; ++c)
+                  consensus_blocks[i]->weights[c] += Square(jacobians[i][r * block_sizes[i] + c]);
+            }
+          }
+        }
+        problem.AddResidualBlock(cost_function, p_LossFunction, parameter_blocks);
+      }
+      if (options.structure_opt == Structure_Parameter_Type::NONE)
+        problem.SetParameterBlockConstant(landmark.X.data());
+    }
+
+    // Consensus terms
+    AddConsensusTerms(problem, cluster.shared_poses, pose_consensus, rho,
+      [&](const IndexT id) { return cluster.poses.at(id).data(); });
+    AddConsensusTerms(problem, cluster.shared_intrinsics, intrinsic_consensus, rho,
+      [&](const IndexT id) { return cluster.intrinsics.at(id).data(); });
+    AddConsensusTerms(problem, cluster.shared_landmarks, landmark_consensus, rho,
+      [&](const IndexT id) { return landmarks.at(id).X.data(); });
+
+    ceres::Solver::Options ceres_config_options = SolverOptions(ceres_options_);
+    ceres_config_options.max_num_iterations = inner_iterations;
+    ceres_config_options.minimizer_progress_to_stdout = false;
+#ifdef OPENMVG_USE_OPENMP
+    // The clusters are refined in parallel
+    ceres_config_options.num_threads = 1;
+#if CERES_VERSION_MAJOR < 2
+    ceres_config_options.num_linear_solver_threads = 1;
+#endif
+#endif
+    ceres::Solver::Summary summary;
+    ceres::Solve(ceres_config_options, &problem, &summary);
+    if (ceres_options_.bCeres_summary_)
+      OPENMVG_LOG_INFO << summary.FullReport();
+    if (!summary.IsSolutionUsable())
+      return false;
+
+    // Collect the local values of the shared blocks
+    for (auto & block_it : cluster.shared_poses)
+      block_it.second.x = cluster.poses.at(block_it.first);
+    for (auto & block_it : cluster.shared_intrinsics)
+      block_it.second.x = cluster.intrinsics.at(block_it.first);
+    for (auto & block_it : cluster.shared_landmarks)
+    {
+      const Vec3 & X = landmarks.at(block_it.first).X;
+      block_it.second.x.assign(X.data(), X.data() + 3);
+    }
+
+    if (b_out_of_core)
+      return RewriteLandmarks(cluster.landmark_file, landmarks);
+    std::swap(landmarks, cluster.landmarks);
+    return true;
+  };
+
+#ifdef OPENMVG_USE_OPENMP
+  // Number of clusters refined at once: in the out-of-core mode it bounds the
+  //  number of clusters whose landmarks are loaded
+  int refinement_thread_count = omp_get_max_threads();
+  if (b_out_of_core && partition_options_.max_loaded_clusters_ > 0)
+    refinement_thread_count = std::min<int>(refinement_thread_count,
+      partition_options_.max_loaded_clusters_);
+#endif
+
+  // ADMM: refine the clusters, then update the consensus values
+  bool b_usable = true;
+  unsigned int iteration = 0;
+  double primal_rmse = 0.0, dual_rmse = 0.0;
+  for (; iteration < partition_options_.max_outer_iterations_ && b_usable; ++iteration)
+  {
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(refinement_thread_count)
+#endif
+    for (int k = 0; k < static_cast<int>(clusters.size()); ++k)
+    {
+      if (!refine_cluster(clusters[k], iteration == 0))
+      {
+#ifdef OPENMVG_USE_OPENMP
+        #pragma omp critical
+#endif
+        {
+          b_usable = false;
+        }
+      }
+    }
+    if (!b_usable)
+      break;
+
+    double primal_residual = 0.0, dual_residual = 0.0;
+    UpdateConsensus(clusters, &Cluster_Data::shared_poses, pose_consensus,
+      primal_residual, dual_residual);
+    UpdateConsensus(clusters, &Cluster_Data::shared_intrinsics, intrinsic_consensus,
+      primal_residual, dual_residual);
+    UpdateConsensus(clusters, &Cluster_Data::shared_landmarks, landmark_consensus,
+      primal_residual, dual_residual);
+    // Residuals expressed as reprojection RMSE (pixels)
+    primal_rmse = observation_count > 0 ?
+      std::sqrt(primal_residual / observation_count) : 0.0;
+    dual_rmse = observation_count > 0 ?
+      rho * std::sqrt(dual_residual / observation_count) : 0.0;
+    if (ceres_options_.bVerbose_)
+    {
+      OPENMVG_LOG_INFO << "Partitioned BA iteration " << iteration
+        << ": cluster disagreement (RMSE): " << primal_rmse
+        << ", consensus change (RMSE): " << dual_rmse
+        << ", rho: " << rho;
+    }
+    if (primal_rmse < partition_options_.consensus_tolerance_ &&
+        dual_rmse < partition_options_.consensus_tolerance_)
+    {
+      ++iteration;
+      break;
+    }
+    // Balance the primal and dual residuals
+    if (primal_rmse > 10.0 * dual_rmse || dual_rmse > 10.0 * primal_rmse)
+    {
+      const double scale = primal_rmse > dual_rmse ? 2.0 : 0.5;
+      rho *= scale;
+      ScaleDualVariables(clusters, 1.0 / scale);
+    }
+  }
+
+  // Update the scene: consensus values for the shared blocks, cluster values otherwise
+  if (b_usable && options.extrinsics_opt != Extrinsic_Parameter_Type::NONE)
+  {
+    for (const auto & pose_it : clusters_per_pose)
+    {
+      const std::vector<double> & parameters = pose_consensus.count(pose_it.first) > 0 ?
+        pose_consensus.at(pose_it.first) : clusters[pose_it.second.front()].poses.at(pose_it.first);
+      UpdatePoseFromParameters(parameters.data(), options.extrinsics_opt,
+        sfm_data.poses.at(pose_it.first));
+    }
+  }
+  if (b_usable && options.intrinsics_opt != Intrinsic_Parameter_Type::NONE)
+  {
+    for (const auto & intrinsic_it : clusters_per_intrinsic)
+    {
+      const std::vector<double> & parameters = intrinsic_consensus.count(intrinsic_it.first) > 0 ?
+        intrinsic_consensus.at(intrinsic_it.first)
+        : clusters[*intrinsic_it.second.begin()].intrinsics.at(intrinsic_it.first);
+      if (!parameters.empty())
+        sfm_data.intrinsics.at(intrinsic_it.first)->updateFromParams(parameters);
+    }
+  }
+  // The landmarks are merged back into the scene (even on failure in the
+  // out-of-core mode, the scene structure must be restored)
+  for (Cluster_Data & cluster : clusters)
+  {
+    Landmarks landmarks;
+    if (b_out_of_core)
+    {
+      if (LoadLandmarks(cluster.landmark_file, cluster.landmark_count, landmarks))
+      {
+        stlplus::file_delete(cluster.landmark_file);
+      }
+      else
+      {
+        // The file is kept: it is the only copy of these landmarks
+        OPENMVG_LOG_ERROR << "Cannot read the file: " << cluster.landmark_file;
+        b_usable = false;
+      }
+    }
+    else
+    {
+      std::swap(landmarks, cluster.landmarks);
+    }
+    for (auto & landmark_it : landmarks)
+    {
+      Landmark & landmark = sfm_data.structure[landmark_it.first];
+      landmark.obs.insert(landmark_it.second.obs.cbegin(), landmark_it.second.obs.cend());
+      if (!b_usable && !b_out_of_core)
+        continue;
+      if (landmark_consensus.count(landmark_it.first) > 0)
+        landmark.X = Eigen::Map<const Vec3>(landmark_consensus.at(landmark_it.first).data());
+      else
+        landmark.X = landmark_it.second.X;
+    }
+  }
+
+  if (!b_usable)
+  {
+    OPENMVG_LOG_ERROR << "Partitioned Bundle Adjustment failed.";
+    return false;
+  }
+  if (ceres_options_.bVerbose_)
+  {
+    OPENMVG_LOG_INFO
+      << "\nPartitioned Bundle Adjustment statistics:\n"
+      << " #clusters: " << clusters.size() << "\n"
+      << " #shared poses: " << pose_consensus.size() << "\n"
+      << " #shared intrinsics: " << intrinsic_consensus.size() << "\n"
+      << " #shared tracks: " << landmark_consensus.size() << "\n"
+      << " #consensus iterations: " << iteration << "\n"
+      << " Cluster disagreement (RMSE): " << primal_rmse << "\n"
+      << " Consensus change (RMSE): " << dual_rmse;
+  }
+  return true;
+}
+
 } // namespace sfm
 } // namespace openMVG
@@ -11,9 +11,16 @@
 
 #include "openMVG/numeric/eigen_alias_definition.hpp"
 #include "openMVG/sfm/sfm_data_BA.hpp"
+#include "openMVG/types.hpp"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace ceres { class CostFunction; }
 namespace openMVG { namespace cameras { struct IntrinsicBase; } }
+namespace openMVG { namespace sfm { struct Landmarks_SoA; } }
 namespace openMVG { namespace sfm { struct SfM_Data; } }
 
 namespace openMVG {
@@ -21,11 +28,14 @@ namespace sfm {
 
 /// Create the appropriate cost functor according the provided input camera intrinsic model
 /// Can be residual cost functor can be weighetd if desired (default 0.0 means no weight).
+/// The Jacobians are computed by automatic differentiation or analytically.
+/// The observation is referenced (not copied): it must outlive the cost functor.
 ceres::CostFunction * IntrinsicsToCostFunction
 (
   cameras::IntrinsicBase * intrinsic,
-  const Vec2 & observation,
-  const double weight = 0.0
+  const Eigen::Ref<const Vec2> & observation,
+  const double weight = 0.0,
+  const bool b_analytic_jacobians = false
 );
 
 class Bundle_Adjustment_Ceres : public Bundle_Adjustment
@@ -42,6 +52,7 @@ class Bundle_Adjustment_Ceres : public Bundle_Adjustment
     double parameter_tolerance_;
     bool bUse_loss_function_;
     int max_num_iterations_;
+    bool bUse_analytic_jacobians_; // analytic or automatic differentiation cost functions
 
     BA_Ceres_options(const bool bVerbose = true, bool bmultithreaded = true);
   };
@@ -64,6 +75,146 @@ class Bundle_Adjustment_Ceres : public Bundle_Adjustment
     // tell which parameter needs to be adjusted
     const Optimize_Options & options
   ) override;
+
+  /// Local bundle adjustment: refine only the poses of pose_ids and the
+  ///  landmarks they observe. The other poses that observe these landmarks
+  ///  are held as constant, as are the intrinsics (motion priors and GCP are
+  ///  not used).
+  bool AdjustLocal
+  (
+    // the SfM scene to refine
+    sfm::SfM_Data & sfm_data,
+    // the pose ids to refine
+    const std::set<IndexT> & pose_ids,
+    // tell which parameter needs to be adjusted
+    const Optimize_Options & options
+  );
+
+  /// Adjust the scene with the landmarks stored in a Landmarks_SoA
+  /// (sfm_data.structure is not used, the landmarks are refined in place)
+  bool Adjust
+  (
+    // the SfM scene to refine (views, intrinsics & poses)
+    sfm::SfM_Data & sfm_data,
+    // the landmarks to refine
+    sfm::Landmarks_SoA & structure,
+    // tell which parameter needs to be adjusted
+    const Optimize_Options & options
+  );
+};
+
+/// Bundle adjustment session: the ceres problem is kept alive between the
+///  Adjust calls on an evolving scene. Each call only adds/removes the
+///  parameter and residual blocks of the poses, intrinsics, landmarks and
+///  observations that changed since the previous call, and the refined
+///  parameters are written back only if they were modified.
+/// Motion priors and GCP are not supported.
+class Bundle_Adjustment_Ceres_Session
+{
+  public:
+  explicit Bundle_Adjustment_Ceres_Session
+  (
+    // tell which parameter needs to be adjusted (fixed for the session)
+    const Optimize_Options & options,
+    const Bundle_Adjustment_Ceres::BA_Ceres_options & ceres_options =
+    Bundle_Adjustment_Ceres::BA_Ceres_options()
+  );
+
+  ~Bundle_Adjustment_Ceres_Session();
+
+  /// Solver options (can be changed between two Adjust calls)
+  Bundle_Adjustment_Ceres::BA_Ceres_options & ceres_options();
+
+  /// Synchronize the problem with the scene, then refine the scene
+  bool Adjust(sfm::SfM_Data & sfm_data);
+
+  /// Number of residual blocks of the problem
+  std::size_t NbResidualBlocks() const;
+
+  private:
+  /// Add/update/remove the problem blocks to match the scene
+  /// Return false if a camera model is not supported
+  bool Synchronize(const sfm::SfM_Data & sfm_data);
+
+  /// Copy the modified parameters to the scene
+  void WriteBack(sfm::SfM_Data & sfm_data);
+
+  Optimize_Options options_;
+  Bundle_Adjustment_Ceres::BA_Ceres_options ceres_options_;
+
+  struct Problem_Data;
+  std::unique_ptr<Problem_Data> data_;
+};
+
+/// Partitioned bundle adjustment for the scenes too large to be refined as
+///  one problem:
+///  - the poses are split into clusters of the view graph, each cluster being
+///    extended by the neighbouring poses that share enough landmarks with it,
+///  - the clusters are refined independently (in parallel),
+///  - the poses, intrinsics and landmarks shared by several clusters are
+///    reconciled by an ADMM consensus loop.
+/// The landmarks of each cluster can be stored on disk and loaded only while
+///  the cluster is refined (out-of-core mode).
+/// Memory: the whole scene structure must fit in memory when Adjust is called
+///  and when it returns (the landmarks are moved back into the scene). In the
+///  out-of-core mode, during the refinement, only the landmarks of the clusters
+///  being refined (at most max_loaded_clusters_) are kept in memory, along with
+///  the landmarks observed by views without pose or intrinsic.
+/// Motion priors and GCP are not supported.
+class Bundle_Adjustment_Ceres_Partitioned : public Bundle_Adjustment
+{
+  public:
+  struct Partition_Options
+  {
+    unsigned int max_cluster_size_;     // maximal number of poses of a cluster (overlap excluded)
+    unsigned int min_shared_landmarks_; // co-visibility required to add an overlapping pose to a cluster
+    unsigned int max_outer_iterations_; // maximal number of consensus iterations
+    unsigned int max_inner_iterations_; // solver iterations per cluster and consensus iteration
+    double rho_;                        // consensus penalty (relative to the reprojection error curvature)
+    double consensus_tolerance_;        // stop once the clusters disagree by less than this RMSE (pixels)
+    std::string temporary_directory_;   // if not empty, the cluster landmarks are stored in this directory
+    unsigned int max_loaded_clusters_;  // out-of-core mode: maximal number of clusters refined (loaded) at once (0: one per thread)
+
+    Partition_Options();
+  };
+
+  struct Pose_Cluster
+  {
+    std::set<IndexT> poses;         // poses of the cluster (disjoint from the other clusters)
+    std::set<IndexT> overlap_poses; // neighbouring poses that belong to other clusters
+  };
+
+  explicit Bundle_Adjustment_Ceres_Partitioned
+  (
+    const Partition_Options & partition_options = Partition_Options(),
+    const Bundle_Adjustment_Ceres::BA_Ceres_options & ceres_options =
+    Bundle_Adjustment_Ceres::BA_Ceres_options()
+  );
+
+  Partition_Options & partition_options();
+
+  Bundle_Adjustment_Ceres::BA_Ceres_options & ceres_options();
+
+  bool Adjust
+  (
+    // the SfM scene to refine
+    sfm::SfM_Data & sfm_data,
+    // tell which parameter needs to be adjusted
+    const Optimize_Options & options
+  ) override;
+
+  /// Split the poses into clusters by region growing on the view graph
+  ///  (the edges are weighted by the number of landmarks shared by two poses)
+  static std::vector<Pose_Cluster> PartitionPoses
+  (
+    const sfm::SfM_Data & sfm_data,
+    const unsigned int max_cluster_size,
+    const unsigned int min_shared_landmarks
+  );
+
+  private:
+  Partition_Options partition_options_;
+  Bundle_Adjustment_Ceres::BA_Ceres_options ceres_options_;
 };
 
 } // namespace sfm
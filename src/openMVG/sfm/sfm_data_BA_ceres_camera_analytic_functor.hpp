@@ -0,0 +1,461 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_SFM_SFM_DATA_BA_CERES_CAMERA_ANALYTIC_FUNCTOR_HPP
+#define OPENMVG_SFM_SFM_DATA_BA_CERES_CAMERA_ANALYTIC_FUNCTOR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ceres/ceres.h>
+#include <ceres/rotation.h>
+
+#include "openMVG/cameras/Camera_Intrinsics.hpp"
+#include "openMVG/numeric/eigen_alias_definition.hpp"
+#include "openMVG/numeric/numeric.h"
+
+//--
+//- Ceres cost functions with analytic Jacobians for each OpenMVG camera model.
+//- They compute the same residuals as the functors of
+//-  sfm_data_BA_ceres_camera_functor.hpp (without the jet arithmetic of the
+//-  automatic differentiation).
+//--
+
+namespace openMVG {
+namespace sfm {
+namespace analytic {
+
+using Mat2 = Eigen::Matrix<double, 2, 2>;
+using Mat23 = Eigen::Matrix<double, 2, 3>;
+
+/**
+ * @brief Transform a point in the camera frame: Xc = R(angle_axis) * X + t.
+ * @param[in] cam_extrinsics: pose [angle axis, t]
+ * @param[in] pos_3dpoint: the 3D point X
+ * @param[out] Xc: the point in the camera frame
+ * @param[out] dXc_dangle_axis: Jacobian of Xc w.r.t. the angle axis (optional)
+ * @param[out] dXc_dX: Jacobian of Xc w.r.t. X, the rotation matrix (optional)
+ */
+inline void TransformPoint
+(
+  const double * cam_extrinsics,
+  const double * pos_3dpoint,
+  Vec3 & Xc,
+  Mat3 * dXc_dangle_axis = nullptr,
+  Mat3 * dXc_dX = nullptr
+)
+{
+  if (dXc_dangle_axis == nullptr || dXc_dX == nullptr)
+  {
+    ceres::AngleAxisRotatePoint(cam_extrinsics, pos_3dpoint, Xc.data());
+    Xc += Eigen::Map<const Vec3>(&cam_extrinsics[3]);
+    return;
+  }
+  const Eigen::Map<const Vec3> angle_axis(cam_extrinsics);
+  const Eigen::Map<const Vec3> X(pos_3dpoint);
+  ceres::AngleAxisToRotationMatrix(cam_extrinsics, dXc_dX->data());
+  const Vec3 RX = *dXc_dX * X;
+  Xc = RX + Eigen::Map<const Vec3>(&cam_extrinsics[3]);
+
+  // d(R X)/d(angle axis) = -[R X]x * Jl(angle axis) (Jl: SO(3) left Jacobian)
+  const double theta2 = angle_axis.squaredNorm();
+  const Mat3 W = CrossProductMatrix(angle_axis);
+  Mat3 Jl = Mat3::Identity();
+  if (theta2 > std::numeric_limits<double>::epsilon())
+  {
+    const double theta = std::sqrt(theta2);
+    Jl += (1.0 - std::cos(theta)) / theta2 * W
+      + (theta - std::sin(theta)) / (theta2 * theta) * W * W;
+  }
+  else
+  {
+    Jl += 0.5 * W;
+  }
+  *dXc_dangle_axis = -CrossProductMatrix(RX) * Jl;
+}
+
+/// Jacobian of the perspective division (x/z, y/z) w.r.t. (x, y, z)
+inline Mat23 PerspectiveDivisionJacobian(const Vec3 & Xc)
+{
+  const double inv_z = 1.0 / Xc.z();
+  Mat23 J;
+  J << inv_z, 0.0, -Xc.x() * inv_z * inv_z,
+       0.0, inv_z, -Xc.y() * inv_z * inv_z;
+  return J;
+}
+
+//--
+// Distortion models: d = disto(p) on the normalized point p
+//  - NbParams: number of distortion parameters (after focal & principal point)
+//  - Apply(k, p, d, dd_dp, dd_dk): dd_dk is a 2 x NbParams row major matrix
+//--
+
+struct Distortion_None
+{
+  static constexpr int NbParams = 0;
+  static void Apply
+  (
+    const double * /*k*/,
+    const Vec2 & p,
+    Vec2 & d,
+    Mat2 & dd_dp,
+    double * /*dd_dk*/
+  )
+  {
+    d = p;
+    dd_dp.setIdentity();
+  }
+};
+
+struct Distortion_Radial_K1
+{
+  static constexpr int NbParams = 1;
+  static void Apply
+  (
+    const double * k,
+    const Vec2 & p,
+    Vec2 & d,
+    Mat2 & dd_dp,
+    double * dd_dk
+  )
+  {
+    const double r2 = p.squaredNorm();
+    const double r_coeff = 1.0 + k[0] * r2;
+    d = p * r_coeff;
+    dd_dp = r_coeff * Mat2::Identity() + (2.0 * k[0]) * p * p.transpose();
+    dd_dk[0] = p.x() * r2;
+    dd_dk[1] = p.y() * r2;
+  }
+};
+
+struct Distortion_Radial_K3
+{
+  static constexpr int NbParams = 3;
+  static void Apply
+  (
+    const double * k,
+    const Vec2 & p,
+    Vec2 & d,
+    Mat2 & dd_dp,
+    double * dd_dk
+  )
+  {
+    const double r2 = p.squaredNorm();
+    const double r4 = r2 * r2;
+    const double r6 = r4 * r2;
+    const double r_coeff = 1.0 + k[0] * r2 + k[1] * r4 + k[2] * r6;
+    const double dr_coeff_dr2 = k[0] + 2.0 * k[1] * r2 + 3.0 * k[2] * r4;
+    d = p * r_coeff;
+    dd_dp = r_coeff * Mat2::Identity() + (2.0 * dr_coeff_dr2) * p * p.transpose();
+    Eigen::Map<Eigen::Matrix<double, 2, 3, Eigen::RowMajor>> J(dd_dk);
+    J.col(0) = p * r2;
+    J.col(1) = p * r4;
+    J.col(2) = p * r6;
+  }
+};
+
+struct Distortion_Brown_T2
+{
+  static constexpr int NbParams = 5;
+  static void Apply
+  (
+    const double * k,
+    const Vec2 & p,
+    Vec2 & d,
+    Mat2 & dd_dp,
+    double * dd_dk
+  )
+  {
+    const double x = p.x(), y = p.y();
+    const double t1 = k[3], t2 = k[4];
+    const double r2 = p.squaredNorm();
+    const double r4 = r2 * r2;
+    const double r6 = r4 * r2;
+    const double r_coeff = 1.0 + k[0] * r2 + k[1] * r4 + k[2] * r6;
+    const double dr_coeff_dr2 = k[0] + 2.0 * k[1] * r2 + 3.0 * k[2] * r4;
+    d << x * r_coeff + t2 * (r2 + 2.0 * x * x) + 2.0 * t1 * x * y,
+         y * r_coeff + t1 * (r2 + 2.0 * y * y) + 2.0 * t2 * x * y;
+    dd_dp = r_coeff * Mat2::Identity() + (2.0 * dr_coeff_dr2) * p * p.transpose();
+    dd_dp(0,0) += 6.0 * t2 * x + 2.0 * t1 * y;
+    dd_dp(0,1) += 2.0 * t2 * y + 2.0 * t1 * x;
+    dd_dp(1,0) += 2.0 * t1 * x + 2.0 * t2 * y;
+    dd_dp(1,1) += 6.0 * t1 * y + 2.0 * t2 * x;
+    Eigen::Map<Eigen::Matrix<double, 2, 5, Eigen::RowMajor>> J(dd_dk);
+    J.col(0) = p * r2;
+    J.col(1) = p * r4;
+    J.col(2) = p * r6;
+    J.col(3) << 2.0 * x * y, r2 + 2.0 * y * y;
+    J.col(4) << r2 + 2.0 * x * x, 2.0 * x * y;
+  }
+};
+
+struct Distortion_Fisheye
+{
+  static constexpr int NbParams = 4;
+  static void Apply
+  (
+    const double * k,
+    const Vec2 & p,
+    Vec2 & d,
+    Mat2 & dd_dp,
+    double * dd_dk
+  )
+  {
+    Eigen::Map<Eigen::Matrix<double, 2, 4, Eigen::RowMajor>> J(dd_dk);
+    const double r2 = p.squaredNorm();
+    const double r = std::sqrt(r2);
+    if (!(r > 1e-8))
+    {
+      // The distortion is the identity around the principal point
+      d = p;
+      dd_dp.setIdentity();
+      J.setZero();
+      return;
+    }
+    const double
+      theta = std::atan(r),
+      theta2 = theta*theta,
+      theta3 = theta2*theta,
+      theta4 = theta2*theta2,
+      theta5 = theta4*theta,
+      theta6 = theta3*theta3,
+      theta7 = theta6*theta,
+      theta8 = theta4*theta4,
+      theta9 = theta8*theta;
+    const double theta_dist = theta + k[0]*theta3 + k[1]*theta5 + k[2]*theta7 + k[3]*theta9;
+    const double inv_r = 1.0 / r;
+    const double cdist = theta_dist * inv_r;
+    // d(cdist)/dr = (dtheta_dist/dtheta * dtheta/dr * r - theta_dist) / r^2
+    const double dtheta_dist_dtheta =
+      1.0 + 3.0*k[0]*theta2 + 5.0*k[1]*theta4 + 7.0*k[2]*theta6 + 9.0*k[3]*theta8;
+    const double dcdist_dr = (dtheta_dist_dtheta / (1.0 + r2) * r - theta_dist) * inv_r * inv_r;
+    d = p * cdist;
+    dd_dp = cdist * Mat2::Identity() + (dcdist_dr * inv_r) * p * p.transpose();
+    J.col(0) = p * (theta3 * inv_r);
+    J.col(1) = p * (theta5 * inv_r);
+    J.col(2) = p * (theta7 * inv_r);
+    J.col(3) = p * (theta9 * inv_r);
+  }
+};
+
+/**
+ * @brief Ceres cost function (analytic Jacobians) for the pinhole camera models.
+ *
+ *  Data parameter blocks are the following <2, 3 + NbParams, 6, 3>
+ *  - 2 => dimension of the residuals,
+ *  - 3 + NbParams => the intrinsic data block [focal, principal point x, principal point y, distortion],
+ *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
+ *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
+ *  - 3 => a 3D point data block.
+ */
+template <typename Distortion>
+class ResidualErrorAnalytic_Pinhole
+  : public ceres::SizedCostFunction<2, 3 + Distortion::NbParams, 6, 3>
+{
+public:
+  ResidualErrorAnalytic_Pinhole
+  (
+    const double * const pos_2dpoint,
+    const double weight = 1.0
+  )
+  : m_pos_2dpoint(pos_2dpoint), m_weight(weight)
+  {
+  }
+
+  bool Evaluate
+  (
+    double const * const * parameters,
+    double * residuals,
+    double ** jacobians
+  ) const override
+  {
+    const double * cam_intrinsics = parameters[0];
+    const double focal = cam_intrinsics[0];
+
+    // The pose and point Jacobians are only computed if requested
+    const bool b_point_jacobians =
+      jacobians != nullptr && (jacobians[1] != nullptr || jacobians[2] != nullptr);
+    Vec3 Xc;
+    Mat3 dXc_dangle_axis, dXc_dX;
+    if (b_point_jacobians)
+      TransformPoint(parameters[1], parameters[2], Xc, &dXc_dangle_axis, &dXc_dX);
+    else
+      TransformPoint(parameters[1], parameters[2], Xc);
+    const Vec2 projected_point = Xc.hnormalized();
+
+    Vec2 d;
+    Mat2 dd_dp;
+    double dd_dk[Distortion::NbParams > 0 ? 2 * Distortion::NbParams : 2];
+    Distortion::Apply(&cam_intrinsics[3], projected_point, d, dd_dp, dd_dk);
+
+    residuals[0] = m_weight * (cam_intrinsics[1] + d.x() * focal - m_pos_2dpoint[0]);
+    residuals[1] = m_weight * (cam_intrinsics[2] + d.y() * focal - m_pos_2dpoint[1]);
+
+    if (jacobians == nullptr)
+      return true;
+
+    if (jacobians[0] != nullptr)
+    {
+      Eigen::Map<Eigen::Matrix<double, 2, 3 + Distortion::NbParams, Eigen::RowMajor>>
+        J(jacobians[0]);
+      J.col(0) = m_weight * d;
+      J.col(1) << m_weight, 0.0;
+      J.col(2) << 0.0, m_weight;
+      for (int i = 0; i < Distortion::NbParams; ++i)
+      {
+        J(0, 3 + i) = m_weight * focal * dd_dk[i];
+        J(1, 3 + i) = m_weight * focal * dd_dk[Distortion::NbParams + i];
+      }
+    }
+    if (!b_point_jacobians)
+      return true;
+
+    const Mat23 dr_dXc = (m_weight * focal) * dd_dp * PerspectiveDivisionJacobian(Xc);
+    if (jacobians[1] != nullptr)
+    {
+      Eigen::Map<Eigen::Matrix<double, 2, 6, Eigen::RowMajor>> J(jacobians[1]);
+      J.leftCols<3>() = dr_dXc * dXc_dangle_axis;
+      J.rightCols<3>() = dr_dXc;
+    }
+    if (jacobians[2] != nullptr)
+    {
+      Eigen::Map<Eigen::Matrix<double, 2, 3, Eigen::RowMajor>> J(jacobians[2]);
+      J = dr_dXc * dXc_dX;
+    }
+    return true;
+  }
+
+  // Factory to hide the construction of the CostFunction object from
+  // the client code.
+  static ceres::CostFunction* Create
+  (
+    const Eigen::Ref<const Vec2> & observation,
+    const double weight = 0.0
+  )
+  {
+    return new ResidualErrorAnalytic_Pinhole(observation.data(), weight == 0.0 ? 1.0 : weight);
+  }
+
+private:
+  const double * m_pos_2dpoint; // The 2D observation
+  const double m_weight;
+};
+
+using ResidualErrorAnalytic_Pinhole_Intrinsic = ResidualErrorAnalytic_Pinhole<Distortion_None>;
+using ResidualErrorAnalytic_Pinhole_Intrinsic_Radial_K1 = ResidualErrorAnalytic_Pinhole<Distortion_Radial_K1>;
+using ResidualErrorAnalytic_Pinhole_Intrinsic_Radial_K3 = ResidualErrorAnalytic_Pinhole<Distortion_Radial_K3>;
+using ResidualErrorAnalytic_Pinhole_Intrinsic_Brown_T2 = ResidualErrorAnalytic_Pinhole<Distortion_Brown_T2>;
+using ResidualErrorAnalytic_Pinhole_Intrinsic_Fisheye = ResidualErrorAnalytic_Pinhole<Distortion_Fisheye>;
+
+/**
+ * @brief Ceres cost function (analytic Jacobians) for the spherical camera model.
+ *
+ *  Data parameter blocks are the following <2,6,3>
+ *  - 2 => dimension of the residuals,
+ *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
+ *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
+ *  - 3 => a 3D point data block.
+ */
+class ResidualErrorAnalytic_Intrinsic_Spherical
+  : public ceres::SizedCostFunction<2, 6, 3>
+{
+public:
+  ResidualErrorAnalytic_Intrinsic_Spherical
+  (
+    const double * const pos_2dpoint,
+    const uint32_t imageSize_w,
+    const uint32_t imageSize_h,
+    const double weight = 1.0
+  )
+  : m_pos_2dpoint(pos_2dpoint),
+    m_imageSize{imageSize_w, imageSize_h},
+    m_weight(weight)
+  {
+  }
+
+  bool Evaluate
+  (
+    double const * const * parameters,
+    double * residuals,
+    double ** jacobians
+  ) const override
+  {
+    const bool b_point_jacobians =
+      jacobians != nullptr && (jacobians[0] != nullptr || jacobians[1] != nullptr);
+    Vec3 Xc;
+    Mat3 dXc_dangle_axis, dXc_dX;
+    if (b_point_jacobians)
+      TransformPoint(parameters[0], parameters[1], Xc, &dXc_dangle_axis, &dXc_dX);
+    else
+      TransformPoint(parameters[0], parameters[1], Xc);
+
+    // Transform the coord in is Image space
+    const double x = Xc.x(), y = Xc.y(), z = Xc.z();
+    const double rho2 = x * x + z * z;
+    const double rho = std::sqrt(rho2);
+    const double lon = std::atan2(x, z); // Horizontal normalization of the  X-Z component
+    const double lat = std::atan2(-y, rho); // Tilt angle
+
+    const double size = std::max(m_imageSize[0], m_imageSize[1]);
+    const double scale = size / (2 * M_PI);
+    residuals[0] = m_weight * (lon * scale - 0.5 + m_imageSize[0] / 2.0 - m_pos_2dpoint[0]);
+    residuals[1] = m_weight * (- lat * scale - 0.5 + m_imageSize[1] / 2.0 - m_pos_2dpoint[1]);
+
+    if (!b_point_jacobians)
+      return true;
+
+    // d(lon)/d(Xc) and d(lat)/d(Xc)
+    const double n2 = rho2 + y * y;
+    Mat23 dr_dXc;
+    dr_dXc << z / rho2, 0.0, -x / rho2,
+              - y * x / (n2 * rho), rho / n2, - y * z / (n2 * rho);
+    dr_dXc.row(0) *= m_weight * scale;
+    dr_dXc.row(1) *= m_weight * scale;
+
+    if (jacobians[0] != nullptr)
+    {
+      Eigen::Map<Eigen::Matrix<double, 2, 6, Eigen::RowMajor>> J(jacobians[0]);
+      J.leftCols<3>() = dr_dXc * dXc_dangle_axis;
+      J.rightCols<3>() = dr_dXc;
+    }
+    if (jacobians[1] != nullptr)
+    {
+      Eigen::Map<Eigen::Matrix<double, 2, 3, Eigen::RowMajor>> J(jacobians[1]);
+      J = dr_dXc * dXc_dX;
+    }
+    return true;
+  }
+
+  // Factory to hide the construction of the CostFunction object from
+  // the client code.
+  static ceres::CostFunction* Create
+  (
+    const cameras::IntrinsicBase * cameraInterface,
+    const Eigen::Ref<const Vec2> & observation,
+    const double weight = 0.0
+  )
+  {
+    return new ResidualErrorAnalytic_Intrinsic_Spherical(
+      observation.data(),
+      cameraInterface->w(),
+      cameraInterface->h(),
+      weight == 0.0 ? 1.0 : weight);
+  }
+
+private:
+  const double * m_pos_2dpoint;  // The 2D observation
+  size_t         m_imageSize[2]; // The image width and height
+  const double   m_weight;
+};
+
+} // namespace analytic
+} // namespace sfm
+} // namespace openMVG
+
+#endif // OPENMVG_SFM_SFM_DATA_BA_CERES_CAMERA_ANALYTIC_FUNCTOR_HPP
@@ -169,7 +169,7 @@ struct ResidualErrorFunctor_Pinhole_Intrinsic
   // the client code.
   static ceres::CostFunction* Create
   (
-    const Vec2 & observation,
+    const Eigen::Ref<const Vec2> & observation,
     const double weight = 0.0
   )
   {
@@ -275,7 +275,7 @@ struct ResidualErrorFunctor_Pinhole_Intrinsic_Radial_K1
   // the client code.
   static ceres::CostFunction* Create
   (
-    const Vec2 & observation,
+    const Eigen::Ref<const Vec2> & observation,
     const double weight = 0.0
   )
   {
@@ -387,7 +387,7 @@ struct ResidualErrorFunctor_Pinhole_Intrinsic_Radial_K3
   // the client code.
   static ceres::CostFunction* Create
   (
-    const Vec2 & observation,
+    const Eigen::Ref<const Vec2> & observation,
     const double weight = 0.0
   )
   {
@@ -508,7 +508,7 @@ struct ResidualErrorFunctor_Pinhole_Intrinsic_Brown_T2
   // the client code.
   static ceres::CostFunction* Create
   (
-    const Vec2 & observation,
+    const Eigen::Ref<const Vec2> & observation,
     const double weight = 0.0
   )
   {
@@ -635,7 +635,7 @@ struct ResidualErrorFunctor_Pinhole_Intrinsic_Fisheye
   // the client code.
   static ceres::CostFunction* Create
   (
-    const Vec2 & observation,
+    const Eigen::Ref<const Vec2> & observation,
     const double weight = 0.0
   )
   {
@@ -724,7 +724,7 @@ struct ResidualErrorFunctor_Intrinsic_Spherical
   static ceres::CostFunction* Create
   (
     const cameras::IntrinsicBase * cameraInterface,
-    const Vec2 & observation,
+    const Eigen::Ref<const Vec2> & observation,
     const double weight = 0.0
   )
   {
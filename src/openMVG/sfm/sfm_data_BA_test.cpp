@@ -21,11 +21,18 @@
 #include "openMVG/sfm/sfm.hpp"
 
 #include "testing/testing.h"
+#include "third_party/stlplus3/filesystemSimplified/file_system.hpp"
 
+#include <ceres/ceres.h>
+
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <set>
+#include <vector>
 
 using namespace openMVG;
 using namespace openMVG::cameras;
@@ -72,6 +79,269 @@ TEST(BUNDLE_ADJUSTMENT, EffectiveMinimization_Pinhole) {
   EXPECT_TRUE( dResidual_before > dResidual_after);
 }
 
+TEST(BUNDLE_ADJUSTMENT, EffectiveMinimization_Pinhole_Landmarks_SoA) {
+
+  const int nviews = 3;
+  const int npoints = 6;
+  const nViewDatasetConfigurator config;
+  const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+  // Translate the input dataset to a SfM_Data scene
+  SfM_Data sfm_data = getInputScene(d, config, PINHOLE_CAMERA);
+
+  const double dResidual_before = RMSE(sfm_data);
+
+  // Move the structure to a Landmarks_SoA container
+  Landmarks_SoA structure;
+  structure.FromLandmarks(sfm_data.structure);
+  sfm_data.structure.clear();
+
+  const bool bVerbose = true;
+  const bool bMultithread = false;
+  Bundle_Adjustment_Ceres ba_object(
+    Bundle_Adjustment_Ceres::BA_Ceres_options(bVerbose, bMultithread));
+  EXPECT_TRUE( ba_object.Adjust(sfm_data, structure,
+    Optimize_Options(
+      Intrinsic_Parameter_Type::ADJUST_ALL,
+      Extrinsic_Parameter_Type::ADJUST_ALL,
+      Structure_Parameter_Type::ADJUST_ALL)) );
+
+  structure.ToLandmarks(sfm_data.structure);
+  EXPECT_EQ(npoints, sfm_data.structure.size());
+  const double dResidual_after = RMSE(sfm_data);
+  EXPECT_TRUE( dResidual_before > dResidual_after);
+}
+
+TEST(BUNDLE_ADJUSTMENT, LocalBundleAdjustment_Pinhole) {
+
+  const int nviews = 6;
+  const int npoints = 32;
+  const nViewDatasetConfigurator config;
+  const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+  // Translate the input dataset to a SfM_Data scene
+  SfM_Data sfm_data = getInputScene(d, config, PINHOLE_CAMERA);
+  const Poses poses_before = sfm_data.poses;
+  const std::vector<double> intrinsic_params_before = sfm_data.intrinsics.at(0)->getParams();
+
+  const double dResidual_before = RMSE(sfm_data);
+
+  // Refine only the poses {0,1} (and the landmarks they see)
+  const bool bVerbose = true;
+  const bool bMultithread = false;
+  Bundle_Adjustment_Ceres ba_object(
+    Bundle_Adjustment_Ceres::BA_Ceres_options(bVerbose, bMultithread));
+  EXPECT_TRUE( ba_object.AdjustLocal(sfm_data, {0, 1},
+    Optimize_Options(
+      Intrinsic_Parameter_Type::ADJUST_ALL,
+      Extrinsic_Parameter_Type::ADJUST_ALL,
+      Structure_Parameter_Type::ADJUST_ALL)) );
+
+  const double dResidual_after = RMSE(sfm_data);
+  EXPECT_TRUE( dResidual_before > dResidual_after);
+
+  // The other poses are held as constant
+  for (const auto & pose_it : sfm_data.poses)
+  {
+    const double center_change = (pose_it.second.center() - poses_before.at(pose_it.first).center()).norm();
+    if (pose_it.first < 2)
+    {
+      EXPECT_TRUE(center_change > 0.0);
+    }
+    else
+    {
+      EXPECT_EQ(0.0, center_change);
+    }
+  }
+  // The intrinsics are shared with the fixed poses: they are held as constant
+  EXPECT_TRUE( intrinsic_params_before == sfm_data.intrinsics.at(0)->getParams() );
+}
+
+TEST(BUNDLE_ADJUSTMENT, Session_Pinhole) {
+
+  const int nviews = 6;
+  const int npoints = 32;
+  const nViewDatasetConfigurator config;
+  const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+  // Translate the input dataset to a SfM_Data scene
+  SfM_Data sfm_data = getInputScene(d, config, PINHOLE_CAMERA);
+  SfM_Data sfm_data_reference = sfm_data;
+
+  const double dResidual_before = RMSE(sfm_data);
+
+  const Optimize_Options ba_refine_options(
+    Intrinsic_Parameter_Type::ADJUST_ALL,
+    Extrinsic_Parameter_Type::ADJUST_ALL,
+    Structure_Parameter_Type::ADJUST_ALL);
+  const bool bVerbose = true;
+  const bool bMultithread = false;
+  Bundle_Adjustment_Ceres_Session ba_session(ba_refine_options,
+    Bundle_Adjustment_Ceres::BA_Ceres_options(bVerbose, bMultithread));
+  EXPECT_TRUE( ba_session.Adjust(sfm_data) );
+  EXPECT_EQ( nviews * npoints, ba_session.NbResidualBlocks() );
+
+  const double dResidual_after = RMSE(sfm_data);
+  EXPECT_TRUE( dResidual_before > dResidual_after);
+
+  // Same minimum as the one shot bundle adjustment
+  Bundle_Adjustment_Ceres ba_object(
+    Bundle_Adjustment_Ceres::BA_Ceres_options(bVerbose, bMultithread));
+  EXPECT_TRUE( ba_object.Adjust(sfm_data_reference, ba_refine_options) );
+  EXPECT_NEAR( RMSE(sfm_data_reference), dResidual_after, 1e-4);
+
+  // Edit the scene: remove a landmark, an observation & a pose (and its observations),
+  //  move a landmark and a pose
+  sfm_data.structure.erase(sfm_data.structure.begin());
+  sfm_data.structure.begin()->second.obs.erase(
+    sfm_data.structure.begin()->second.obs.begin());
+  sfm_data.structure.begin()->second.X += Vec3(0.1, -0.1, 0.1);
+  sfm_data.poses.erase(5);
+  for (auto & landmark_it : sfm_data.structure)
+    landmark_it.second.obs.erase(5);
+  sfm_data.poses.at(2).center() += Vec3(0.05, 0.05, 0.0);
+
+  size_t nb_observations = 0;
+  for (const auto & landmark_it : sfm_data.structure)
+    nb_observations += landmark_it.second.obs.size();
+
+  const double dResidual_edited = RMSE(sfm_data);
+  EXPECT_TRUE( ba_session.Adjust(sfm_data) );
+  EXPECT_EQ( nb_observations, ba_session.NbResidualBlocks() );
+  EXPECT_TRUE( dResidual_edited > RMSE(sfm_data) );
+  EXPECT_NEAR( dResidual_after, RMSE(sfm_data), 0.05 );
+
+  // Edit the scene: replace an intrinsic by another camera model, move a view
+  //  to a new pose
+  sfm_data.intrinsics.at(0) = std::make_shared<Pinhole_Intrinsic_Radial_K3>(
+    config._cx * 2, config._cy * 2, config._fx, config._cx, config._cy);
+  const IndexT new_pose_id = nviews;
+  sfm_data.poses[new_pose_id] = sfm_data.poses.at(1);
+  sfm_data.poses.at(new_pose_id).center() += Vec3(0.05, 0.0, 0.05);
+  sfm_data.poses.erase(1);
+  sfm_data.views.at(1)->id_pose = new_pose_id;
+
+  const double dResidual_moved = RMSE(sfm_data);
+  EXPECT_TRUE( ba_session.Adjust(sfm_data) );
+  EXPECT_EQ( nb_observations, ba_session.NbResidualBlocks() );
+  EXPECT_EQ( 6, sfm_data.intrinsics.at(0)->getParams().size() );
+  EXPECT_TRUE( dResidual_moved > RMSE(sfm_data) );
+  EXPECT_NEAR( dResidual_after, RMSE(sfm_data), 0.05 );
+
+  // A scene with an unsupported camera model is rejected (and left unchanged)
+  struct Unsupported_Intrinsic : public Pinhole_Intrinsic
+  {
+    using Pinhole_Intrinsic::Pinhole_Intrinsic;
+    EINTRINSIC getType() const override { return PINHOLE_CAMERA_END; }
+  };
+  const IndexT unsupported_intrinsic_id = sfm_data.intrinsics.size();
+  sfm_data.intrinsics[unsupported_intrinsic_id] = std::make_shared<Unsupported_Intrinsic>(
+    config._cx * 2, config._cy * 2, config._fx, config._cx, config._cy);
+  sfm_data.views.at(0)->id_intrinsic = unsupported_intrinsic_id;
+  const double dResidual_unsupported = RMSE(sfm_data);
+  EXPECT_FALSE( ba_session.Adjust(sfm_data) );
+  EXPECT_EQ( dResidual_unsupported, RMSE(sfm_data) );
+}
+
+TEST(BUNDLE_ADJUSTMENT, Partitioned_Pinhole) {
+
+  const int nviews = 12;
+  const int npoints = 128;
+  const nViewDatasetConfigurator config;
+  const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+  // Translate the input dataset to a SfM_Data scene
+  // (each point is kept visible by a window of 4 consecutive cameras)
+  SfM_Data sfm_data = getInputScene(d, config, PINHOLE_CAMERA);
+  for (auto & landmark_it : sfm_data.structure)
+  {
+    const IndexT first_view = landmark_it.first % nviews;
+    auto & obs = landmark_it.second.obs;
+    for (auto obs_it = obs.begin(); obs_it != obs.end();)
+    {
+      if ((obs_it->first + nviews - first_view) % nviews >= 4)
+        obs_it = obs.erase(obs_it);
+      else
+        ++obs_it;
+    }
+  }
+  SfM_Data sfm_data_reference = sfm_data;
+  SfM_Data sfm_data_out_of_core = sfm_data;
+  for (SfM_Data * scene : {&sfm_data_reference, &sfm_data_out_of_core})
+  {
+    for (auto & intrinsic_it : scene->intrinsics)
+      intrinsic_it.second.reset(intrinsic_it.second->clone());
+  }
+
+  const double dResidual_before = RMSE(sfm_data);
+
+  // The clusters cover all the poses (without intersection)
+  Bundle_Adjustment_Ceres_Partitioned::Partition_Options partition_options;
+  partition_options.max_cluster_size_ = 4;
+  partition_options.min_shared_landmarks_ = 32;
+  partition_options.consensus_tolerance_ = 3e-3;
+  const std::vector<Bundle_Adjustment_Ceres_Partitioned::Pose_Cluster> clusters =
+    Bundle_Adjustment_Ceres_Partitioned::PartitionPoses(sfm_data,
+      partition_options.max_cluster_size_, partition_options.min_shared_landmarks_);
+  EXPECT_EQ(3, clusters.size());
+  std::set<IndexT> clustered_poses;
+  for (const auto & cluster : clusters)
+  {
+    EXPECT_TRUE( cluster.poses.size() <= partition_options.max_cluster_size_ );
+    EXPECT_FALSE( cluster.overlap_poses.empty() );
+    for (const IndexT pose_id : cluster.poses)
+    {
+      EXPECT_TRUE( clustered_poses.insert(pose_id).second );
+      EXPECT_EQ( 0, cluster.overlap_poses.count(pose_id) );
+    }
+  }
+  EXPECT_EQ( sfm_data.poses.size(), clustered_poses.size() );
+
+  const Optimize_Options ba_refine_options(
+    Intrinsic_Parameter_Type::ADJUST_ALL,
+    Extrinsic_Parameter_Type::ADJUST_ALL,
+    Structure_Parameter_Type::ADJUST_ALL);
+  const bool bVerbose = true;
+  const bool bMultithread = false;
+  const Bundle_Adjustment_Ceres::BA_Ceres_options ceres_options(bVerbose, bMultithread);
+
+  // Reference: the whole scene refined as one problem
+  Bundle_Adjustment_Ceres ba_object(ceres_options);
+  EXPECT_TRUE( ba_object.Adjust(sfm_data_reference, ba_refine_options) );
+  const double dResidual_reference = RMSE(sfm_data_reference);
+
+  Bundle_Adjustment_Ceres_Partitioned ba_partitioned(partition_options, ceres_options);
+  EXPECT_TRUE( ba_partitioned.Adjust(sfm_data, ba_refine_options) );
+  const double dResidual_after = RMSE(sfm_data);
+  EXPECT_TRUE( dResidual_before > dResidual_after );
+  EXPECT_NEAR( dResidual_reference, dResidual_after, 0.1 * dResidual_reference );
+
+  // Same result with the landmarks stored on disk (one cluster loaded at once)
+  // The observations of a view without pose are not refined but kept.
+  const IndexT unposed_view_id = nviews;
+  sfm_data_out_of_core.views[unposed_view_id] = std::make_shared<View>(
+    "unposed.jpg", unposed_view_id, 0, UndefinedIndexT,
+    config._cx * 2, config._cy * 2);
+  for (IndexT landmark_id = 0; landmark_id < 10; ++landmark_id)
+    sfm_data_out_of_core.structure.at(landmark_id).obs[unposed_view_id] = Observation(Vec2(1.0, 1.0), 0);
+  partition_options.temporary_directory_ = "partitioned_BA_tmp";
+  partition_options.max_loaded_clusters_ = 1;
+  Bundle_Adjustment_Ceres_Partitioned ba_out_of_core(partition_options, ceres_options);
+  EXPECT_TRUE( ba_out_of_core.Adjust(sfm_data_out_of_core, ba_refine_options) );
+  for (IndexT landmark_id = 0; landmark_id < 10; ++landmark_id)
+    EXPECT_EQ( 1, sfm_data_out_of_core.structure.at(landmark_id).obs.erase(unposed_view_id) );
+  sfm_data_out_of_core.views.erase(unposed_view_id);
+  EXPECT_EQ( sfm_data.structure.size(), sfm_data_out_of_core.structure.size() );
+  for (const auto & landmark_it : sfm_data.structure)
+  {
+    const Landmark & landmark = sfm_data_out_of_core.structure.at(landmark_it.first);
+    EXPECT_EQ( landmark_it.second.obs.size(), landmark.obs.size() );
+    EXPECT_NEAR( 0.0, (landmark_it.second.X - landmark.X).norm(), 1e-8 );
+  }
+  EXPECT_NEAR( dResidual_after, RMSE(sfm_data_out_of_core), 1e-8 );
+  stlplus::folder_delete(partition_options.temporary_directory_, true);
+}
+
 TEST(BUNDLE_ADJUSTMENT, EffectiveMinimization_Pinhole_Radial_K1) {
 
   const int nviews = 3;
@@ -185,6 +455,122 @@ TEST(BUNDLE_ADJUSTMENT, EffectiveMinimization_Pinhole_Intrinsic_Fisheye) {
 }
 
 //-- Test with GCP - Camera position once BA done must be the same as the GT
+TEST(BUNDLE_ADJUSTMENT, AnalyticJacobians) {
+
+  // Check the analytic cost functions against the automatic differentiation ones
+  const std::vector<std::shared_ptr<IntrinsicBase>> intrinsics = {
+    std::make_shared<Pinhole_Intrinsic>(1000, 800, 900, 505, 398),
+    std::make_shared<Pinhole_Intrinsic_Radial_K1>(1000, 800, 900, 505, 398, -0.1),
+    std::make_shared<Pinhole_Intrinsic_Radial_K3>(1000, 800, 900, 505, 398, -0.1, 0.02, -0.005),
+    std::make_shared<Pinhole_Intrinsic_Brown_T2>(1000, 800, 900, 505, 398, -0.1, 0.02, -0.005, 0.001, -0.002),
+    std::make_shared<Pinhole_Intrinsic_Fisheye>(1000, 800, 900, 505, 398, -0.05, 0.01, -0.002, 0.0005),
+    std::make_shared<Intrinsic_Spherical>(2000, 1000)
+  };
+
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+  for (const auto & intrinsic : intrinsics)
+  {
+    for (const double angle_scale : {0.5, 1e-6, 1e-12, 0.0})
+    {
+      for (const double weight : {0.0, 2.5})
+      {
+        const Vec2 observation(400.0 + 100.0 * distribution(random_generator),
+                               300.0 + 100.0 * distribution(random_generator));
+        std::unique_ptr<ceres::CostFunction> autodiff_cost(
+          IntrinsicsToCostFunction(intrinsic.get(), observation, weight, false));
+        std::unique_ptr<ceres::CostFunction> analytic_cost(
+          IntrinsicsToCostFunction(intrinsic.get(), observation, weight, true));
+        CHECK(autodiff_cost && analytic_cost);
+        EXPECT_TRUE( autodiff_cost->parameter_block_sizes() == analytic_cost->parameter_block_sizes() );
+
+        // Parameter blocks: [intrinsic], pose [angle axis, t], 3D point
+        std::vector<double> intrinsic_params = intrinsic->getParams();
+        std::vector<double> pose_params(6), point_params(3);
+        for (int i = 0; i < 3; ++i)
+        {
+          pose_params[i] = angle_scale * distribution(random_generator);
+          pose_params[3 + i] = 0.2 * distribution(random_generator);
+          point_params[i] = 0.5 * distribution(random_generator);
+        }
+        point_params[2] += 4.0;
+        std::vector<double*> parameters;
+        if (autodiff_cost->parameter_block_sizes().size() == 3)
+          parameters.push_back(intrinsic_params.data());
+        parameters.push_back(pose_params.data());
+        parameters.push_back(point_params.data());
+
+        std::vector<std::vector<double>> jacobians_autodiff, jacobians_analytic;
+        std::vector<double*> jacobian_ptrs_autodiff, jacobian_ptrs_analytic;
+        for (const auto block_size : autodiff_cost->parameter_block_sizes())
+        {
+          jacobians_autodiff.emplace_back(2 * block_size);
+          jacobians_analytic.emplace_back(2 * block_size);
+        }
+        for (size_t i = 0; i < jacobians_autodiff.size(); ++i)
+        {
+          jacobian_ptrs_autodiff.push_back(jacobians_autodiff[i].data());
+          jacobian_ptrs_analytic.push_back(jacobians_analytic[i].data());
+        }
+
+        Vec2 residuals_autodiff, residuals_analytic;
+        EXPECT_TRUE( autodiff_cost->Evaluate(parameters.data(),
+          residuals_autodiff.data(), jacobian_ptrs_autodiff.data()) );
+        EXPECT_TRUE( analytic_cost->Evaluate(parameters.data(),
+          residuals_analytic.data(), jacobian_ptrs_analytic.data()) );
+
+        EXPECT_NEAR( 0.0, (residuals_autodiff - residuals_analytic).norm(), 1e-8 );
+        // The automatic differentiation of the angle axis rotation loses
+        //  a few digits for small rotation angles
+        for (size_t i = 0; i < jacobians_autodiff.size(); ++i)
+        {
+          for (size_t j = 0; j < jacobians_autodiff[i].size(); ++j)
+          {
+            EXPECT_NEAR( jacobians_autodiff[i][j], jacobians_analytic[i][j],
+              1e-6 * std::max(1.0, std::abs(jacobians_autodiff[i][j])) );
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(BUNDLE_ADJUSTMENT, EffectiveMinimization_Pinhole_Radial_K3_AnalyticJacobians) {
+
+  const int nviews = 3;
+  const int npoints = 6;
+  const nViewDatasetConfigurator config;
+  const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+  // Translate the input dataset to a SfM_Data scene
+  SfM_Data sfm_data = getInputScene(d, config, PINHOLE_CAMERA_RADIAL3);
+  SfM_Data sfm_data_autodiff = sfm_data;
+  // Do not share the intrinsics between the two scenes
+  for (auto & intrinsic_it : sfm_data_autodiff.intrinsics)
+    intrinsic_it.second.reset(intrinsic_it.second->clone());
+
+  const double dResidual_before = RMSE(sfm_data);
+
+  const Optimize_Options ba_refine_options(
+    Intrinsic_Parameter_Type::ADJUST_ALL,
+    Extrinsic_Parameter_Type::ADJUST_ALL,
+    Structure_Parameter_Type::ADJUST_ALL);
+  const bool bVerbose = true;
+  const bool bMultithread = false;
+  Bundle_Adjustment_Ceres::BA_Ceres_options ceres_options(bVerbose, bMultithread);
+  Bundle_Adjustment_Ceres ba_autodiff(ceres_options);
+  EXPECT_TRUE( ba_autodiff.Adjust(sfm_data_autodiff, ba_refine_options) );
+  ceres_options.bUse_analytic_jacobians_ = true;
+  Bundle_Adjustment_Ceres ba_analytic(ceres_options);
+  EXPECT_TRUE( ba_analytic.Adjust(sfm_data, ba_refine_options) );
+
+  const double dResidual_after = RMSE(sfm_data);
+  EXPECT_TRUE( dResidual_before > dResidual_after);
+  // Same minimum as with the automatic differentiation
+  EXPECT_NEAR( RMSE(sfm_data_autodiff), dResidual_after, 1e-4);
+}
+
 TEST(BUNDLE_ADJUSTMENT, EffectiveMinimization_Pinhole_GCP) {
 
   const int nviews = 3;
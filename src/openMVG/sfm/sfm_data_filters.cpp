@@ -8,6 +8,7 @@
 
 #include "openMVG/sfm/sfm_data_filters.hpp"
 #include "openMVG/sfm/sfm_data.hpp"
+#include "openMVG/sfm/sfm_landmark_soa.hpp"
 #include "openMVG/stl/stl.hpp"
 #include "openMVG/system/logger.hpp"
 #include "openMVG/tracks/union_find.hpp"
@@ -118,6 +119,60 @@ IndexT RemoveOutliers_AngleError
   return removedTrack_count;
 }
 
+IndexT RemoveOutliers_PixelResidualError
+(
+  const SfM_Data & sfm_data,
+  Landmarks_SoA & landmarks,
+  const double dThresholdPixel,
+  const unsigned int minTrackLength
+)
+{
+  return static_cast<IndexT>(landmarks.EraseObservations(
+    [&](const std::size_t i, const uint64_t obs)
+    {
+      const View * view = sfm_data.views.at(landmarks.obs_view_ids[obs]).get();
+      const geometry::Pose3 pose = sfm_data.GetPoseOrDie(view);
+      const cameras::IntrinsicBase * intrinsic = sfm_data.intrinsics.at(view->id_intrinsic).get();
+      const Vec2 residual = intrinsic->residual(pose(landmarks.X.col(i)), landmarks.obs_x.col(obs));
+      return residual.norm() > dThresholdPixel;
+    },
+    minTrackLength));
+}
+
+IndexT RemoveOutliers_AngleError
+(
+  const SfM_Data & sfm_data,
+  Landmarks_SoA & landmarks,
+  const double dMinAcceptedAngle
+)
+{
+  return static_cast<IndexT>(landmarks.EraseLandmarks(
+    [&](const std::size_t i)
+    {
+      double max_angle = 0.0;
+      for (uint64_t obs1 = landmarks.obs_offsets[i]; obs1 < landmarks.obs_offsets[i + 1]; ++obs1)
+      {
+        const View * view1 = sfm_data.views.at(landmarks.obs_view_ids[obs1]).get();
+        const geometry::Pose3 pose1 = sfm_data.GetPoseOrDie(view1);
+        const cameras::IntrinsicBase * intrinsic1 = sfm_data.intrinsics.at(view1->id_intrinsic).get();
+
+        for (uint64_t obs2 = obs1 + 1; obs2 < landmarks.obs_offsets[i + 1]; ++obs2)
+        {
+          const View * view2 = sfm_data.views.at(landmarks.obs_view_ids[obs2]).get();
+          const geometry::Pose3 pose2 = sfm_data.GetPoseOrDie(view2);
+          const cameras::IntrinsicBase * intrinsic2 = sfm_data.intrinsics.at(view2->id_intrinsic).get();
+
+          const double angle = AngleBetweenRay(
+            pose1, intrinsic1, pose2, intrinsic2,
+            intrinsic1->get_ud_pixel(landmarks.obs_x.col(obs1)),
+            intrinsic2->get_ud_pixel(landmarks.obs_x.col(obs2)));
+          max_angle = std::max(angle, max_angle);
+        }
+      }
+      return max_angle < dMinAcceptedAngle;
+    }));
+}
+
 bool eraseMissingPoses
 (
   SfM_Data & sfm_data,
@@ -13,6 +13,7 @@
 
 #include "openMVG/types.hpp"
 
+namespace openMVG { namespace sfm { struct Landmarks_SoA; } }
 namespace openMVG { namespace sfm { struct SfM_Data; } }
 
 namespace openMVG {
@@ -59,6 +60,25 @@ IndexT RemoveOutliers_AngleError
   const double dMinAcceptedAngle
 );
 
+/// RemoveOutliers_PixelResidualError for a Landmarks_SoA structure
+///  (the views, poses and intrinsics are read from sfm_data)
+IndexT RemoveOutliers_PixelResidualError
+(
+  const SfM_Data & sfm_data,
+  Landmarks_SoA & landmarks,
+  const double dThresholdPixel,
+  const unsigned int minTrackLength = 2
+);
+
+/// RemoveOutliers_AngleError for a Landmarks_SoA structure
+///  (the views, poses and intrinsics are read from sfm_data)
+IndexT RemoveOutliers_AngleError
+(
+  const SfM_Data & sfm_data,
+  Landmarks_SoA & landmarks,
+  const double dMinAcceptedAngle
+);
+
 /// Erase pose with insufficient track observations
 bool eraseMissingPoses
 (
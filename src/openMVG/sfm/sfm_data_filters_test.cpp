@@ -9,9 +9,13 @@
 #include "openMVG/cameras/Camera_Pinhole.hpp"
 #include "openMVG/sfm/sfm_data.hpp"
 #include "openMVG/sfm/sfm_data_filters.hpp"
+#include "openMVG/sfm/sfm_landmark_soa.hpp"
 
 #include "testing/testing.h"
 
+#include <algorithm>
+#include <random>
+
 using namespace openMVG;
 using namespace openMVG::cameras;
 using namespace openMVG::geometry;
@@ -164,6 +168,83 @@ TEST(SFM_DATA_FILTERS, eraseUnstablePosesAndObservations)
   EXPECT_EQ(0, sfm_data.structure.count(5));
 }
 
+// Check that two landmark collections are the same
+static bool AreLandmarksEqual(const Landmarks & a, const Landmarks & b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (const auto & landmark_it : a)
+  {
+    const auto it = b.find(landmark_it.first);
+    if (it == b.end() || landmark_it.second.X != it->second.X
+        || landmark_it.second.obs.size() != it->second.obs.size())
+      return false;
+    for (const auto & obs_it : landmark_it.second.obs)
+    {
+      const auto obs = it->second.obs.find(obs_it.first);
+      if (obs == it->second.obs.end() || obs->second.id_feat != obs_it.second.id_feat
+          || obs->second.x != obs_it.second.x)
+        return false;
+    }
+  }
+  return true;
+}
+
+TEST(SFM_DATA_FILTERS, Landmarks_SoA)
+{
+  // Init a scene with 8 views with poses along the X axis
+  SfM_Data sfm_data;
+  init_scene(sfm_data, 8);
+  for (auto & pose_it : sfm_data.poses)
+    pose_it.second = Pose3(Mat3::Identity(), Vec3(pose_it.first, 0, 0));
+  sfm_data.intrinsics[0] = std::make_shared<Pinhole_Intrinsic>(1000, 1000, 1000, 500, 500);
+
+  // Landmarks observed by random views (with some outlier observations)
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  std::uniform_int_distribution<IndexT> view_dist(0, 7), length_dist(1, 5);
+  std::uniform_real_distribution<double> pos_dist(-1.0, 1.0), outlier_dist(0.0, 1.0);
+  const cameras::IntrinsicBase * intrinsic = sfm_data.intrinsics.at(0).get();
+  for (IndexT id = 0; id < 500; ++id)
+  {
+    // Some far landmarks have a tiny triangulation angle
+    const double depth = (id % 10 == 0) ? 1000.0 : 10.0;
+    Landmark & landmark = sfm_data.structure[2 * id];
+    landmark.X = Vec3(3.5 + pos_dist(random_generator), pos_dist(random_generator), depth);
+    const IndexT length = length_dist(random_generator);
+    while (landmark.obs.size() < length)
+    {
+      const IndexT view_id = view_dist(random_generator);
+      Vec2 x = intrinsic->project(sfm_data.poses.at(view_id)(landmark.X));
+      if (outlier_dist(random_generator) < 0.2)
+        x += Vec2(10, -10);
+      landmark.obs[view_id] = Observation(x, id + view_id);
+    }
+  }
+
+  Landmarks_SoA landmarks;
+  landmarks.FromLandmarks(sfm_data.structure);
+  EXPECT_EQ(sfm_data.structure.size(), landmarks.size());
+  EXPECT_EQ(landmarks.size(), landmarks.Find(1));
+  EXPECT_EQ(3, landmarks.Find(6));
+  EXPECT_TRUE(std::is_sorted(landmarks.ids.cbegin(), landmarks.ids.cend()));
+  Landmarks converted_landmarks;
+  landmarks.ToLandmarks(converted_landmarks);
+  EXPECT_TRUE(AreLandmarksEqual(sfm_data.structure, converted_landmarks));
+
+  // The filters must give the same results for both containers
+  EXPECT_EQ(RemoveOutliers_PixelResidualError(sfm_data, 4.0, 2),
+            RemoveOutliers_PixelResidualError(sfm_data, landmarks, 4.0, 2));
+  landmarks.ToLandmarks(converted_landmarks);
+  EXPECT_TRUE(AreLandmarksEqual(sfm_data.structure, converted_landmarks));
+
+  EXPECT_EQ(RemoveOutliers_AngleError(sfm_data, 2.0),
+            RemoveOutliers_AngleError(sfm_data, landmarks, 2.0));
+  landmarks.ToLandmarks(converted_landmarks);
+  EXPECT_TRUE(AreLandmarksEqual(sfm_data.structure, converted_landmarks));
+  EXPECT_TRUE(landmarks.size() > 100);
+  EXPECT_EQ(landmarks.obs_offsets.back(), landmarks.NbObservations());
+}
+
 
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
@@ -10,6 +10,7 @@
 
 #include "openMVG/geometry/Similarity3.hpp"
 #include "openMVG/sfm/sfm_data.hpp"
+#include "openMVG/sfm/sfm_landmark_soa.hpp"
 
 namespace openMVG {
 namespace sfm {
@@ -53,5 +54,16 @@ void ApplySimilarity
   }
 }
 
+/// Apply a similarity to the landmark positions
+void ApplySimilarity
+(
+  const geometry::Similarity3 & sim,
+  Landmarks_SoA & landmarks
+)
+{
+  if (!landmarks.empty())
+    landmarks.X = sim(landmarks.X);
+}
+
 } // namespace sfm
 } // namespace openMVG
@@ -18,6 +18,7 @@ namespace geometry
 
 namespace sfm {
 
+struct Landmarks_SoA;
 struct SfM_Data;
 
 /// Apply a similarity to the SfM_Data scene (transform landmarks & camera poses)
@@ -28,6 +29,13 @@ void ApplySimilarity
   bool transform_priors = false
 );
 
+/// Apply a similarity to the landmark positions
+void ApplySimilarity
+(
+  const geometry::Similarity3 & sim,
+  Landmarks_SoA & landmarks
+);
+
 } // namespace sfm
 } // namespace openMVG
 
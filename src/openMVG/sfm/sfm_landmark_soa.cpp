@@ -0,0 +1,149 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/sfm/sfm_landmark_soa.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace openMVG {
+namespace sfm {
+
+void Landmarks_SoA::clear()
+{
+  ids.clear();
+  X.resize(3, 0);
+  obs_offsets.assign(1, 0);
+  obs_view_ids.clear();
+  obs_feat_ids.clear();
+  obs_x.resize(2, 0);
+}
+
+std::size_t Landmarks_SoA::Find(const IndexT id) const
+{
+  const auto it = std::lower_bound(ids.cbegin(), ids.cend(), id);
+  return (it != ids.cend() && *it == id) ? it - ids.cbegin() : size();
+}
+
+Landmark Landmarks_SoA::GetLandmark(const std::size_t i) const
+{
+  Landmark landmark;
+  landmark.X = X.col(i);
+  for (uint64_t obs = obs_offsets[i]; obs < obs_offsets[i + 1]; ++obs)
+  {
+    landmark.obs[obs_view_ids[obs]] = Observation(obs_x.col(obs), obs_feat_ids[obs]);
+  }
+  return landmark;
+}
+
+void Landmarks_SoA::FromLandmarks(const Landmarks & landmarks)
+{
+  // List the landmarks by increasing id
+  std::vector<std::pair<IndexT, const Landmark *>> sorted_landmarks;
+  sorted_landmarks.reserve(landmarks.size());
+  for (const auto & landmark_it : landmarks)
+    sorted_landmarks.emplace_back(landmark_it.first, &landmark_it.second);
+  std::sort(sorted_landmarks.begin(), sorted_landmarks.end());
+
+  ids.resize(sorted_landmarks.size());
+  X.resize(3, sorted_landmarks.size());
+  obs_offsets.resize(sorted_landmarks.size() + 1);
+  obs_offsets[0] = 0;
+  for (std::size_t i = 0; i < sorted_landmarks.size(); ++i)
+    obs_offsets[i + 1] = obs_offsets[i] + sorted_landmarks[i].second->obs.size();
+  obs_view_ids.resize(obs_offsets.back());
+  obs_feat_ids.resize(obs_offsets.back());
+  obs_x.resize(2, obs_offsets.back());
+
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (int64_t i = 0; i < static_cast<int64_t>(sorted_landmarks.size()); ++i)
+  {
+    const Landmark & landmark = *sorted_landmarks[i].second;
+    ids[i] = sorted_landmarks[i].first;
+    X.col(i) = landmark.X;
+    // Sort the observations by view id
+    std::vector<std::pair<IndexT, const Observation *>> sorted_obs;
+    sorted_obs.reserve(landmark.obs.size());
+    for (const auto & obs_it : landmark.obs)
+      sorted_obs.emplace_back(obs_it.first, &obs_it.second);
+    std::sort(sorted_obs.begin(), sorted_obs.end());
+    uint64_t obs = obs_offsets[i];
+    for (const auto & view_obs : sorted_obs)
+    {
+      obs_view_ids[obs] = view_obs.first;
+      obs_feat_ids[obs] = view_obs.second->id_feat;
+      obs_x.col(obs) = view_obs.second->x;
+      ++obs;
+    }
+  }
+}
+
+void Landmarks_SoA::ToLandmarks(Landmarks & landmarks) const
+{
+  landmarks.clear();
+  for (std::size_t i = 0; i < size(); ++i)
+  {
+    landmarks.emplace_hint(landmarks.end(), ids[i], GetLandmark(i));
+  }
+}
+
+std::size_t Landmarks_SoA::MemoryFootprint() const
+{
+  return ids.capacity() * sizeof(IndexT)
+    + X.size() * sizeof(double)
+    + obs_offsets.capacity() * sizeof(uint64_t)
+    + obs_view_ids.capacity() * sizeof(IndexT)
+    + obs_feat_ids.capacity() * sizeof(IndexT)
+    + obs_x.size() * sizeof(double);
+}
+
+std::size_t Landmarks_SoA::Compact
+(
+  const std::vector<unsigned char> & removed_observations,
+  const std::size_t min_track_length
+)
+{
+  std::size_t landmark_count = 0;
+  uint64_t obs_count = 0;
+  uint64_t begin = obs_offsets[0];
+  for (std::size_t i = 0; i < size(); ++i)
+  {
+    const uint64_t end = obs_offsets[i + 1];
+    const auto kept_count = static_cast<std::size_t>(
+      std::count(removed_observations.cbegin() + begin, removed_observations.cbegin() + end, 0));
+    if (kept_count > 0 && kept_count >= min_track_length)
+    {
+      ids[landmark_count] = ids[i];
+      X.col(landmark_count) = X.col(i);
+      for (uint64_t obs = begin; obs < end; ++obs)
+      {
+        if (removed_observations[obs])
+          continue;
+        obs_view_ids[obs_count] = obs_view_ids[obs];
+        obs_feat_ids[obs_count] = obs_feat_ids[obs];
+        obs_x.col(obs_count) = obs_x.col(obs);
+        ++obs_count;
+      }
+      obs_offsets[++landmark_count] = obs_count;
+    }
+    begin = end;
+  }
+  const std::size_t removed_count = size() - landmark_count;
+  ids.resize(landmark_count);
+  X.conservativeResize(3, landmark_count);
+  obs_offsets.resize(landmark_count + 1);
+  obs_view_ids.resize(obs_count);
+  obs_feat_ids.resize(obs_count);
+  obs_x.conservativeResize(2, obs_count);
+  return removed_count;
+}
+
+} // namespace sfm
+} // namespace openMVG
@@ -0,0 +1,143 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_SFM_SFM_LANDMARK_SOA_HPP
+#define OPENMVG_SFM_SFM_LANDMARK_SOA_HPP
+
+#include "openMVG/numeric/eigen_alias_definition.hpp"
+#include "openMVG/sfm/sfm_landmark.hpp"
+#include "openMVG/types.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace openMVG {
+namespace sfm {
+
+/// Structure of arrays storage of a landmark collection.
+/// The 3D points are stored contiguously (one column per landmark) and the
+///  observations in flat arrays: the observations of the i-th landmark are
+///  [obs_offsets[i], obs_offsets[i+1]), sorted by view id.
+/// It avoids the per landmark containers of Landmarks (memory & locality)
+///  and can be converted from/to Landmarks.
+struct Landmarks_SoA
+{
+  std::vector<IndexT> ids;               // landmark ids (sorted)
+  Mat3X X;                               // 3D points (one column per landmark)
+  std::vector<uint64_t> obs_offsets {0}; // observation range of each landmark
+  std::vector<IndexT> obs_view_ids;      // view id of the observations
+  std::vector<IndexT> obs_feat_ids;      // feature id of the observations
+  Mat2X obs_x;                           // 2D observations (one column per observation)
+
+  std::size_t size() const { return ids.size(); }
+  bool empty() const { return ids.empty(); }
+  std::size_t NbObservations() const { return obs_view_ids.size(); }
+  std::size_t NbObservations(const std::size_t i) const { return obs_offsets[i + 1] - obs_offsets[i]; }
+
+  void clear();
+
+  /// Return the index of the landmark id (size() if not found)
+  std::size_t Find(const IndexT id) const;
+
+  /// Build the i-th landmark (with its observations)
+  Landmark GetLandmark(const std::size_t i) const;
+
+  void FromLandmarks(const Landmarks & landmarks);
+  void ToLandmarks(Landmarks & landmarks) const;
+
+  /// Heap memory used by the arrays (in bytes)
+  std::size_t MemoryFootprint() const;
+
+  /**
+  * @brief Remove the observations and the landmarks that verify a predicate.
+  * The predicates are evaluated in parallel (they must be thread safe).
+  * @param remove_observation Functor (landmark index, observation index) -> bool
+  * @param min_track_length Remove the landmarks that keep less observations (at least 1)
+  * @return The number of observations that verify the predicate
+  */
+  template <typename ObservationPredicate>
+  std::size_t EraseObservations
+  (
+    ObservationPredicate remove_observation,
+    const std::size_t min_track_length = 1
+  );
+
+  /**
+  * @brief Remove the landmarks (and their observations) that verify a predicate.
+  * The predicate is evaluated in parallel (it must be thread safe).
+  * @param remove_landmark Functor (landmark index) -> bool
+  * @return The number of removed landmarks
+  */
+  template <typename LandmarkPredicate>
+  std::size_t EraseLandmarks
+  (
+    LandmarkPredicate remove_landmark
+  );
+
+  // Serialization (same archive layout as Landmarks)
+  template <class Archive>
+  void save( Archive & ar) const;
+
+  template <class Archive>
+  void load( Archive & ar);
+
+private:
+  /// Compact the arrays (remove the flagged observations and the landmarks
+  ///  with less than min_track_length observations left)
+  /// Return the number of removed landmarks
+  std::size_t Compact
+  (
+    const std::vector<unsigned char> & removed_observations,
+    const std::size_t min_track_length
+  );
+};
+
+template <typename ObservationPredicate>
+std::size_t Landmarks_SoA::EraseObservations
+(
+  ObservationPredicate remove_observation,
+  const std::size_t min_track_length
+)
+{
+  std::vector<unsigned char> removed_observations(NbObservations(), 0);
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (int64_t i = 0; i < static_cast<int64_t>(size()); ++i)
+  {
+    for (uint64_t obs = obs_offsets[i]; obs < obs_offsets[i + 1]; ++obs)
+      removed_observations[obs] = remove_observation(static_cast<std::size_t>(i), obs);
+  }
+  Compact(removed_observations, min_track_length);
+  return std::count(removed_observations.cbegin(), removed_observations.cend(), 1);
+}
+
+template <typename LandmarkPredicate>
+std::size_t Landmarks_SoA::EraseLandmarks
+(
+  LandmarkPredicate remove_landmark
+)
+{
+  std::vector<unsigned char> removed_observations(NbObservations(), 0);
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (int64_t i = 0; i < static_cast<int64_t>(size()); ++i)
+  {
+    if (remove_landmark(static_cast<std::size_t>(i)))
+      std::fill(removed_observations.begin() + obs_offsets[i],
+                removed_observations.begin() + obs_offsets[i + 1], 1);
+  }
+  return Compact(removed_observations, 1);
+}
+
+} // namespace sfm
+} // namespace openMVG
+
+#endif // OPENMVG_SFM_SFM_LANDMARK_SOA_HPP
@@ -0,0 +1,78 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_SFM_SFM_LANDMARK_SOA_IO_HPP
+#define OPENMVG_SFM_SFM_LANDMARK_SOA_IO_HPP
+
+#include "openMVG/sfm/sfm_landmark_soa.hpp"
+#include "openMVG/sfm/sfm_landmark_io.hpp"
+
+#include <cereal/cereal.hpp> // Serialization
+
+#include <algorithm>
+#include <utility>
+
+// The landmarks are serialized as a Landmarks map (id -> Landmark), so a
+//  Landmarks_SoA archive can be read as Landmarks (and vice versa)
+
+template <class Archive>
+void openMVG::sfm::Landmarks_SoA::save( Archive & ar) const
+{
+  ar(cereal::make_size_tag(static_cast<cereal::size_type>(size())));
+  for (std::size_t i = 0; i < size(); ++i)
+  {
+    const Landmark landmark = GetLandmark(i);
+    ar(cereal::make_map_item(ids[i], landmark));
+  }
+}
+
+template <class Archive>
+void openMVG::sfm::Landmarks_SoA::load( Archive & ar)
+{
+  cereal::size_type landmark_count;
+  ar(cereal::make_size_tag(landmark_count));
+  // Collect the landmarks by chunks, to bound the temporary memory
+  Landmarks landmarks;
+  Landmarks_SoA chunk;
+  Landmarks_SoA loaded;
+  const auto append = [&]()
+  {
+    chunk.FromLandmarks(landmarks);
+    landmarks.clear();
+    loaded.ids.insert(loaded.ids.end(), chunk.ids.cbegin(), chunk.ids.cend());
+    loaded.X.conservativeResize(3, loaded.X.cols() + chunk.X.cols());
+    loaded.X.rightCols(chunk.X.cols()) = chunk.X;
+    const uint64_t obs_count = loaded.NbObservations();
+    for (std::size_t i = 1; i < chunk.obs_offsets.size(); ++i)
+      loaded.obs_offsets.push_back(obs_count + chunk.obs_offsets[i]);
+    loaded.obs_view_ids.insert(loaded.obs_view_ids.end(), chunk.obs_view_ids.cbegin(), chunk.obs_view_ids.cend());
+    loaded.obs_feat_ids.insert(loaded.obs_feat_ids.end(), chunk.obs_feat_ids.cbegin(), chunk.obs_feat_ids.cend());
+    loaded.obs_x.conservativeResize(2, loaded.obs_x.cols() + chunk.obs_x.cols());
+    loaded.obs_x.rightCols(chunk.obs_x.cols()) = chunk.obs_x;
+  };
+  for (cereal::size_type i = 0; i < landmark_count; ++i)
+  {
+    IndexT id;
+    Landmark landmark;
+    ar(cereal::make_map_item(id, landmark));
+    landmarks.emplace(id, std::move(landmark));
+    if (landmarks.size() == 65536)
+      append();
+  }
+  append();
+
+  // The archived map can be unordered
+  if (!std::is_sorted(loaded.ids.cbegin(), loaded.ids.cend()))
+  {
+    loaded.ToLandmarks(landmarks);
+    loaded.FromLandmarks(landmarks);
+  }
+  *this = std::move(loaded);
+}
+
+#endif // OPENMVG_SFM_SFM_LANDMARK_SOA_IO_HPP
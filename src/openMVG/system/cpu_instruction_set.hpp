@@ -11,6 +11,7 @@
 
 #include <array>
 #include <bitset>
+#include <cstdint>
 
 #if defined _MSC_VER
   #include <intrin.h>
@@ -18,6 +19,16 @@
   #include <cpuid.h>
 #endif
 
+// Allow to compile a function for a given instruction set (i.e "avx2", "popcnt")
+//  without enabling it for the whole translation unit.
+// Such function must be called only if the CPU supports the instruction set
+//  (see CpuInstructionSet).
+#if defined __GNUC__
+  #define OPENMVG_TARGET(instruction_set) __attribute__((target(instruction_set)))
+#else
+  #define OPENMVG_TARGET(instruction_set)
+#endif
+
 namespace openMVG
 {
 /**
@@ -38,6 +49,10 @@ class CpuInstructionSet
   bool m_AVX = false;
   bool m_AVX2 = false;
   bool m_POPCNT = false;
+  bool m_AVX512F = false;
+  bool m_AVX512BW = false;
+  bool m_AVX512VPOPCNTDQ = false;
+  bool m_AVX512VNNI = false;
 
   public:
 
@@ -65,11 +80,19 @@ class CpuInstructionSet
       m_SSE42 = Ecx[20];
       m_POPCNT = Ecx[23];
 
+      // AVX-512 registers must be saved by the OS
+      const bool os_avx512 = Ecx[27] && ((internal_xgetbv() & 0xE6) == 0xE6);
+
       if (nIds > 6)
       {
         internal_cpuid(cpui.data(), 7);
         const std::bitset<32> Ebx (cpui[1]);
+        const std::bitset<32> Ecx7 (cpui[2]);
         m_AVX2 = Ebx[5];
+        m_AVX512F = os_avx512 && Ebx[16];
+        m_AVX512BW = m_AVX512F && Ebx[30];
+        m_AVX512VNNI = m_AVX512F && Ecx7[11];
+        m_AVX512VPOPCNTDQ = m_AVX512F && Ecx7[14];
       }
     }
   }
@@ -114,6 +137,26 @@ class CpuInstructionSet
     return m_POPCNT;
   }
 
+  bool supportAVX512F() const
+  {
+    return m_AVX512F;
+  }
+
+  bool supportAVX512BW() const
+  {
+    return m_AVX512BW;
+  }
+
+  bool supportAVX512VPOPCNTDQ() const
+  {
+    return m_AVX512VPOPCNTDQ;
+  }
+
+  bool supportAVX512VNNI() const
+  {
+    return m_AVX512VNNI;
+  }
+
 private:
   static bool internal_cpuid(int32_t out[4], int32_t x)
   {
@@ -127,6 +170,20 @@ private:
     #endif
     return false;
   }
+
+  // Return the OS enabled register states (XCR0)
+  static uint64_t internal_xgetbv()
+  {
+    #if defined __GNUC__
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+    #endif
+    #if defined _MSC_VER
+    return _xgetbv(0);
+    #endif
+    return 0;
+  }
 };
 
 } // namespace system
@@ -0,0 +1,103 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/system/memory_mapped_file.hpp"
+
+#if defined _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace openMVG {
+namespace system {
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  close();
+}
+
+bool MemoryMappedFile::open(const std::string & filename)
+{
+  close();
+#if defined _WIN32
+  file_handle_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+    nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file_handle_ == INVALID_HANDLE_VALUE)
+  {
+    file_handle_ = nullptr;
+    return false;
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle_, &file_size) || file_size.QuadPart == 0)
+  {
+    close();
+    return false;
+  }
+  mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping_handle_)
+  {
+    close();
+    return false;
+  }
+  data_ = static_cast<const unsigned char *>(
+    MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+  if (!data_)
+  {
+    close();
+    return false;
+  }
+  size_ = static_cast<std::size_t>(file_size.QuadPart);
+#else
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+  {
+    ::close(fd);
+    return false;
+  }
+  void * ptr = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file
+  ::close(fd);
+  if (ptr == MAP_FAILED)
+    return false;
+  data_ = static_cast<const unsigned char *>(ptr);
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+#endif
+  return true;
+}
+
+void MemoryMappedFile::close()
+{
+#if defined _WIN32
+  if (data_)
+    UnmapViewOfFile(data_);
+  if (mapping_handle_)
+    CloseHandle(mapping_handle_);
+  if (file_handle_)
+    CloseHandle(file_handle_);
+  mapping_handle_ = nullptr;
+  file_handle_ = nullptr;
+#else
+  if (data_)
+    munmap(const_cast<unsigned char *>(data_), size_);
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
+
+} // namespace system
+} // namespace openMVG
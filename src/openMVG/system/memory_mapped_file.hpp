@@ -0,0 +1,67 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPENMVG_SYSTEM_MEMORY_MAPPED_FILE_HPP
+#define OPENMVG_SYSTEM_MEMORY_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace openMVG
+{
+namespace system
+{
+
+/**
+* @brief Read-only view of a file mapped in the process address space.
+* The mapping is released when the object is destroyed.
+*/
+class MemoryMappedFile
+{
+  public:
+
+    MemoryMappedFile() = default;
+    ~MemoryMappedFile();
+
+    // Make this class non copyable (the mapping is an owned resource)
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile & operator=(const MemoryMappedFile &) = delete;
+
+    /**
+    * @brief Map the whole file in read-only mode.
+    * @param filename Path of the file to map
+    * @return true if the mapping succeeded
+    */
+    bool open(const std::string & filename);
+
+    /**
+    * @brief Release the mapping (if any).
+    */
+    void close();
+
+    bool is_open() const { return data_ != nullptr; }
+
+    /// Pointer to the first byte of the mapping (nullptr if not open)
+    const unsigned char * data() const { return data_; }
+
+    /// Size of the mapping in bytes
+    std::size_t size() const { return size_; }
+
+  private:
+    const unsigned char * data_ = nullptr;
+    std::size_t size_ = 0;
+#if defined _WIN32
+    void * file_handle_ = nullptr;
+    void * mapping_handle_ = nullptr;
+#endif
+};
+
+} // namespace system
+} // namespace openMVG
+
+#endif // OPENMVG_SYSTEM_MEMORY_MAPPED_FILE_HPP
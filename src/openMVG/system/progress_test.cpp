@@ -154,6 +154,23 @@ TEST(Progress, percent)
   EXPECT_EQ(100, progress.Percent());
 }
 
+TEST(Progress, throughput)
+{
+  ProgressInterface progress(10);
+  EXPECT_EQ(0, progress.work_count());
+
+  progress += 5;
+  progress.AddWork(500);
+  progress.AddWork(250);
+  EXPECT_EQ(750, progress.work_count());
+  EXPECT_TRUE(progress.ElapsedSeconds() >= 0.);
+  EXPECT_TRUE(progress.StepsPerSecond() >= 0.);
+  EXPECT_TRUE(progress.WorkPerSecond() >= progress.StepsPerSecond());
+
+  progress.Restart(10);
+  EXPECT_EQ(0, progress.work_count());
+}
+
 using openMVG::system::LoggerProgress;
 
 TEST(LogProgress, logging)
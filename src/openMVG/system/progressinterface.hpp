@@ -10,6 +10,7 @@
 #define OPENMVG_SYSTEM_PROGRESS_HPP
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <string>
 
@@ -52,6 +53,8 @@ class ProgressInterface {
   {
     count_ = 0;
     expected_count_ = expected_count;
+    work_count_ = 0;
+    start_time_ = std::chrono::steady_clock::now();
   }
 
   /** @brief Indicator if the current operation should be aborted.
@@ -79,6 +82,16 @@ class ProgressInterface {
     return operator+=(1);
   }
 
+  /**
+   * @brief Add some units of work (i.e compared descriptors) to the throughput counter.
+   * Steps measure the progress, work units measure the amount of work of the steps.
+   * @param[in] work the number of work units done
+   **/
+  void AddWork(const std::uint64_t work)
+  {
+    work_count_ += work;
+  }
+
   /** @brief A dummy progress reporter. Does nothing.
    **/
   static ProgressInterface& dummy()
@@ -112,11 +125,51 @@ class ProgressInterface {
    **/
   std::uint32_t expected_count() const { return expected_count_; }
 
+  /**
+   * @brief Get the number of work units done since the last Restart
+   * @return The value of work_count_
+   **/
+  std::uint64_t work_count() const { return work_count_; }
+
+  /**
+   * @brief Get the time elapsed since the last Restart
+   * @return The elapsed time in seconds
+   **/
+  double ElapsedSeconds() const
+  {
+    return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start_time_).count();
+  }
+
+  /**
+   * @brief Get the step throughput since the last Restart
+   * @return The number of completed steps per second
+   **/
+  double StepsPerSecond() const
+  {
+    const double elapsed = ElapsedSeconds();
+    return elapsed > 0. ? count_ / elapsed : 0.;
+  }
+
+  /**
+   * @brief Get the work throughput since the last Restart
+   * @return The number of work units per second
+   **/
+  double WorkPerSecond() const
+  {
+    const double elapsed = ElapsedSeconds();
+    return elapsed > 0. ? work_count_ / elapsed : 0.;
+  }
+
  protected:
   /// Number of expected number of steps
   std::uint32_t expected_count_;
   /// Tracking of the number of completed steps => count_ will evolve in [0, expected_count_]
   std::atomic<std::uint32_t> count_;
+  /// Amount of work done by the completed steps (throughput counter)
+  std::atomic<std::uint64_t> work_count_;
+  /// Time of the last Restart
+  std::chrono::steady_clock::time_point start_time_;
 };
 
 } // namespace system
@@ -28,6 +28,7 @@
 //  tracksBuilder.Build(map_Matches); // Build: Efficient fusion of correspondences
 //  tracksBuilder.Filter();           // Filter: Remove tracks that have conflict
 //  tracksBuilder.ExportToSTL(map_tracks); // Build tracks with STL compliant type
+//  // or tracksBuilder.ExportToCSR(csr_tracks); // Build tracks in flat arrays
 //
 
 #ifndef OPENMVG_TRACKS_TRACKS_HPP
@@ -41,14 +42,19 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <utility>
 #include <vector>
 
 #include "openMVG/matching/indMatch.hpp"
-#include "openMVG/tracks/flat_pair_map.hpp"
+#include "openMVG/system/logger.hpp"
 #include "openMVG/tracks/union_find.hpp"
 
+#ifdef OPENMVG_USE_OPENMP
+#include <omp.h>
+#endif
+
 namespace openMVG  {
 
 namespace tracks  {
@@ -59,170 +65,440 @@ using submapTrack = std::map<uint32_t, uint32_t>;
 // A track is a collection of {trackId, submapTrack}
 using STLMAPTracks = std::map<uint32_t, submapTrack>;
 
-struct TracksBuilder
+/// Tracks stored in compressed sparse rows (CSR):
+///  the observations of the k-th track are in [offsets[k], offsets[k+1])
+///  of the view_ids and feat_ids arrays, sorted by increasing view id.
+/// The tracks are sorted by increasing track id.
+struct CSRTracks
 {
-  using indexedFeaturePair = std::pair<uint32_t, uint32_t>;
+  std::vector<uint32_t> track_ids;
+  std::vector<uint64_t> offsets = {0};
+  std::vector<uint32_t> view_ids;
+  std::vector<uint32_t> feat_ids;
 
-  flat_pair_map<indexedFeaturePair, uint32_t> map_node_to_index;
-  UnionFind uf_tree;
+  /// Number of tracks
+  size_t size() const { return track_ids.size(); }
 
-  /// Build tracks for a given series of pairWise matches
-  void Build( const matching::PairWiseMatches &  map_pair_wise_matches)
+  /// Number of observations of all the tracks
+  size_t NbObservations() const { return view_ids.size(); }
+
+  /// Number of observations of the k-th track
+  uint32_t TrackLength(size_t k) const
   {
-    // 1. We need to know how much single set we will have.
-    //   i.e each set is made of a tuple : (imageIndex, featureIndex)
-    std::set<indexedFeaturePair> allFeatures;
-    // For each couple of images list the used features
-    for ( const auto & iter : map_pair_wise_matches )
-    {
-      const auto & I = iter.first.first;
-      const auto & J = iter.first.second;
-      const std::vector<matching::IndMatch> & vec_FilteredMatches = iter.second;
+    return static_cast<uint32_t>(offsets[k + 1] - offsets[k]);
+  }
 
-      // Retrieve all shared features and add them to a set
-      for ( const auto & cur_filtered_match : vec_FilteredMatches )
+  void clear()
+  {
+    track_ids.clear();
+    offsets.assign(1, 0);
+    view_ids.clear();
+    feat_ids.clear();
+  }
+
+  /// Convert tracks from the map representation
+  void FromSTL(const STLMAPTracks & map_tracks)
+  {
+    clear();
+    track_ids.reserve(map_tracks.size());
+    offsets.reserve(map_tracks.size() + 1);
+    for (const auto & track_it : map_tracks)
+    {
+      track_ids.push_back(track_it.first);
+      for (const auto & obs_it : track_it.second)
       {
-        allFeatures.emplace(I,cur_filtered_match.i_);
-        allFeatures.emplace(J,cur_filtered_match.j_);
+        view_ids.push_back(obs_it.first);
+        feat_ids.push_back(obs_it.second);
       }
+      offsets.push_back(view_ids.size());
     }
+  }
 
-    // 2. Build the 'flat' representation where a tuple (the node)
-    //  is attached to a unique index.
-    map_node_to_index.reserve(allFeatures.size());
-    uint32_t cpt = 0;
-    for (const auto & feat : allFeatures)
+  /// Convert tracks to the map representation
+  void ToSTL(STLMAPTracks & map_tracks) const
+  {
+    map_tracks.clear();
+    for (size_t k = 0; k < size(); ++k)
     {
-      map_node_to_index.emplace_back(feat, cpt);
-      ++cpt;
+      submapTrack & track = map_tracks.emplace_hint(map_tracks.end(), track_ids[k], submapTrack())->second;
+      for (uint64_t obs = offsets[k]; obs < offsets[k + 1]; ++obs)
+        track.emplace_hint(track.end(), view_ids[obs], feat_ids[obs]);
     }
-    // Sort the flat_pair_map
-    map_node_to_index.sort();
-    // Clean some memory
-    allFeatures.clear();
+  }
+};
 
-    // 3. Add the node and the pairwise correspondences in the UF tree.
-    uf_tree.InitSets(map_node_to_index.size());
+namespace internal {
+
+/// Stable LSD radix sort of the keys (and of their associated values).
+/// The 8 bit digits that are the same for all the keys are skipped.
+/// The histograms and the scattering are computed by all the threads of the
+///  team (each thread processes a contiguous chunk of the keys).
+inline void RadixSortByKey
+(
+  std::vector<uint64_t> & keys,
+  std::vector<uint64_t> & values
+)
+{
+  const size_t key_count = keys.size();
+  uint64_t key_or = 0, key_and = std::numeric_limits<uint64_t>::max();
+  for (const uint64_t key : keys)
+  {
+    key_or |= key;
+    key_and &= key;
+  }
+  const uint64_t varying_bits = key_or ^ key_and;
 
-    // 4. Union of the matched features corresponding UF tree sets
-    for ( const auto & iter : map_pair_wise_matches )
+  std::vector<uint64_t> keys_tmp(key_count);
+  std::vector<uint64_t> values_tmp(key_count);
+  std::vector<size_t> histograms;
+  for (int shift = 0; shift < 64; shift += 8)
+  {
+    if (((varying_bits >> shift) & 0xFF) == 0)
+      continue;
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel
+#endif
     {
-      const auto & I = iter.first.first;
-      const auto & J = iter.first.second;
-      const std::vector<matching::IndMatch> & vec_FilteredMatches = iter.second;
-      for (const matching::IndMatch & match : vec_FilteredMatches)
+#ifdef OPENMVG_USE_OPENMP
+      const int thread_count = omp_get_num_threads(), thread_id = omp_get_thread_num();
+#else
+      const int thread_count = 1, thread_id = 0;
+#endif
+#ifdef OPENMVG_USE_OPENMP
+      #pragma omp single
+#endif
+      histograms.assign(256 * thread_count, 0);
+
+      const size_t
+        chunk_size = (key_count + thread_count - 1) / thread_count,
+        begin = std::min(key_count, thread_id * chunk_size),
+        end = std::min(key_count, begin + chunk_size);
+      size_t * histogram = &histograms[256 * thread_id];
+      for (size_t i = begin; i < end; ++i)
+        ++histogram[(keys[i] >> shift) & 0xFF];
+#ifdef OPENMVG_USE_OPENMP
+      #pragma omp barrier
+      #pragma omp single
+#endif
       {
-        const indexedFeaturePair pairI(I, match.i_);
-        const indexedFeaturePair pairJ(J, match.j_);
-        // Link feature correspondences to the corresponding containing sets.
-        uf_tree.Union(map_node_to_index[pairI], map_node_to_index[pairJ]);
+        // Start position of each (digit, thread) bucket
+        size_t position = 0;
+        for (int digit = 0; digit < 256; ++digit)
+        {
+          for (int t = 0; t < thread_count; ++t)
+          {
+            const size_t count = histograms[256 * t + digit];
+            histograms[256 * t + digit] = position;
+            position += count;
+          }
+        }
+      }
+      for (size_t i = begin; i < end; ++i)
+      {
+        const size_t position = histogram[(keys[i] >> shift) & 0xFF]++;
+        keys_tmp[position] = keys[i];
+        values_tmp[position] = values[i];
       }
     }
+    keys.swap(keys_tmp);
+    values.swap(values_tmp);
   }
+}
 
-  /// Remove bad tracks (too short or track with ids collision)
-  bool Filter(uint32_t nLengthSupTo = 2)
+} // namespace internal
+
+/// Build tracks from pairwise matches:
+///  - the nodes (imageIndex, featureIndex) are sorted and deduplicated with
+///    a (parallel) radix sort of their packed 64 bit keys,
+///  - the matches are merged in a concurrent union-find (in parallel),
+///  - the tracks are grouped in a flat CSR array.
+/// The track id is the index of the smallest node (imageIndex, featureIndex)
+///  of the track, so the result does not depend on the number of threads.
+struct TracksBuilder
+{
+  /// Build tracks for a given series of pairWise matches
+  void Build( const matching::PairWiseMatches &  map_pair_wise_matches)
   {
-    // Build the Track observations & mark tracks that have id collision:
-    std::map<uint32_t, std::set<uint32_t>> tracks; // {track_id, {image_id, image_id, ...}}
-    std::set<uint32_t> problematic_track_id; // {track_id, ...}
-
-    // For each node retrieve its track id from the UF tree and add the node to the track
-    // - if an image id is observed multiple time, then mark the track as invalid
-    //   - a track cannot list many times the same image index
-    for (uint32_t k = 0; k < map_node_to_index.size(); ++k)
+    // 1. Collect the two nodes of each match (the value is the slot of the node,
+    //    there can be more than 2^32 slots)
+    std::vector<const std::pair<const Pair, matching::IndMatches> *> pairs;
+    std::vector<uint64_t> pair_offsets(1, 0);
+    for (const auto & iter : map_pair_wise_matches)
     {
-      const uint32_t & track_id = uf_tree.Find(k);
-      const auto & feat = map_node_to_index[k];
-
-      // Augment the track and mark if invalid (an image can only be listed once)
-      if (tracks[track_id].insert(feat.first.first).second == false)
+      pairs.push_back(&iter);
+      pair_offsets.push_back(pair_offsets.back() + 2 * iter.second.size());
+    }
+    std::vector<uint64_t> keys(pair_offsets.back());
+    std::vector<uint64_t> slots(keys.size());
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int p = 0; p < static_cast<int>(pairs.size()); ++p)
+    {
+      const uint64_t I = pairs[p]->first.first, J = pairs[p]->first.second;
+      uint64_t slot = pair_offsets[p];
+      for (const matching::IndMatch & match : pairs[p]->second)
       {
-        problematic_track_id.insert(track_id); // invalid
+        keys[slot] = (I << 32) | match.i_;
+        slots[slot] = slot;
+        ++slot;
+        keys[slot] = (J << 32) | match.j_;
+        slots[slot] = slot;
+        ++slot;
       }
     }
 
-    // Reject tracks that have too few observations
-    for (const auto & val : tracks)
+    // 2. Sort the nodes, keep the unique ones and the node index of each slot
+    internal::RadixSortByKey(keys, slots);
+    nodes_.clear();
+    std::vector<uint32_t> slot_nodes(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
     {
-      if (val.second.size() < nLengthSupTo)
-      {
-        problematic_track_id.insert(val.first);
-      }
+      if (i == 0 || keys[i] != keys[i - 1])
+        nodes_.push_back(keys[i]);
+      slot_nodes[slots[i]] = static_cast<uint32_t>(nodes_.size() - 1);
+    }
+    std::vector<uint64_t>().swap(keys);
+    std::vector<uint64_t>().swap(slots);
+
+    // The node indices are stored on 32 bits (max() marks the rejected nodes)
+    if (nodes_.size() >= std::numeric_limits<uint32_t>::max())
+    {
+      OPENMVG_LOG_ERROR << "TracksBuilder: too many matched features ("
+        << nodes_.size() << "), no track is built.";
+      nodes_.clear();
+      node_tracks_.clear();
+      return;
+    }
+
+    // 3. Union of the matched nodes
+    ConcurrentUnionFind uf_tree;
+    uf_tree.InitSets(nodes_.size());
+    const int64_t match_count = slot_nodes.size() / 2;
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int64_t m = 0; m < match_count; ++m)
+    {
+      uf_tree.Union(slot_nodes[2 * m], slot_nodes[2 * m + 1]);
     }
 
-    // Reset the marked invalid track ids in the UF Tree
-    for (uint32_t & root_index : uf_tree.m_cc_parent)
+    // 4. Track id of each node
+    node_tracks_.resize(nodes_.size());
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int64_t k = 0; k < static_cast<int64_t>(nodes_.size()); ++k)
+    {
+      node_tracks_[k] = uf_tree.Find(static_cast<uint32_t>(k));
+    }
+  }
+
+  /// Remove bad tracks (too short or track with ids collision)
+  bool Filter(uint32_t nLengthSupTo = 2)
+  {
+    CSRTracks tracks;
+    GroupNodes(tracks);
+
+    // Mark the nodes of the invalid tracks
+    // - a track cannot list many times the same image index (the track nodes
+    //   are sorted by image index, so duplicates are contiguous)
+    // - a track must have at least nLengthSupTo observations
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+#endif
+    for (int64_t k = 0; k < static_cast<int64_t>(tracks.size()); ++k)
     {
-      if (problematic_track_id.count(root_index) > 0)
+      bool valid = tracks.TrackLength(k) >= nLengthSupTo;
+      for (uint64_t obs = tracks.offsets[k] + 1; obs < tracks.offsets[k + 1] && valid; ++obs)
+        valid = tracks.view_ids[obs] != tracks.view_ids[obs - 1];
+      if (!valid)
       {
-        // reset selected root
-        uf_tree.m_cc_size[root_index] = 1;
-        root_index = std::numeric_limits<uint32_t>::max();
+        for (uint64_t obs = tracks.offsets[k]; obs < tracks.offsets[k + 1]; ++obs)
+          node_tracks_[tracks.feat_ids[obs]] = std::numeric_limits<uint32_t>::max();
       }
     }
     return false;
   }
 
-  /// Return the number of connected set in the UnionFind structure (tree forest)
+  /// Return the number of tracks (the rejected ones are not counted)
   size_t NbTracks() const
   {
-    std::set<uint32_t> parent_id(uf_tree.m_cc_parent.cbegin(), uf_tree.m_cc_parent.cend());
-    // Erase the "special marker" that depicted rejected tracks
-    parent_id.erase(std::numeric_limits<uint32_t>::max());
-    return parent_id.size();
+    size_t track_count = 0;
+    for (size_t k = 0; k < node_tracks_.size(); ++k)
+      track_count += (node_tracks_[k] == k);
+    return track_count;
   }
 
   /// Export tracks as a map (each entry is a sequence of imageId and featureIndex):
   ///  {TrackIndex => {(imageIndex, featureIndex), ... ,(imageIndex, featureIndex)}
-  void ExportToSTL(STLMAPTracks & map_tracks)
+  void ExportToSTL(STLMAPTracks & map_tracks) const
   {
-    map_tracks.clear();
-    for (uint32_t k = 0; k < map_node_to_index.size(); ++k)
+    CSRTracks tracks;
+    ExportToCSR(tracks);
+    tracks.ToSTL(map_tracks);
+  }
+
+  /// Export tracks in the CSR representation
+  void ExportToCSR(CSRTracks & tracks) const
+  {
+    GroupNodes(tracks);
+    // Replace the node indexes by the feature indexes
+    //  and remove 1-length tracks (not a track)
+    size_t track_count = 0;
+    uint64_t obs_count = 0;
+    for (size_t k = 0; k < tracks.size(); ++k)
     {
-      const auto & feat = map_node_to_index[k];
-      const uint32_t & track_id = uf_tree.m_cc_parent[k];
-      if
-      (
-        // ensure never add rejected elements (track marked as invalid)
-        track_id != std::numeric_limits<uint32_t>::max()
-        // ensure never add 1-length track element (it's not a track)
-        && uf_tree.m_cc_size[track_id] > 1
-      )
+      const uint64_t begin = tracks.offsets[k], end = tracks.offsets[k + 1];
+      if (end - begin < 2)
+        continue;
+      tracks.track_ids[track_count] = tracks.track_ids[k];
+      for (uint64_t obs = begin; obs < end; ++obs, ++obs_count)
       {
-        map_tracks[track_id].insert(feat.first);
+        tracks.view_ids[obs_count] = tracks.view_ids[obs];
+        tracks.feat_ids[obs_count] = static_cast<uint32_t>(nodes_[tracks.feat_ids[obs]]);
       }
+      ++track_count;
+      tracks.offsets[track_count] = obs_count;
     }
+    tracks.track_ids.resize(track_count);
+    tracks.offsets.resize(track_count + 1);
+    tracks.view_ids.resize(obs_count);
+    tracks.feat_ids.resize(obs_count);
   }
+
+private:
+  /// Group the nodes of the valid tracks by track id (counting sort).
+  /// The feat_ids array stores the node indexes; since the nodes are sorted,
+  ///  the nodes of a track are sorted by image index.
+  void GroupNodes(CSRTracks & tracks) const
+  {
+    tracks.clear();
+    std::vector<uint32_t> track_index(node_tracks_.size(), std::numeric_limits<uint32_t>::max());
+    for (size_t k = 0; k < node_tracks_.size(); ++k)
+    {
+      if (node_tracks_[k] == k) // root node: track id
+      {
+        track_index[k] = static_cast<uint32_t>(tracks.track_ids.size());
+        tracks.track_ids.push_back(static_cast<uint32_t>(k));
+      }
+    }
+    tracks.offsets.assign(tracks.track_ids.size() + 1, 0);
+    for (const uint32_t track_id : node_tracks_)
+    {
+      if (track_id != std::numeric_limits<uint32_t>::max())
+        ++tracks.offsets[track_index[track_id] + 1];
+    }
+    std::partial_sum(tracks.offsets.begin(), tracks.offsets.end(), tracks.offsets.begin());
+    tracks.view_ids.resize(tracks.offsets.back());
+    tracks.feat_ids.resize(tracks.offsets.back());
+    std::vector<uint64_t> fill(tracks.offsets.begin(), tracks.offsets.end() - 1);
+    for (size_t k = 0; k < node_tracks_.size(); ++k)
+    {
+      const uint32_t track_id = node_tracks_[k];
+      if (track_id == std::numeric_limits<uint32_t>::max())
+        continue;
+      const uint64_t obs = fill[track_index[track_id]]++;
+      tracks.view_ids[obs] = static_cast<uint32_t>(nodes_[k] >> 32);
+      tracks.feat_ids[obs] = static_cast<uint32_t>(k);
+    }
+  }
+
+  std::vector<uint64_t> nodes_;       // sorted unique (imageIndex << 32 | featureIndex)
+  std::vector<uint32_t> node_tracks_; // track id of each node (max() if rejected)
 };
 
+namespace internal {
+
+/// Return the first position in [first, last) whose value is not less than value.
+/// Exponential (galloping) search from first: the cost depends on the distance
+///  to the found position, so a sorted list can be intersected with a much
+///  larger one in O(n log(N/n)).
+template <typename Iterator, typename T>
+Iterator GallopingLowerBound(Iterator first, Iterator last, const T & value)
+{
+  const auto count = last - first;
+  decltype(last - first) bound = 1;
+  while (bound < count && first[bound] < value)
+    bound *= 2;
+  return std::lower_bound(first + bound / 2, first + std::min(bound + 1, count), value);
+}
+
+} // namespace internal
+
 // This structure help to store the track visibility per view.
 // Computing the tracks in common between many view can then be done
 //  by computing the intersection of the track visibility for the asked view index.
-// Thank to an additional array in memory this solution is faster than TracksUtilsMap::GetTracksInImages.
+// The sorted track ids of each view (and the corresponding feature ids) are
+//  stored in flat arrays; the intersections use a galloping search.
+// Thank to this additional memory this solution is faster than TracksUtilsMap::GetTracksInImages.
 struct SharedTrackVisibilityHelper
 {
 private:
-  using TrackIdsPerView = std::map<uint32_t, std::set<uint32_t>>;
+  std::vector<uint32_t> view_ids_;     // sorted view ids
+  std::vector<uint64_t> view_offsets_; // the tracks of view_ids_[k] are in [view_offsets_[k], view_offsets_[k+1])
+  std::vector<uint32_t> track_ids_;    // track ids (sorted per view)
+  std::vector<uint32_t> feat_ids_;     // feature id of the view in the track
+
+  void Init(const CSRTracks & tracks)
+  {
+    view_ids_ = tracks.view_ids;
+    std::sort(view_ids_.begin(), view_ids_.end());
+    view_ids_.erase(std::unique(view_ids_.begin(), view_ids_.end()), view_ids_.end());
+
+    // Count the tracks per view and fill the view lists in track order
+    view_offsets_.assign(view_ids_.size() + 1, 0);
+    std::vector<uint32_t> view_index(tracks.NbObservations());
+    for (size_t obs = 0; obs < tracks.NbObservations(); ++obs)
+    {
+      view_index[obs] = static_cast<uint32_t>(
+        std::lower_bound(view_ids_.cbegin(), view_ids_.cend(), tracks.view_ids[obs]) - view_ids_.cbegin());
+      ++view_offsets_[view_index[obs] + 1];
+    }
+    std::partial_sum(view_offsets_.begin(), view_offsets_.end(), view_offsets_.begin());
+    track_ids_.resize(tracks.NbObservations());
+    feat_ids_.resize(tracks.NbObservations());
+    std::vector<uint64_t> fill(view_offsets_.cbegin(), view_offsets_.cend() - 1);
+    for (size_t k = 0; k < tracks.size(); ++k)
+    {
+      for (uint64_t obs = tracks.offsets[k]; obs < tracks.offsets[k + 1]; ++obs)
+      {
+        const uint64_t position = fill[view_index[obs]]++;
+        track_ids_[position] = tracks.track_ids[k];
+        feat_ids_[position] = tracks.feat_ids[obs];
+      }
+    }
+  }
 
-  TrackIdsPerView track_ids_per_view_;
-  const STLMAPTracks & tracks_;
+  /// Return the position of the view track list in [begin, end) (false if the view is unknown)
+  bool ViewRange(const uint32_t view_id, uint64_t & begin, uint64_t & end) const
+  {
+    const auto view_it = std::lower_bound(view_ids_.cbegin(), view_ids_.cend(), view_id);
+    if (view_it == view_ids_.cend() || *view_it != view_id)
+      return false;
+    begin = view_offsets_[view_it - view_ids_.cbegin()];
+    end = view_offsets_[view_it - view_ids_.cbegin() + 1];
+    return true;
+  }
 
 public:
 
   explicit SharedTrackVisibilityHelper
   (
     const STLMAPTracks & tracks
-  ): tracks_(tracks)
+  )
   {
-    for (const auto & tracks_it : tracks_)
-    {
-      // Add the track id visibility in the corresponding view track list
-      for (const auto & track_obs_it : tracks_it.second)
-      {
-        track_ids_per_view_[track_obs_it.first].insert(tracks_it.first);
-      }
-    }
+    CSRTracks csr_tracks;
+    csr_tracks.FromSTL(tracks);
+    Init(csr_tracks);
+  }
+
+  explicit SharedTrackVisibilityHelper
+  (
+    const CSRTracks & tracks
+  )
+  {
+    Init(tracks);
   }
 
   /**
@@ -235,64 +511,102 @@ public:
   (
     const std::set<uint32_t> & image_ids,
     STLMAPTracks & tracks
-  )
+  ) const
   {
     tracks.clear();
     if (image_ids.empty())
       return false;
 
-    // Collect the shared tracks ids by the views
-    std::set<uint32_t> common_track_ids;
+    // Track list range of the views (a view without track => no shared track)
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    for (const uint32_t image_id : image_ids)
     {
-      // Compute the intersection of all the track ids of the view's track ids.
-      // 1. Initialize the track_id with the view first tracks
-      // 2. Iteratively collect the common id of the remaining requested view
-      auto image_index_it = image_ids.cbegin();
-      if (track_ids_per_view_.count(*image_index_it))
+      uint64_t begin, end;
+      if (!ViewRange(image_id, begin, end))
+        return false;
+      ranges.emplace_back(begin, end);
+    }
+    // Drive the intersection by the shortest list
+    const size_t shortest = std::min_element(ranges.cbegin(), ranges.cend(),
+      [](const std::pair<uint64_t, uint64_t> & a, const std::pair<uint64_t, uint64_t> & b)
       {
-        common_track_ids = track_ids_per_view_[*image_index_it];
-      }
-      bool merged = false;
-      std::advance(image_index_it, 1);
-      while (image_index_it != image_ids.cend())
+        return a.second - a.first < b.second - b.first;
+      }) - ranges.cbegin();
+
+    std::vector<uint64_t> positions(ranges.size());
+    for (uint64_t pos = ranges[shortest].first; pos < ranges[shortest].second; ++pos)
+    {
+      const uint32_t track_id = track_ids_[pos];
+      bool shared = true;
+      for (size_t v = 0; v < ranges.size() && shared; ++v)
       {
-        if (track_ids_per_view_.count(*image_index_it))
+        if (v == shortest)
         {
-          const auto ids_per_view_it = track_ids_per_view_.find(*image_index_it);
-          const auto & track_ids = ids_per_view_it->second;
-
-          std::set<uint32_t> tmp;
-          std::set_intersection(
-            common_track_ids.cbegin(), common_track_ids.cend(),
-            track_ids.cbegin(), track_ids.cend(),
-            std::inserter(tmp, tmp.begin()));
-          common_track_ids.swap(tmp);
-          merged = true;
+          positions[v] = pos;
+          continue;
         }
-        std::advance(image_index_it, 1);
+        // Search from the last found position of this view
+        const auto track_it = internal::GallopingLowerBound(
+          track_ids_.cbegin() + ranges[v].first, track_ids_.cbegin() + ranges[v].second, track_id);
+        ranges[v].first = track_it - track_ids_.cbegin();
+        shared = ranges[v].first != ranges[v].second && *track_it == track_id;
+        positions[v] = ranges[v].first;
       }
-      if (image_ids.size() > 1 && !merged)
+      if (!shared)
+        continue;
+      // Collect the {img id, feat id} data for this shared track
+      submapTrack & track = tracks.emplace_hint(tracks.end(), track_id, submapTrack())->second;
+      size_t v = 0;
+      for (const uint32_t image_id : image_ids)
       {
-        // If more than one image id is required and no merge operation have been done
-        //  we need to reset the common track id
-        common_track_ids.clear();
+        track.emplace_hint(track.end(), image_id, feat_ids_[positions[v]]);
+        ++v;
       }
     }
+    return !tracks.empty();
+  }
 
-    // Collect the selected {img id, feat id} data for the shared track ids
-    for (const auto track_ids_it : common_track_ids)
+  /**
+   * @brief Count for many images the number of their tracks that belong to
+   *  a track id list (i.e. the reconstructed tracks). The images are
+   *  processed in parallel.
+   *
+   * @param[in] image_ids: images id to consider
+   * @param[in] sorted_track_ids: track ids to look for (sorted increasing)
+   * @param[out] counts: number of the sorted_track_ids tracks seen by each image
+   */
+  void CountTracksInImages
+  (
+    const std::vector<uint32_t> & image_ids,
+    const std::vector<uint32_t> & sorted_track_ids,
+    std::vector<uint32_t> & counts
+  ) const
+  {
+    counts.assign(image_ids.size(), 0);
+#ifdef OPENMVG_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < static_cast<int>(image_ids.size()); ++i)
     {
-      const auto track_it = tracks_.find(track_ids_it);
-      const auto & track = track_it->second;
-      // Find the corresponding output track and update it
-      submapTrack& trackFeatsOut = tracks[track_it->first];
-      for (const auto img_index: image_ids)
+      uint64_t begin, end;
+      if (!ViewRange(image_ids[i], begin, end))
+        continue;
+      // Look for the elements of the shortest list in the longest one
+      auto small_it = track_ids_.cbegin() + begin, small_end = track_ids_.cbegin() + end;
+      auto large_it = sorted_track_ids.cbegin(), large_end = sorted_track_ids.cend();
+      if (small_end - small_it > large_end - large_it)
       {
-        const auto track_view_info = track.find(img_index);
-        trackFeatsOut[img_index] = track_view_info->second;
+        std::swap(small_it, large_it);
+        std::swap(small_end, large_end);
       }
+      uint32_t count = 0;
+      for (; small_it != small_end && large_it != large_end; ++small_it)
+      {
+        large_it = internal::GallopingLowerBound(large_it, large_end, *small_it);
+        count += (large_it != large_end && *large_it == *small_it);
+      }
+      counts[i] = count;
     }
-    return !tracks.empty();
   }
 };
 
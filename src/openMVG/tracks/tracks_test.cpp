@@ -12,8 +12,13 @@
 #include "CppUnitLite/TestHarness.h"
 #include "testing/testing.h"
 
-#include <vector>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
 #include <utility>
+#include <vector>
 
 using namespace openMVG::tracks;
 using namespace openMVG::matching;
@@ -142,6 +147,110 @@ TEST(Tracks, Conflict) {
   CHECK(GT_Tracks == map_tracks);
 }
 
+TEST(Tracks, CSR_Export) {
+
+  //A    B    C
+  //0 -> 0 -> 0
+  //1 -> 1 -> 6
+  //2 -> 3
+  PairWiseMatches map_pairwisematches;
+  map_pairwisematches[ {0,1} ] = {IndMatch(0,0), IndMatch(1,1), IndMatch(2,3)};
+  map_pairwisematches[ {1,2} ] = {IndMatch(0,0), IndMatch(1,6)};
+
+  TracksBuilder trackBuilder;
+  trackBuilder.Build( map_pairwisematches );
+  trackBuilder.Filter();
+
+  CSRTracks csr_tracks;
+  trackBuilder.ExportToCSR(csr_tracks);
+  EXPECT_EQ(3, csr_tracks.size());
+  EXPECT_EQ(8, csr_tracks.NbObservations());
+  EXPECT_EQ(3, csr_tracks.TrackLength(0));
+  EXPECT_EQ(2, csr_tracks.TrackLength(2));
+
+  // Same tracks than the map export
+  STLMAPTracks map_tracks, map_tracks_from_csr;
+  trackBuilder.ExportToSTL(map_tracks);
+  csr_tracks.ToSTL(map_tracks_from_csr);
+  CHECK(map_tracks == map_tracks_from_csr);
+
+  // Map -> CSR -> Map
+  CSRTracks csr_tracks_from_map;
+  csr_tracks_from_map.FromSTL(map_tracks);
+  CHECK(csr_tracks.track_ids == csr_tracks_from_map.track_ids);
+  CHECK(csr_tracks.offsets == csr_tracks_from_map.offsets);
+  CHECK(csr_tracks.view_ids == csr_tracks_from_map.view_ids);
+  CHECK(csr_tracks.feat_ids == csr_tracks_from_map.feat_ids);
+}
+
+TEST(Tracks, Random) {
+
+  // Random matches between some views
+  const uint32_t kViewCount = 20, kFeatCount = 500;
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  std::uniform_int_distribution<uint32_t> feat_dist(0, kFeatCount - 1);
+  PairWiseMatches map_pairwisematches;
+  for (uint32_t I = 0; I < kViewCount; ++I)
+  {
+    for (uint32_t J = I + 1; J < kViewCount; J += 3)
+    {
+      IndMatches & matches = map_pairwisematches[{I, J}];
+      for (int k = 0; k < 40; ++k)
+        matches.emplace_back(feat_dist(random_generator), feat_dist(random_generator));
+    }
+  }
+
+  // Reference: connected components of the (view, feature) nodes
+  std::map<std::pair<uint32_t, uint32_t>, std::pair<uint32_t, uint32_t>> parent;
+  std::function<std::pair<uint32_t, uint32_t>(const std::pair<uint32_t, uint32_t> &)> find =
+    [&](const std::pair<uint32_t, uint32_t> & node)
+    {
+      const auto it = parent.find(node);
+      return (it == parent.end() || it->second == node) ? node : find(it->second);
+    };
+  for (const auto & pair_matches : map_pairwisematches)
+  {
+    for (const IndMatch & match : pair_matches.second)
+    {
+      const auto
+        root_i = find({pair_matches.first.first, match.i_}),
+        root_j = find({pair_matches.first.second, match.j_});
+      // The smallest node is the root
+      if (root_i < root_j)
+        parent[root_j] = root_i;
+      else if (root_j < root_i)
+        parent[root_i] = root_j;
+      parent.emplace(root_i, root_i);
+      parent.emplace(root_j, root_j);
+    }
+  }
+  std::map<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t>>> components;
+  for (const auto & node : parent)
+    components[find(node.first)].push_back(node.first);
+  std::set<std::vector<std::pair<uint32_t, uint32_t>>> expected_tracks;
+  for (const auto & component : components)
+  {
+    std::set<uint32_t> views;
+    for (const auto & node : component.second)
+      views.insert(node.first);
+    if (views.size() == component.second.size() && views.size() >= 3)
+      expected_tracks.insert(component.second);
+  }
+
+  EXPECT_FALSE(expected_tracks.empty());
+
+  TracksBuilder trackBuilder;
+  trackBuilder.Build( map_pairwisematches );
+  trackBuilder.Filter(3);
+  EXPECT_EQ(expected_tracks.size(), trackBuilder.NbTracks());
+
+  STLMAPTracks map_tracks;
+  trackBuilder.ExportToSTL(map_tracks);
+  std::set<std::vector<std::pair<uint32_t, uint32_t>>> tracks;
+  for (const auto & track : map_tracks)
+    tracks.emplace(track.second.cbegin(), track.second.cend());
+  EXPECT_TRUE(expected_tracks == tracks);
+}
 
 TEST(Tracks, TracksInImages) {
 
@@ -211,6 +320,59 @@ TEST(Tracks, TracksInImages) {
   }
 }
 
+TEST(Tracks, SharedTrackVisibilityHelper_Random) {
+
+  // Random tracks: each track is seen by a random subset of the views
+  const uint32_t kViewCount = 30, kTrackCount = 2000;
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  std::uniform_int_distribution<uint32_t> view_dist(0, kViewCount - 1), length_dist(2, 8);
+  STLMAPTracks tracks_in;
+  for (uint32_t track_id = 0; track_id < kTrackCount; ++track_id)
+  {
+    // Non contiguous track ids
+    submapTrack & track = tracks_in[3 * track_id + 1];
+    const uint32_t length = length_dist(random_generator);
+    while (track.size() < length)
+      track[view_dist(random_generator)] = track_id;
+  }
+
+  const SharedTrackVisibilityHelper shared_track_visibility_helper(tracks_in);
+  std::uniform_int_distribution<uint32_t> view_count_dist(1, 3);
+  for (int k = 0; k < 100; ++k)
+  {
+    std::set<uint32_t> image_ids;
+    const uint32_t view_count = view_count_dist(random_generator);
+    while (image_ids.size() < view_count)
+      image_ids.insert(view_dist(random_generator));
+
+    STLMAPTracks expected_tracks, tracks_out;
+    EXPECT_EQ(TracksUtilsMap::GetTracksInImages(image_ids, tracks_in, expected_tracks),
+              shared_track_visibility_helper.GetTracksInImages(image_ids, tracks_out));
+    EXPECT_TRUE(expected_tracks == tracks_out);
+  }
+
+  // Batched count of the tracks of some views that belong to a track subset
+  std::vector<uint32_t> track_ids;
+  for (const auto & track : tracks_in)
+    if (track.first % 2 == 0)
+      track_ids.push_back(track.first);
+  std::vector<uint32_t> image_ids(kViewCount + 1);
+  std::iota(image_ids.begin(), image_ids.end(), 0); // the last view is not in the tracks
+  std::vector<uint32_t> counts;
+  shared_track_visibility_helper.CountTracksInImages(image_ids, track_ids, counts);
+  EXPECT_EQ(image_ids.size(), counts.size());
+  for (size_t i = 0; i < image_ids.size(); ++i)
+  {
+    STLMAPTracks view_tracks;
+    TracksUtilsMap::GetTracksInImages({image_ids[i]}, tracks_in, view_tracks);
+    uint32_t expected_count = 0;
+    for (const auto & track : view_tracks)
+      expected_count += (track.first % 2 == 0);
+    EXPECT_EQ(expected_count, counts[i]);
+  }
+  EXPECT_EQ(0, counts.back());
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
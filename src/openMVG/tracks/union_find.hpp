@@ -9,7 +9,10 @@
 #ifndef OPENMVG_TRACKS_UNION_FIND_DISJOINT_SET_HPP
 #define OPENMVG_TRACKS_UNION_FIND_DISJOINT_SET_HPP
 
+#include <atomic>
+#include <memory>
 #include <numeric>
+#include <utility>
 #include <vector>
 
 namespace openMVG  {
@@ -103,6 +106,80 @@ struct UnionFind
   }
 };
 
+// Concurrent Union-Find/Disjoint-Set data structure
+//--
+// Lock free variant: Find and Union can be called from many threads at once.
+// - The sets are linked by index (the root of the set that has the larger
+//   index is attached to the other root), so the representative of a set is
+//   always its smallest index, whatever the order of the Union calls,
+// - Find uses path halving (the parents are updated with compare-and-swap).
+//--
+struct ConcurrentUnionFind
+{
+  // Init the UF structure with num_cc nodes
+  void InitSets
+  (
+    const unsigned int num_cc
+  )
+  {
+    m_num_nodes = num_cc;
+    m_cc_parent.reset(new std::atomic<unsigned int>[num_cc]);
+    for (unsigned int i = 0; i < num_cc; ++i)
+      m_cc_parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  // Return the number of nodes that have been initialized in the UF tree
+  unsigned int GetNumNodes() const
+  {
+    return m_num_nodes;
+  }
+
+  // Return the representative set id of I nth component
+  unsigned int Find
+  (
+    unsigned int i
+  )
+  {
+    while (true)
+    {
+      unsigned int parent = m_cc_parent[i].load();
+      if (parent == i)
+        return i;
+      const unsigned int grand_parent = m_cc_parent[parent].load();
+      // Path halving: link the node to its grand parent
+      if (grand_parent != parent)
+        m_cc_parent[i].compare_exchange_weak(parent, grand_parent);
+      i = grand_parent;
+    }
+  }
+
+  // Replace sets containing I and J with their union
+  void Union
+  (
+    unsigned int i,
+    unsigned int j
+  )
+  {
+    while (true)
+    {
+      i = Find(i);
+      j = Find(j);
+      if (i == j)
+        return;
+      if (i < j)
+        std::swap(i, j);
+      // Attach the root i to the root j (fails if i is no longer a root)
+      unsigned int expected = i;
+      if (m_cc_parent[i].compare_exchange_strong(expected, j))
+        return;
+    }
+  }
+
+private:
+  std::unique_ptr<std::atomic<unsigned int>[]> m_cc_parent;
+  unsigned int m_num_nodes = 0;
+};
+
 } // namespace openMVG
 
 #endif // OPENMVG_TRACKS_UNION_FIND_DISJOINT_SET_HPP
@@ -11,7 +11,11 @@
 #include "CppUnitLite/TestHarness.h"
 #include "testing/testing.h"
 
+#include <map>
+#include <random>
 #include <set>
+#include <utility>
+#include <vector>
 
 using namespace openMVG;
 
@@ -107,6 +111,44 @@ TEST(Tracks, four_cc) {
   EXPECT_EQ(4, parent_id.size());
 }
 
+TEST(Tracks, concurrent_union_find) {
+
+  // Random unions applied to both UF structures must give the same sets
+  const unsigned int kNumNodes = 10000;
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  std::uniform_int_distribution<unsigned int> node_dist(0, kNumNodes - 1);
+  std::vector<std::pair<unsigned int, unsigned int>> unions(6000);
+  for (auto & node_pair : unions)
+    node_pair = {node_dist(random_generator), node_dist(random_generator)};
+
+  UnionFind uf_tree;
+  uf_tree.InitSets(kNumNodes);
+  ConcurrentUnionFind concurrent_uf_tree;
+  concurrent_uf_tree.InitSets(kNumNodes);
+  EXPECT_EQ(kNumNodes, concurrent_uf_tree.GetNumNodes());
+
+  for (const auto & node_pair : unions)
+    uf_tree.Union(node_pair.first, node_pair.second);
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for
+#endif
+  for (int i = 0; i < static_cast<int>(unions.size()); ++i)
+    concurrent_uf_tree.Union(unions[i].first, unions[i].second);
+
+  // The representative of a set is its smallest index
+  std::map<unsigned int, unsigned int> min_index_per_set;
+  for (unsigned int i = 0; i < kNumNodes; ++i)
+  {
+    const unsigned int root = uf_tree.Find(i);
+    if (min_index_per_set.count(root) == 0)
+      min_index_per_set[root] = i;
+  }
+  for (unsigned int i = 0; i < kNumNodes; ++i)
+  {
+    EXPECT_EQ(min_index_per_set.at(uf_tree.Find(i)), concurrent_uf_tree.Find(i));
+  }
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -51,6 +51,11 @@ int main( int argc, char** argv )
   std::string  sNearestMatchingMethod = "AUTO";
   bool         bForce                 = false;
   unsigned int ui_max_cache_size      = 0;
+  unsigned int ui_max_cache_memory    = 0;
+
+  // HNSW matchers parameters
+  HNSWParams hnsw_params;
+  unsigned int ui_hnsw_index_cache_size = 32;
 
   // Pre-emptive matching parameters
   unsigned int ui_preemptive_feature_count = 200;
@@ -65,6 +70,13 @@ int main( int argc, char** argv )
   cmd.add( make_option( 'n', sNearestMatchingMethod, "nearest_matching_method" ) );
   cmd.add( make_option( 'f', bForce, "force" ) );
   cmd.add( make_option( 'c', ui_max_cache_size, "cache_size" ) );
+  cmd.add( make_option( 'm', ui_max_cache_memory, "cache_memory" ) );
+  cmd.add( make_switch( 'H', "cache_hashes" ) );
+  cmd.add( make_option( 'M', hnsw_params.M, "hnsw_m" ) );
+  cmd.add( make_option( 'E', hnsw_params.ef_construction, "hnsw_ef_construction" ) );
+  cmd.add( make_option( 'e', hnsw_params.ef_search, "hnsw_ef_search" ) );
+  cmd.add( make_option( 'g', ui_hnsw_index_cache_size, "hnsw_index_cache" ) );
+  cmd.add( make_switch( 'G', "save_hnsw_index" ) );
   // Pre-emptive matching
   cmd.add( make_option( 'P', ui_preemptive_feature_count, "preemptive_feature_count") );
 
@@ -90,6 +102,8 @@ int main( int argc, char** argv )
       << "  AUTO: auto choice from regions type,\n"
       << "  For Scalar based regions descriptor:\n"
       << "    BRUTEFORCEL2: L2 BruteForce matching,\n"
+      << "    BRUTEFORCEL2GEMM: L2 BruteForce matching computed by blocked matrix products,\n"
+      << "    BRUTEFORCEL2GEMMMUTUAL: idem + keep only the mutual nearest neighbors,\n"
       << "    HNSWL2: L2 Approximate Matching with Hierarchical Navigable Small World graphs,\n"
       << "    HNSWL1: L1 Approximate Matching with Hierarchical Navigable Small World graphs\n"
       << "      tailored for quantized and histogram based descriptors (e.g uint8 RootSIFT)\n"
@@ -103,7 +117,20 @@ int main( int argc, char** argv )
       << "    HNSWHAMMING: Hamming Approximate Matching with Hierarchical Navigable Small World graphs\n"
       << "[-c|--cache_size]\n"
       << "  Use a regions cache (only cache_size regions will be stored in memory)\n"
-      << "  If not used, all regions will be load in memory."
+      << "  If not used, all regions will be load in memory.\n"
+      << "[-m|--cache_memory]\n"
+      << "  Use a regions cache bounded by a memory budget (in MB)\n"
+      << "  Can be combined with --cache_size.\n"
+      << "[-H|--cache_hashes]\n"
+      << "  FASTCASCADEHASHINGL2 only: save the hashed regions next to the regions files\n"
+      << "  and reuse them in the next runs (only new or modified regions are hashed).\n"
+      << "[-M|--hnsw_m] HNSW matchers: number of links per node (default 16)\n"
+      << "[-E|--hnsw_ef_construction] HNSW matchers: candidate list size at construction (default 100)\n"
+      << "[-e|--hnsw_ef_search] HNSW matchers: candidate list size at search (default 16)\n"
+      << "[-g|--hnsw_index_cache] HNSW matchers: number of view graphs kept in memory\n"
+      << "  to be reused by the next pairs of these views (default 32)\n"
+      << "[-G|--save_hnsw_index] HNSW matchers: save the graph of each view next to its\n"
+      << "  regions file and reuse it in the next runs (if the regions did not change)."
       << "\n[Pre-emptive matching:]\n"
       << "[-P|--preemptive_feature_count] <NUMBER> Number of feature used for pre-emptive matching";
 
@@ -123,6 +150,13 @@ int main( int argc, char** argv )
             << "--ratio " << fDistRatio << "\n"
             << "--nearest_matching_method " << sNearestMatchingMethod << "\n"
             << "--cache_size " << ((ui_max_cache_size == 0) ? "unlimited" : std::to_string(ui_max_cache_size)) << "\n"
+            << "--cache_memory " << ((ui_max_cache_memory == 0) ? "unlimited" : std::to_string(ui_max_cache_memory)) << "\n"
+            << "--cache_hashes " << cmd.used('H') << "\n"
+            << "--hnsw_m " << hnsw_params.M << "\n"
+            << "--hnsw_ef_construction " << hnsw_params.ef_construction << "\n"
+            << "--hnsw_ef_search " << hnsw_params.ef_search << "\n"
+            << "--hnsw_index_cache " << ui_hnsw_index_cache_size << "\n"
+            << "--save_hnsw_index " << cmd.used('G') << "\n"
             << "--preemptive_feature_used/count " << cmd.used('P') << " / " << ui_preemptive_feature_count;
   if (cmd.used('P'))
   {
@@ -172,7 +206,7 @@ int main( int argc, char** argv )
 
   // Load the corresponding view regions
   std::shared_ptr<Regions_Provider> regions_provider;
-  if (ui_max_cache_size == 0)
+  if (ui_max_cache_size == 0 && ui_max_cache_memory == 0)
   {
     // Default regions provider (load & store all regions in memory)
     regions_provider = std::make_shared<Regions_Provider>();
@@ -180,7 +214,8 @@ int main( int argc, char** argv )
   else
   {
     // Cached regions provider (load & store regions on demand)
-    regions_provider = std::make_shared<Regions_Provider_Cache>(ui_max_cache_size);
+    regions_provider = std::make_shared<Regions_Provider_Cache>(
+      ui_max_cache_size, static_cast<std::size_t>(ui_max_cache_memory) << 20);
   }
   // If we use pre-emptive matching, we load less regions:
   if (ui_preemptive_feature_count > 0 && cmd.used('P'))
@@ -236,13 +271,14 @@ int main( int argc, char** argv )
       if ( regions_type->IsScalar() )
       {
         OPENMVG_LOG_INFO << "Using FAST_CASCADE_HASHING_L2 matcher";
-        collectionMatcher.reset(new Cascade_Hashing_Matcher_Regions(fDistRatio));
+        collectionMatcher.reset(new Cascade_Hashing_Matcher_Regions(fDistRatio, cmd.used('H')));
       }
       else
       if (regions_type->IsBinary())
       {
         OPENMVG_LOG_INFO << "Using HNSWHAMMING matcher";
-        collectionMatcher.reset(new Matcher_Regions(fDistRatio, HNSW_HAMMING));
+        collectionMatcher.reset(new Matcher_Regions(fDistRatio, HNSW_HAMMING,
+          hnsw_params, ui_hnsw_index_cache_size, cmd.used('G')));
       }
     }
     else
@@ -252,6 +288,18 @@ int main( int argc, char** argv )
       collectionMatcher.reset(new Matcher_Regions(fDistRatio, BRUTE_FORCE_L2));
     }
     else
+    if (sNearestMatchingMethod == "BRUTEFORCEL2GEMM")
+    {
+      OPENMVG_LOG_INFO << "Using BRUTE_FORCE_L2_GEMM matcher";
+      collectionMatcher.reset(new Matcher_Regions(fDistRatio, BRUTE_FORCE_L2_GEMM));
+    }
+    else
+    if (sNearestMatchingMethod == "BRUTEFORCEL2GEMMMUTUAL")
+    {
+      OPENMVG_LOG_INFO << "Using BRUTE_FORCE_L2_GEMM_MUTUAL matcher";
+      collectionMatcher.reset(new Matcher_Regions(fDistRatio, BRUTE_FORCE_L2_GEMM_MUTUAL));
+    }
+    else
     if (sNearestMatchingMethod == "BRUTEFORCEHAMMING")
     {
       OPENMVG_LOG_INFO << "Using BRUTE_FORCE_HAMMING matcher";
@@ -261,18 +309,21 @@ int main( int argc, char** argv )
     if (sNearestMatchingMethod == "HNSWL2")
     {
       OPENMVG_LOG_INFO << "Using HNSWL2 matcher";
-      collectionMatcher.reset(new Matcher_Regions(fDistRatio, HNSW_L2));
+      collectionMatcher.reset(new Matcher_Regions(fDistRatio, HNSW_L2,
+        hnsw_params, ui_hnsw_index_cache_size, cmd.used('G')));
     }
     if (sNearestMatchingMethod == "HNSWL1")
     {
       OPENMVG_LOG_INFO << "Using HNSWL1 matcher";
-      collectionMatcher.reset(new Matcher_Regions(fDistRatio, HNSW_L1));
+      collectionMatcher.reset(new Matcher_Regions(fDistRatio, HNSW_L1,
+        hnsw_params, ui_hnsw_index_cache_size, cmd.used('G')));
     }
     else
     if (sNearestMatchingMethod == "HNSWHAMMING")
     {
       OPENMVG_LOG_INFO << "Using HNSWHAMMING matcher";
-      collectionMatcher.reset(new Matcher_Regions(fDistRatio, HNSW_HAMMING));
+      collectionMatcher.reset(new Matcher_Regions(fDistRatio, HNSW_HAMMING,
+        hnsw_params, ui_hnsw_index_cache_size, cmd.used('G')));
     }
     else
     if (sNearestMatchingMethod == "ANNL2")
@@ -290,7 +341,7 @@ int main( int argc, char** argv )
     if (sNearestMatchingMethod == "FASTCASCADEHASHINGL2")
     {
       OPENMVG_LOG_INFO << "Using FAST_CASCADE_HASHING_L2 matcher";
-      collectionMatcher.reset(new Cascade_Hashing_Matcher_Regions(fDistRatio));
+      collectionMatcher.reset(new Cascade_Hashing_Matcher_Regions(fDistRatio, cmd.used('H')));
     }
     if (!collectionMatcher)
     {
@@ -361,6 +412,22 @@ int main( int argc, char** argv )
       }
     }
     OPENMVG_LOG_INFO << "Task (Regions Matching) done in (s): " << timer.elapsed();
+
+    // Report how the regions cache behaved with the pair ordering
+    if (const auto regions_cache =
+          std::dynamic_pointer_cast<Regions_Provider_Cache>(regions_provider))
+    {
+      const std::size_t request_count =
+        regions_cache->hit_count() + regions_cache->miss_count();
+      OPENMVG_LOG_INFO
+        << "Regions cache statistics:\n"
+        << " #requests: " << request_count << "\n"
+        << " hit ratio: "
+        << (request_count ? regions_cache->hit_count() / double(request_count) : 0.0) << "\n"
+        << " #loads: " << regions_cache->miss_count() << "\n"
+        << " #reloads: " << regions_cache->reload_count() << "\n"
+        << " #evictions: " << regions_cache->eviction_count();
+    }
   }
 
   OPENMVG_LOG_INFO << "#Putative pairs: " << map_PutativeMatches.size();
@@ -69,6 +69,9 @@ int main(int argc, char **argv)
   double dMax_reprojection_error = 4.0;
   unsigned int ui_max_cache_size = 0;
   int triangulation_method = static_cast<int>(ETriangulationMethod::DEFAULT);
+  unsigned int ba_cluster_size = 0;
+  std::string sBA_temporary_directory;
+  unsigned int ba_max_loaded_clusters = 0;
 
   cmd.add( make_option('i', sSfM_Data_Filename, "input_file") );
   cmd.add( make_option('m', sMatchesDir, "match_dir") );
@@ -81,6 +84,9 @@ int main(int argc, char **argv)
   cmd.add( make_switch('d', "direct_triangulation"));
   cmd.add( make_option('t', triangulation_method, "triangulation_method"));
   cmd.add( make_option('T', sSfm_data_tracks, "sfm_data_tracks"));
+  cmd.add( make_option('C', ba_cluster_size, "ba_cluster_size"));
+  cmd.add( make_option('D', sBA_temporary_directory, "ba_temporary_dir"));
+  cmd.add( make_option('K', ba_max_loaded_clusters, "ba_loaded_clusters"));
 
   try {
     if (argc == 1) throw std::string("Invalid command line parameter.");
@@ -112,6 +118,12 @@ int main(int argc, char **argv)
     << "\t" << static_cast<int>(ETriangulationMethod::INVERSE_DEPTH_WEIGHTED_MIDPOINT) << ": INVERSE_DEPTH_WEIGHTED_MIDPOINT\n"
     << "\n[Optional]\n"
     << "[-b|--bundle_adjustment] (switch) perform a bundle adjustment on the scene (OFF by default)\n"
+    << "[-C|--ba_cluster_size] partitioned bundle adjustment: the poses are split in clusters of this size,\n"
+    << "  refined independently and reconciled by a consensus loop (0 by default: the scene is refined as one problem)\n"
+    << "[-D|--ba_temporary_dir] partitioned bundle adjustment: store the landmarks of the clusters in this\n"
+    << "  directory while they are not refined (the whole structure is still loaded before and after the adjustment)\n"
+    << "[-K|--ba_loaded_clusters] partitioned bundle adjustment with a temporary directory: maximal number of\n"
+    << "  clusters refined (loaded in memory) at once (0 by default: one per thread)\n"
     << "[-r|--residual_threshold] maximal pixels reprojection error that will be considered for triangulations (4.0 by default)\n"
     << "[-c|--cache_size]\n"
     << "  Use a regions cache (only cache_size regions will be stored in memory)\n"
@@ -391,16 +403,26 @@ int main(int argc, char **argv)
       options.linear_solver_type_ = ceres::DENSE_SCHUR;
     }
 
-    OPENMVG_LOG_INFO << "Bundle adjustment...";
-    Bundle_Adjustment_Ceres bundle_adjustment_obj(options);
-    bundle_adjustment_obj.Adjust
-      (
-        sfm_data,
-        Optimize_Options(
-          cameras::Intrinsic_Parameter_Type::ADJUST_ALL,
-          Extrinsic_Parameter_Type::ADJUST_ALL,
-          Structure_Parameter_Type::ADJUST_ALL)
-      );
+    const Optimize_Options ba_refine_options(
+      cameras::Intrinsic_Parameter_Type::ADJUST_ALL,
+      Extrinsic_Parameter_Type::ADJUST_ALL,
+      Structure_Parameter_Type::ADJUST_ALL);
+    std::unique_ptr<Bundle_Adjustment> bundle_adjustment_obj;
+    if (ba_cluster_size > 0)
+    {
+      OPENMVG_LOG_INFO << "Partitioned bundle adjustment...";
+      Bundle_Adjustment_Ceres_Partitioned::Partition_Options partition_options;
+      partition_options.max_cluster_size_ = ba_cluster_size;
+      partition_options.temporary_directory_ = sBA_temporary_directory;
+      partition_options.max_loaded_clusters_ = ba_max_loaded_clusters;
+      bundle_adjustment_obj.reset(new Bundle_Adjustment_Ceres_Partitioned(partition_options, options));
+    }
+    else
+    {
+      OPENMVG_LOG_INFO << "Bundle adjustment...";
+      bundle_adjustment_obj.reset(new Bundle_Adjustment_Ceres(options));
+    }
+    bundle_adjustment_obj->Adjust(sfm_data, ba_refine_options);
   }
 
   OPENMVG_LOG_INFO
@@ -31,7 +31,8 @@ int main(int argc, char ** argv)
       if (argc == 1) throw std::string("Invalid command line parameter.");
       cmd.process(argc, argv);
   } catch (const std::string& s) {
-      std::cerr << "Convert matches from bin to txt or txt to bin.\nUsage: " << argv[0] << "\n"
+      std::cerr << "Convert matches between the txt, bin and cbin (columnar binary) formats.\n"
+      << "The format is selected by the file extension.\nUsage: " << argv[0] << "\n"
       << "[-m|--sMatchFile filename]\n"
       << "[-o|--outmatchfile filename]\n"
       << std::endl;
@@ -0,0 +1,122 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/features/regions.hpp"
+#include "openMVG/sfm/sfm_data.hpp"
+#include "openMVG/sfm/sfm_data_io.hpp"
+#include "openMVG/system/logger.hpp"
+#include "openMVG/system/loggerprogress.hpp"
+
+#include "third_party/cmdLine/cmdLine.h"
+#include "third_party/stlplus3/filesystemSimplified/file_system.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+
+using namespace openMVG;
+using namespace openMVG::features;
+using namespace openMVG::sfm;
+
+/// Convert the .feat/.desc regions files of a feature directory
+///  to the single file binary regions format (.regions).
+int main(int argc, char ** argv)
+{
+  CmdLine cmd;
+
+  std::string sSfM_Data_Filename;
+  std::string sFeaturesDir;
+  std::string sOutDir = "";
+  bool bForce = false;
+
+  cmd.add( make_option('i', sSfM_Data_Filename, "input_file") );
+  cmd.add( make_option('d', sFeaturesDir, "featuresdir") );
+  cmd.add( make_option('o', sOutDir, "outdir") );
+  cmd.add( make_option('f', bForce, "force") );
+
+  try {
+      if (argc == 1) throw std::string("Invalid command line parameter.");
+      cmd.process(argc, argv);
+  } catch (const std::string& s) {
+      OPENMVG_LOG_INFO << "Convert .feat/.desc regions files to binary .regions files.\n"
+        << "Usage: " << argv[0] << "\n"
+        << "[-i|--input_file file] path to a SfM_Data scene\n"
+        << "[-d|--featuresdir path] directory containing the .feat/.desc files\n"
+        << "\n[Optional]\n"
+        << "[-o|--outdir path] output directory (default: the features directory)\n"
+        << "[-f|--force] overwrite existing .regions files\n";
+
+      OPENMVG_LOG_ERROR << s;
+      return EXIT_FAILURE;
+  }
+
+  if (sFeaturesDir.empty())  {
+    OPENMVG_LOG_ERROR << "\nIt is an invalid features directory";
+    return EXIT_FAILURE;
+  }
+  if (sOutDir.empty())
+    sOutDir = sFeaturesDir;
+
+  if (!stlplus::folder_exists(sOutDir))
+  {
+    if (!stlplus::folder_create(sOutDir))
+    {
+      OPENMVG_LOG_ERROR << "Cannot create output directory";
+      return EXIT_FAILURE;
+    }
+  }
+
+  SfM_Data sfm_data;
+  if (!Load(sfm_data, sSfM_Data_Filename, ESfM_Data(VIEWS))) {
+    OPENMVG_LOG_ERROR << "\n"
+      << "The input SfM_Data file \""<< sSfM_Data_Filename << "\" cannot be read.";
+    return EXIT_FAILURE;
+  }
+
+  // Init the regions_type from the image describer file (used for image regions extraction)
+  const std::string sImage_describer = stlplus::create_filespec(sFeaturesDir, "image_describer", "json");
+  std::unique_ptr<Regions> regions_type = Init_region_type_from_file(sImage_describer);
+  if (!regions_type)
+  {
+    OPENMVG_LOG_ERROR << "Invalid: " << sImage_describer << " regions type file.";
+    return EXIT_FAILURE;
+  }
+  if (sOutDir != sFeaturesDir)
+  {
+    stlplus::file_copy(sImage_describer,
+      stlplus::create_filespec(sOutDir, "image_describer", "json"));
+  }
+
+  system::LoggerProgress my_progress_bar(sfm_data.GetViews().size(), "- Regions conversion -");
+  std::atomic<bool> bOk(true);
+#ifdef OPENMVG_USE_OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < static_cast<int>(sfm_data.GetViews().size()); ++i)
+  {
+    auto iter = sfm_data.GetViews().cbegin();
+    std::advance(iter, i);
+    const std::string basename = stlplus::basename_part(iter->second->s_Img_path);
+    const std::string sRegions = stlplus::create_filespec(sOutDir, basename, ".regions");
+    if (bForce || !stlplus::file_exists(sRegions))
+    {
+      std::unique_ptr<Regions> regions(regions_type->EmptyClone());
+      if (!regions->Load(
+            stlplus::create_filespec(sFeaturesDir, basename, ".feat"),
+            stlplus::create_filespec(sFeaturesDir, basename, ".desc"))
+          || !regions->SaveBinary(sRegions))
+      {
+        OPENMVG_LOG_ERROR << "Cannot convert the regions of: " << basename;
+        bOk = false;
+      }
+    }
+    ++my_progress_bar;
+  }
+
+  return bOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
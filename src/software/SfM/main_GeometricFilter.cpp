@@ -56,6 +56,33 @@ enum EGeometricModel
   ESSENTIAL_MATRIX_UPRIGHT = 5
 };
 
+/// Keep only the pairs with a sufficient overlap (ratio of geometric inliers
+///  over the putative matches) and forward them to another container
+struct Overlap_Filtered_Matches : public PairWiseMatchesContainer
+{
+  Overlap_Filtered_Matches
+  (
+    const PairWiseMatches & putative_matches,
+    PairWiseMatchesContainer & geometric_matches
+  ):putative_matches_(putative_matches),
+    geometric_matches_(geometric_matches)
+  {}
+
+  void insert(std::pair<Pair, IndMatches> && pairWiseMatches) override
+  {
+    const size_t putativePhotometricCount = putative_matches_.at( pairWiseMatches.first ).size();
+    const size_t putativeGeometricCount   = pairWiseMatches.second.size();
+    const float  ratio                    = putativeGeometricCount / static_cast<float>( putativePhotometricCount );
+    if ( putativeGeometricCount >= 50 && ratio >= .3f )
+    {
+      geometric_matches_.insert( std::move( pairWiseMatches ) );
+    }
+  }
+
+  const PairWiseMatches & putative_matches_;
+  PairWiseMatchesContainer & geometric_matches_;
+};
+
 /// Compute corresponding features between a series of views:
 /// - Load view images description (regions: features & descriptors)
 /// - Compute putative local feature matches (descriptors matching)
@@ -81,6 +108,7 @@ int main( int argc, char** argv )
   bool         bGuided_matching  = false;
   int          imax_iteration    = 2048;
   unsigned int ui_max_cache_size = 0;
+  std::string  sRansacAcceleration = "";
 
   //required
   cmd.add( make_option( 'i', sSfM_Data_Filename, "input_file" ) );
@@ -94,6 +122,8 @@ int main( int argc, char** argv )
   cmd.add( make_option( 'r', bGuided_matching, "guided_matching" ) );
   cmd.add( make_option( 'I', imax_iteration, "max_iteration" ) );
   cmd.add( make_option( 'c', ui_max_cache_size, "cache_size" ) );
+  cmd.add( make_switch( 'S', "stream_output" ) );
+  cmd.add( make_option( 'A', sRansacAcceleration, "ransac_acceleration" ) );
 
   try
   {
@@ -121,7 +151,16 @@ int main( int argc, char** argv )
                      << "[-r|--guided_matching]  Use the found model to improve the pairwise correspondences.\n"
                      << "[-c|--cache_size]\n"
                      << "  Use a regions cache (only cache_size regions will be stored in memory)\n"
-                     << "  If not used, all regions will be load in memory.";
+                     << "  If not used, all regions will be load in memory.\n"
+                     << "[-S|--stream_output]\n"
+                     << "  Write the filtered matches to the output file as soon as they are computed\n"
+                     << "  (they are not kept in memory, the adjacency matrix is not exported).\n"
+                     << "[-A|--ransac_acceleration]\n"
+                     << "  Accelerations of the a contrario robust estimation (f, e, h, a models),\n"
+                     << "  any combination of:\n"
+                     << "   s: sequential probability ratio test (early rejection of the bad models),\n"
+                     << "   p: PROSAC (samples drawn first among the matches with the lowest descriptor distance),\n"
+                     << "   l: local optimization of the best models.";
 
     OPENMVG_LOG_INFO << s;
     return EXIT_FAILURE;
@@ -140,7 +179,31 @@ int main( int argc, char** argv )
                    << "--force              " << (bForce ? "true" : "false") << "\n"
                    << "--geometric_model    " << sGeometricModel << "\n"
                    << "--guided_matching    " << bGuided_matching << "\n"
-                   << "--cache_size         " << ((ui_max_cache_size == 0) ? "unlimited" : std::to_string(ui_max_cache_size));
+                   << "--cache_size         " << ((ui_max_cache_size == 0) ? "unlimited" : std::to_string(ui_max_cache_size)) << "\n"
+                   << "--stream_output      " << cmd.used( 'S' ) << "\n"
+                   << "--ransac_acceleration " << sRansacAcceleration;
+
+  // Configure the accelerations of the robust estimation
+  ACRANSAC_Options acransac_options;
+  bool b_prosac = false;
+  for ( const char acceleration : sRansacAcceleration )
+  {
+    switch ( acceleration )
+    {
+      case 's':
+        acransac_options.sprt = true;
+        break;
+      case 'p':
+        b_prosac = true;
+        break;
+      case 'l':
+        acransac_options.local_optimization_iterations = 10;
+        break;
+      default:
+        OPENMVG_LOG_ERROR << "Unknown ransac acceleration: " << acceleration;
+        return EXIT_FAILURE;
+    }
+  }
 
   if ( sFilteredMatchesFilename.empty() )
   {
@@ -284,68 +347,64 @@ int main( int argc, char** argv )
     system::Timer timer;
     const double  d_distance_ratio = 0.6;
 
+    // The filtered matches are kept in memory or written as they are computed
     PairWiseMatches map_GeometricMatches;
+    std::unique_ptr<PairWiseMatches_Writer> matches_writer;
+    if ( cmd.used( 'S' ) )
+    {
+      matches_writer.reset( new PairWiseMatches_Writer( sFilteredMatchesFilename ) );
+      if ( !matches_writer->good() )
+      {
+        OPENMVG_LOG_ERROR << "Cannot save filtered matches in: " << sFilteredMatchesFilename;
+        return EXIT_FAILURE;
+      }
+    }
+    PairWiseMatchesContainer & geometric_matches =
+      matches_writer ? static_cast<PairWiseMatchesContainer&>( *matches_writer ) : map_GeometricMatches;
+
     switch ( eGeometricModelToCompute )
     {
       case HOMOGRAPHY_MATRIX:
       {
         const bool bGeometric_only_guided_matching = true;
         filter_ptr->Robust_model_estimation(
-            GeometricFilter_HMatrix_AC( 4.0, imax_iteration ),
+            GeometricFilter_HMatrix_AC( 4.0, imax_iteration, acransac_options, b_prosac ),
             map_PutativeMatches,
+            geometric_matches,
             bGuided_matching,
             bGeometric_only_guided_matching ? -1.0 : d_distance_ratio,
             &progress );
-        map_GeometricMatches = filter_ptr->Get_geometric_matches();
       }
       break;
       case FUNDAMENTAL_MATRIX:
       {
         filter_ptr->Robust_model_estimation(
-            GeometricFilter_FMatrix_AC( 4.0, imax_iteration ),
+            GeometricFilter_FMatrix_AC( 4.0, imax_iteration, acransac_options, b_prosac ),
             map_PutativeMatches,
+            geometric_matches,
             bGuided_matching,
             d_distance_ratio,
             &progress );
-        map_GeometricMatches = filter_ptr->Get_geometric_matches();
       }
       break;
       case ESSENTIAL_MATRIX:
       {
+        //-- Perform an additional check to remove pairs with poor overlap
+        Overlap_Filtered_Matches overlap_filtered_matches( map_PutativeMatches, geometric_matches );
         filter_ptr->Robust_model_estimation(
-            GeometricFilter_EMatrix_AC( 4.0, imax_iteration ),
+            GeometricFilter_EMatrix_AC( 4.0, imax_iteration, acransac_options, b_prosac ),
             map_PutativeMatches,
+            overlap_filtered_matches,
             bGuided_matching,
             d_distance_ratio,
             &progress );
-        map_GeometricMatches = filter_ptr->Get_geometric_matches();
-
-        //-- Perform an additional check to remove pairs with poor overlap
-        std::vector<PairWiseMatches::key_type> vec_toRemove;
-        for ( const auto& pairwisematches_it : map_GeometricMatches )
-        {
-          const size_t putativePhotometricCount = map_PutativeMatches.find( pairwisematches_it.first )->second.size();
-          const size_t putativeGeometricCount   = pairwisematches_it.second.size();
-          const float  ratio                    = putativeGeometricCount / static_cast<float>( putativePhotometricCount );
-          if ( putativeGeometricCount < 50 || ratio < .3f )
-          {
-            // the pair will be removed
-            vec_toRemove.push_back( pairwisematches_it.first );
-          }
-        }
-        //-- remove discarded pairs
-        for ( const auto& pair_to_remove_it : vec_toRemove )
-        {
-          map_GeometricMatches.erase( pair_to_remove_it );
-        }
       }
       break;
       case ESSENTIAL_MATRIX_ANGULAR:
       {
         filter_ptr->Robust_model_estimation(
-          GeometricFilter_ESphericalMatrix_AC_Angular<false>(4.0, imax_iteration),
-          map_PutativeMatches, bGuided_matching, d_distance_ratio, &progress);
-        map_GeometricMatches = filter_ptr->Get_geometric_matches();
+          GeometricFilter_ESphericalMatrix_AC_Angular<false>(4.0, imax_iteration, acransac_options, b_prosac),
+          map_PutativeMatches, geometric_matches, bGuided_matching, d_distance_ratio, &progress);
       }
       break;
       case ESSENTIAL_MATRIX_ORTHO:
@@ -353,10 +412,10 @@ int main( int argc, char** argv )
         filter_ptr->Robust_model_estimation(
             GeometricFilter_EOMatrix_RA( 2.0, imax_iteration ),
             map_PutativeMatches,
+            geometric_matches,
             bGuided_matching,
             d_distance_ratio,
             &progress );
-        map_GeometricMatches = filter_ptr->Get_geometric_matches();
       }
       break;
     }
@@ -364,25 +423,30 @@ int main( int argc, char** argv )
     //---------------------------------------
     //-- Export geometric filtered matches
     //---------------------------------------
-    if ( !Save( map_GeometricMatches, sFilteredMatchesFilename ) )
+    if ( matches_writer ? !matches_writer->close()
+                        : !Save( map_GeometricMatches, sFilteredMatchesFilename ) )
     {
       OPENMVG_LOG_ERROR << "Cannot save filtered matches in: " << sFilteredMatchesFilename;
       return EXIT_FAILURE;
     }
 
+    const Pair_Set outputPairs =
+      matches_writer ? matches_writer->pairs() : getPairs( map_GeometricMatches );
+
     // -- export Geometric View Graph statistics
-    graph::getGraphStatistics(sfm_data.GetViews().size(), getPairs(map_GeometricMatches));
+    graph::getGraphStatistics(sfm_data.GetViews().size(), outputPairs);
 
     OPENMVG_LOG_INFO << "Task done in (s): " << timer.elapsed();
 
     //-- export Adjacency matrix
-    OPENMVG_LOG_INFO <<  "\n Export Adjacency Matrix of the pairwise's geometric matches";
-
-    PairWiseMatchingToAdjacencyMatrixSVG( sfm_data.GetViews().size(),
-                                          map_GeometricMatches,
-                                          stlplus::create_filespec( sMatchesDirectory, "GeometricAdjacencyMatrix", "svg" ) );
+    if ( !matches_writer )
+    {
+      OPENMVG_LOG_INFO <<  "\n Export Adjacency Matrix of the pairwise's geometric matches";
 
-    const Pair_Set outputPairs = getPairs( map_GeometricMatches );
+      PairWiseMatchingToAdjacencyMatrixSVG( sfm_data.GetViews().size(),
+                                            map_GeometricMatches,
+                                            stlplus::create_filespec( sMatchesDirectory, "GeometricAdjacencyMatrix", "svg" ) );
+    }
 
     //-- export view pair graph once geometric filter have been done
     {
@@ -158,6 +158,8 @@ int main(int argc, char **argv)
 
   // SfM v1
   std::pair<std::string,std::string> initial_pair_string("","");
+  unsigned int local_ba_nb_covisible_poses = 20;
+  unsigned int global_ba_period = 10;
 
   // SfM v2
   std::string sfm_initializer_method = "STELLAR";
@@ -188,6 +190,9 @@ int main(int argc, char **argv)
   // Incremental SfM1
   cmd.add( make_option('a', initial_pair_string.first, "initial_pair_a") );
   cmd.add( make_option('b', initial_pair_string.second, "initial_pair_b") );
+  cmd.add( make_switch('L', "local_ba") );
+  cmd.add( make_option('N', local_ba_nb_covisible_poses, "local_ba_covisible_poses") );
+  cmd.add( make_option('G', global_ba_period, "global_ba_period") );
   // Global SfM
   cmd.add( make_option('r', rotation_averaging_method, "rotationAveraging") );
   cmd.add( make_option('t', translation_averaging_method, "translationAveraging") );
@@ -234,6 +239,13 @@ int main(int argc, char **argv)
     << "[INCREMENTAL]\n"
     << "\t[-a|--initial_pair_a] filename of the first image (without path)\n"
     << "\t[-b|--initial_pair_b] filename of the second image (without path)\n"
+    << "\t[-L|--local_ba] Enable the local bundle adjustment: after a resection group refine only\n"
+      << "\t\t the new poses, their most covisible poses and the 3D points they see\n"
+      << "\t\t (the intrinsics are refined by the global bundle adjustments only) (default: false)\n"
+    << "\t[-N|--local_ba_covisible_poses] Number of covisible poses refined by the local bundle adjustment (default: "
+      << local_ba_nb_covisible_poses << ")\n"
+    << "\t[-G|--global_ba_period] Run a global bundle adjustment every N resection groups"
+      << " when the local bundle adjustment is used (default: " << global_ba_period << ", 0: disabled)\n"
     << "\t[-c|--camera_model] Camera model type for view with unknown intrinsic:\n"
       << "\t\t 1: Pinhole \n"
       << "\t\t 2: Pinhole radial 1\n"
@@ -463,6 +475,7 @@ int main(int argc, char **argv)
     engine->Set_Use_Motion_Prior(b_use_motion_priors);
     engine->SetTriangulationMethod(static_cast<ETriangulationMethod>(triangulation_method));
     engine->SetResectionMethod(static_cast<resection::SolverType>(resection_method));
+    engine->SetLocalBundleAdjustment(cmd.used('L'), local_ba_nb_covisible_poses, global_ba_period);
 
     // Handle Initial pair parameter
     if (!initial_pair_string.first.empty() && !initial_pair_string.second.empty())
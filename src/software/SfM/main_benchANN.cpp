@@ -25,8 +25,10 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 using namespace openMVG;
 using namespace matching;
@@ -140,6 +142,7 @@ int main(int argc, char **argv)
   // - accuracy is defined as the median percentage of similar index retrieved
   const std::vector<std::string> matcher_to_evaluate = {
     "brute_force_l2",
+    "brute_force_l2_gemm",
     "hnsw_l1",
     "hnsw_l2",
     "ann_l2",
@@ -166,6 +169,8 @@ int main(int argc, char **argv)
   {
     if (method == "brute_force_l2")
       collectionMatcher.reset(new Matcher_Regions(fDistRatio, BRUTE_FORCE_L2));
+    else if (method == "brute_force_l2_gemm")
+      collectionMatcher.reset(new Matcher_Regions(fDistRatio, BRUTE_FORCE_L2_GEMM));
     else if (method == "hnsw_l1")
       collectionMatcher.reset(new Matcher_Regions(fDistRatio, HNSW_L1));
     else if (method == "hnsw_l2")
@@ -229,5 +234,70 @@ int main(int argc, char **argv)
       OPENMVG_LOG_INFO << "accuracy(percent): " << collected_stats[method].accuracy;
   }
 
+  // HNSW graphs: construction (or loading) time versus query time
+  // (the graph of a view is built once and used by all the pairs of this view)
+  {
+    const EMatcherType hnsw_type = regions_type->IsBinary() ? HNSW_HAMMING : HNSW_L2;
+    const std::string index_filename =
+      stlplus::create_filespec(sFeatDirectory, "benchANN", "hnsw");
+    std::map<IndexT, std::vector<IndexT>> pairs_per_view;
+    for (const Pair & pair : pairs)
+      pairs_per_view[pair.first].push_back(pair.second);
+
+    double build_time = 0.0, load_time = 0.0, query_time = 0.0;
+    size_t graph_count = 0, query_count = 0;
+    for (const auto & view_pairs : pairs_per_view)
+    {
+      const std::shared_ptr<Regions> regionsI = regions_provider->get(view_pairs.first);
+      if (!regionsI || regionsI->RegionCount() == 0)
+        continue;
+
+      HNSWParams hnsw_params;
+      system::Timer timer;
+      const std::unique_ptr<RegionsMatcher> matcher =
+        RegionMatcherFactory(hnsw_type, *regionsI, hnsw_params);
+      build_time += timer.elapsed();
+      if (!matcher)
+        continue;
+      ++graph_count;
+
+      // Save the graph, then time its loading
+      hnsw_params.index_filename = index_filename;
+      stlplus::file_delete(index_filename);
+      RegionMatcherFactory(hnsw_type, *regionsI, hnsw_params);
+      timer.reset();
+      RegionMatcherFactory(hnsw_type, *regionsI, hnsw_params);
+      load_time += timer.elapsed();
+
+      for (const IndexT J : view_pairs.second)
+      {
+        const std::shared_ptr<Regions> regionsJ = regions_provider->get(J);
+        if (!regionsJ || regionsJ->RegionCount() == 0)
+          continue;
+        IndMatches matches;
+        timer.reset();
+        matcher->MatchDistanceRatio(fDistRatio, *regionsJ, matches);
+        query_time += timer.elapsed();
+        ++query_count;
+      }
+    }
+    stlplus::file_delete(index_filename);
+
+    if (graph_count > 0 && query_count > 0)
+    {
+      OPENMVG_LOG_INFO << "HNSW graphs (" << graph_count << " views, "
+        << query_count << " pairs):\n"
+        << "build time(seconds): " << build_time
+        << " (" << 1000. * build_time / graph_count << " ms per view)\n"
+        << "load time(seconds): " << load_time
+        << " (" << 1000. * load_time / graph_count << " ms per view)\n"
+        << "query time(seconds): " << query_time
+        << " (" << 1000. * query_time / query_count << " ms per pair)\n"
+        << "A graph build costs as much as "
+        << (build_time / graph_count) / (query_time / query_count)
+        << " pair queries.";
+    }
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,243 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "openMVG/cameras/cameras.hpp"
+#include "openMVG/sfm/sfm_data.hpp"
+#include "openMVG/sfm/sfm_data_BA_ceres.hpp"
+#include "openMVG/system/logger.hpp"
+#include "openMVG/system/timer.hpp"
+
+#include "third_party/cmdLine/cmdLine.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace openMVG;
+using namespace openMVG::cameras;
+using namespace openMVG::geometry;
+using namespace openMVG::sfm;
+
+/// Compute the Root Mean Square Error of the residuals
+static double RMSE(const SfM_Data & sfm_data)
+{
+  double squared_error = 0.0;
+  size_t observation_count = 0;
+  for (const auto & landmark_it : sfm_data.structure)
+  {
+    for (const auto & obs_it : landmark_it.second.obs)
+    {
+      const View * view = sfm_data.views.at(obs_it.first).get();
+      const Pose3 pose = sfm_data.GetPoseOrDie(view);
+      const IntrinsicBase * intrinsic = sfm_data.intrinsics.at(view->id_intrinsic).get();
+      squared_error += intrinsic->residual(pose(landmark_it.second.X), obs_it.second.x).squaredNorm();
+      ++observation_count;
+    }
+  }
+  return observation_count > 0 ? std::sqrt(squared_error / observation_count) : 0.0;
+}
+
+/// Synthetic scene: a ring of cameras looking outward at a cylindrical wall
+///  of points, each point being seen by a window of consecutive cameras.
+static SfM_Data SyntheticScene
+(
+  const int camera_count,
+  const int point_count,
+  const int camera_window,
+  const EINTRINSIC intrinsic_type,
+  std::mt19937 & random_generator
+)
+{
+  const double focal = 1000.0, size = 1000.0;
+  const double camera_radius = 10.0, wall_radius = 14.0;
+
+  SfM_Data sfm_data;
+  switch (intrinsic_type)
+  {
+    case PINHOLE_CAMERA:
+      sfm_data.intrinsics[0] = std::make_shared<Pinhole_Intrinsic>
+        (size, size, focal, size / 2, size / 2);
+    break;
+    case PINHOLE_CAMERA_RADIAL1:
+      sfm_data.intrinsics[0] = std::make_shared<Pinhole_Intrinsic_Radial_K1>
+        (size, size, focal, size / 2, size / 2, -0.05);
+    break;
+    case PINHOLE_CAMERA_RADIAL3:
+      sfm_data.intrinsics[0] = std::make_shared<Pinhole_Intrinsic_Radial_K3>
+        (size, size, focal, size / 2, size / 2, -0.05, 0.01, -0.001);
+    break;
+    case PINHOLE_CAMERA_BROWN:
+      sfm_data.intrinsics[0] = std::make_shared<Pinhole_Intrinsic_Brown_T2>
+        (size, size, focal, size / 2, size / 2, -0.05, 0.01, -0.001, 0.0005, -0.0005);
+    break;
+    case PINHOLE_CAMERA_FISHEYE:
+      sfm_data.intrinsics[0] = std::make_shared<Pinhole_Intrinsic_Fisheye>
+        (size, size, focal, size / 2, size / 2, -0.02, 0.005, -0.001, 0.0001);
+    break;
+    default:
+      return sfm_data;
+  }
+
+  // Cameras
+  const double angle_step = 2.0 * M_PI / camera_count;
+  for (int i = 0; i < camera_count; ++i)
+  {
+    const double angle = i * angle_step;
+    const Vec3 z_axis(std::cos(angle), std::sin(angle), 0.0);
+    const Vec3 y_axis(0.0, 0.0, -1.0);
+    Mat3 R;
+    R.row(0) = y_axis.cross(z_axis);
+    R.row(1) = y_axis;
+    R.row(2) = z_axis;
+    sfm_data.views[i] = std::make_shared<View>("", i, 0, i, size, size);
+    sfm_data.poses[i] = Pose3(R, camera_radius * z_axis);
+  }
+
+  // Points (observed by the cameras of the window centered on their angle)
+  std::uniform_real_distribution<double> distribution_angle(0.0, 2.0 * M_PI);
+  std::uniform_real_distribution<double> distribution_height(-3.0, 3.0);
+  std::normal_distribution<double> distribution_noise(0.0, 0.5);
+  const IntrinsicBase * intrinsic = sfm_data.intrinsics.at(0).get();
+  for (int j = 0; j < point_count; ++j)
+  {
+    const double angle = distribution_angle(random_generator);
+    Landmark landmark;
+    landmark.X << wall_radius * std::cos(angle), wall_radius * std::sin(angle),
+      distribution_height(random_generator);
+    const int center = static_cast<int>(std::lround(angle / angle_step));
+    for (int k = center - camera_window / 2; k <= center + camera_window / 2; ++k)
+    {
+      const IndexT view_id = (k + camera_count) % camera_count;
+      const Vec3 Xc = sfm_data.poses.at(view_id)(landmark.X);
+      if (Xc.z() <= 0.0)
+        continue;
+      const Vec2 x = intrinsic->project(Xc);
+      if (x.x() < 0.0 || x.y() < 0.0 || x.x() >= size || x.y() >= size)
+        continue;
+      landmark.obs[view_id] = Observation(
+        x + Vec2(distribution_noise(random_generator), distribution_noise(random_generator)), j);
+    }
+    if (landmark.obs.size() >= 2)
+      sfm_data.structure[j] = std::move(landmark);
+  }
+
+  // Perturb the poses and the points
+  std::normal_distribution<double> distribution_pose(0.0, 0.001);
+  for (auto & pose_it : sfm_data.poses)
+  {
+    const Mat3 dR = (Eigen::AngleAxisd(distribution_pose(random_generator), Vec3::UnitX())
+      * Eigen::AngleAxisd(distribution_pose(random_generator), Vec3::UnitY())).toRotationMatrix();
+    pose_it.second = Pose3(dR * pose_it.second.rotation(),
+      pose_it.second.center() + Vec3::Constant(distribution_pose(random_generator)));
+  }
+  std::normal_distribution<double> distribution_point(0.0, 0.01);
+  for (auto & landmark_it : sfm_data.structure)
+  {
+    landmark_it.second.X += Vec3(distribution_point(random_generator),
+      distribution_point(random_generator), distribution_point(random_generator));
+  }
+  return sfm_data;
+}
+
+int main(int argc, char **argv)
+{
+  CmdLine cmd;
+
+  int camera_count = 1000;
+  int point_count = 20000;
+  int camera_window = 8;
+  int intrinsic_type = PINHOLE_CAMERA_RADIAL3;
+  int max_iteration_count = 10;
+  int thread_count = 0;
+
+  // optional
+  cmd.add(make_option('c', camera_count, "camera_count"));
+  cmd.add(make_option('p', point_count, "point_count"));
+  cmd.add(make_option('w', camera_window, "camera_window"));
+  cmd.add(make_option('m', intrinsic_type, "camera_model"));
+  cmd.add(make_option('i', max_iteration_count, "max_iteration"));
+  cmd.add(make_option('n', thread_count, "numThreads"));
+
+  try
+  {
+    cmd.process(argc, argv);
+  }
+  catch (const std::string &s)
+  {
+    OPENMVG_LOG_ERROR << "Usage: " << argv[0] << '\n'
+              << "--- Optional ---\n"
+              << "[-c|--camera_count] number of cameras (default 1000)\n"
+              << "[-p|--point_count] number of 3D points (default 20000)\n"
+              << "[-w|--camera_window] number of cameras observing a point (default 8)\n"
+              << "[-m|--camera_model] camera model (default 3):\n"
+              << "\t 1: Pinhole\n"
+              << "\t 2: Pinhole radial 1\n"
+              << "\t 3: Pinhole radial 3\n"
+              << "\t 4: Pinhole brown 2\n"
+              << "\t 5: Pinhole with a simple Fish-eye distortion\n"
+              << "[-i|--max_iteration] maximum number of solver iterations (default 10)\n"
+              << "[-n|--numThreads] number of threads (default 0: all the cores)";
+    OPENMVG_LOG_ERROR << s;
+    return EXIT_FAILURE;
+  }
+
+  if (!isPinhole(EINTRINSIC(intrinsic_type)) || camera_count < 3 || camera_window < 2)
+  {
+    OPENMVG_LOG_ERROR << "Invalid parameters.";
+    return EXIT_FAILURE;
+  }
+
+  std::mt19937 random_generator(std::mt19937::default_seed);
+  const SfM_Data sfm_data = SyntheticScene(camera_count, point_count, camera_window,
+    EINTRINSIC(intrinsic_type), random_generator);
+
+  size_t observation_count = 0;
+  for (const auto & landmark_it : sfm_data.structure)
+    observation_count += landmark_it.second.obs.size();
+  OPENMVG_LOG_INFO << "Synthetic scene:\n"
+    << "#cameras: " << sfm_data.poses.size() << "\n"
+    << "#points: " << sfm_data.structure.size() << "\n"
+    << "#observations: " << observation_count << "\n"
+    << "Initial RMSE: " << RMSE(sfm_data);
+
+  const Optimize_Options ba_refine_options(
+    Intrinsic_Parameter_Type::ADJUST_ALL,
+    Extrinsic_Parameter_Type::ADJUST_ALL,
+    Structure_Parameter_Type::ADJUST_ALL);
+
+  // Refine the same scene with the automatic and the analytic derivatives
+  for (const bool b_analytic_jacobians : {false, true})
+  {
+    SfM_Data scene = sfm_data;
+    for (auto & intrinsic_it : scene.intrinsics)
+      intrinsic_it.second.reset(intrinsic_it.second->clone());
+
+    Bundle_Adjustment_Ceres::BA_Ceres_options ceres_options(false);
+    ceres_options.max_num_iterations_ = max_iteration_count;
+    ceres_options.bUse_analytic_jacobians_ = b_analytic_jacobians;
+    if (thread_count > 0)
+      ceres_options.nb_threads_ = thread_count;
+    Bundle_Adjustment_Ceres bundle_adjustment(ceres_options);
+
+    system::Timer timer;
+    const bool b_adjusted = bundle_adjustment.Adjust(scene, ba_refine_options);
+    const double time = timer.elapsedMs();
+
+    OPENMVG_LOG_INFO
+      << (b_analytic_jacobians ? "Analytic" : "Automatic") << " derivatives:\n"
+      << "success: " << b_adjusted << "\n"
+      << "time(ms): " << time << "\n"
+      << "Final RMSE: " << RMSE(scene);
+  }
+
+  return EXIT_SUCCESS;
+}
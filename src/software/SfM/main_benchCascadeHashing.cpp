@@ -0,0 +1,140 @@
+// This file is part of OpenMVG, an Open Multiple View Geometry C++ library.
+
+// Copyright (c) 2026 openMVG contributors.
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Micro benchmark of the cascade hashing candidate ranking:
+// - the reference implementation (per candidate Hamming distance + histogram),
+// - the batched implementation (SIMD Hamming kernels + counting sort).
+// Descriptors are synthetic SIFT like uint8 descriptors.
+
+#include "openMVG/matching/cascade_hasher.hpp"
+#include "openMVG/system/cpu_instruction_set.hpp"
+#include "openMVG/system/logger.hpp"
+#include "openMVG/system/timer.hpp"
+
+#include "third_party/cmdLine/cmdLine.h"
+
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace openMVG;
+using namespace openMVG::matching;
+
+using DescriptorMat = Eigen::Matrix<uint8_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+// Draw descriptors around some random centers (to get non uniform buckets)
+DescriptorMat RandomDescriptors
+(
+  const int count,
+  const DescriptorMat & centers,
+  std::mt19937 & gen
+)
+{
+  std::uniform_int_distribution<int> center_distribution(0, centers.rows() - 1);
+  std::normal_distribution<float> noise(0.f, 12.f);
+  DescriptorMat descriptors(count, centers.cols());
+  for (int i = 0; i < count; ++i)
+  {
+    const int center = center_distribution(gen);
+    for (int j = 0; j < centers.cols(); ++j)
+    {
+      const float value = centers(center, j) + noise(gen);
+      descriptors(i, j) = static_cast<uint8_t>(std::min(255.f, std::max(0.f, value)));
+    }
+  }
+  return descriptors;
+}
+
+int main(int argc, char **argv)
+{
+  CmdLine cmd;
+
+  int descriptor_count = 5000;
+  int repetition_count = 10;
+  int seed = 0;
+
+  cmd.add(make_option('n', descriptor_count, "descriptor_count"));
+  cmd.add(make_option('r', repetition_count, "repetition_count"));
+  cmd.add(make_option('s', seed, "seed"));
+
+  try
+  {
+    cmd.process(argc, argv);
+  }
+  catch (const std::string &s)
+  {
+    OPENMVG_LOG_ERROR << "Usage: " << argv[0] << '\n'
+              << "--- Optional ---\n"
+              << "[-n|--descriptor_count] number of descriptors per image (default 5000)\n"
+              << "[-r|--repetition_count] number of matching repetitions (default 10)\n"
+              << "[-s|--seed] random seed";
+    OPENMVG_LOG_ERROR << s;
+    return EXIT_FAILURE;
+  }
+
+  const system::CpuInstructionSet cpu_instruction_set;
+  OPENMVG_LOG_INFO << "CPU support:"
+    << " POPCNT: " << cpu_instruction_set.supportPOPCNT()
+    << " AVX2: " << cpu_instruction_set.supportAVX2()
+    << " AVX512 VPOPCNTDQ: " << cpu_instruction_set.supportAVX512VPOPCNTDQ();
+
+  // Two "images" sharing the same descriptor distribution
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> uniform(0, 255);
+  DescriptorMat centers(descriptor_count / 10 + 1, 128);
+  for (int i = 0; i < centers.size(); ++i)
+    centers.data()[i] = uniform(gen);
+  const DescriptorMat descriptors1 = RandomDescriptors(descriptor_count, centers, gen);
+  const DescriptorMat descriptors2 = RandomDescriptors(descriptor_count, centers, gen);
+
+  CascadeHasher cascade_hasher;
+  cascade_hasher.Init(128);
+  const Eigen::VectorXf zero_mean = CascadeHasher::GetZeroMeanDescriptor(descriptors1);
+  const HashedDescriptions hashed1 = cascade_hasher.CreateHashedDescriptions(descriptors1, zero_mean);
+  const HashedDescriptions hashed2 = cascade_hasher.CreateHashedDescriptions(descriptors2, zero_mean);
+
+  using DistanceType = L2<uint8_t>::ResultType;
+  IndMatches reference_indices, batched_indices;
+  std::vector<DistanceType> reference_distances, batched_distances;
+
+  system::Timer timer;
+  for (int i = 0; i < repetition_count; ++i)
+  {
+    reference_indices.clear();
+    reference_distances.clear();
+    cascade_hasher.Match_HashedDescriptions_Histogram<DescriptorMat, DistanceType>(
+      hashed2, descriptors2, hashed1, descriptors1,
+      &reference_indices, &reference_distances);
+  }
+  const double reference_time = timer.elapsedMs() / repetition_count;
+
+  timer.reset();
+  for (int i = 0; i < repetition_count; ++i)
+  {
+    batched_indices.clear();
+    batched_distances.clear();
+    cascade_hasher.Match_HashedDescriptions<DescriptorMat, DistanceType>(
+      hashed2, descriptors2, hashed1, descriptors1,
+      &batched_indices, &batched_distances);
+  }
+  const double batched_time = timer.elapsedMs() / repetition_count;
+
+  const bool same_results =
+    reference_indices == batched_indices && reference_distances == batched_distances;
+
+  OPENMVG_LOG_INFO << "\n"
+    << "#Descriptors per image: " << descriptor_count << "\n"
+    << "#Retrieved neighbors: " << batched_indices.size() << "\n"
+    << "Reference (histogram) matching: " << reference_time << " ms\n"
+    << "Batched (SIMD) matching: " << batched_time << " ms\n"
+    << "Speedup: " << reference_time / batched_time << "\n"
+    << "Identical results: " << (same_results ? "yes" : "no");
+
+  return same_results ? EXIT_SUCCESS : EXIT_FAILURE;
+}